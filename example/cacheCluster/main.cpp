@@ -1,18 +1,12 @@
-
 #include <inttypes.h>
+#include <unistd.h>
 
 #include <iostream>
-#include <string>
 #include <vector>
 
-#include "include/cache.hpp"
-#include "include/cacheCluster.hpp"
-#include "include/cacheServer.hpp"
 #include "libCacheSim.h"
 
-namespace CDNSimulator {
-
-void simulate(int argc, char *argv[]) {
+int main(int argc, char *argv[]) {
   const char *data_path = "../../../data/twitter_cluster52.csv";
   if (argc > 1) {
     data_path = argv[1];
@@ -37,58 +31,54 @@ void simulate(int argc, char *argv[]) {
   /* we can also use open_trace with the same parameters */
   reader_t *reader = open_trace(data_path, CSV_TRACE, &init_params);
 
-  const uint64_t n_server = 10;
-  const uint64_t server_dram_cache_size = 1 * MiB;
-  const uint64_t server_disk_cache_size = 10 * MiB;
-  const std::string algo = "lru";
-  // each cache holds 2 ** 20 objects, this is for performance optimization
-  // you can specify a smaller number to save memory
-  const uint32_t hashpower = 20;
+  const int n_server = 10;
+  const int replication = 2;
+  const int n_thread = 4;
+  const uint64_t server_cache_size = 10 * MiB;
   printf(
-      "setting up a cluster of %lu servers, each server has %lu MB DRAM cache "
-      "and %lu MB disk cache, using %s as cache replacement algorithm\n",
-      (unsigned long)n_server, (unsigned long)(server_dram_cache_size / MiB),
-      (unsigned long)(server_disk_cache_size / MiB), algo.c_str());
-
-  CacheCluster cluster(0);
+      "setting up a cluster of %d servers, each server has %lu MB cache, "
+      "each object is placed on %d servers\n",
+      n_server, (unsigned long)(server_cache_size / MiB), replication);
 
+  common_cache_params_t cc_params = default_common_cache_params();
+  cc_params.cache_size = server_cache_size;
+  // each cache holds 2 ** 20 objects, this is for performance optimization
+  // you can specify a smaller number to save memory
+  cc_params.hashpower = 20;
+  std::vector<cache_t *> caches;
   for (int i = 0; i < n_server; i++) {
-    CacheServer server(i);
-    server.add_cache(std::move(Cache(server_dram_cache_size, algo, hashpower)));
-    server.add_cache(std::move(Cache(server_disk_cache_size, algo, hashpower)));
-    cluster.add_server(std::move(server));
+    caches.push_back(LRU_init(cc_params, NULL));
   }
-
-  /* read the trace */
-  request_t *req = new_request();
-
-  uint64_t n_miss = 0, n_miss_byte = 0;
-  uint64_t n_req = 0, n_req_byte = 0;
-
-  while (read_trace(reader, req) == 0) {
-    bool hit = cluster.get(req);
-    if (!hit) {
-      n_miss += 1;
-      n_miss_byte += req->obj_size;
-    }
-    n_req += 1;
-    n_req_byte += req->obj_size;
+  cache_cluster_t *cluster =
+      create_cache_cluster(caches.data(), NULL, n_server, replication);
+
+  /* server 9 joins the cluster later, and server 3 fails in the middle */
+  int64_t n_req = (int64_t)get_num_of_req(reader);
+  cluster_event_t events[] = {
+      {0, CLUSTER_EVENT_REMOVE_SERVER, 9},
+      {n_req / 4, CLUSTER_EVENT_ADD_SERVER, 9},
+      {n_req / 2, CLUSTER_EVENT_REMOVE_SERVER, 3},
+  };
+
+  cluster_stat_t *stat = simulate_cache_cluster(
+      cluster, reader, events, sizeof(events) / sizeof(events[0]), n_thread);
+
+  std::cout << stat->n_req << " requests, " << stat->n_miss
+            << " misses, miss ratio: " << (double)stat->n_miss / stat->n_req
+            << ", byte miss ratio: "
+            << (double)stat->n_miss_byte / stat->n_req_byte
+            << ", load imbalance: " << stat->load_imbalance << std::endl;
+  for (int i = 0; i < n_server; i++) {
+    const cluster_server_stat_t *s = &stat->server_stats[i];
+    printf("server %d: %" PRId64 " requests, hit ratio %.4lf, %" PRId64
+           " replica requests\n",
+           i, s->n_req, s->n_req == 0 ? 0 : (double)s->n_hit / s->n_req,
+           s->n_replica_req);
   }
 
-  std::cout << n_req << " requests, " << n_miss << " misses, miss ratio: " << (double)n_miss / n_req
-            << ", byte miss ratio: " << (double)n_miss_byte / n_req_byte << std::endl;
-
+  free_cluster_stat(stat);
+  free_cache_cluster(cluster);
   close_trace(reader);
-}
-}  // namespace CDNSimulator
-
-int main(int argc, char *argv[]) {
-  try {
-    CDNSimulator::simulate(argc, argv);
-  } catch (std::exception &e) {
-    std::cerr << e.what() << std::endl;
-    print_stack_trace();
-  }
 
   return 0;
 }
@@ -5,12 +5,12 @@
 #include <unistd.h>
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
-#include <thread>
 #include <vector>
 
+#include "libCacheSim.h"
 #include "myconfig.hpp"
-#include "simulator.hpp"
 #include "utils.hpp"
 
 using namespace std;
@@ -28,30 +28,61 @@ int main(int argc, char* argv[]) {
   Myconfig config(config_path);
   config.print();
 
-  // start L1: generate N cachemiss traces
-  vector<thread> simulator_thread_vec;
+  // L1: one cache per trace
+  vector<reader_t*> readers;
+  vector<cache_t*> l1_caches;
   for (int i = 0; i < config.n_l1; i++) {
-    uint64_t cache_size = config.l1_sizes.at(i);
-    string& trace_path = config.l1_trace_path.at(i);
-    string& miss_output_path = config.l1_miss_output_path.at(i);
-    std::thread t(Simulator::gen_miss_trace, cache_algo, cache_size, trace_path,
-                  miss_output_path);
-    simulator_thread_vec.push_back(std::move(t));
+    reader_init_param_t reader_init_params = default_reader_init_params();
+    reader_init_params.time_field = 1;
+    reader_init_params.obj_id_field = 2;
+    reader_init_params.obj_size_field = 3;
+    // see the cacheSimulator example for using csv trace
+    reader_init_params.binary_fmt_str = (char*)"<III";
+    readers.push_back(open_trace(config.l1_trace_path.at(i).c_str(), BIN_TRACE,
+                                 &reader_init_params));
+
+    common_cache_params_t cc_params = default_common_cache_params();
+    cc_params.cache_size = config.l1_sizes.at(i);
+    l1_caches.push_back(create_cache(cache_algo.c_str(), cc_params, nullptr));
+  }
+
+  // L2: each size sees the same merged miss stream of the L1 caches
+  vector<cache_t*> l2_caches;
+  for (auto sz : config.l2_sizes) {
+    common_cache_params_t cc_params = default_common_cache_params();
+    cc_params.cache_size = sz;
+    l2_caches.push_back(create_cache(cache_algo.c_str(), cc_params, nullptr));
   }
 
-  for (auto& t : simulator_thread_vec) {
-    t.join();
+  hierarchy_level_t levels[2] = {{l1_caches.data(), (int)l1_caches.size()},
+                                 {l2_caches.data(), (int)l2_caches.size()}};
+  hierarchy_stat_t* stat = simulate_cache_hierarchy(
+      readers.data(), levels, 2,
+      config.exclusive ? HIERARCHY_EXCLUSIVE : HIERARCHY_INCLUSIVE,
+      config.write_back ? HIERARCHY_WRITE_BACK : HIERARCHY_WRITE_THROUGH);
+
+  for (int i = 0; i < config.n_l1; i++) {
+    hierarchy_cache_stat_t* s = &stat->cache_stats[0][i];
+    std::cout << config.l1_trace_path.at(i) << ", object miss ratio "
+              << 1.0 - (double)s->n_hit / s->n_req << std::endl;
   }
 
-  // create L2 traces
-  std::cout << "************* create L2 trace "
-            << TraceUtils::merge_l1_trace(config.l1_miss_output_path,
-                                          config.l2_trace_path)
-            << " req" << std::endl;
+  std::ofstream mrc_ofs(config.l2_mrc_output_path);
+  hierarchy_cache_stat_t* l2_stats = stat->cache_stats[1];
+  mrc_ofs << "# L2, " << l2_stats[0].n_req << " req, " << l2_stats[0].n_req_byte
+          << " byte" << std::endl;
+  mrc_ofs << "# cache size, miss_cnt, miss_byte" << std::endl;
+  for (int i = 0; i < (int)config.l2_sizes.size(); i++) {
+    mrc_ofs << config.l2_sizes.at(i) << ","
+            << l2_stats[i].n_req - l2_stats[i].n_hit << ","
+            << l2_stats[i].n_req_byte - l2_stats[i].n_hit_byte << std::endl;
+  }
+  mrc_ofs.close();
 
-  // start L2: get a MRC
-  Simulator::output_mrc(cache_algo, config.l2_sizes, config.l2_trace_path,
-                        config.l2_mrc_output_path);
+  free_hierarchy_stat(stat);
+  for (auto cache : l1_caches) cache->cache_free(cache);
+  for (auto cache : l2_caches) cache->cache_free(cache);
+  for (auto reader : readers) close_trace(reader);
 
   return 0;
-}
\ No newline at end of file
+}
@@ -35,18 +35,14 @@ void Myconfig::load_config() {
     l2_sizes_str.push_back(sz);
   }
 
+  if (yamlconfig["exclusive"]) exclusive = yamlconfig["exclusive"].as<bool>();
+  if (yamlconfig["write_back"])
+    write_back = yamlconfig["write_back"].as<bool>();
+
   output_path = yamlconfig["output"].as<string>();
 }
 
 void Myconfig::_prepare() {
-  for (int i = 0; i < n_l1; i++) {
-    int pos = l1_trace_path.at(i).rfind('/');
-    if (pos == std::string::npos) pos = -1;
-    l1_names.push_back(l1_trace_path.at(i).substr(pos + 1));
-
-    l1_miss_output_path.push_back(output_path + "/l1_trace_" + l1_names.back());
-  }
-  l2_trace_path = output_path + "/l2.trace";
   l2_mrc_output_path = output_path + "/l2.mrc";
   mkdir(output_path.c_str(), 0777);
 }
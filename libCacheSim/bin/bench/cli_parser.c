@@ -0,0 +1,159 @@
+#define _GNU_SOURCE
+#include <argp.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../../include/libCacheSim/logging.h"
+#include "internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const char *argp_program_version = "bench 0.0.1";
+const char *argp_program_bug_address =
+    "https://groups.google.com/g/libcachesim/";
+
+enum argp_option_short {
+  OPTION_ALGO = 'a',
+  OPTION_WORKLOAD = 'w',
+  OPTION_CACHE_SIZE_RATIO = 'r',
+  OPTION_REPEAT = 'n',
+  OPTION_TIMEOUT = 't',
+  OPTION_OUTPUT_PATH = 'o',
+};
+
+/*
+   OPTIONS.  Field 1 in ARGP.
+   Order of fields: {NAME, KEY, ARG, FLAGS, DOC}.
+*/
+static struct argp_option options[] = {
+    {"algo", OPTION_ALGO, "lru,fifo", 0,
+     "Eviction algorithms to benchmark separated by comma, default all "
+     "algorithms in cache_init.c",
+     1},
+    {"workload", OPTION_WORKLOAD, "dist=zipf,alpha=1", 0,
+     "A synthetic trace spec or the path to an oracleGeneral trace, can be "
+     "used multiple times, default one synthetic Zipf workload and "
+     "../data/cloudPhysicsIO.oracleGeneral.bin",
+     1},
+    {"cache-size-ratio", OPTION_CACHE_SIZE_RATIO, "0.1", 0,
+     "Cache size as a fraction of the working set size", 2},
+    {"repeat", OPTION_REPEAT, "1", 0,
+     "Number of runs of each (workload, algorithm), the fastest run is "
+     "reported",
+     2},
+    {"timeout", OPTION_TIMEOUT, "600", 0,
+     "Timeout of each run in seconds, 0 means no timeout", 2},
+    {"output", OPTION_OUTPUT_PATH, "bench.json", 0, "Output path of the JSON",
+     3},
+
+    {0}};
+
+static void add_algos(struct arguments *args, const char *arg) {
+  char *algos_str = strdup(arg);
+  char *s = algos_str;
+  while (s != NULL && s[0] != '\0') {
+    char *algo = strsep(&s, ",");
+    while (*algo == ' ') algo++;
+    if (algo[0] == '\0') continue;
+    if (args->n_algo >= N_MAX_ALGO) {
+      ERROR("too many algorithms, at most %d\n", N_MAX_ALGO);
+      exit(1);
+    }
+    args->algos[args->n_algo++] = strdup(algo);
+  }
+  free(algos_str);
+}
+
+/*
+   PARSER. Field 2 in ARGP.
+   Order of parameters: KEY, ARG, STATE.
+*/
+static error_t parse_opt(int key, char *arg, struct argp_state *state) {
+  struct arguments *arguments = state->input;
+
+  switch (key) {
+    case OPTION_ALGO:
+      add_algos(arguments, arg);
+      break;
+    case OPTION_WORKLOAD:
+      if (arguments->n_workload >= N_MAX_WORKLOAD) {
+        ERROR("too many workloads, at most %d\n", N_MAX_WORKLOAD);
+        exit(1);
+      }
+      arguments->workloads[arguments->n_workload++] = strdup(arg);
+      break;
+    case OPTION_CACHE_SIZE_RATIO:
+      arguments->cache_size_ratio = strtod(arg, NULL);
+      break;
+    case OPTION_REPEAT:
+      arguments->n_repeat = atoi(arg);
+      break;
+    case OPTION_TIMEOUT:
+      arguments->timeout_sec = atoi(arg);
+      break;
+    case OPTION_OUTPUT_PATH:
+      strncpy(arguments->ofilepath, arg, OFILEPATH_LEN - 1);
+      break;
+    case ARGP_KEY_ARG:
+      printf("found unexpected argument %s\n", arg);
+      argp_usage(state);
+      exit(1);
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+
+/* Program documentation. */
+static char doc[] =
+    "example: ./bench -a lru,s3fifo -w dist=zipf,alpha=0.8,n-obj=1e6 -o "
+    "bench.json\n\n"
+    "benchmark eviction algorithms and report ns/req, allocations/req, peak "
+    "RSS and hardware counters (cycles, instructions, cache misses and branch "
+    "misses) if perf_event_open is allowed\n";
+
+/**
+ * @brief initialize the arguments
+ *
+ * @param args
+ */
+static void init_arg(struct arguments *args) {
+  memset(args, 0, sizeof(struct arguments));
+  args->cache_size_ratio = 0.1;
+  args->n_repeat = 1;
+  args->timeout_sec = 600;
+  strncpy(args->ofilepath, "bench.json", OFILEPATH_LEN - 1);
+}
+
+/**
+ * @brief parse the command line arguments
+ *
+ * @param argc
+ * @param argv
+ */
+void parse_cmd(int argc, char *argv[], struct arguments *args) {
+  init_arg(args);
+
+  static struct argp argp = {options, parse_opt, NULL, doc, NULL, NULL, NULL};
+
+  argp_parse(&argp, argc, argv, 0, 0, args);
+
+  if (args->n_workload == 0) {
+    args->workloads[args->n_workload++] =
+        strdup("dist=zipf,alpha=1.0,n-obj=100000,n-req=2000000,seed=42");
+    args->workloads[args->n_workload++] =
+        strdup("../data/cloudPhysicsIO.oracleGeneral.bin");
+  }
+
+  if (args->cache_size_ratio <= 0 || args->cache_size_ratio > 1) {
+    ERROR("cache size ratio should be in (0, 1]\n");
+    exit(1);
+  }
+  if (args->n_repeat < 1) args->n_repeat = 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
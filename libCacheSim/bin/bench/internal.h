@@ -0,0 +1,93 @@
+#pragma once
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "../../include/libCacheSim/request.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define N_MAX_ALGO 128
+#define N_MAX_WORKLOAD 8
+#define OFILEPATH_LEN 256
+
+struct arguments {
+  char *algos[N_MAX_ALGO];
+  int n_algo;
+  /* a workload is either a synthetic trace spec or an oracleGeneral trace */
+  char *workloads[N_MAX_WORKLOAD];
+  int n_workload;
+  double cache_size_ratio;
+  int n_repeat;
+  /* a run that does not finish in timeout_sec is reported as timeout */
+  int timeout_sec;
+  char ofilepath[OFILEPATH_LEN];
+};
+
+void parse_cmd(int argc, char *argv[], struct arguments *args);
+
+/* the requests of a workload are loaded into memory before benchmarking so
+ * that trace parsing is not measured */
+typedef struct {
+  int64_t clock_time;
+  obj_id_t obj_id;
+  int64_t obj_size;
+  int64_t next_access_vtime;
+} bench_req_t;
+
+typedef struct {
+  char *name;
+  bool has_oracle;
+  bench_req_t *reqs;
+  int64_t n_req;
+  int64_t n_obj;
+  int64_t working_set_byte;
+} workload_t;
+
+/**************** perf counters ****************/
+typedef enum {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_MISSES,
+  PERF_BRANCH_MISSES,
+
+  N_PERF_COUNTER,
+} perf_counter_e;
+
+extern const char *perf_counter_name[N_PERF_COUNTER];
+
+typedef struct {
+  int group_fd;
+  int fds[N_PERF_COUNTER];
+  /* -1 if the counter is not available */
+  int64_t values[N_PERF_COUNTER];
+} perf_counters_t;
+
+/* open the counters of this thread, counters that the kernel does not allow
+ * (no PMU, perf_event_paranoid, container) are marked as unavailable */
+void perf_counters_open(perf_counters_t *pc);
+
+void perf_counters_start(perf_counters_t *pc);
+
+void perf_counters_stop(perf_counters_t *pc);
+
+void perf_counters_close(perf_counters_t *pc);
+
+/**************** memory ****************/
+/* the number of allocation calls and bytes since start,
+ * return false if allocations cannot be counted on this platform */
+bool get_alloc_cnt(uint64_t *n_alloc, uint64_t *n_alloc_byte);
+
+/* reset the peak RSS so that the next get_peak_rss returns the peak since the
+ * reset, return false if the kernel does not support it */
+bool reset_peak_rss(void);
+
+int64_t get_peak_rss_byte(void);
+
+int64_t get_curr_rss_byte(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,366 @@
+//
+// benchmark the eviction algorithms on fixed workloads,
+// the results are written as JSON so that they can be compared over time
+//
+// ./bin/bench -o bench.json
+// ./bin/bench -a lru,s3fifo -w dist=zipf,alpha=0.8,n-obj=1e6,n-req=1e7
+//
+
+#define _GNU_SOURCE
+#include <assert.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../include/libCacheSim/cache.h"
+#include "../../include/libCacheSim/reader.h"
+#include "../../utils/include/mysys.h"
+#include "../cachesim/cache_init.h"
+#include "internal.h"
+
+typedef enum {
+  BENCH_OK,
+  BENCH_FAILED,
+  BENCH_TIMEOUT,
+} bench_status_e;
+
+static const char *bench_status_str[] = {"ok", "failed", "timeout"};
+
+typedef struct {
+  const char *workload;
+  const char *algo;
+  bench_status_e status;
+  int64_t cache_size;
+  int64_t n_req;
+  int64_t n_miss;
+  int64_t n_req_byte;
+  int64_t n_miss_byte;
+  double runtime_sec;
+  bool alloc_counted;
+  uint64_t n_alloc;
+  uint64_t n_alloc_byte;
+  int64_t peak_rss_byte;
+  int64_t rss_growth_byte;
+  int64_t perf[N_PERF_COUNTER];
+} bench_result_t;
+
+static bool algo_need_oracle(const char *algo) {
+  for (int i = 0; i < n_cache_algos; i++) {
+    if (strcasecmp(cache_algos[i].name, algo) == 0)
+      return cache_algos[i].need_oracle;
+  }
+  return false;
+}
+
+static void load_workload(const char *name, workload_t *wl) {
+  /* the workload is an oracleGeneral trace if the file exists,
+   * otherwise it is a synthetic trace spec */
+  bool is_file = access(name, R_OK) == 0;
+  trace_type_e trace_type = is_file ? ORACLE_GENERAL_TRACE : SYNTHETIC_TRACE;
+  reader_t *reader = setup_reader(name, trace_type, NULL);
+
+  wl->name = strdup(name);
+  wl->has_oracle = is_file;
+  wl->n_req = 0;
+  wl->n_obj = 0;
+  wl->working_set_byte = 0;
+
+  int64_t n_max_req = (int64_t)get_num_of_req(reader);
+  wl->reqs = malloc(sizeof(bench_req_t) * n_max_req);
+
+  GHashTable *obj_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+  request_t *req = new_request();
+  while (read_one_req(reader, req) == 0) {
+    assert(wl->n_req < n_max_req);
+    bench_req_t *r = &wl->reqs[wl->n_req++];
+    r->clock_time = req->clock_time;
+    r->obj_id = req->obj_id;
+    r->obj_size = req->obj_size;
+    r->next_access_vtime = req->next_access_vtime;
+
+    if (!g_hash_table_contains(obj_table, GSIZE_TO_POINTER(req->obj_id))) {
+      g_hash_table_add(obj_table, GSIZE_TO_POINTER(req->obj_id));
+      wl->n_obj += 1;
+      wl->working_set_byte += req->obj_size;
+    }
+  }
+
+  g_hash_table_destroy(obj_table);
+  free_request(req);
+  close_reader(reader);
+
+  if (wl->n_obj == 0) {
+    ERROR("workload %s has no request\n", name);
+    exit(1);
+  }
+
+  INFO("workload %s: %ld req, %ld obj, working set %ld bytes\n", wl->name,
+       (long)wl->n_req, (long)wl->n_obj, (long)wl->working_set_byte);
+}
+
+static void run_one(const workload_t *wl, const char *algo, int64_t cache_size,
+                    perf_counters_t *pc, bench_result_t *res) {
+  cache_t *cache = create_cache(wl->name, algo, cache_size, NULL, false,
+                                MAX(wl->working_set_byte / wl->n_obj, 1));
+  request_t *req = new_request();
+
+  uint64_t n_alloc_start = 0, n_alloc_byte_start = 0;
+  bool rss_reset = reset_peak_rss();
+  int64_t rss_start = get_curr_rss_byte();
+  get_alloc_cnt(&n_alloc_start, &n_alloc_byte_start);
+
+  perf_counters_start(pc);
+  double start_time = gettime();
+  for (int64_t i = 0; i < wl->n_req; i++) {
+    const bench_req_t *r = &wl->reqs[i];
+    req->clock_time = r->clock_time;
+    req->obj_id = r->obj_id;
+    req->obj_size = r->obj_size;
+    req->next_access_vtime = r->next_access_vtime;
+    req->hv = 0;
+    req->valid = true;
+
+    res->n_req_byte += req->obj_size;
+    if (!cache->get(cache, req)) {
+      res->n_miss += 1;
+      res->n_miss_byte += req->obj_size;
+    }
+  }
+  res->runtime_sec = gettime() - start_time;
+  perf_counters_stop(pc);
+
+  uint64_t n_alloc_end = 0, n_alloc_byte_end = 0;
+  res->alloc_counted = get_alloc_cnt(&n_alloc_end, &n_alloc_byte_end);
+  res->n_alloc = n_alloc_end - n_alloc_start;
+  res->n_alloc_byte = n_alloc_byte_end - n_alloc_byte_start;
+  res->peak_rss_byte = get_peak_rss_byte();
+  res->rss_growth_byte =
+      rss_reset && rss_start >= 0 ? res->peak_rss_byte - rss_start : -1;
+  res->n_req = wl->n_req;
+  memcpy(res->perf, pc->values, sizeof(res->perf));
+
+  free_request(req);
+  cache->cache_free(cache);
+}
+
+/**
+ * @brief run one benchmark in a child process, so that the allocation
+ * counters, RSS and perf counters are not polluted by previous runs, and an
+ * algorithm that crashes does not stop the benchmark
+ *
+ * @return false if the run failed
+ */
+static bool run_one_isolated(const workload_t *wl, const char *algo,
+                             int64_t cache_size, int timeout_sec,
+                             bench_result_t *res) {
+  memset(res, 0, sizeof(bench_result_t));
+  res->workload = wl->name;
+  res->algo = algo;
+  res->cache_size = cache_size;
+  res->status = BENCH_FAILED;
+
+  int fds[2];
+  if (pipe(fds) != 0) {
+    ERROR("pipe failed: %s\n", strerror(errno));
+    return false;
+  }
+
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid < 0) {
+    ERROR("fork failed: %s\n", strerror(errno));
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+
+  if (pid == 0) {
+    close(fds[0]);
+    /* the default action of SIGALRM terminates the child */
+    if (timeout_sec > 0) alarm(timeout_sec);
+    perf_counters_t pc;
+    perf_counters_open(&pc);
+    run_one(wl, algo, cache_size, &pc, res);
+    perf_counters_close(&pc);
+    res->status = BENCH_OK;
+    ssize_t n = write(fds[1], res, sizeof(bench_result_t));
+    close(fds[1]);
+    _exit(n == sizeof(bench_result_t) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  bench_result_t child_res;
+  size_t n_read = 0;
+  while (n_read < sizeof(child_res)) {
+    ssize_t n = read(fds[0], (char *)&child_res + n_read,
+                     sizeof(child_res) - n_read);
+    if (n <= 0) break;
+    n_read += n;
+  }
+  close(fds[0]);
+
+  int status;
+  waitpid(pid, &status, 0);
+  if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM) {
+    WARN("%s on %s did not finish in %d sec\n", algo, wl->name, timeout_sec);
+    res->status = BENCH_TIMEOUT;
+    return false;
+  }
+  if (n_read != sizeof(child_res) || !WIFEXITED(status) ||
+      WEXITSTATUS(status) != 0) {
+    WARN("%s on %s failed\n", algo, wl->name);
+    return false;
+  }
+
+  *res = child_res;
+  return true;
+}
+
+static void print_json_str(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s != '\0'; s++) {
+    if (*s == '"' || *s == '\\') fputc('\\', f);
+    fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+static void print_json_per_req(FILE *f, const char *key, int64_t v,
+                               int64_t n_req) {
+  if (v < 0) {
+    fprintf(f, ", \"%s\": null", key);
+  } else {
+    fprintf(f, ", \"%s\": %.4lf", key, (double)v / (double)n_req);
+  }
+}
+
+static void write_json(const char *path, const struct arguments *args,
+                       const bench_result_t *results, int n_result) {
+  FILE *f = fopen(path, "w");
+  if (f == NULL) {
+    ERROR("cannot open %s: %s\n", path, strerror(errno));
+    return;
+  }
+
+  char time_str[64];
+  time_t now = time(NULL);
+  strftime(time_str, sizeof(time_str), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+  char hostname[128] = "";
+  gethostname(hostname, sizeof(hostname) - 1);
+
+  fprintf(f, "{\n  \"version\": 1,\n  \"timestamp\": \"%s\",\n", time_str);
+  fprintf(f, "  \"host\": ");
+  print_json_str(f, hostname);
+  fprintf(f, ",\n  \"n_cores\": %d,\n  \"cache_size_ratio\": %.4lf,\n",
+          n_cores(), args->cache_size_ratio);
+  fprintf(f, "  \"results\": [\n");
+  for (int i = 0; i < n_result; i++) {
+    const bench_result_t *r = &results[i];
+    fprintf(f, "    {\"workload\": ");
+    print_json_str(f, r->workload);
+    fprintf(f, ", \"algo\": ");
+    print_json_str(f, r->algo);
+    fprintf(f, ", \"status\": \"%s\"", bench_status_str[r->status]);
+    if (r->status != BENCH_OK) {
+      fprintf(f, "}%s\n", i == n_result - 1 ? "" : ",");
+      continue;
+    }
+    fprintf(f,
+            ", \"cache_size\": %ld, \"n_req\": %ld, \"miss_ratio\": %.6lf, "
+            "\"byte_miss_ratio\": %.6lf, \"ns_per_req\": %.2lf, "
+            "\"mqps\": %.4lf",
+            (long)r->cache_size, (long)r->n_req,
+            (double)r->n_miss / (double)r->n_req,
+            (double)r->n_miss_byte / (double)r->n_req_byte,
+            r->runtime_sec * 1e9 / (double)r->n_req,
+            (double)r->n_req / 1e6 / r->runtime_sec);
+    print_json_per_req(f, "alloc_per_req",
+                       r->alloc_counted ? (int64_t)r->n_alloc : -1, r->n_req);
+    print_json_per_req(f, "alloc_byte_per_req",
+                       r->alloc_counted ? (int64_t)r->n_alloc_byte : -1,
+                       r->n_req);
+    fprintf(f, ", \"peak_rss_byte\": %ld, \"rss_growth_byte\": %ld",
+            (long)r->peak_rss_byte, (long)r->rss_growth_byte);
+    for (int j = 0; j < N_PERF_COUNTER; j++) {
+      char key[64];
+      snprintf(key, sizeof(key), "%s_per_req", perf_counter_name[j]);
+      print_json_per_req(f, key, r->perf[j], r->n_req);
+    }
+    fprintf(f, "}%s\n", i == n_result - 1 ? "" : ",");
+  }
+  fprintf(f, "  ]\n}\n");
+  fclose(f);
+}
+
+int main(int argc, char **argv) {
+  struct arguments args;
+  parse_cmd(argc, argv, &args);
+
+  if (args.n_algo == 0) {
+    for (int i = 0; i < n_cache_algos; i++) {
+      args.algos[args.n_algo++] = strdup(cache_algos[i].name);
+    }
+  }
+
+  /* check whether the perf counters are available, each run opens its own */
+  perf_counters_t pc;
+  perf_counters_open(&pc);
+  perf_counters_close(&pc);
+
+  bench_result_t *results =
+      malloc(sizeof(bench_result_t) * args.n_workload * args.n_algo);
+  int n_result = 0;
+
+  printf("%-48s %16s %10s %10s %12s %12s %10s %12s\n", "workload", "algo",
+         "miss_ratio", "ns/req", "alloc/req", "peakRSS_MB", "IPC",
+         "LLCmiss/req");
+  for (int w = 0; w < args.n_workload; w++) {
+    workload_t wl;
+    load_workload(args.workloads[w], &wl);
+    int64_t cache_size =
+        MAX((int64_t)(wl.working_set_byte * args.cache_size_ratio), 1);
+
+    for (int a = 0; a < args.n_algo; a++) {
+      if (algo_need_oracle(args.algos[a]) && !wl.has_oracle) {
+        INFO("skip %s on %s, which has no next access time\n", args.algos[a],
+             wl.name);
+        continue;
+      }
+
+      /* report the fastest run */
+      bench_result_t *best = &results[n_result++];
+      for (int r = 0; r < args.n_repeat; r++) {
+        bench_result_t res;
+        if (!run_one_isolated(&wl, args.algos[a], cache_size, args.timeout_sec,
+                              &res)) {
+          *best = res;
+          break;
+        }
+        if (r == 0 || res.runtime_sec < best->runtime_sec) *best = res;
+      }
+      if (best->status != BENCH_OK) continue;
+
+      double ipc = best->perf[PERF_CYCLES] > 0 && best->perf[PERF_INSTRUCTIONS] >= 0
+                       ? (double)best->perf[PERF_INSTRUCTIONS] / best->perf[PERF_CYCLES]
+                       : -1;
+      double llc_miss = best->perf[PERF_CACHE_MISSES] >= 0
+                            ? (double)best->perf[PERF_CACHE_MISSES] / best->n_req
+                            : -1;
+      printf("%-48.48s %16s %10.4lf %10.2lf %12.2lf %12.2lf %10.2lf %12.2lf\n",
+             wl.name, best->algo, (double)best->n_miss / best->n_req,
+             best->runtime_sec * 1e9 / best->n_req,
+             best->alloc_counted ? (double)best->n_alloc / best->n_req : -1.0,
+             (double)best->peak_rss_byte / MiB, ipc, llc_miss);
+    }
+    /* the results keep a pointer to the workload name */
+    free(wl.reqs);
+  }
+
+  write_json(args.ofilepath, &args, results, n_result);
+  INFO("results are written to %s\n", args.ofilepath);
+
+  free(results);
+  return 0;
+}
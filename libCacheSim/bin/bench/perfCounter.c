@@ -0,0 +1,222 @@
+//
+// hardware counters, allocation counting and RSS used by the benchmark
+//
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../../include/libCacheSim/logging.h"
+#include "internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************** perf counters ****************/
+const char *perf_counter_name[N_PERF_COUNTER] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"};
+
+#ifdef __linux__
+static int perf_event_open(struct perf_event_attr *attr, pid_t pid, int cpu,
+                           int group_fd, unsigned long flags) {
+  return (int)syscall(__NR_perf_event_open, attr, pid, cpu, group_fd, flags);
+}
+
+static const uint64_t perf_counter_config[N_PERF_COUNTER] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+#endif
+
+void perf_counters_open(perf_counters_t *pc) {
+  pc->group_fd = -1;
+  for (int i = 0; i < N_PERF_COUNTER; i++) {
+    pc->fds[i] = -1;
+    pc->values[i] = -1;
+  }
+
+#ifdef __linux__
+  for (int i = 0; i < N_PERF_COUNTER; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = perf_counter_config[i];
+    attr.disabled = pc->group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    int fd = perf_event_open(&attr, 0, -1, pc->group_fd, 0);
+    if (fd < 0) {
+      static bool warned = false;
+      if (!warned) {
+        WARN("perf counter %s is not available (%s), check perf_event_paranoid\n",
+             perf_counter_name[i], strerror(errno));
+        warned = true;
+      }
+      continue;
+    }
+    if (pc->group_fd == -1) pc->group_fd = fd;
+    pc->fds[i] = fd;
+  }
+#endif
+}
+
+void perf_counters_start(perf_counters_t *pc) {
+#ifdef __linux__
+  if (pc->group_fd == -1) return;
+  ioctl(pc->group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(pc->group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void perf_counters_stop(perf_counters_t *pc) {
+#ifdef __linux__
+  if (pc->group_fd == -1) return;
+  ioctl(pc->group_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  for (int i = 0; i < N_PERF_COUNTER; i++) {
+    uint64_t v;
+    if (pc->fds[i] == -1) continue;
+    if (read(pc->fds[i], &v, sizeof(v)) == sizeof(v)) {
+      pc->values[i] = (int64_t)v;
+    }
+  }
+#endif
+}
+
+void perf_counters_close(perf_counters_t *pc) {
+  for (int i = 0; i < N_PERF_COUNTER; i++) {
+    if (pc->fds[i] != -1) close(pc->fds[i]);
+    pc->fds[i] = -1;
+  }
+  pc->group_fd = -1;
+}
+
+/**************** allocation counting ****************/
+#ifdef __GLIBC__
+/* the benchmark replaces malloc, calloc, realloc, the aligned allocations
+ * (used with HEAP_ALLOCATOR_ALIGNED_MALLOC) and free, and forwards them to
+ * glibc, so the allocations in libCacheSim and glib are counted */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static uint64_t n_alloc = 0;
+static uint64_t n_alloc_byte = 0;
+
+static inline void count_alloc(size_t size) {
+  __atomic_fetch_add(&n_alloc, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&n_alloc_byte, size, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) {
+  count_alloc(size);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+  count_alloc(n * size);
+  return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  count_alloc(size);
+  return __libc_realloc(ptr, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+  count_alloc(size);
+  return __libc_memalign(alignment, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+  count_alloc(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size) {
+  if (alignment % sizeof(void *) != 0 ||
+      (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  count_alloc(size);
+  void *ptr = __libc_memalign(alignment, size);
+  if (ptr == NULL) return ENOMEM;
+  *memptr = ptr;
+  return 0;
+}
+
+void free(void *ptr) { __libc_free(ptr); }
+
+bool get_alloc_cnt(uint64_t *n, uint64_t *n_byte) {
+  *n = __atomic_load_n(&n_alloc, __ATOMIC_RELAXED);
+  *n_byte = __atomic_load_n(&n_alloc_byte, __ATOMIC_RELAXED);
+  return true;
+}
+#else
+bool get_alloc_cnt(uint64_t *n, uint64_t *n_byte) {
+  *n = 0;
+  *n_byte = 0;
+  return false;
+}
+#endif
+
+/**************** RSS ****************/
+bool reset_peak_rss(void) {
+#ifdef __linux__
+  /* writing 5 to clear_refs resets VmHWM (since Linux 4.0) */
+  FILE *f = fopen("/proc/self/clear_refs", "w");
+  if (f == NULL) return false;
+  bool ok = fputs("5", f) >= 0;
+  ok = (fclose(f) == 0) && ok;
+  return ok;
+#else
+  return false;
+#endif
+}
+
+static int64_t read_proc_status_kb(const char *key) {
+#ifdef __linux__
+  FILE *f = fopen("/proc/self/status", "r");
+  if (f == NULL) return -1;
+
+  char line[256];
+  int64_t v = -1;
+  size_t key_len = strlen(key);
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (strncmp(line, key, key_len) == 0 && line[key_len] == ':') {
+      v = strtoll(line + key_len + 1, NULL, 10);
+      break;
+    }
+  }
+  fclose(f);
+  return v;
+#else
+  return -1;
+#endif
+}
+
+int64_t get_peak_rss_byte(void) {
+  int64_t kb = read_proc_status_kb("VmHWM");
+  return kb < 0 ? -1 : kb * 1024;
+}
+
+int64_t get_curr_rss_byte(void) {
+  int64_t kb = read_proc_status_kb("VmRSS");
+  return kb < 0 ? -1 : kb * 1024;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+#define _GNU_SOURCE
+#include "cache_init.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the canonical name of every algorithm create_cache supports (aliases are
+ * not listed), add the algorithm here when adding a branch to create_cache */
+const cache_algo_t cache_algos[] = {
+    {"lru", false},          {"fifo", false},        {"arc", false},
+    {"arcv0", false},        {"lhd", false},         {"random", false},
+    {"randomTwo", false},    {"lfu", false},         {"gdsf", false},
+    {"lfuda", false},        {"twoq", false},        {"slru", false},
+    {"slruv0", false},       {"hyperbolic", false},  {"lecar", false},
+    {"lecarv0", false},      {"RandomLRU", false},   {"cacheus", false},
+    {"size", false},         {"lfucpp", false},      {"tinyLFU", false},
+    {"wtinyLFU", false},     {"belady", true},       {"nop", false},
+    {"beladySize", true},    {"clock", false},       {"lirs", false},
+    {"fifomerge", false},    {"flashProb", false},   {"sfifo", false},
+    {"sfifov0", false},      {"lru-prob", false},    {"fifo-belady", true},
+    {"lru-belady", true},    {"sieve-belady", true}, {"s3lru", false},
+    {"s3fifo", false},       {"s3fifod", false},     {"qdlp", false},
+    {"sieve", false},
+#ifdef ENABLE_GLCACHE
+    {"GLCache", false},
+#endif
+#ifdef ENABLE_LRB
+    {"lrb", false},
+#endif
+#ifdef INCLUDE_PRIV
+    {"mclock", false},       {"lp-sfifo", false},    {"lp-arc", false},
+    {"lp-twoq", false},      {"qdlpv0", false},      {"s3fifodv2", false},
+    {"myMQv1", false},
+#endif
+};
+
+const int n_cache_algos = sizeof(cache_algos) / sizeof(cache_algos[0]);
+
+#ifdef __cplusplus
+}
+#endif
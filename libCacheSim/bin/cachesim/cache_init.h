@@ -12,19 +12,41 @@
 extern "C" {
 #endif
 
+typedef struct {
+  const char *name;
+  /* oracle algorithms need next_access_vtime, e.g., oracleGeneral trace */
+  bool need_oracle;
+} cache_algo_t;
+
+/* the canonical name of every algorithm create_cache supports (aliases are
+ * not listed), defined in cache_init.c */
+extern const cache_algo_t cache_algos[];
+extern const int n_cache_algos;
+
+/**
+ * @brief create a cache by name
+ *
+ * @param trace_path
+ * @param eviction_algo
+ * @param cache_size
+ * @param eviction_params
+ * @param consider_obj_metadata
+ * @param mean_obj_size the mean object size of the trace (1 if the object size
+ *    is ignored), the hashtable of the cache is sized for
+ *    cache_size / mean_obj_size objects and grows when needed
+ * @return cache_t*
+ */
 static inline cache_t *create_cache(const char *trace_path, const char *eviction_algo, const uint64_t cache_size,
-                                    const char *eviction_params, const bool consider_obj_metadata) {
+                                    const char *eviction_params, const bool consider_obj_metadata,
+                                    const int64_t mean_obj_size) {
   common_cache_params_t cc_params = {
       .cache_size = cache_size,
       .default_ttl = 86400 * 300,
-      .hashpower = 24,
+      .hashpower = get_hashpower_for_cache_size(cache_size, mean_obj_size),
       .consider_obj_metadata = consider_obj_metadata,
   };
   cache_t *cache;
 
-  /* the trace provided is small */
-  if (trace_path != NULL && strstr(trace_path, "data/trace.") != NULL) cc_params.hashpower -= 8;
-
   if (strcasecmp(eviction_algo, "lru") == 0) {
     cache = LRU_init(cc_params, eviction_params);
   } else if (strcasecmp(eviction_algo, "fifo") == 0) {
@@ -52,7 +74,6 @@ static inline cache_t *create_cache(const char *trace_path, const char *eviction
   } else if (strcasecmp(eviction_algo, "slruv0") == 0) {
     cache = SLRUv0_init(cc_params, eviction_params);
   } else if (strcasecmp(eviction_algo, "hyperbolic") == 0) {
-    cc_params.hashpower = MAX(cc_params.hashpower - 8, 16);
     cache = Hyperbolic_init(cc_params, eviction_params);
   } else if (strcasecmp(eviction_algo, "lecar") == 0) {
     cache = LeCaR_init(cc_params, eviction_params);
@@ -96,7 +117,6 @@ static inline cache_t *create_cache(const char *trace_path, const char *eviction
     if (strcasestr(trace_path, "oracleGeneral") == NULL) {
       WARN("belady is only supported for oracleGeneral trace\n");
     }
-    cc_params.hashpower = MAX(cc_params.hashpower - 8, 16);
     cache = BeladySize_init(cc_params, eviction_params);
   } else if (strcasecmp(eviction_algo, "fifo-reinsertion") == 0 || strcasecmp(eviction_algo, "clock") == 0 ||
              strcasecmp(eviction_algo, "second-chance") == 0) {
@@ -48,6 +48,9 @@ enum argp_option_short {
   OPTION_PREFETCH_ALGO = 'p',
   OPTION_PREFETCH_PARAMS = 0x109,
   OPTION_PRINT_HEAD_REQ = 0x10a,
+  OPTION_TILED = 0x10b,
+  OPTION_METRICS_OUTPUT = 0x10c,
+  OPTION_CHARGE_METADATA = 0x10d,
 };
 
 /*
@@ -73,7 +76,7 @@ static struct argp_option options[] = {
     {"admission-params", OPTION_ADMISSION_PARAMS, "\"prob=0.8\"", 0,
      "params for admission algorithm", 4},
     {"prefetch", OPTION_PREFETCH_ALGO, "Mithril", 0,
-     "Prefetching algorithm: Mithril/OBL/PG/AMP", 4},
+     "Prefetching algorithm: Mithril/OBL/PG/Stride", 4},
     {"prefetch-params", OPTION_PREFETCH_PARAMS, "\"block-size=65536\"", 0,
      "optional params for each prefetching algorithm, e.g., block-size=65536",
      4},
@@ -84,15 +87,30 @@ static struct argp_option options[] = {
     {"output", OPTION_OUTPUT_PATH, "output", 0, "Output path", 6},
     {"num-thread", OPTION_NUM_THREAD, "16", 0,
      "Number of threads if running when using default cache sizes", 6},
+    {"tiled", OPTION_TILED, "false", 0,
+     "Simulate groups of caches in lock step on batches of requests, faster "
+     "for many small caches",
+     6},
 
     {0, 0, 0, 0, "Other less common options:"},
     {"report-interval", OPTION_REPORT_INTERVAL, "3600", 0,
-     "how often to report stat when running one cache", 10},
+     "how often to report stat when running one cache, also the window of "
+     "--metrics-output",
+     10},
+    {"metrics-output", OPTION_METRICS_OUTPUT, "metrics.csv", 0,
+     "Record the miss ratio, occupancy and evictions of every cache in each "
+     "report interval to this file, csv if it ends with .csv, binary "
+     "otherwise",
+     10},
     {"warmup-sec", OPTION_WARMUP_SEC, "0", 0, "warm up time in seconds", 10},
     {"use-ttl", OPTION_USE_TTL, "false", 0, "specify to use ttl from the trace",
      10},
     {"consider-obj-metadata", OPTION_CONSIDER_OBJ_METADATA, "false", 0,
      "Whether consider per object metadata size in the simulated cache", 10},
+    {"charge-metadata", OPTION_CHARGE_METADATA, "false", 0,
+     "Whether the memory used by the data structures of the cache (hash "
+     "table, objects, ghosts, sketches) counts against the cache size",
+     10},
     {"verbose", OPTION_VERBOSE, "1", 0, "Produce verbose output", 10},
     {"print-head-req", OPTION_PRINT_HEAD_REQ, "false", 0,
      "Print the first few requests", 10},
@@ -164,12 +182,22 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case OPTION_CONSIDER_OBJ_METADATA:
       arguments->consider_obj_metadata = is_true(arg) ? true : false;
       break;
+    case OPTION_CHARGE_METADATA:
+      arguments->charge_metadata = is_true(arg) ? true : false;
+      break;
     case OPTION_WARMUP_SEC:
       arguments->warmup_sec = atoi(arg);
       break;
     case OPTION_PRINT_HEAD_REQ:
       arguments->print_head_req = is_true(arg) ? true : false;
       break;
+    case OPTION_TILED:
+      arguments->tiled = is_true(arg) ? true : false;
+      break;
+    case OPTION_METRICS_OUTPUT:
+      strncpy(arguments->metrics_ofilepath, arg, OFILEPATH_LEN - 1);
+      arguments->metrics_ofilepath[OFILEPATH_LEN - 1] = 0;
+      break;
     case ARGP_KEY_ARG:
       if (state->arg_num >= N_ARGS) {
         printf("found too many arguments, current %s\n", arg);
@@ -203,7 +231,9 @@ static char doc[] =
     "example: ./cachesim /trace/path csv LRU 100MB\n\n"
     "trace can be zstd compressed\n"
     "cache_size is in byte, but also support KB/MB/GB\n"
-    "supported trace_type: txt/csv/twr/vscsi/oracleGeneralBin\n"
+    "supported trace_type: txt/csv/twr/vscsi/oracleGeneralBin/synthetic\n"
+    "synthetic trace uses the workload spec as trace_path, "
+    "e.g., dist=zipf,alpha=0.8,n-obj=1e6,n-req=1e8\n"
     "supported eviction_algo: LRU/LFU/FIFO/ARC/LeCaR/Cacheus\n"
     "print-head-req: Print the first few requests when simulating start\n";
 
@@ -227,6 +257,7 @@ static void init_arg(struct arguments *args) {
   args->use_ttl = false;
   args->ignore_obj_size = false;
   args->consider_obj_metadata = false;
+  args->charge_metadata = false;
   args->report_interval = 3600 * 24;
   args->n_thread = n_cores();
   args->warmup_sec = -1;
@@ -234,6 +265,7 @@ static void init_arg(struct arguments *args) {
   args->n_req = -1;
   args->sample_ratio = 1.0;
   args->print_head_req = true;
+  args->tiled = false;
 
   for (int i = 0; i < N_MAX_ALGO; i++) {
     args->eviction_algo[i] = NULL;
@@ -330,6 +362,11 @@ void parse_cmd(int argc, char *argv[], struct arguments *args) {
     args->consider_obj_metadata = false;
   }
 
+  if (args->charge_metadata && args->consider_obj_metadata) {
+    WARN("the object metadata is charged, ignore --consider-obj-metadata\n");
+    args->consider_obj_metadata = false;
+  }
+
   /** convert the cache sizes from string to int,
    * if the user specifies 0 or auto, we use 12 cache sizes as fraction of
    * the working set size
@@ -337,12 +374,16 @@ void parse_cmd(int argc, char *argv[], struct arguments *args) {
    * the working set size **/
   conv_cache_sizes(args->args[3], args);
 
+  /* the hashtable of each cache is sized using the mean object size */
+  int64_t mean_obj_size = get_mean_obj_size(args->reader);
+
   for (int i = 0; i < args->n_eviction_algo; i++) {
     for (int j = 0; j < args->n_cache_size; j++) {
       int idx = i * args->n_cache_size + j;
       args->caches[idx] = create_cache(
           args->trace_path, args->eviction_algo[i], args->cache_sizes[j],
-          args->eviction_params, args->consider_obj_metadata);
+          args->eviction_params, args->consider_obj_metadata, mean_obj_size);
+      args->caches[idx]->charge_metadata = args->charge_metadata;
 
       if (args->admission_algo != NULL) {
         args->caches[idx]->admissioner =
@@ -548,6 +589,17 @@ void print_parsed_args(struct arguments *args) {
     n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
                   ", consider object metadata");
 
+  if (args->charge_metadata)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", charge metadata");
+
+  if (args->tiled)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1, ", tiled");
+
+  if (args->metrics_ofilepath[0] != '\0')
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", metrics output: %s", args->metrics_ofilepath);
+
   snprintf(output_str + n, OUTPUT_STR_LEN - n - 1, "\n");
 
   INFO("%s", output_str);
@@ -6,6 +6,7 @@
 #include "../../include/libCacheSim/cache.h"
 #include "../../include/libCacheSim/enum.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
+#include "../../include/libCacheSim/metricsRecorder.h"
 #include "../../include/libCacheSim/reader.h"
 
 #ifdef __cplusplus
@@ -31,6 +32,8 @@ struct arguments {
   int warmup_sec;
 
   char ofilepath[OFILEPATH_LEN];
+  /* empty if the metrics over time are not recorded */
+  char metrics_ofilepath[OFILEPATH_LEN];
   char *trace_type_str;
   trace_type_e trace_type;
   char *trace_type_params;
@@ -45,8 +48,10 @@ struct arguments {
   int report_interval;
   bool ignore_obj_size;
   bool consider_obj_metadata;
+  bool charge_metadata;
   bool use_ttl;
   bool print_head_req;
+  bool tiled;
 
   /* arguments generated */
   reader_t *reader;
@@ -59,7 +64,7 @@ void free_arg(struct arguments *args);
 
 void simulate(reader_t *reader, cache_t *cache, int report_interval,
               int warmup_sec, char *ofilepath, bool ignore_obj_size,
-              bool print_head_req);
+              bool print_head_req, metrics_recorder_t *metrics_recorder);
 
 void print_parsed_args(struct arguments *args);
 
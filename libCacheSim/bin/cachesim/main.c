@@ -19,21 +19,34 @@ int main(int argc, char **argv) {
   if (args.n_cache_size == 0) {
     ERROR("no cache size found\n");
   }
+  metrics_recorder_t *metrics_recorder = NULL;
+  if (args.metrics_ofilepath[0] != '\0') {
+    metrics_recorder = create_metrics_recorder(
+        args.metrics_ofilepath, metrics_format_from_path(args.metrics_ofilepath), args.report_interval, 0);
+  }
+
   if (args.n_cache_size * args.n_eviction_algo == 1) {
     simulate(args.reader, args.caches[0], args.report_interval, args.warmup_sec, args.ofilepath, args.ignore_obj_size,
-             args.print_head_req);
+             args.print_head_req, metrics_recorder);
 
+    if (metrics_recorder != NULL) close_metrics_recorder(metrics_recorder);
     free_arg(&args);
     return 0;
   }
-
   // cache_stat_t *result = simulate_at_multi_sizes(
   //     args.reader, args.cache, args.n_cache_size, args.cache_sizes, NULL, 0,
-  //     args.warmup_sec, args.n_thread);
+  //     args.warmup_sec, args.n_thread, metrics_recorder);
 
-  cache_stat_t *result = simulate_with_multi_caches(
-      args.reader, args.caches, args.n_cache_size * args.n_eviction_algo, NULL,
-      0, args.warmup_sec, args.n_thread, true);
+  cache_stat_t *result;
+  if (args.tiled) {
+    result = simulate_with_multi_caches_tiled(
+        args.reader, args.caches, args.n_cache_size * args.n_eviction_algo,
+        NULL, 0, args.warmup_sec, args.n_thread, true, metrics_recorder);
+  } else {
+    result = simulate_with_multi_caches(
+        args.reader, args.caches, args.n_cache_size * args.n_eviction_algo,
+        NULL, 0, args.warmup_sec, args.n_thread, true, metrics_recorder);
+  }
 
   char output_str[1024];
   char output_filename[128];
@@ -70,9 +83,22 @@ int main(int argc, char **argv) {
              (double)result[i].n_miss_byte / (double)result[i].n_req_byte);
     printf("%s", output_str);
     fprintf(output_file, "%s", output_str);
+    printf("%32s metadata %.2lf MiB, peak %.2lf MiB\n", result[i].cache_name,
+           (double)result[i].metadata_byte / MiB,
+           (double)result[i].max_metadata_byte / MiB);
+#ifdef SUPPORT_TTL
+    printf("%32s bytes freed by expiration %lld (%lld obj), eviction %lld "
+           "(%lld obj)\n",
+           result[i].cache_name, (long long)result[i].expired_bytes,
+           (long long)result[i].expired_obj_cnt,
+           (long long)result[i].evicted_bytes,
+           (long long)result[i].n_eviction);
+#endif
   }
   fclose(output_file);
 
+  if (metrics_recorder != NULL) close_metrics_recorder(metrics_recorder);
+
   if (args.n_cache_size * args.n_eviction_algo > 0)
     my_free(sizeof(cache_stat_t) * args.n_cache_size * args.n_eviction_algo, result);
 
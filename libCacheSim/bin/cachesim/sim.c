@@ -1,4 +1,5 @@
 #include "../../include/libCacheSim/cache.h"
+#include "../../include/libCacheSim/metricsRecorder.h"
 #include "../../include/libCacheSim/reader.h"
 #include "../../utils/include/mymath.h"
 #include "../../utils/include/mystr.h"
@@ -17,7 +18,7 @@ void print_head_requests(request_t *req, uint64_t req_cnt) {
 }
 
 void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_sec, char *ofilepath,
-              bool ignore_obj_size, bool print_head_req) {
+              bool ignore_obj_size, bool print_head_req, metrics_recorder_t *metrics_recorder) {
   /* random seed */
   srand(time(NULL));
   set_rand_seed(rand());
@@ -32,6 +33,7 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
   uint64_t last_report_ts = warmup_sec;
 
   double start_time = -1;
+  metrics_tracker_t *tracker = NULL;
   while (req->valid) {
     if (print_head_req) {
       print_head_requests(req, req_cnt);
@@ -45,15 +47,22 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
     } else {
       if (start_time < 0) {
         start_time = gettime();
+        if (metrics_recorder != NULL) {
+          tracker = create_metrics_tracker(metrics_recorder, 0, cache);
+        }
       }
     }
 
     req_cnt++;
     req_byte += req->obj_size;
-    if (cache->get(cache, req) == false) {
+    bool hit = cache->get(cache, req);
+    if (hit == false) {
       miss_cnt++;
       miss_byte += req->obj_size;
     }
+    if (tracker != NULL) {
+      metrics_tracker_record(tracker, cache, req, hit);
+    }
     if (req->clock_time - last_report_ts >= report_interval &&
         req->clock_time != 0) {
       INFO(
@@ -73,6 +82,9 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
   }
 
   double runtime = gettime() - start_time;
+  if (tracker != NULL) {
+    free_metrics_tracker(tracker, cache, (int64_t)req->clock_time);
+  }
 
   char output_str[1024];
   char size_str[8];
@@ -98,6 +110,8 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
 
 #pragma GCC diagnostic pop
   printf("%s", output_str);
+  printf("%s %s metadata %.2lf MiB\n", reader->trace_path, cache->cache_name,
+         (double)cache->get_metadata_bytes(cache) / MiB);
 
   FILE *output_file = fopen(ofilepath, "a");
   if (output_file == NULL) {
@@ -4,6 +4,7 @@
 #include <assert.h>
 #include <string.h>
 
+#include "../include/libCacheSim/macro.h"
 #include "../include/libCacheSim/reader.h"
 #include "../utils/include/mystr.h"
 #include "cli_reader_utils.h"
@@ -61,6 +62,9 @@ trace_type_e trace_type_str_to_enum(const char *trace_type_str,
     return ORACLE_SYS_TWRNS_TRACE;
   } else if (strcasecmp(trace_type_str, "valpinTrace") == 0) {
     return VALPIN_TRACE;
+  } else if (strcasecmp(trace_type_str, "synthetic") == 0) {
+    /* the trace path is the workload spec, e.g., dist=zipf,alpha=0.8 */
+    return SYNTHETIC_TRACE;
   } else {
     ERROR("unsupported trace type: %s\n", trace_type_str);
   }
@@ -283,6 +287,46 @@ void cal_working_set_size(reader_t *reader, int64_t *wss_obj,
   reset_reader(reader);
 }
 
+/**
+ * @brief get the mean object size of the trace, this is used to size the
+ * hashtable of the caches, we use the object stat in the trace header if
+ * available (e.g., LCS trace), otherwise we sample the first requests
+ *
+ * @param reader
+ * @return int64_t
+ */
+#define N_SAMPLE_REQ 100000
+int64_t get_mean_obj_size(reader_t *reader) {
+  if (reader->ignore_obj_size) return 1;
+
+  if (reader->n_total_obj > 0 && reader->n_total_obj_byte > 0) {
+    return MAX(reader->n_total_obj_byte / reader->n_total_obj, 1);
+  }
+
+  request_t *req = new_request();
+  GHashTable *obj_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+  int64_t n_obj = 0, n_obj_byte = 0;
+  for (int i = 0; i < N_SAMPLE_REQ; i++) {
+    if (read_one_req(reader, req) != 0) break;
+
+    if (g_hash_table_contains(obj_table, (gconstpointer)req->obj_id)) {
+      continue;
+    }
+    g_hash_table_add(obj_table, (gpointer)req->obj_id);
+    n_obj += 1;
+    n_obj_byte += req->obj_size;
+  }
+  g_hash_table_destroy(obj_table);
+  free_request(req);
+  reset_reader(reader);
+
+  int64_t mean_obj_size = n_obj > 0 ? MAX(n_obj_byte / n_obj, 1) : 1;
+  DEBUG("mean object size %ld from %ld sampled objects\n",
+        (long)mean_obj_size, (long)n_obj);
+  return mean_obj_size;
+}
+#undef N_SAMPLE_REQ
+
 /**
  * @brief Create a reader from the parameters
  *
@@ -21,6 +21,8 @@ bool should_disable_obj_metadata(reader_t *reader);
 void cal_working_set_size(reader_t *reader, int64_t *wss_obj,
                           int64_t *wss_byte);
 
+int64_t get_mean_obj_size(reader_t *reader);
+
 reader_t *create_reader(const char *trace_type_str, const char *trace_path,
                         const char *trace_type_params, const int64_t n_req,
                         const bool ignore_obj_size, const int sample_ratio);
@@ -30,6 +30,8 @@ enum argp_option_short {
   OPTION_ACCESS_PATTERN_SAMPLE_RATIO = 0x102,
   OPTION_TRACK_N_HIT = 0x103,
   OPTION_TRACK_N_POPULAR = 0x104,
+  OPTION_NUM_THREAD = 0x105,
+  OPTION_SKETCH = 0x106,
 
   OPTION_ENABLE_ALL = 0x200,
   OPTION_ENABLE_COMMON = 0x201,
@@ -109,6 +111,16 @@ static struct argp_option options[] = {
      "track one-hit-wonder, two-hit-wonder, etc.", 4},
     {"track-n-popular", OPTION_TRACK_N_POPULAR, "8", 0,
      "track how many requests the n most popular objects get", 4},
+    {"num-thread", OPTION_NUM_THREAD, "1", 0,
+     "the number of threads updating the object map, more than one runs the "
+     "analyses in a pipeline, each analysis uses one more thread",
+     4},
+    {"sketch", OPTION_SKETCH, "popularity,size,reuse,objStat",
+     OPTION_ARG_OPTIONAL,
+     "use fixed-memory sketches instead of per-object state for the listed "
+     "analyses (default all), the object map is not built if no enabled "
+     "analysis needs it, e.g., --common --sketch on a very large trace",
+     4},
 
     {NULL, 0, NULL, 0, "common parameters:", 0},
 
@@ -117,6 +129,35 @@ static struct argp_option options[] = {
      "Produce verbose output", 8},
     {0}};
 
+static void parse_sketch_option(const char *arg,
+                                traceAnalyzer::analysis_option_t *option) {
+  if (arg == NULL || strcasecmp(arg, "all") == 0) {
+    option->popularity_sketch = true;
+    option->size_sketch = true;
+    option->reuse_sketch = true;
+    option->obj_stat_sketch = true;
+    return;
+  }
+
+  char *sketch_str = strdup(arg);
+  char *s = sketch_str;
+  while (s != NULL && s[0] != '\0') {
+    char *name = strsep(&s, ",");
+    if (strcasecmp(name, "popularity") == 0) {
+      option->popularity_sketch = true;
+    } else if (strcasecmp(name, "size") == 0) {
+      option->size_sketch = true;
+    } else if (strcasecmp(name, "reuse") == 0) {
+      option->reuse_sketch = true;
+    } else if (strcasecmp(name, "objStat") == 0) {
+      option->obj_stat_sketch = true;
+    } else {
+      ERROR("unknown sketch analysis %s\n", name);
+    }
+  }
+  free(sketch_str);
+}
+
 /*
    PARSER. Field 2 in ARGP.
    Order of parameters: KEY, ARG, STATE.
@@ -150,6 +191,12 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case OPTION_TRACK_N_HIT:
       arguments->analysis_param.track_n_hit = atoi(arg);
       break;
+    case OPTION_NUM_THREAD:
+      arguments->analysis_param.n_thread = atoi(arg);
+      break;
+    case OPTION_SKETCH:
+      parse_sketch_option(arg, &arguments->analysis_option);
+      break;
     case OPTION_ENABLE_ALL:
       arguments->analysis_option.req_rate = true;
       arguments->analysis_option.access_pattern = true;
@@ -36,7 +36,10 @@ enum argp_option_short {
 
   // trace filter
   OPTION_FILTER_TYPE = 0x301,
-  OPTION_FILTER_SIZE = 0x302
+  OPTION_FILTER_SIZE = 0x302,
+  OPTION_COMPRESS = 0x303,
+  OPTION_LRU_STACK_DIST = 0x304,
+  OPTION_NUM_THREAD = 0x305
 };
 
 /*
@@ -74,10 +77,20 @@ static struct argp_option options[] = {
 
     {0, 0, 0, 0, "traceFilter options:"},
     {"filter-type", OPTION_FILTER_TYPE, "FIFO", 0,
-     "The filter type, e.g., FIFO and LRU", 8},
+     "The filter types, e.g., FIFO or \"LRU,FIFO\"", 8},
     {"filter-size", OPTION_FILTER_SIZE, "0.1", 0,
-     "The size of the filter, can be absolute size or relative to working set",
+     "The sizes of the filter, e.g., 0.1 or \"0.01,0.1,1GiB\", can be absolute "
+     "size or relative to working set, each type and size is one filter",
      8},
+    {"compress", OPTION_COMPRESS, "false", 0,
+     "compress the filtered traces with zstd", 8},
+    {"lru-stack-dist", OPTION_LRU_STACK_DIST, "false", 0,
+     "derive the LRU filters of all sizes from one pass of stack distances, "
+     "exact only if object sizes do not change and all objects fit in the "
+     "filter",
+     8},
+    {"num-thread", OPTION_NUM_THREAD, "-1", 0,
+     "Number of threads to run the filters, -1 means all cores", 8},
 
     {0}};
 
@@ -127,7 +140,19 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
       arguments->cache_name = arg;
       break;
     case OPTION_FILTER_SIZE:
-      arguments->cache_size = atof(arg);
+      arguments->cache_size = arg;
+      break;
+    case OPTION_COMPRESS:
+      arguments->compress_output = is_true(arg) ? true : false;
+      break;
+    case OPTION_LRU_STACK_DIST:
+      arguments->lru_stack_dist = is_true(arg) ? true : false;
+      break;
+    case OPTION_NUM_THREAD:
+      arguments->n_thread = atoi(arg);
+      if (arguments->n_thread <= 0) {
+        arguments->n_thread = n_cores();
+      }
       break;
     case ARGP_KEY_ARG:
       if (state->arg_num >= N_ARGS) {
@@ -169,7 +194,9 @@ static char doc[] =
     "/path/new_trace.oracleGeneral -t "
     "\"obj-id-col=5,time-col=2,obj-size-col=4\"\n\n"
     "example usage: ./traceFilter /trace/path lcs -o /path/new_trace.lcs "
-    "--filter fifo --filter-size 0.1\n\n";
+    "--filter-type fifo --filter-size 0.1\n\n"
+    "example usage: ./traceFilter /trace/path lcs -o /path/l2 "
+    "--filter-type lru,fifo --filter-size 0.01,0.02,0.05 --compress true\n\n";
 
 /**
  * @brief initialize the arguments
@@ -189,7 +216,10 @@ static void init_arg(struct arguments *args) {
   args->output_txt = false;
   args->remove_size_change = false;
   args->cache_name = NULL;
-  args->cache_size = 0;
+  args->cache_size = NULL;
+  args->compress_output = false;
+  args->lru_stack_dist = false;
+  args->n_thread = n_cores();
   args->delimiter = ',';
   args->print_obj_id_only = false;
   args->print_obj_id_32bit = false;
@@ -36,9 +36,14 @@ struct arguments {
   bool print_obj_id_32bit;
 
   /* trace filter */
+  /* comma separated lists, each (algorithm, size) pair is one filter */
   char *cache_name;
-  double cache_size;
-  cache_t *cache;
+  char *cache_size;
+  /* compress the filtered traces with zstd */
+  bool compress_output;
+  /* derive all LRU filters from one pass of stack distances */
+  bool lru_stack_dist;
+  int n_thread;
 
   /* arguments generated */
   reader_t *reader;
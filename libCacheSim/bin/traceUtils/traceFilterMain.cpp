@@ -1,15 +1,33 @@
 /**
- * Filter the trace to generate a second-layer cache trace.
- * only support single algorithm (without params), e.g., FIFO and LRU, at this
- * moment. The output format is lcs format (oracleGeneral).
+ * Filter the trace to generate second-layer cache traces.
+ * each filter is a cache (algorithm without params, e.g., FIFO and LRU) of one
+ * size, all filters share one pass over the trace, and the misses of each
+ * filter are written to one trace in lcs format (oracleGeneral), optionally
+ * compressed with zstd.
+ *
+ * with --lru-stack-dist, the LRU filters of all sizes are derived from the
+ * byte stack distance of each request, which is computed once, an LRU cache of
+ * size C hits iff the total size of the distinct objects accessed since the
+ * last access of the object (including itself) is at most C, this matches the
+ * LRU cache only when object sizes do not change and no object is larger than
+ * the cache (e.g., with --ignore-obj-size), otherwise the miss count differs
+ * slightly, so it is off by default
  *
  */
 
 #include <libgen.h>
+#include <strings.h>
 
-#include <fstream>
-#include <iostream>
+#include <algorithm>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef SUPPORT_ZSTD_TRACE
+#include <zstd.h>
+#endif
 
 #include "../../include/libCacheSim/cache.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
@@ -28,35 +46,329 @@ struct output_format {
   int64_t next_access_vtime;
 } __attribute__((packed));
 
-void filter(reader_t *reader, cache_t *cache, std::string ofilepath) {
-  request_t *req = new_request();
+/* the number of requests decoded at a time, the filters process one batch
+ * while the next batch is decoded */
+static const int64_t BATCH_SIZE = 256 * 1024;
+static const size_t WRITE_BUFFER_SIZE = 4 * MiB;
+
+/* the fields of a request used by the filters */
+struct filter_req {
+  int64_t clock_time;
+  obj_id_t obj_id;
+  int64_t obj_size;
+  /* -1 if the object is accessed for the first time */
+  int64_t stack_dist;
+};
+
+/* write the records through a large buffer, and compress the buffer with zstd
+ * if needed */
+class TraceWriter {
+ public:
+  TraceWriter(const std::string &path, bool compress)
+      : path_(path), compress_(compress) {
+    ofile_ = fopen(path.c_str(), "wb");
+    if (ofile_ == nullptr) {
+      ERROR("cannot open %s: %s\n", path.c_str(), strerror(errno));
+    }
+    buf_.reserve(WRITE_BUFFER_SIZE);
+#ifdef SUPPORT_ZSTD_TRACE
+    if (compress_) {
+      cctx_ = ZSTD_createCCtx();
+      ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, 3);
+      zbuf_.resize(ZSTD_CStreamOutSize());
+    }
+#else
+    if (compress_) {
+      ERROR("zstd is not supported, compile with OPT_SUPPORT_ZSTD_TRACE\n");
+    }
+#endif
+  }
+
+  ~TraceWriter() { close(); }
+
+  void write(const struct output_format &rec) {
+    const char *p = reinterpret_cast<const char *>(&rec);
+    buf_.insert(buf_.end(), p, p + sizeof(rec));
+    if (buf_.size() + sizeof(rec) > WRITE_BUFFER_SIZE) flush(false);
+  }
+
+  void close() {
+    if (ofile_ == nullptr) return;
+    flush(true);
+    fclose(ofile_);
+    ofile_ = nullptr;
+#ifdef SUPPORT_ZSTD_TRACE
+    if (cctx_ != nullptr) ZSTD_freeCCtx(cctx_);
+    cctx_ = nullptr;
+#endif
+  }
+
+  const std::string &path() const { return path_; }
+
+ private:
+  void flush(bool end) {
+#ifdef SUPPORT_ZSTD_TRACE
+    if (compress_) {
+      ZSTD_inBuffer input = {buf_.data(), buf_.size(), 0};
+      ZSTD_EndDirective mode = end ? ZSTD_e_end : ZSTD_e_continue;
+      bool finished = false;
+      while (!finished) {
+        ZSTD_outBuffer output = {zbuf_.data(), zbuf_.size(), 0};
+        size_t remaining = ZSTD_compressStream2(cctx_, &output, &input, mode);
+        if (ZSTD_isError(remaining)) {
+          ERROR("zstd compression error: %s\n", ZSTD_getErrorName(remaining));
+        }
+        write_raw(zbuf_.data(), output.pos);
+        finished = end ? remaining == 0 : input.pos == input.size;
+      }
+      buf_.clear();
+      return;
+    }
+#endif
+    (void)end;
+    write_raw(buf_.data(), buf_.size());
+    buf_.clear();
+  }
+
+  void write_raw(const char *data, size_t size) {
+    if (size > 0 && fwrite(data, 1, size, ofile_) != size) {
+      ERROR("failed to write %s: %s\n", path_.c_str(), strerror(errno));
+    }
+  }
+
+  std::string path_;
+  bool compress_;
+  FILE *ofile_ = nullptr;
+  std::vector<char> buf_;
+#ifdef SUPPORT_ZSTD_TRACE
+  ZSTD_CCtx *cctx_ = nullptr;
+  std::vector<char> zbuf_;
+#endif
+};
+
+/* the byte stack distance of each request, the size of an object is kept at
+ * the position of its last access in a Fenwick tree, the positions are
+ * compacted when they run out, so the memory is linear in the number of
+ * objects */
+class ByteStackDist {
+ public:
+  int64_t access(obj_id_t obj_id, int64_t obj_size) {
+    if (now_ >= (int64_t)tree_.size()) compact();
+
+    int64_t dist = -1;
+    auto it = last_access_.find(obj_id);
+    if (it != last_access_.end()) {
+      int64_t pos = it->second.first;
+      dist = it->second.second + prefix_sum(now_ - 1) - prefix_sum(pos);
+      add(pos, -it->second.second);
+    }
+
+    add(now_, obj_size);
+    last_access_[obj_id] = std::make_pair(now_, obj_size);
+    now_ += 1;
+    return dist;
+  }
+
+ private:
+  void add(int64_t pos, int64_t v) {
+    for (; pos < (int64_t)tree_.size(); pos += pos & (-pos)) tree_[pos] += v;
+  }
+
+  int64_t prefix_sum(int64_t pos) const {
+    int64_t s = 0;
+    for (; pos > 0; pos -= pos & (-pos)) s += tree_[pos];
+    return s;
+  }
+
+  /* renumber the objects 1..n in the order of the last access */
+  void compact() {
+    std::vector<std::pair<int64_t, obj_id_t>> order;
+    order.reserve(last_access_.size());
+    for (auto &kv : last_access_) order.emplace_back(kv.second.first, kv.first);
+    std::sort(order.begin(), order.end());
+
+    int64_t n_slot = std::max<int64_t>(1024, 2 * (int64_t)order.size() + 2);
+    tree_.assign(n_slot, 0);
+    for (size_t i = 0; i < order.size(); i++) {
+      auto &entry = last_access_[order[i].second];
+      entry.first = (int64_t)i + 1;
+      tree_[i + 1] = entry.second;
+    }
+    /* build the tree in linear time */
+    for (int64_t i = 1; i < n_slot; i++) {
+      int64_t parent = i + (i & (-i));
+      if (parent < n_slot) tree_[parent] += tree_[i];
+    }
+    now_ = (int64_t)order.size() + 1;
+  }
+
+  /* obj_id -> (position of the last access, size) */
+  std::unordered_map<obj_id_t, std::pair<int64_t, int64_t>> last_access_;
+  std::vector<int64_t> tree_;
+  int64_t now_ = 1;
+};
 
-  std::ofstream output_file(ofilepath, std::ios::binary);
+struct Filter {
+  std::string algo;
+  uint64_t cache_size;
+  /* NULL if the filter is derived from the stack distance */
+  cache_t *cache;
+  TraceWriter *writer;
+  int64_t n_req;
+  int64_t n_written_req;
+};
+
+static void run_filter(Filter *filter, const std::vector<filter_req> &batch,
+                       request_t *req) {
   struct output_format output_req;
   output_req.next_access_vtime = -2;
 
+  for (const filter_req &r : batch) {
+    bool hit;
+    if (filter->cache == nullptr) {
+      hit = r.stack_dist >= 0 && r.stack_dist <= (int64_t)filter->cache_size;
+    } else {
+      req->clock_time = r.clock_time;
+      req->obj_id = r.obj_id;
+      req->obj_size = r.obj_size;
+      hit = filter->cache->get(filter->cache, req);
+    }
+
+    if (!hit) {
+      output_req.clock_time = (uint32_t)r.clock_time;
+      output_req.obj_id = r.obj_id;
+      output_req.obj_size = (uint32_t)r.obj_size;
+      filter->writer->write(output_req);
+      filter->n_written_req++;
+    }
+  }
+  filter->n_req += (int64_t)batch.size();
+}
+
+/* decode the trace once, worker i runs filters i, i + n_thread, ... on a batch
+ * while the next batch is decoded */
+void filter(reader_t *reader, std::vector<Filter> &filters, int n_thread,
+            bool need_stack_dist) {
+  request_t *req = new_request();
+  ByteStackDist stack_dist;
+  std::vector<filter_req> batches[2];
+  int n_worker = std::max(1, std::min(n_thread, (int)filters.size()));
+  std::vector<request_t *> worker_reqs;
+  for (int i = 0; i < n_worker; i++) worker_reqs.push_back(new_request());
+
   read_one_req(reader, req);
-  uint64_t start_ts = (uint64_t)req->clock_time;
-
-  int64_t n_req = 0, n_written_req = 0;
-  while (req->valid) {
-    n_req++;
-    req->clock_time -= start_ts;
-    if (cache->get(cache, req) == false) {
-      output_req.clock_time = req->clock_time;
-      output_req.obj_id = req->obj_id;
-      output_req.obj_size = req->obj_size;
-      output_file.write((char *)&output_req, sizeof(struct output_format));
-      n_written_req++;
+  int64_t start_ts = req->clock_time;
+
+  auto decode = [&](std::vector<filter_req> &batch) {
+    batch.clear();
+    while (req->valid && (int64_t)batch.size() < BATCH_SIZE) {
+      filter_req r;
+      r.clock_time = req->clock_time - start_ts;
+      r.obj_id = req->obj_id;
+      r.obj_size = req->obj_size;
+      r.stack_dist =
+          need_stack_dist ? stack_dist.access(req->obj_id, req->obj_size) : -1;
+      batch.push_back(r);
+      read_one_req(reader, req);
     }
+  };
+
+  int curr = 0;
+  decode(batches[curr]);
+  while (!batches[curr].empty()) {
+    std::vector<std::thread> workers;
+    for (int w = 0; w < n_worker; w++) {
+      workers.emplace_back([&, w]() {
+        for (size_t i = w; i < filters.size(); i += n_worker) {
+          run_filter(&filters[i], batches[curr], worker_reqs[w]);
+        }
+      });
+    }
+    decode(batches[1 - curr]);
+    for (auto &t : workers) t.join();
+    curr = 1 - curr;
+  }
 
-    read_one_req(reader, req);
+  for (auto &f : filters) {
+    f.writer->close();
+    INFO("%s %lu: write %ld/%ld %.4lf requests to file %s\n", f.algo.c_str(),
+         (unsigned long)f.cache_size, (long)f.n_written_req, (long)f.n_req,
+         f.n_req == 0 ? 0.0 : (double)f.n_written_req / f.n_req,
+         f.writer->path().c_str());
   }
 
-  INFO("write %ld/%ld %.4lf requests to file %s\n", (long) n_written_req, (long) n_req,
-       (double)n_written_req / n_req, ofilepath.c_str());
+  for (auto r : worker_reqs) free_request(r);
   free_request(req);
-  output_file.close();
+}
+
+/* the size is an absolute size if it has a unit suffix (e.g., 1.5GiB or 64KB),
+ * otherwise it is relative to the working set size if it is a fraction */
+static uint64_t conv_size(const std::string &size_str, reader_t *reader,
+                          bool ignore_obj_size, int64_t *wss) {
+  char *end = nullptr;
+  double v = strtod(size_str.c_str(), &end);
+  if (end == size_str.c_str() || v < 0) {
+    ERROR("invalid filter size %s\n", size_str.c_str());
+  }
+
+  if (*end != '\0') {
+    switch (tolower(*end)) {
+      case 'k':
+        return (uint64_t)(v * KiB);
+      case 'm':
+        return (uint64_t)(v * MiB);
+      case 'g':
+        return (uint64_t)(v * GiB);
+      case 't':
+        return (uint64_t)(v * TiB);
+      default:
+        ERROR("unknown unit in filter size %s\n", size_str.c_str());
+    }
+  }
+
+  if (size_str.find('.') != std::string::npos || v < 1) {
+    if (*wss == 0) {
+      int64_t wss_obj = 0, wss_byte = 0;
+      cal_working_set_size(reader, &wss_obj, &wss_byte);
+      *wss = ignore_obj_size ? wss_obj : wss_byte;
+    }
+    return (uint64_t)((double)*wss * v);
+  }
+
+  return strtoull(size_str.c_str(), NULL, 10);
+}
+
+static std::vector<std::string> split(const char *str) {
+  std::vector<std::string> tokens;
+  std::string s(str);
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t end = s.find(',', start);
+    if (end == std::string::npos) end = s.size();
+    if (end > start) tokens.push_back(s.substr(start, end - start));
+    start = end + 1;
+  }
+  return tokens;
+}
+
+static cache_t *create_filter_cache(const std::string &algo,
+                                    const common_cache_params_t &cc_params) {
+  const char *name = algo.c_str();
+  if (strcasecmp(name, "LRU") == 0) {
+    return LRU_init(cc_params, NULL);
+  } else if (strcasecmp(name, "FIFO") == 0) {
+    return FIFO_init(cc_params, NULL);
+  } else if (strcasecmp(name, "Clock") == 0) {
+    return Clock_init(cc_params, NULL);
+  } else if (strcasecmp(name, "Sieve") == 0) {
+    return Sieve_init(cc_params, NULL);
+  } else if (strcasecmp(name, "S3FIFO") == 0) {
+    return S3FIFO_init(cc_params, NULL);
+  } else if (strcasecmp(name, "ARC") == 0) {
+    return ARC_init(cc_params, NULL);
+  }
+  ERROR("unsupported cache name %s\n", name);
+  return nullptr;
 }
 }  // namespace TraceFilter
 
@@ -64,40 +376,68 @@ int main(int argc, char *argv[]) {
   struct arguments args;
   cli::parse_cmd(argc, argv, &args);
 
-  if (args.cache_size < 1) {
-    int64_t wss_obj = 0, wss_byte = 0;
-    cal_working_set_size(args.reader, &wss_obj, &wss_byte);
-    if (args.ignore_obj_size) {
-      args.cache_size = (int64_t)(wss_obj * args.cache_size);
-    } else {
-      args.cache_size = (int64_t)(wss_byte * args.cache_size);
-    }
+  std::vector<std::string> algos =
+      TraceFilter::split(args.cache_name == NULL ? "FIFO" : args.cache_name);
+  std::vector<std::string> size_strs =
+      TraceFilter::split(args.cache_size == NULL ? "0.1" : args.cache_size);
+  if (algos.empty() || size_strs.empty()) {
+    ERROR("no filter type or size is given\n");
   }
 
-  common_cache_params_t cc_params = {
-      .cache_size = static_cast<uint64_t>(args.cache_size),
-      .default_ttl = 86400 * 300,
-      .hashpower = 24,
-      .consider_obj_metadata = false};
+  const char *trace_filename = rindex(args.trace_path, '/');
+  trace_filename = trace_filename == NULL ? args.trace_path : trace_filename + 1;
+  bool single_filter = algos.size() == 1 && size_strs.size() == 1;
 
-  if (strcasecmp(args.cache_name, "LRU") == 0) {
-    args.cache = LRU_init(cc_params, NULL);
-  } else if (strcasecmp(args.cache_name, "FIFO") == 0) {
-    args.cache = FIFO_init(cc_params, NULL);
-  } else {
-    ERROR("unsupported cache name %s\n", args.cache_name);
-    exit(1);
-  }
+  int64_t wss = 0;
+  bool need_stack_dist = false;
+  std::vector<TraceFilter::Filter> filters;
+  for (auto &algo : algos) {
+    for (auto &size_str : size_strs) {
+      TraceFilter::Filter f;
+      f.algo = algo;
+      f.cache_size = TraceFilter::conv_size(size_str, args.reader,
+                                            args.ignore_obj_size, &wss);
+      f.n_req = 0;
+      f.n_written_req = 0;
+
+      if (args.lru_stack_dist && strcasecmp(algo.c_str(), "LRU") == 0) {
+        f.cache = nullptr;
+        need_stack_dist = true;
+      } else {
+        common_cache_params_t cc_params = {.cache_size = f.cache_size,
+                                           .default_ttl = 86400 * 300,
+                                           .hashpower = 24,
+                                           .consider_obj_metadata = false};
+        f.cache = TraceFilter::create_filter_cache(algo, cc_params);
+      }
 
-  if (args.ofilepath[0] == '\0') {
-    char *trace_filename = rindex(args.trace_path, '/');
-    snprintf(args.ofilepath, OFILEPATH_LEN, "%s.filter_%s_%lu.oracleGeneral",
-             trace_filename == NULL ? args.trace_path : trace_filename + 1,
-             args.cache_name, static_cast<unsigned long>(args.cache_size));
+      /* one filter writes to the output path, several filters use it as the
+       * prefix */
+      char path[OFILEPATH_LEN + 128];
+      if (single_filter && args.ofilepath[0] != '\0') {
+        snprintf(path, sizeof(path), "%s", args.ofilepath);
+      } else {
+        snprintf(path, sizeof(path), "%s.filter_%s_%lu.oracleGeneral",
+                 args.ofilepath[0] != '\0' ? args.ofilepath : trace_filename,
+                 algo.c_str(), (unsigned long)f.cache_size);
+      }
+      std::string ofilepath(path);
+      if (args.compress_output && (ofilepath.size() < 4 ||
+                                   ofilepath.substr(ofilepath.size() - 4) !=
+                                       ".zst")) {
+        ofilepath += ".zst";
+      }
+      f.writer = new TraceFilter::TraceWriter(ofilepath, args.compress_output);
+      filters.push_back(f);
+    }
   }
 
-  TraceFilter::filter(args.reader, args.cache, args.ofilepath);
+  TraceFilter::filter(args.reader, filters, args.n_thread, need_stack_dist);
 
+  for (auto &f : filters) {
+    if (f.cache != nullptr) f.cache->cache_free(f.cache);
+    delete f.writer;
+  }
   cli::free_arg(&args);
 
   return 0;
@@ -1,10 +1,26 @@
 //
 // Created by Juncheng on 5/29/21.
 //
+// a doorkeeper admission that admits an object on its second request within
+// a period, the objects seen are tracked by two Bloom filters, new objects are
+// added to the current filter and an object is considered seen if it is in
+// either filter, when the current filter is full (n-obj insertions) or
+// rotate-sec has passed, the previous filter is cleared and the two are
+// swapped, so the memory is fixed and an object is forgotten after one to two
+// periods
+//
+// params:
+//   n-obj=1000000 the number of objects each filter is sized for
+//   fp-rate=0.01 the false positive rate of each filter when full
+//   rotate-sec=0 rotate the filters every rotate-sec seconds of trace time,
+//                0 means rotating after n-obj insertions
+//
 
-#include <glib.h>
+#include <math.h>
 #include <stdbool.h>
 
+#include "../../dataStructure/bloom.h"
+#include "../../dataStructure/hash/hash.h"
 #include "../../include/libCacheSim/admissionAlgo.h"
 
 #ifdef __cplusplus
@@ -12,22 +28,102 @@ extern "C" {
 #endif
 
 typedef struct bloomfilter_admission {
-  GHashTable *seen_times;
+  struct bloom filters[2];
+  /* the index of the filter new objects are added to */
+  int curr;
+  int64_t n_insert_curr;
+  int64_t last_rotate_time;
+
+  int64_t n_obj;
+  double fp_rate;
+  int64_t rotate_sec;
 } bf_admission_params_t;
 
+static void bloomfilter_rotate(bf_admission_params_t *bf) {
+  bf->curr = 1 - bf->curr;
+  bloom_reset(&bf->filters[bf->curr]);
+  bf->n_insert_curr = 0;
+}
+
 bool bloomfilter_admit(admissioner_t *admissioner, const request_t *req) {
   bf_admission_params_t *bf = admissioner->params;
-  gpointer key = GINT_TO_POINTER(req->obj_id);
-  gpointer n_times =
-      g_hash_table_lookup(bf->seen_times, GSIZE_TO_POINTER(req->obj_id));
-  if (n_times == NULL) {
-    g_hash_table_insert(bf->seen_times, key, GINT_TO_POINTER(1));
-    return false;
-  } else {
-    g_hash_table_insert(bf->seen_times, key,
-                        GINT_TO_POINTER(GPOINTER_TO_INT(n_times) + 1));
+
+  if (bf->rotate_sec > 0) {
+    if (req->clock_time - bf->last_rotate_time >= bf->rotate_sec) {
+      bloomfilter_rotate(bf);
+      bf->last_rotate_time = req->clock_time;
+    }
+  } else if (bf->n_insert_curr >= bf->n_obj) {
+    bloomfilter_rotate(bf);
+  }
+
+  /* the reader may have computed the hash already */
+  uint64_t hv = req->hv != 0 ? req->hv : get_hash_value_int_64(&req->obj_id);
+
+  if (bloom_add_hash(&bf->filters[bf->curr], hv) == 1) {
     return true;
   }
+  bf->n_insert_curr += 1;
+
+  return bloom_check_hash(&bf->filters[1 - bf->curr], hv) == 1;
+}
+
+static void bloomfilter_admissioner_parse_params(const char *init_params,
+                                                 bf_admission_params_t *bf) {
+  bf->n_obj = 1000000;
+  bf->fp_rate = 0.01;
+  bf->rotate_sec = 0;
+
+  if (init_params == NULL) {
+    return;
+  }
+
+  char *params_str = strdup(init_params);
+  char *old_params_str = params_str;
+  char *end;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "n-obj") == 0) {
+      bf->n_obj = (int64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "fp-rate") == 0) {
+      bf->fp_rate = strtod(value, &end);
+    } else if (strcasecmp(key, "rotate-sec") == 0) {
+      bf->rotate_sec = strtoll(value, &end, 0);
+    } else {
+      ERROR("bloomfilter admission does not have parameter %s\n", key);
+    }
+    if (strlen(end) > 2) {
+      ERROR("param parsing error, find string \"%s\" after number\n", end);
+    }
+  }
+  free(old_params_str);
+
+  if (bf->fp_rate <= 0 || bf->fp_rate >= 1) {
+    ERROR("bloomfilter admission requires fp-rate in (0, 1)\n");
+  }
+  /* the number of bits of a filter is an int */
+  double n_bit = (double)bf->n_obj * -log(bf->fp_rate) / (M_LN2 * M_LN2);
+  if (bf->n_obj < 1000 || n_bit >= INT32_MAX) {
+    ERROR("bloomfilter admission n-obj %lld is too small or too large\n",
+          (long long)bf->n_obj);
+  }
+}
+
+static int64_t bloomfilter_get_metadata_bytes(
+    const admissioner_t *admissioner) {
+  const bf_admission_params_t *bf = admissioner->params;
+  return (int64_t)sizeof(bf_admission_params_t) + bf->filters[0].bytes +
+         bf->filters[1].bytes;
 }
 
 admissioner_t *clone_bloomfilter_admissioner(admissioner_t *admissioner) {
@@ -35,8 +131,9 @@ admissioner_t *clone_bloomfilter_admissioner(admissioner_t *admissioner) {
 }
 
 void free_bloomfilter_admissioner(admissioner_t *admissioner) {
-  struct bloomfilter_admission *bf = admissioner->params;
-  g_hash_table_destroy(bf->seen_times);
+  bf_admission_params_t *bf = admissioner->params;
+  bloom_free(&bf->filters[0]);
+  bloom_free(&bf->filters[1]);
   free(bf);
   if (admissioner->init_params) {
     free(admissioner->init_params);
@@ -45,22 +142,28 @@ void free_bloomfilter_admissioner(admissioner_t *admissioner) {
 }
 
 admissioner_t *create_bloomfilter_admissioner(const char *init_params) {
-  if (init_params != NULL) {
-    ERROR("bloomfilter admission does not take any parameters");
+  bf_admission_params_t *bf =
+      (bf_admission_params_t *)malloc(sizeof(bf_admission_params_t));
+  memset(bf, 0, sizeof(bf_admission_params_t));
+  bloomfilter_admissioner_parse_params(init_params, bf);
+
+  for (int i = 0; i < 2; i++) {
+    if (bloom_init(&bf->filters[i], (int)bf->n_obj, bf->fp_rate) != 0) {
+      ERROR("failed to create bloom filter for %lld objects\n",
+            (long long)bf->n_obj);
+    }
   }
+  DEBUG("bloomfilter admission: 2 filters of %d bytes and %d hashes\n",
+        bf->filters[0].bytes, bf->filters[0].hashes);
 
   admissioner_t *admissioner = (admissioner_t *)malloc(sizeof(admissioner_t));
-  admissioner->init_params = NULL;
-
-  bf_admission_params_t *bf_params =
-      (bf_admission_params_t *)malloc(sizeof(bf_admission_params_t));
-  memset(bf_params, 0, sizeof(struct bloomfilter_admission));
-  bf_params->seen_times = g_hash_table_new(g_direct_hash, g_direct_equal);
-
-  admissioner->params = bf_params;
+  memset(admissioner, 0, sizeof(admissioner_t));
+  admissioner->params = bf;
   admissioner->clone = clone_bloomfilter_admissioner;
   admissioner->free = free_bloomfilter_admissioner;
   admissioner->admit = bloomfilter_admit;
+  admissioner->get_metadata_bytes = bloomfilter_get_metadata_bytes;
+  if (init_params != NULL) admissioner->init_params = strdup(init_params);
 
   return admissioner;
 }
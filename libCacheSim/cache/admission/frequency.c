@@ -0,0 +1,130 @@
+//
+// admit an object when its estimated frequency reaches min-freq, the
+// frequency is estimated by a Count-Min sketch of 4-bit counters that halves
+// the counters over time (the TinyLFU frequency estimator), so the memory is
+// fixed and old requests are forgotten
+//
+// the admissioner is called on cache misses, so the frequency counts the
+// requests that miss in the cache
+//
+// params:
+//   n-obj=1000000 the number of objects the sketch is sized for
+//   sample-size=0 the counters are halved every sample-size requests,
+//                 0 means 10 * n-obj
+//   min-freq=2 the frequency (including the current request) to admit, at
+//              most 15
+//
+
+#include "../../dataStructure/countMinSketch.h"
+#include "../../dataStructure/hash/hash.h"
+#include "../../include/libCacheSim/admissionAlgo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct frequency_admission {
+  count_min_sketch_t *cms;
+
+  int64_t n_obj;
+  int64_t sample_size;
+  int min_freq;
+} frequency_admission_params_t;
+
+bool frequency_admit(admissioner_t *admissioner, const request_t *req) {
+  frequency_admission_params_t *pa = admissioner->params;
+
+  /* the reader may have computed the hash already */
+  uint64_t hv = req->hv != 0 ? req->hv : get_hash_value_int_64(&req->obj_id);
+
+  return count_min_sketch_add(pa->cms, hv) >= pa->min_freq;
+}
+
+static void frequency_admissioner_parse_params(
+    const char *init_params, frequency_admission_params_t *pa) {
+  pa->n_obj = 1000000;
+  pa->sample_size = 0;
+  pa->min_freq = 2;
+
+  if (init_params == NULL) {
+    return;
+  }
+
+  char *params_str = strdup(init_params);
+  char *old_params_str = params_str;
+  char *end;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "n-obj") == 0) {
+      pa->n_obj = (int64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "sample-size") == 0) {
+      pa->sample_size = (int64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "min-freq") == 0) {
+      pa->min_freq = (int)strtol(value, &end, 0);
+    } else {
+      ERROR("frequency admission does not have parameter %s\n", key);
+    }
+    if (strlen(end) > 2) {
+      ERROR("param parsing error, find string \"%s\" after number\n", end);
+    }
+  }
+  free(old_params_str);
+
+  if (pa->min_freq < 1 || pa->min_freq > CMS_COUNTER_MAX) {
+    ERROR("frequency admission requires min-freq in [1, %d]\n",
+          CMS_COUNTER_MAX);
+  }
+}
+
+static int64_t frequency_get_metadata_bytes(const admissioner_t *admissioner) {
+  const frequency_admission_params_t *pa = admissioner->params;
+  return (int64_t)sizeof(frequency_admission_params_t) +
+         count_min_sketch_get_metadata_bytes(pa->cms);
+}
+
+admissioner_t *clone_frequency_admissioner(admissioner_t *admissioner) {
+  return create_frequency_admissioner(admissioner->init_params);
+}
+
+void free_frequency_admissioner(admissioner_t *admissioner) {
+  frequency_admission_params_t *pa = admissioner->params;
+  free_count_min_sketch(pa->cms);
+  free(pa);
+  if (admissioner->init_params) {
+    free(admissioner->init_params);
+  }
+  free(admissioner);
+}
+
+admissioner_t *create_frequency_admissioner(const char *init_params) {
+  frequency_admission_params_t *pa = (frequency_admission_params_t *)malloc(
+      sizeof(frequency_admission_params_t));
+  memset(pa, 0, sizeof(frequency_admission_params_t));
+  frequency_admissioner_parse_params(init_params, pa);
+  pa->cms = create_count_min_sketch(pa->n_obj, pa->sample_size);
+
+  admissioner_t *admissioner = (admissioner_t *)malloc(sizeof(admissioner_t));
+  memset(admissioner, 0, sizeof(admissioner_t));
+  admissioner->params = pa;
+  admissioner->clone = clone_frequency_admissioner;
+  admissioner->free = free_frequency_admissioner;
+  admissioner->admit = frequency_admit;
+  admissioner->get_metadata_bytes = frequency_get_metadata_bytes;
+  if (init_params != NULL) admissioner->init_params = strdup(init_params);
+
+  return admissioner;
+}
+
+#ifdef __cplusplus
+}
+#endif
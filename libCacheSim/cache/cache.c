@@ -2,7 +2,12 @@
 // Created by Juncheng Yang on 6/20/20.
 //
 
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+
 #include "../dataStructure/hashtable/hashtable.h"
+#include "../dataStructure/timerWheel.h"
 #include "../include/libCacheSim/cache.h"
 #include "../include/libCacheSim/prefetchAlgo.h"
 
@@ -44,6 +49,7 @@ cache_t *cache_struct_init(const char *const cache_name,
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->get_n_obj = cache_get_n_obj_default;
+  cache->get_metadata_bytes = cache_get_metadata_bytes_default;
 
   /* this option works only when eviction age tracking
    * is on in config.h */
@@ -61,6 +67,10 @@ cache_t *cache_struct_init(const char *const cache_name,
   hashtable_add_ptr_to_monitoring(cache->hashtable, &cache->q_head);
   hashtable_add_ptr_to_monitoring(cache->hashtable, &cache->q_tail);
 
+#ifdef SUPPORT_TTL
+  cache->ttl_wheel = create_timer_wheel();
+#endif
+
   return cache;
 }
 
@@ -71,11 +81,48 @@ cache_t *cache_struct_init(const char *const cache_name,
  */
 void cache_struct_free(cache_t *cache) {
   free_hashtable(cache->hashtable);
+  if (cache->ttl_wheel != NULL) free_timer_wheel(cache->ttl_wheel);
   if (cache->admissioner != NULL) cache->admissioner->free(cache->admissioner);
   if (cache->prefetcher != NULL) cache->prefetcher->free(cache->prefetcher);
   my_free(sizeof(cache_t), cache);
 }
 
+void cache_set_obj_struct_size(cache_t *cache, size_t obj_struct_size) {
+  if (obj_struct_size < CACHE_OBJ_HEADER_SIZE ||
+      obj_struct_size > sizeof(cache_obj_t)) {
+    ERROR("%s object struct size %zu is not in [%zu, %zu]\n",
+          cache->cache_name, obj_struct_size, (size_t)CACHE_OBJ_HEADER_SIZE,
+          sizeof(cache_obj_t));
+  }
+  if (cache->hashtable->n_obj != 0) {
+    ERROR("%s object struct size cannot change after insert\n",
+          cache->cache_name);
+  }
+  hashtable_set_obj_struct_size(cache->hashtable, obj_struct_size);
+}
+
+size_t cache_get_obj_struct_size(const cache_t *cache) {
+  return cache->hashtable->obj_struct_size;
+}
+
+int64_t cache_get_metadata_bytes_default(const cache_t *cache) {
+  int64_t n_byte = (int64_t)sizeof(cache_t) +
+                   hashtable_get_metadata_bytes(cache->hashtable);
+  if (cache->ttl_wheel != NULL) {
+    n_byte += (int64_t)sizeof(timer_wheel_t) +
+              cache->ttl_wheel->n_entry * (int64_t)sizeof(timer_wheel_entry_t);
+  }
+  if (cache->admissioner != NULL &&
+      cache->admissioner->get_metadata_bytes != NULL) {
+    n_byte += cache->admissioner->get_metadata_bytes(cache->admissioner);
+  }
+  if (cache->prefetcher != NULL &&
+      cache->prefetcher->get_metadata_bytes != NULL) {
+    n_byte += cache->prefetcher->get_metadata_bytes(cache->prefetcher);
+  }
+  return n_byte;
+}
+
 /**
  * @brief create a new cache with the same size as the old cache
  *
@@ -95,6 +142,7 @@ cache_t *clone_cache(const cache_t *old_cache) {
   if (old_cache->admissioner != NULL) {
     cache->admissioner = old_cache->admissioner->clone(old_cache->admissioner);
   }
+  cache->charge_metadata = old_cache->charge_metadata;
   cache->future_stack_dist = old_cache->future_stack_dist;
   cache->future_stack_dist_array_size = old_cache->future_stack_dist_array_size;
 
@@ -125,6 +173,7 @@ cache_t *create_cache_with_new_size(const cache_t *old_cache,
     cache->prefetcher =
         old_cache->prefetcher->clone(old_cache->prefetcher, new_size);
   }
+  cache->charge_metadata = old_cache->charge_metadata;
   cache->future_stack_dist = old_cache->future_stack_dist;
   cache->future_stack_dist_array_size = old_cache->future_stack_dist_array_size;
   return cache;
@@ -160,6 +209,101 @@ bool cache_can_insert_default(cache_t *cache, const request_t *req) {
   return true;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                       object expiration                       ****
+// ****                                                               ****
+// ***********************************************************************
+#ifdef SUPPORT_TTL
+/* the ttl wheel is compacted when it has more than twice the number of
+ * cached objects plus this number of entries */
+#define TTL_WHEEL_COMPACT_SLACK 65536
+
+/* remove an expired object and count the bytes it frees, the bytes are
+ * measured by the change of occupied bytes, so removing a ghost entry does
+ * not count as an expiration */
+static void cache_remove_expired_obj(cache_t *cache, obj_id_t obj_id) {
+  int64_t occupied_byte = cache->get_occupied_byte(cache);
+  cache->remove(cache, obj_id);
+  int64_t freed_byte = occupied_byte - cache->get_occupied_byte(cache);
+  if (freed_byte > 0) {
+    cache->n_expiration += 1;
+    cache->n_expired_byte += freed_byte;
+  }
+}
+
+typedef struct {
+  cache_t *cache;
+  request_t req;
+} ttl_wheel_ctx_t;
+
+/* the wheel is not updated on eviction or re-insertion, so an entry is valid
+ * only if the object is still cached with the same expiration time */
+static bool ttl_wheel_entry_valid(obj_id_t obj_id, uint32_t exp_time,
+                                  void *user_data) {
+  ttl_wheel_ctx_t *ctx = user_data;
+  ctx->req.obj_id = obj_id;
+  cache_obj_t *obj = ctx->cache->find(ctx->cache, &ctx->req, false);
+  return obj != NULL && obj->exp_time == exp_time;
+}
+
+static void ttl_wheel_expire(obj_id_t obj_id, uint32_t exp_time,
+                             void *user_data) {
+  ttl_wheel_ctx_t *ctx = user_data;
+  if (ttl_wheel_entry_valid(obj_id, exp_time, user_data)) {
+    cache_remove_expired_obj(ctx->cache, obj_id);
+  }
+}
+
+/* the request has clock time 0 so that find does not treat the object as
+ * expired */
+static void ttl_wheel_ctx_init(ttl_wheel_ctx_t *ctx, cache_t *cache) {
+  ctx->cache = cache;
+  memset(&ctx->req, 0, sizeof(request_t));
+  ctx->req.obj_size = 1;
+  ctx->req.valid = true;
+}
+
+/**
+ * @brief add a newly inserted object to the ttl wheel, the stale entries of
+ * evicted objects are dropped when the wheel grows too large, so the wheel
+ * of a sub-cache that does not receive requests also has bounded size
+ *
+ * @param cache
+ * @param obj
+ */
+static void cache_track_expiration(cache_t *cache, const cache_obj_t *obj) {
+  timer_wheel_t *tw = cache->ttl_wheel;
+  if (tw == NULL) return;
+
+  timer_wheel_add(tw, obj->obj_id, obj->exp_time);
+  if (tw->n_entry > 2 * cache->get_n_obj(cache) + TTL_WHEEL_COMPACT_SLACK) {
+    ttl_wheel_ctx_t ctx;
+    ttl_wheel_ctx_init(&ctx, cache);
+    int64_t n_removed = timer_wheel_compact(tw, ttl_wheel_entry_valid, &ctx);
+    DEBUG("%s ttl wheel drops %ld stale entries, %ld entries left\n",
+          cache->cache_name, (long)n_removed, (long)tw->n_entry);
+  }
+}
+#endif
+
+int64_t cache_remove_expired(cache_t *cache, int64_t now) {
+#ifdef SUPPORT_TTL
+  if (cache->ttl_wheel == NULL) return 0;
+
+  int64_t n_expiration = cache->n_expiration;
+  ttl_wheel_ctx_t ctx;
+  ttl_wheel_ctx_init(&ctx, cache);
+  /* an object expires when exp_time < now */
+  timer_wheel_advance(cache->ttl_wheel, now - 1, ttl_wheel_expire, &ctx);
+  return cache->n_expiration - n_expiration;
+#else
+  (void)cache;
+  (void)now;
+  return 0;
+#endif
+}
+
 /**
  * @brief this function is called by eviction algorithms that use
  * the hash table to find whether an object is in the cache
@@ -183,21 +327,21 @@ cache_obj_t *cache_find_base(cache_t *cache, const request_t *req,
     cache->prefetcher->handle_find(cache, req, hit);
   }
 
-  if (cache_obj != NULL) {
 #ifdef SUPPORT_TTL
-    if (cache_obj->exp_time != 0 && cache_obj->exp_time < req->clock_time) {
-      if (update_cache) {
-        cache->remove(cache, cache_obj->obj_id);
-      }
-
-      cache_obj = NULL;
+  if (cache_obj != NULL && cache_obj->exp_time != 0 &&
+      cache_obj->exp_time < req->clock_time) {
+    if (update_cache) {
+      cache_remove_expired_obj(cache, cache_obj->obj_id);
     }
+
+    cache_obj = NULL;
+  }
 #endif
 
-    if (update_cache) {
-      cache_obj->misc.next_access_vtime = req->next_access_vtime;
-      cache_obj->misc.freq += 1;
-    }
+  if (cache_obj != NULL && update_cache &&
+      cache->hashtable->obj_struct_size >= CACHE_OBJ_SIZE_WITH(misc)) {
+    cache_obj->misc.next_access_vtime = req->next_access_vtime;
+    cache_obj->misc.freq += 1;
   }
 
   return cache_obj;
@@ -225,6 +369,10 @@ cache_obj_t *cache_find_base(cache_t *cache, const request_t *req,
 bool cache_get_base(cache_t *cache, const request_t *req) {
   cache->n_req += 1;
 
+#ifdef SUPPORT_TTL
+  cache_remove_expired(cache, req->clock_time);
+#endif
+
   VERBOSE("******* %s req %ld, obj %ld, obj_size %ld, cache size %ld/%ld\n",
           cache->cache_name, cache->n_req, req->obj_id, req->obj_size,
           cache->get_occupied_byte(cache), cache->cache_size);
@@ -238,12 +386,40 @@ bool cache_get_base(cache_t *cache, const request_t *req) {
     VVERBOSE("req %ld, obj %ld --- cache miss cannot insert\n", cache->n_req,
              req->obj_id);
   } else {
-    while (cache->get_occupied_byte(cache) + req->obj_size +
-               cache->obj_md_size >
-           cache->cache_size) {
+    int64_t need_byte = (int64_t)req->obj_size + cache->obj_md_size;
+    bool has_space = true;
+    while (cache->get_occupied_byte(cache) + need_byte >
+           cache_get_usable_byte(cache)) {
+      if (cache->charge_metadata && cache->get_n_obj(cache) == 0) {
+        /* the metadata of the empty cache leaves no space for the object */
+        has_space = false;
+        break;
+      }
+      int64_t occupied_byte = cache->get_occupied_byte(cache);
       cache->evict(cache, req);
+      int64_t freed_byte = occupied_byte - cache->get_occupied_byte(cache);
+      if (cache->charge_metadata && freed_byte == 0) {
+        /* the algorithms that size their queues at init (e.g., LIRS) do not
+         * evict for the metadata */
+        WARN_ONCE("%s does not evict to make space for the metadata\n",
+                  cache->cache_name);
+        break;
+      }
+      cache->n_eviction += 1;
+      cache->n_evicted_byte += freed_byte;
+    }
+    cache_obj_t *obj = has_space ? cache->insert(cache, req) : NULL;
+#ifdef SUPPORT_TTL
+    /* the objects inserted into this cache's hash table are tracked by
+     * cache_insert_base, the ones inserted into sub-caches (e.g., S3FIFO) are
+     * tracked here so that they are removed from the composed cache */
+    if (obj != NULL && obj->exp_time != 0 &&
+        hashtable_find_obj_id(cache->hashtable, obj->obj_id) != obj) {
+      cache_track_expiration(cache, obj);
     }
-    cache->insert(cache, req);
+#else
+    (void)obj;
+#endif
   }
 
   if (cache->prefetcher && cache->prefetcher->prefetch) {
@@ -270,9 +446,12 @@ cache_obj_t *cache_insert_base(cache_t *cache, const request_t *req) {
   cache->n_obj += 1;
 
 #ifdef SUPPORT_TTL
-  if (cache->default_ttl != 0 && req->ttl == 0) {
+  if (cache->default_ttl != 0 && req->ttl <= 0) {
     cache_obj->exp_time = (int32_t)cache->default_ttl + req->clock_time;
   }
+  if (cache_obj->exp_time != 0) {
+    cache_track_expiration(cache, cache_obj);
+  }
 #endif
 
 #if defined(TRACK_EVICTION_V_AGE) || defined(TRACK_DEMOTION) || \
@@ -280,8 +459,10 @@ cache_obj_t *cache_insert_base(cache_t *cache, const request_t *req) {
   cache_obj->create_time = CURR_TIME(cache, req);
 #endif
 
-  cache_obj->misc.next_access_vtime = req->next_access_vtime;
-  cache_obj->misc.freq = 0;
+  if (cache->hashtable->obj_struct_size >= CACHE_OBJ_SIZE_WITH(misc)) {
+    cache_obj->misc.next_access_vtime = req->next_access_vtime;
+    cache_obj->misc.freq = 0;
+  }
 
   return cache_obj;
 }
@@ -301,6 +482,9 @@ void cache_evict_base(cache_t *cache, cache_obj_t *obj,
     record_eviction_age(cache, obj, CURR_TIME(cache, req) - obj->create_time);
   }
 #endif
+  if (cache->evict_listener != NULL) {
+    cache->evict_listener(cache, obj, cache->evict_listener_data);
+  }
   if (cache->prefetcher && cache->prefetcher->handle_evict) {
     request_t *check_req = new_request();
     check_req->obj_id = obj->obj_id;
@@ -487,4 +671,215 @@ bool dump_cached_obj_age(cache_t *cache, const request_t *req,
 
   fclose(ofile);
   return true;
-}
\ No newline at end of file
+}
+
+// ***********************************************************************
+// ****                                                               ****
+// ****                           snapshot                            ****
+// ****                                                               ****
+// ***********************************************************************
+#define SNAPSHOT_MAGIC "LCSSNAP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_TAG_LEN 16
+
+/* the part of the object struct after the hash chain and the queue pointers,
+ * it has the size, the expiration time, misc and the algorithm specific
+ * metadata that the cache declares */
+#define OBJ_STATE_OFFSET \
+  (offsetof(cache_obj_t, queue) + sizeof(((cache_obj_t *)0)->queue))
+#define OBJ_STATE_SIZE(cache) \
+  (cache_get_obj_struct_size(cache) - OBJ_STATE_OFFSET)
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  /* the object metadata is stored as is, so the snapshot can only be loaded
+   * by a build with the same object struct */
+  uint32_t cache_obj_size;
+  int64_t cache_size;
+  char cache_name[CACHE_NAME_ARRAY_LEN];
+  char init_params[CACHE_INIT_PARAMS_LEN];
+} snapshot_header_t;
+
+bool cache_snapshot_write_tag(FILE *f, const char *tag) {
+  char buf[SNAPSHOT_TAG_LEN] = {0};
+  strncpy(buf, tag, SNAPSHOT_TAG_LEN - 1);
+  return fwrite(buf, SNAPSHOT_TAG_LEN, 1, f) == 1;
+}
+
+bool cache_snapshot_check_tag(FILE *f, const char *tag) {
+  char buf[SNAPSHOT_TAG_LEN];
+  if (fread(buf, SNAPSHOT_TAG_LEN, 1, f) != 1) {
+    WARN("snapshot is truncated\n");
+    return false;
+  }
+  buf[SNAPSHOT_TAG_LEN - 1] = '\0';
+  if (strcmp(buf, tag) != 0) {
+    WARN("snapshot is saved by %s, cannot be loaded into %s\n", buf, tag);
+    return false;
+  }
+  return true;
+}
+
+bool cache_save_obj_list(const cache_t *cache, FILE *f,
+                         const cache_obj_t *q_tail) {
+  int64_t n_obj = 0;
+  for (const cache_obj_t *obj = q_tail; obj != NULL; obj = obj->queue.prev) {
+    n_obj++;
+  }
+  if (fwrite(&n_obj, sizeof(n_obj), 1, f) != 1) return false;
+
+  for (const cache_obj_t *obj = q_tail; obj != NULL; obj = obj->queue.prev) {
+    uint32_t obj_size = obj->obj_size;
+    if (fwrite(&obj->obj_id, sizeof(obj_id_t), 1, f) != 1 ||
+        fwrite(&obj_size, sizeof(obj_size), 1, f) != 1 ||
+        fwrite((const char *)obj + OBJ_STATE_OFFSET, OBJ_STATE_SIZE(cache), 1,
+               f) != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t cache_load_obj_list(cache_t *cache, FILE *f, cache_obj_t **q_head,
+                            cache_obj_t **q_tail) {
+  int64_t n_obj;
+  if (fread(&n_obj, sizeof(n_obj), 1, f) != 1 || n_obj < 0) {
+    WARN("snapshot is truncated\n");
+    return -1;
+  }
+
+  request_t *req = new_request();
+  char state[sizeof(cache_obj_t)];
+  for (int64_t i = 0; i < n_obj; i++) {
+    uint32_t obj_size;
+    if (fread(&req->obj_id, sizeof(obj_id_t), 1, f) != 1 ||
+        fread(&obj_size, sizeof(obj_size), 1, f) != 1 ||
+        fread(state, OBJ_STATE_SIZE(cache), 1, f) != 1) {
+      WARN("snapshot is truncated\n");
+      free_request(req);
+      return -1;
+    }
+    req->obj_size = obj_size;
+
+    cache_obj_t *obj = cache_insert_base(cache, req);
+    memcpy((char *)obj + OBJ_STATE_OFFSET, state, OBJ_STATE_SIZE(cache));
+    prepend_obj_to_head(q_head, q_tail, obj);
+#ifdef SUPPORT_TTL
+    if (obj->exp_time != 0) cache_track_expiration(cache, obj);
+#endif
+  }
+  free_request(req);
+
+  return n_obj;
+}
+
+bool cache_save_state(const cache_t *cache, FILE *f) {
+  if (cache->save_state == NULL) {
+    WARN("%s does not support snapshot\n", cache->cache_name);
+    return false;
+  }
+  if (fwrite(&cache->n_req, sizeof(cache->n_req), 1, f) != 1) return false;
+  return cache->save_state(cache, f);
+}
+
+bool cache_load_state(cache_t *cache, FILE *f) {
+  if (cache->load_state == NULL) {
+    WARN("%s does not support snapshot\n", cache->cache_name);
+    return false;
+  }
+  if (cache->get_n_obj(cache) != 0) {
+    WARN("snapshot can only be loaded into an empty cache\n");
+    return false;
+  }
+  int64_t n_req;
+  if (fread(&n_req, sizeof(n_req), 1, f) != 1) {
+    WARN("snapshot is truncated\n");
+    return false;
+  }
+  if (!cache->load_state(cache, f)) return false;
+  cache->n_req = n_req;
+  return true;
+}
+
+bool cache_save_snapshot(const cache_t *cache, const char *path) {
+  if (cache->save_state == NULL) {
+    WARN("%s does not support snapshot\n", cache->cache_name);
+    return false;
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) {
+    WARN("cannot open %s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  snapshot_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  header.version = SNAPSHOT_VERSION;
+  header.cache_obj_size = cache_get_obj_struct_size(cache);
+  header.cache_size = cache->cache_size;
+  memcpy(header.cache_name, cache->cache_name, CACHE_NAME_ARRAY_LEN);
+  memcpy(header.init_params, cache->init_params, CACHE_INIT_PARAMS_LEN);
+
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+  ok = ok && cache_save_state(cache, f);
+  ok = (fclose(f) == 0) && ok;
+  if (!ok) {
+    WARN("failed to write snapshot %s\n", path);
+    remove(path);
+    return false;
+  }
+
+  INFO("saved %s snapshot (%ld objects, %ld bytes) to %s\n", cache->cache_name,
+       (long)cache->get_n_obj(cache), (long)cache->get_occupied_byte(cache),
+       path);
+  return true;
+}
+
+bool cache_load_snapshot(cache_t *cache, const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    WARN("cannot open %s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  snapshot_header_t header;
+  if (fread(&header, sizeof(header), 1, f) != 1 ||
+      memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+    WARN("%s is not a cache snapshot\n", path);
+    fclose(f);
+    return false;
+  }
+  if (header.version != SNAPSHOT_VERSION ||
+      header.cache_obj_size != cache_get_obj_struct_size(cache)) {
+    WARN("snapshot %s is saved by a different version (%u, %u)\n", path,
+         header.version, header.cache_obj_size);
+    fclose(f);
+    return false;
+  }
+  if (header.cache_size != cache->cache_size) {
+    WARN("snapshot %s has cache size %ld, but the cache size is %ld\n", path,
+         (long)header.cache_size, (long)cache->cache_size);
+    fclose(f);
+    return false;
+  }
+  header.cache_name[CACHE_NAME_ARRAY_LEN - 1] = '\0';
+  if (strcmp(header.cache_name, cache->cache_name) != 0) {
+    WARN("load snapshot of %s into %s\n", header.cache_name,
+         cache->cache_name);
+  }
+
+  bool ok = cache_load_state(cache, f);
+  fclose(f);
+  if (!ok) {
+    WARN("failed to load snapshot %s\n", path);
+    return false;
+  }
+
+  INFO("loaded %s snapshot (%ld objects, %ld bytes) from %s\n",
+       cache->cache_name, (long)cache->get_n_obj(cache),
+       (long)cache->get_occupied_byte(cache), path);
+  return true;
+}
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <gmodule.h>
 
+#include "../include/libCacheSim/cache.h"
 #include "../include/libCacheSim/cacheObj.h"
 #include "../include/libCacheSim/macro.h"
 #include "../include/libCacheSim/request.h"
@@ -10,13 +11,19 @@
 /**
  * copy the cache_obj to req_dest
  * @param req_dest
+ * @param cache the cache that owns cache_obj
  * @param cache_obj
  */
-void copy_cache_obj_to_request(request_t *req_dest,
+void copy_cache_obj_to_request(request_t *req_dest, const cache_t *cache,
                                const cache_obj_t *cache_obj) {
   req_dest->obj_id = cache_obj->obj_id;
   req_dest->obj_size = cache_obj->obj_size;
-  req_dest->next_access_vtime = cache_obj->misc.next_access_vtime;
+  /* the objects of a cache without misc are allocated without it */
+  if (cache_get_obj_struct_size(cache) >= CACHE_OBJ_SIZE_WITH(misc)) {
+    req_dest->next_access_vtime = cache_obj->misc.next_access_vtime;
+  } else {
+    req_dest->next_access_vtime = -2;
+  }
   req_dest->valid = true;
 }
 
@@ -28,7 +35,8 @@ void copy_cache_obj_to_request(request_t *req_dest,
 void copy_request_to_cache_obj(cache_obj_t *cache_obj, const request_t *req) {
   cache_obj->obj_size = req->obj_size;
 #ifdef SUPPORT_TTL
-  if (req->ttl != 0)
+  /* the readers set ttl to -1 if the trace does not have ttl */
+  if (req->ttl > 0)
     cache_obj->exp_time = req->clock_time + req->ttl;
   else
     cache_obj->exp_time = 0;
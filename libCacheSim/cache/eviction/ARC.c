@@ -118,6 +118,7 @@ cache_t *ARC_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(ARC));
 
   cache->eviction_params = my_malloc_n(ARC_params_t, 1);
   ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
@@ -222,26 +223,26 @@ static cache_obj_t *ARC_find(cache_t *cache, const request_t *req,
 
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
 
-  if (!update_cache) {
-    return obj->ARC.ghost ? NULL : obj;
-  }
-
   if (obj == NULL) {
     return NULL;
   }
 
+  if (!update_cache) {
+    return CACHE_OBJ_MEMBER(cache, obj, ARC).ghost ? NULL : obj;
+  }
+
   params->curr_obj_in_L1_ghost = false;
   params->curr_obj_in_L2_ghost = false;
 
-  int lru_id = obj->ARC.lru_id;
+  int lru_id = CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id;
   cache_obj_t *ret = obj;
 
-  if (obj->ARC.ghost) {
+  if (CACHE_OBJ_MEMBER(cache, obj, ARC).ghost) {
     // ghost hit
     ret = NULL;
     params->vtime_last_req_in_ghost = cache->n_req;
     // cache miss, but hit on thost
-    if (obj->ARC.lru_id == 1) {
+    if (CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id == 1) {
       params->curr_obj_in_L1_ghost = true;
       // case II: x in L1_ghost
       DEBUG_ASSERT(params->L1_ghost_size >= 1);
@@ -272,7 +273,7 @@ static cache_obj_t *ARC_find(cache_t *cache, const request_t *req,
 
     if (lru_id == 1) {
       // move to LRU2
-      obj->ARC.lru_id = 2;
+      CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id = 2;
       remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
       prepend_obj_to_head(&params->L2_data_head, &params->L2_data_tail, obj);
 
@@ -312,7 +313,7 @@ static cache_obj_t *ARC_insert(cache_t *cache, const request_t *req) {
   if (params->vtime_last_req_in_ghost == cache->n_req &&
       (params->curr_obj_in_L1_ghost || params->curr_obj_in_L2_ghost)) {
     // insert to L2 data head
-    obj->ARC.lru_id = 2;
+    CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id = 2;
     prepend_obj_to_head(&params->L2_data_head, &params->L2_data_tail, obj);
     params->L2_data_size += req->obj_size + cache->obj_md_size;
 
@@ -321,7 +322,7 @@ static cache_obj_t *ARC_insert(cache_t *cache, const request_t *req) {
     params->vtime_last_req_in_ghost = -1;
   } else {
     // insert to L1 data head
-    obj->ARC.lru_id = 1;
+    CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id = 1;
     prepend_obj_to_head(&params->L1_data_head, &params->L1_data_tail, obj);
     params->L1_data_size += req->obj_size + cache->obj_md_size;
   }
@@ -392,8 +393,8 @@ static bool ARC_remove(cache_t *cache, const obj_id_t obj_id) {
     return false;
   }
 
-  if (obj->ARC.ghost) {
-    if (obj->ARC.lru_id == 1) {
+  if (CACHE_OBJ_MEMBER(cache, obj, ARC).ghost) {
+    if (CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id == 1) {
       params->L1_ghost_size -= obj->obj_size + cache->obj_md_size;
       remove_obj_from_list(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
     } else {
@@ -401,7 +402,7 @@ static bool ARC_remove(cache_t *cache, const obj_id_t obj_id) {
       remove_obj_from_list(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
     }
   } else {
-    if (obj->ARC.lru_id == 1) {
+    if (CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id == 1) {
       params->L1_data_size -= obj->obj_size + cache->obj_md_size;
       remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
     } else {
@@ -459,7 +460,7 @@ static void _ARC_evict_L1_data(cache_t *cache, const request_t *req) {
   params->L1_ghost_size += obj->obj_size + cache->obj_md_size;
   remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
   prepend_obj_to_head(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
-  obj->ARC.ghost = true;
+  CACHE_OBJ_MEMBER(cache, obj, ARC).ghost = true;
 }
 
 static void _ARC_evict_L1_data_no_ghost(cache_t *cache, const request_t *req) {
@@ -488,7 +489,7 @@ static void _ARC_evict_L2_data(cache_t *cache, const request_t *req) {
   remove_obj_from_list(&params->L2_data_head, &params->L2_data_tail, obj);
   prepend_obj_to_head(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
 
-  obj->ARC.ghost = true;
+  CACHE_OBJ_MEMBER(cache, obj, ARC).ghost = true;
 
   cache_evict_base(cache, obj, false);
 }
@@ -497,7 +498,7 @@ static void _ARC_evict_L1_ghost(cache_t *cache, const request_t *req) {
   ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
   cache_obj_t *obj = params->L1_ghost_tail;
   DEBUG_ASSERT(obj != NULL);
-  DEBUG_ASSERT(obj->ARC.ghost);
+  DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).ghost);
   int64_t sz = obj->obj_size + cache->obj_md_size;
   params->L1_ghost_size -= sz;
   remove_obj_from_list(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
@@ -508,7 +509,7 @@ static void _ARC_evict_L2_ghost(cache_t *cache, const request_t *req) {
   ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
   cache_obj_t *obj = params->L2_ghost_tail;
   DEBUG_ASSERT(obj != NULL);
-  DEBUG_ASSERT(obj->ARC.ghost);
+  DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).ghost);
   int64_t sz = obj->obj_size + cache->obj_md_size;
   params->L2_ghost_size -= sz;
   remove_obj_from_list(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
@@ -723,8 +724,8 @@ static inline void _ARC_sanity_check_full(cache_t *cache,
   cache_obj_t *obj = params->L1_data_head;
   cache_obj_t *last_obj = NULL;
   while (obj != NULL) {
-    DEBUG_ASSERT(obj->ARC.lru_id == 1);
-    DEBUG_ASSERT(!obj->ARC.ghost);
+    DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id == 1);
+    DEBUG_ASSERT(!CACHE_OBJ_MEMBER(cache, obj, ARC).ghost);
     L1_data_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
@@ -735,8 +736,8 @@ static inline void _ARC_sanity_check_full(cache_t *cache,
   obj = params->L1_ghost_head;
   last_obj = NULL;
   while (obj != NULL) {
-    DEBUG_ASSERT(obj->ARC.lru_id == 1);
-    DEBUG_ASSERT(obj->ARC.ghost);
+    DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id == 1);
+    DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).ghost);
     L1_ghost_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
@@ -747,8 +748,8 @@ static inline void _ARC_sanity_check_full(cache_t *cache,
   obj = params->L2_data_head;
   last_obj = NULL;
   while (obj != NULL) {
-    DEBUG_ASSERT(obj->ARC.lru_id == 2);
-    DEBUG_ASSERT(!obj->ARC.ghost);
+    DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id == 2);
+    DEBUG_ASSERT(!CACHE_OBJ_MEMBER(cache, obj, ARC).ghost);
     L2_data_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
@@ -759,8 +760,8 @@ static inline void _ARC_sanity_check_full(cache_t *cache,
   obj = params->L2_ghost_head;
   last_obj = NULL;
   while (obj != NULL) {
-    DEBUG_ASSERT(obj->ARC.lru_id == 2);
-    DEBUG_ASSERT(obj->ARC.ghost);
+    DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).lru_id == 2);
+    DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, ARC).ghost);
     L2_ghost_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
@@ -62,6 +62,7 @@ static void ARCv0_evict(cache_t *cache, const request_t *req);
 static bool ARCv0_remove(cache_t *cache, const obj_id_t obj_id);
 static int64_t ARCv0_get_occupied_byte(const cache_t *cache);
 static int64_t ARCv0_get_n_obj(const cache_t *cache);
+static int64_t ARCv0_get_metadata_bytes(const cache_t *cache);
 
 /* internal functions */
 
@@ -104,6 +105,7 @@ cache_t *ARCv0_init(const common_cache_params_t ccache_params,
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = ARCv0_get_occupied_byte;
   cache->get_n_obj = ARCv0_get_n_obj;
+  cache->get_metadata_bytes = ARCv0_get_metadata_bytes;
 
   if (ccache_params.consider_obj_metadata) {
     // two pointer + ghost metadata
@@ -125,6 +127,11 @@ cache_t *ARCv0_init(const common_cache_params_t ccache_params,
   params->T2 = LRU_init(ccache_params_local, NULL);
 #endif
   params->B2 = LRU_init(ccache_params_local, NULL);
+  /* the objects move between the sub-caches with their metadata */
+  cache_set_obj_struct_size(params->T1, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->B1, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->T2, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->B2, sizeof(cache_obj_t));
 
   params->curr_obj_in_L1_ghost = false;
   params->curr_obj_in_L2_ghost = false;
@@ -378,6 +385,16 @@ static int64_t ARCv0_get_n_obj(const cache_t *cache) {
   return params->T1->get_n_obj(params->T1) + params->T2->get_n_obj(params->T2);
 }
 
+static int64_t ARCv0_get_metadata_bytes(const cache_t *cache) {
+  ARCv0_params_t *params = (ARCv0_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(ARCv0_params_t) +
+         params->T1->get_metadata_bytes(params->T1) +
+         params->B1->get_metadata_bytes(params->B1) +
+         params->T2->get_metadata_bytes(params->T2) +
+         params->B2->get_metadata_bytes(params->B2);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                  cache internal functions                     ****
@@ -419,7 +436,7 @@ static void _ARCv0_replace(cache_t *cache, const request_t *req) {
     // delete the LRU in L1 data, move to L1_ghost
     cache_obj_t *obj = params->T1->to_evict(params->T1, req);
     DEBUG_ASSERT(obj != NULL);
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, params->T1, obj);
 #ifdef LAZY_PROMOTION
     if (obj->misc.freq > 0) {
       params->T2->get(params->T2, params->req_local);
@@ -434,7 +451,7 @@ static void _ARCv0_replace(cache_t *cache, const request_t *req) {
     // delete the item in L2 data, move to L2_ghost
     cache_obj_t *obj = params->T2->to_evict(params->T2, req);
     DEBUG_ASSERT(obj != NULL);
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, params->T2, obj);
     params->T2->evict(params->T2, req);
     params->B2->get(params->B2, params->req_local);
   }
@@ -488,7 +505,7 @@ static void _ARCv0_evict_miss_on_all_queues(cache_t *cache,
 #ifdef LAZY_PROMOTION
       cache_obj_t *obj = params->T1->to_evict(params->T1, req);
       DEBUG_ASSERT(obj != NULL);
-      copy_cache_obj_to_request(params->req_local, obj);
+      copy_cache_obj_to_request(params->req_local, params->T1, obj);
       if (obj->misc.freq > 0) {
         params->T2->get(params->T2, params->req_local);
       }
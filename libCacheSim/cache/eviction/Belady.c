@@ -38,6 +38,7 @@ static cache_obj_t *Belady_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *Belady_to_evict(cache_t *cache, const request_t *req);
 static void Belady_evict(cache_t *cache, const request_t *req);
 static bool Belady_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t Belady_get_metadata_bytes(const cache_t *cache);
 static void Belady_remove_obj(cache_t *cache, cache_obj_t *obj);
 
 // ***********************************************************************
@@ -57,6 +58,7 @@ cache_t *Belady_init(const common_cache_params_t ccache_params,
                      __attribute__((unused))
                      const char *cache_specific_params) {
   cache_t *cache = cache_struct_init("Belady", ccache_params, cache_specific_params);
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(Belady));
   cache->cache_init = Belady_init;
   cache->cache_free = Belady_free;
   cache->get = Belady_get;
@@ -65,6 +67,7 @@ cache_t *Belady_init(const common_cache_params_t ccache_params,
   cache->evict = Belady_evict;
   cache->to_evict = Belady_to_evict;
   cache->remove = Belady_remove;
+  cache->get_metadata_bytes = Belady_get_metadata_bytes;
 
   Belady_params_t *params = my_malloc(Belady_params_t);
   cache->eviction_params = params;
@@ -90,6 +93,13 @@ static void Belady_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t Belady_get_metadata_bytes(const cache_t *cache) {
+  Belady_params_t *params = (Belady_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(Belady_params_t) +
+         pqueue_get_metadata_bytes(params->pq, sizeof(pq_node_t));
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -147,13 +157,11 @@ static cache_obj_t *Belady_find(cache_t *cache, const request_t *req,
     return NULL;
   }
 
-  cached_obj->Belady.next_access_vtime = req->next_access_vtime;
+  Belady_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cached_obj, Belady);
+  md->next_access_vtime = req->next_access_vtime;
   pqueue_pri_t pri = {.pri = req->next_access_vtime};
-  pqueue_change_priority(params->pq, pri,
-                         (pq_node_t *)(cached_obj->Belady.pq_node));
-  DEBUG_ASSERT(
-      ((pq_node_t *)hashtable_find(cache->hashtable, req)->Belady.pq_node)
-          ->pri.pri == req->next_access_vtime);
+  pqueue_change_priority(params->pq, pri, (pq_node_t *)(md->pq_node));
+  DEBUG_ASSERT(((pq_node_t *)md->pq_node)->pri.pri == req->next_access_vtime);
 
 #if defined(EVICT_IMMEDIATELY_IF_NO_FUTURE_ACCESS)
   if (req->next_access_vtime == INT64_MAX) {
@@ -187,12 +195,11 @@ static cache_obj_t *Belady_insert(cache_t *cache, const request_t *req) {
   node->obj_id = req->obj_id;
   node->pri.pri = req->next_access_vtime;
   pqueue_insert(params->pq, (void *)node);
-  cached_obj->Belady.pq_node = node;
-  cached_obj->Belady.next_access_vtime = req->next_access_vtime;
+  Belady_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cached_obj, Belady);
+  md->pq_node = node;
+  md->next_access_vtime = req->next_access_vtime;
 
-  DEBUG_ASSERT(
-      ((pq_node_t *)hashtable_find(cache->hashtable, req)->Belady.pq_node)
-          ->pri.pri == req->next_access_vtime);
+  DEBUG_ASSERT(((pq_node_t *)md->pq_node)->pri.pri == req->next_access_vtime);
 
 #if defined(EVICT_IMMEDIATELY_IF_NO_FUTURE_ACCESS)
   if (req->next_access_vtime == INT64_MAX) {
@@ -235,9 +242,9 @@ static void Belady_evict(cache_t *cache,
 
   cache_obj_t *obj_to_evict =
       hashtable_find_obj_id(cache->hashtable, node->obj_id);
-  DEBUG_ASSERT(node == obj_to_evict->Belady.pq_node);
+  DEBUG_ASSERT(node == CACHE_OBJ_MEMBER(cache, obj_to_evict, Belady).pq_node);
 
-  obj_to_evict->Belady.pq_node = NULL;
+  CACHE_OBJ_MEMBER(cache, obj_to_evict, Belady).pq_node = NULL;
   my_free(sizeof(pq_node_t), node);
 
   cache_evict_base(cache, obj_to_evict, true);
@@ -247,11 +254,11 @@ static void Belady_remove_obj(cache_t *cache, cache_obj_t *obj) {
   Belady_params_t *params = cache->eviction_params;
   DEBUG_ASSERT(obj != NULL);
 
-  if (obj->Belady.pq_node != NULL) {
+  if (CACHE_OBJ_MEMBER(cache, obj, Belady).pq_node != NULL) {
     /* if it is NULL, it means we have deleted the entry in pq before this */
-    pqueue_remove(params->pq, obj->Belady.pq_node);
-    my_free(sizeof(pq_node_t), obj->Belady.pq_node);
-    obj->Belady.pq_node = NULL;
+    pqueue_remove(params->pq, CACHE_OBJ_MEMBER(cache, obj, Belady).pq_node);
+    my_free(sizeof(pq_node_t), CACHE_OBJ_MEMBER(cache, obj, Belady).pq_node);
+    CACHE_OBJ_MEMBER(cache, obj, Belady).pq_node = NULL;
   }
 
   cache_remove_obj_base(cache, obj, true);
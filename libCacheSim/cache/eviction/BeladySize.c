@@ -56,6 +56,7 @@ static void BeladySize_remove_obj(cache_t *cache, cache_obj_t *obj);
 cache_t *BeladySize_init(const common_cache_params_t ccache_params,
                          const char *cache_specific_params) {
   cache_t *cache = cache_struct_init("BeladySize", ccache_params, cache_specific_params);
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(Belady));
 
   cache->cache_init = BeladySize_init;
   cache->cache_free = BeladySize_free;
@@ -139,7 +140,8 @@ static cache_obj_t *BeladySize_find(cache_t *cache, const request_t *req,
     if (req->next_access_vtime == -1 || req->next_access_vtime == INT64_MAX) {
       BeladySize_remove(cache, obj->obj_id);
     } else {
-      obj->Belady.next_access_vtime = req->next_access_vtime;
+      CACHE_OBJ_MEMBER(cache, obj, Belady).next_access_vtime =
+          req->next_access_vtime;
     }
   }
 
@@ -162,13 +164,15 @@ static cache_obj_t *BeladySize_insert(cache_t *cache, const request_t *req) {
   }
 
   cache_obj_t *obj = cache_insert_base(cache, req);
-  obj->Belady.next_access_vtime = req->next_access_vtime;
+  CACHE_OBJ_MEMBER(cache, obj, Belady).next_access_vtime =
+      req->next_access_vtime;
 
   return obj;
 }
 
 #ifdef EXACT_Belady
 struct hash_iter_user_data {
+  cache_t *cache;
   uint64_t curr_vtime;
   cache_obj_t *to_evict_obj;
   uint64_t max_score;
@@ -180,12 +184,15 @@ static inline void hashtable_iter_Belady_size(cache_obj_t *cache_obj,
       (struct hash_iter_user_data *)userdata;
   if (iter_userdata->max_score == UINT64_MAX) return;
 
+  int64_t next_access_vtime =
+      CACHE_OBJ_MEMBER(iter_userdata->cache, cache_obj, Belady)
+          .next_access_vtime;
   uint64_t obj_score;
-  if (cache_obj->Belady.next_access_vtime == -1)
+  if (next_access_vtime == -1)
     obj_score = UINT64_MAX;
   else
-    obj_score = cache_obj->obj_size * (cache_obj->Belady.next_access_vtime -
-                                       iter_userdata->curr_vtime);
+    obj_score = cache_obj->obj_size *
+                (next_access_vtime - iter_userdata->curr_vtime);
 
   if (obj_score > iter_userdata->max_score) {
     iter_userdata->to_evict_obj = cache_obj;
@@ -205,6 +212,7 @@ static inline void hashtable_iter_Belady_size(cache_obj_t *cache_obj,
  */
 static cache_obj_t *BeladySize_to_evict(cache_t *cache, const request_t *req) {
   struct hash_iter_user_data iter_userdata;
+  iter_userdata.cache = cache;
   iter_userdata.curr_vtime = cache->n_req;
   iter_userdata.max_score = 0;
   iter_userdata.to_evict_obj = NULL;
@@ -224,7 +232,9 @@ static cache_obj_t *BeladySize_to_evict(cache_t *cache, const request_t *req) {
     sampled_obj = hashtable_rand_obj(cache->hashtable);
     sampled_obj_score =
         (int64_t)sampled_obj->obj_size *
-        (int64_t)(sampled_obj->Belady.next_access_vtime - cache->n_req);
+        (int64_t)(CACHE_OBJ_MEMBER(cache, sampled_obj, Belady)
+                      .next_access_vtime -
+                  cache->n_req);
     if (obj_to_evict_score < sampled_obj_score) {
       obj_to_evict = sampled_obj;
       obj_to_evict_score = sampled_obj_score;
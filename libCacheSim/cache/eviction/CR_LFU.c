@@ -62,6 +62,9 @@ cache_t *CR_LFU_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  /* the objects use both lfu and CR_LFU */
+  cache_set_obj_struct_size(
+      cache, MAX(CACHE_OBJ_SIZE_WITH(lfu), CACHE_OBJ_SIZE_WITH(CR_LFU)));
 
   CR_LFU_params_t *params = my_malloc_n(CR_LFU_params_t, 1);
   cache->eviction_params = params;
@@ -143,33 +146,34 @@ static cache_obj_t *CR_LFU_find(cache_t *cache, const request_t *req,
 
   if (cache_obj && likely(update_cache)) {
     CR_LFU_params_t *params = (CR_LFU_params_t *)(cache->eviction_params);
+    LFU_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, lfu);
     /* freq incr and move to next freq node */
-    cache_obj->lfu.freq += 1;
-    if (params->max_freq < cache_obj->lfu.freq) {
-      params->max_freq = cache_obj->lfu.freq;
+    md->freq += 1;
+    if (params->max_freq < md->freq) {
+      params->max_freq = md->freq;
     }
 
     // find the freq_node this object belongs to and update its info
     freq_node_t *old_node = g_hash_table_lookup(
-        params->freq_map, GSIZE_TO_POINTER(cache_obj->lfu.freq - 1));
+        params->freq_map, GSIZE_TO_POINTER(md->freq - 1));
     DEBUG_ASSERT(old_node != NULL);
-    DEBUG_ASSERT(old_node->freq == cache_obj->lfu.freq - 1);
+    DEBUG_ASSERT(old_node->freq == md->freq - 1);
     DEBUG_ASSERT(old_node->n_obj > 0);
     old_node->n_obj -= 1;
     remove_obj_from_list(&old_node->first_obj, &old_node->last_obj, cache_obj);
 
     // find the new freq_node this object should move to
     freq_node_t *new_node = g_hash_table_lookup(
-        params->freq_map, GSIZE_TO_POINTER(cache_obj->lfu.freq));
+        params->freq_map, GSIZE_TO_POINTER(md->freq));
     if (new_node == NULL) {
       new_node = my_malloc_n(freq_node_t, 1);
       memset(new_node, 0, sizeof(freq_node_t));
-      new_node->freq = cache_obj->lfu.freq;
+      new_node->freq = md->freq;
       g_hash_table_insert(params->freq_map,
-                          GSIZE_TO_POINTER(cache_obj->lfu.freq), new_node);
+                          GSIZE_TO_POINTER(md->freq), new_node);
     } else {
       // it could be new_node is empty
-      DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
+      DEBUG_ASSERT(new_node->freq == md->freq);
     }
 
     /* add to tail of the list */
@@ -221,7 +225,8 @@ static cache_obj_t *CR_LFU_find(cache_t *cache, const request_t *req,
 static cache_obj_t *CR_LFU_insert(cache_t *cache, const request_t *req) {
   CR_LFU_params_t *params = (CR_LFU_params_t *)(cache->eviction_params);
   cache_obj_t *cache_obj = cache_insert_base(cache, req);
-  cache_obj->lfu.freq = 1;
+  LFU_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, lfu);
+  md->freq = 1;
 
   if (params->other_cache) {
     // Check if the requested obj is present in SR-LRU's history
@@ -230,14 +235,15 @@ static cache_obj_t *CR_LFU_insert(cache_t *cache, const request_t *req) {
     DEBUG_ASSERT(p->R_list->find(p->R_list, req, false) == NULL);
     DEBUG_ASSERT(p->SR_list->find(p->SR_list, req, false) == NULL);
     if (obj_other_cache != NULL) {
-      DEBUG_ASSERT(obj_other_cache->CR_LFU.freq >= 1);
+      int64_t freq = CACHE_OBJ_MEMBER(p->H_list, obj_other_cache, CR_LFU).freq;
+      DEBUG_ASSERT(freq >= 1);
       // Load the obj frequency into the current CR-LFU
-      cache_obj->lfu.freq = obj_other_cache->CR_LFU.freq + 1;
+      md->freq = freq + 1;
     }
   }
 
   // If the obj was new, i.e. not inserted in SR_LRU history
-  if (cache_obj->lfu.freq == 1) {
+  if (md->freq == 1) {
     params->min_freq = 1;
     freq_node_t *freq_one_node = params->freq_one_node;
     cache_obj->queue.prev = freq_one_node->last_obj;
@@ -255,16 +261,16 @@ static cache_obj_t *CR_LFU_insert(cache_t *cache, const request_t *req) {
     // find the new freq_node this object should move to
     DEBUG_ASSERT(params->other_cache != NULL);
     freq_node_t *new_node = g_hash_table_lookup(
-        params->freq_map, GSIZE_TO_POINTER(cache_obj->lfu.freq));
+        params->freq_map, GSIZE_TO_POINTER(md->freq));
     if (new_node == NULL) {
       new_node = my_malloc_n(freq_node_t, 1);
       memset(new_node, 0, sizeof(freq_node_t));
-      new_node->freq = cache_obj->lfu.freq;
+      new_node->freq = md->freq;
       g_hash_table_insert(params->freq_map,
-                          GSIZE_TO_POINTER(cache_obj->lfu.freq), new_node);
+                          GSIZE_TO_POINTER(md->freq), new_node);
     } else {
       // it could be new_node is empty
-      DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
+      DEBUG_ASSERT(new_node->freq == md->freq);
     }
     /* add to tail of the list */
     if (new_node->last_obj != NULL) {
@@ -283,15 +289,15 @@ static cache_obj_t *CR_LFU_insert(cache_t *cache, const request_t *req) {
   }
 
   // Update min_freq and max_freq
-  if (params->max_freq < cache_obj->lfu.freq) {
-    params->max_freq = cache_obj->lfu.freq;
+  if (params->max_freq < md->freq) {
+    params->max_freq = md->freq;
   }
-  if (params->min_freq > cache_obj->lfu.freq || params->min_freq == -1) {
+  if (params->min_freq > md->freq || params->min_freq == -1) {
     // when considering object size, it is possible that
     // one object evicts all other objects
     // and it has a frequency more than 1
     // because the history is kept in SR-LRU
-    params->min_freq = cache_obj->lfu.freq;
+    params->min_freq = md->freq;
   }
 
   freq_node_t *min_freq_node =
@@ -329,7 +335,7 @@ static void CR_LFU_evict(cache_t *cache, const request_t *req) {
 
   min_freq_node->n_obj--;
   cache_obj_t *obj_to_evict = min_freq_node->last_obj;
-  copy_cache_obj_to_request(params->req_local, obj_to_evict);
+  copy_cache_obj_to_request(params->req_local, cache, obj_to_evict);
 
   if (params->other_cache) {
     // Before evicting the object, "offload" the obj frequency to history in
@@ -339,7 +345,8 @@ static void CR_LFU_evict(cache_t *cache, const request_t *req) {
     cache_obj_t *obj_other_cache =
         p->H_list->find(p->H_list, params->req_local, false);
     DEBUG_ASSERT(obj_other_cache != NULL);
-    obj_other_cache->CR_LFU.freq = obj_to_evict->lfu.freq;
+    CACHE_OBJ_MEMBER(p->H_list, obj_other_cache, CR_LFU).freq =
+        CACHE_OBJ_MEMBER(cache, obj_to_evict, lfu).freq;
   }
 
   if (obj_to_evict->queue.prev == NULL) {
@@ -391,7 +398,8 @@ static bool CR_LFU_remove(cache_t *cache, const obj_id_t obj_id) {
     return false;
   }
 
-  copy_cache_obj_to_request(params->req_local, obj);
+  int64_t freq = CACHE_OBJ_MEMBER(cache, obj, lfu).freq;
+  copy_cache_obj_to_request(params->req_local, cache, obj);
   if (params->other_cache) {
     // Before evicting the object, "offload" the obj frequency to history in
     // SR-LRU In case in the future history hit, LFU can load that frequency
@@ -402,12 +410,12 @@ static bool CR_LFU_remove(cache_t *cache, const obj_id_t obj_id) {
     // Since we call SR_LRU evict before CR_LFU remove, the obj has to be either
     // in H
     DEBUG_ASSERT(obj_other_cache != NULL);
-    obj_other_cache->CR_LFU.freq = obj->lfu.freq;
+    CACHE_OBJ_MEMBER(p->H_list, obj_other_cache, CR_LFU).freq = freq;
   }
 
   freq_node_t *freq_node =
-      g_hash_table_lookup(params->freq_map, GSIZE_TO_POINTER(obj->lfu.freq));
-  DEBUG_ASSERT(freq_node->freq == obj->lfu.freq);
+      g_hash_table_lookup(params->freq_map, GSIZE_TO_POINTER(freq));
+  DEBUG_ASSERT(freq_node->freq == freq);
   DEBUG_ASSERT(freq_node->n_obj > 0);
 
   freq_node->n_obj--;
@@ -465,7 +473,7 @@ static int _verify(cache_t *cache) {
       prev_obj = NULL;
       while (cache_obj != NULL) {
         n_obj++;
-        DEBUG_ASSERT(cache_obj->lfu.freq == freq);
+        DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, cache_obj, lfu).freq == freq);
         DEBUG_ASSERT(cache_obj->queue.prev == prev_obj);
         prev_obj = cache_obj;
         cache_obj = cache_obj->queue.next;
@@ -49,6 +49,7 @@ static bool Cacheus_remove(cache_t *cache, const obj_id_t obj_id);
 
 static inline int64_t Cacheus_get_occupied_byte(const cache_t *cache);
 static inline int64_t Cacheus_get_n_obj(const cache_t *cache);
+static int64_t Cacheus_get_metadata_bytes(const cache_t *cache);
 
 /* internal functions */
 static void update_weight(cache_t *cache, const request_t *req);
@@ -85,6 +86,7 @@ cache_t *Cacheus_init(const common_cache_params_t ccache_params,
   cache->to_evict = Cacheus_to_evict;
   cache->can_insert = cache_can_insert_default;
   cache->get_n_obj = Cacheus_get_n_obj;
+  cache->get_metadata_bytes = Cacheus_get_metadata_bytes;
   cache->get_occupied_byte = Cacheus_get_occupied_byte;
 
   if (ccache_params.consider_obj_metadata) {
@@ -125,6 +127,9 @@ cache_t *Cacheus_init(const common_cache_params_t ccache_params,
 
   params->LRU_g = LRU_init(ccache_params_g, NULL);  // LRU_history
   params->LFU_g = LRU_init(ccache_params_g, NULL);  // LFU_history
+  /* the history lists keep the metadata of the evicted objects */
+  cache_set_obj_struct_size(params->LRU_g, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->LFU_g, sizeof(cache_obj_t));
   return cache;
 }
 
@@ -291,7 +296,7 @@ static void Cacheus_evict(cache_t *cache, const request_t *req) {
     lru->evict(lru, req);
     lfu->evict(lfu, req);
   } else if (obj_to_evict == lru_to_evict) {
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, lru, obj_to_evict);
     lru->evict(lru, req);
     bool removed = lfu->remove(lfu, params->req_local->obj_id);
     DEBUG_ASSERT(removed);
@@ -301,7 +306,7 @@ static void Cacheus_evict(cache_t *cache, const request_t *req) {
   } else {
     // Remove first because LFU needs to offload the freq to obj in LRU
     // history
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, lfu, obj_to_evict);
     // LRU remove needs to before LFU evict
     bool removed = lru->remove(lru, params->req_local->obj_id);
     DEBUG_ASSERT(removed);
@@ -337,6 +342,16 @@ static inline int64_t Cacheus_get_n_obj(const cache_t *cache) {
   return n_obj;
 }
 
+static int64_t Cacheus_get_metadata_bytes(const cache_t *cache) {
+  Cacheus_params_t *params = (Cacheus_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(Cacheus_params_t) +
+         params->LRU->get_metadata_bytes(params->LRU) +
+         params->LRU_g->get_metadata_bytes(params->LRU_g) +
+         params->LFU->get_metadata_bytes(params->LFU) +
+         params->LFU_g->get_metadata_bytes(params->LFU_g);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                    internal functions                         ****
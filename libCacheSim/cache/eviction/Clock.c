@@ -38,6 +38,9 @@ static cache_obj_t *Clock_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *Clock_to_evict(cache_t *cache, const request_t *req);
 static void Clock_evict(cache_t *cache, const request_t *req);
 static bool Clock_remove(cache_t *cache, const obj_id_t obj_id);
+static bool Clock_save_state(const cache_t *cache, FILE *f);
+static bool Clock_load_state(cache_t *cache, FILE *f);
+static bool Clock_set_params(cache_t *cache, const char *cache_specific_params);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -66,7 +69,11 @@ cache_t *Clock_init(const common_cache_params_t ccache_params,
   cache->get_n_obj = cache_get_n_obj_default;
   cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->to_evict = Clock_to_evict;
+  cache->save_state = Clock_save_state;
+  cache->load_state = Clock_load_state;
+  cache->set_params = Clock_set_params;
   cache->obj_md_size = 0;
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(clock));
 
 #ifdef USE_BELADY
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "Clock_Belady");
@@ -147,8 +154,8 @@ static cache_obj_t *Clock_find(cache_t *cache, const request_t *req,
   Clock_params_t *params = (Clock_params_t *)cache->eviction_params;
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
   if (obj != NULL && update_cache) {
-    if (obj->clock.freq < params->max_freq) {
-      obj->clock.freq += 1;
+    if (CACHE_OBJ_MEMBER(cache, obj, clock).freq < params->max_freq) {
+      CACHE_OBJ_MEMBER(cache, obj, clock).freq += 1;
     }
 #ifdef USE_BELADY
     obj->next_access_vtime = req->next_access_vtime;
@@ -174,7 +181,7 @@ static cache_obj_t *Clock_insert(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = cache_insert_base(cache, req);
   prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
 
-  obj->clock.freq = 0;
+  CACHE_OBJ_MEMBER(cache, obj, clock).freq = 0;
 #ifdef USE_BELADY
   obj->next_access_vtime = req->next_access_vtime;
 #endif
@@ -200,7 +207,7 @@ static cache_obj_t *Clock_to_evict(cache_t *cache, const request_t *req) {
 #ifdef USE_BELADY
   while (obj_to_evict->next_access_vtime != INT64_MAX) {
 #else
-  while (obj_to_evict->clock.freq - n_round >= 1) {
+  while (CACHE_OBJ_MEMBER(cache, obj_to_evict, clock).freq - n_round >= 1) {
 #endif
     obj_to_evict = obj_to_evict->queue.prev;
     if (obj_to_evict == NULL) {
@@ -225,8 +232,8 @@ static void Clock_evict(cache_t *cache, const request_t *req) {
   Clock_params_t *params = (Clock_params_t *)cache->eviction_params;
 
   cache_obj_t *obj_to_evict = params->q_tail;
-  while (obj_to_evict->clock.freq >= 1) {
-    obj_to_evict->clock.freq -= 1;
+  while (CACHE_OBJ_MEMBER(cache, obj_to_evict, clock).freq >= 1) {
+    CACHE_OBJ_MEMBER(cache, obj_to_evict, clock).freq -= 1;
     params->n_obj_rewritten += 1;
     params->n_byte_rewritten += obj_to_evict->obj_size;
     move_obj_to_head(&params->q_head, &params->q_tail, obj_to_evict);
@@ -333,6 +340,52 @@ static void Clock_parse_params(cache_t *cache,
   free(old_params_str);
 }
 
+/* the counters of the objects in the cache are clamped lazily: an object
+ * with a larger count than the new max_freq needs more rounds to be evicted */
+static bool Clock_set_params(cache_t *cache,
+                             const char *cache_specific_params) {
+  Clock_params_t *params = (Clock_params_t *)cache->eviction_params;
+  Clock_parse_params(cache, cache_specific_params);
+  if (params->n_bit_counter != 1) {
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "Clock-%d",
+             params->n_bit_counter);
+  } else {
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "Clock");
+  }
+  return true;
+}
+
+// ***********************************************************************
+// ****                                                               ****
+// ****                       snapshot functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+static bool Clock_save_state(const cache_t *cache, FILE *f) {
+  Clock_params_t *params = (Clock_params_t *)cache->eviction_params;
+  return cache_snapshot_write_tag(f, "Clock") &&
+         fwrite(&params->n_obj_rewritten, sizeof(int64_t), 1, f) == 1 &&
+         fwrite(&params->n_byte_rewritten, sizeof(int64_t), 1, f) == 1 &&
+         cache_save_obj_list(cache, f, params->q_tail);
+}
+
+/* the frequency of each object is restored as is, it is clamped to the
+ * counter of this cache in case n-bit-counter is changed */
+static bool Clock_load_state(cache_t *cache, FILE *f) {
+  Clock_params_t *params = (Clock_params_t *)cache->eviction_params;
+  if (!cache_snapshot_check_tag(f, "Clock") ||
+      fread(&params->n_obj_rewritten, sizeof(int64_t), 1, f) != 1 ||
+      fread(&params->n_byte_rewritten, sizeof(int64_t), 1, f) != 1 ||
+      cache_load_obj_list(cache, f, &params->q_head, &params->q_tail) < 0) {
+    return false;
+  }
+
+  for (cache_obj_t *obj = params->q_head; obj != NULL; obj = obj->queue.next) {
+    CACHE_OBJ_MEMBER(cache, obj, clock).freq =
+        MIN(CACHE_OBJ_MEMBER(cache, obj, clock).freq, params->max_freq);
+  }
+  return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,8 @@ static cache_obj_t *FIFO_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *FIFO_to_evict(cache_t *cache, const request_t *req);
 static void FIFO_evict(cache_t *cache, const request_t *req);
 static bool FIFO_remove(cache_t *cache, const obj_id_t obj_id);
+static bool FIFO_save_state(const cache_t *cache, FILE *f);
+static bool FIFO_load_state(cache_t *cache, FILE *f);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -60,7 +62,11 @@ cache_t *FIFO_init(const common_cache_params_t ccache_params,
   cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->get_n_obj = cache_get_n_obj_default;
   cache->can_insert = cache_can_insert_default;
+  cache->save_state = FIFO_save_state;
+  cache->load_state = FIFO_load_state;
   cache->obj_md_size = 0;
+  /* the objects only need the queue pointers */
+  cache_set_obj_struct_size(cache, CACHE_OBJ_HEADER_SIZE);
 
   cache->eviction_params = malloc(sizeof(FIFO_params_t));
   FIFO_params_t *params = (FIFO_params_t *)cache->eviction_params;
@@ -214,6 +220,23 @@ static bool FIFO_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                       snapshot functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+static bool FIFO_save_state(const cache_t *cache, FILE *f) {
+  FIFO_params_t *params = (FIFO_params_t *)cache->eviction_params;
+  return cache_snapshot_write_tag(f, "FIFO") &&
+         cache_save_obj_list(cache, f, params->q_tail);
+}
+
+static bool FIFO_load_state(cache_t *cache, FILE *f) {
+  FIFO_params_t *params = (FIFO_params_t *)cache->eviction_params;
+  return cache_snapshot_check_tag(f, "FIFO") &&
+         cache_load_obj_list(cache, f, &params->q_head, &params->q_tail) >= 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
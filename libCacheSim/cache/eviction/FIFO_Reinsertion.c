@@ -110,6 +110,7 @@ cache_t *FIFO_Reinsertion_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(FIFO_Reinsertion));
 
   FIFO_Reinsertion_params_t *params = my_malloc(FIFO_Reinsertion_params_t);
   memset(params, 0, sizeof(FIFO_Reinsertion_params_t));
@@ -195,8 +196,10 @@ static cache_obj_t *FIFO_Reinsertion_find(cache_t *cache, const request_t *req,
   cache_obj_t *cache_obj = cache_find_base(cache, req, update_cache);
 
   if (cache_obj && update_cache) {
-    cache_obj->FIFO_Reinsertion.freq++;
-    cache_obj->FIFO_Reinsertion.last_access_vtime = cache->n_req;
+    FIFO_Reinsertion_obj_metadata_t *md =
+        &CACHE_OBJ_MEMBER(cache, cache_obj, FIFO_Reinsertion);
+    md->freq++;
+    md->last_access_vtime = cache->n_req;
     cache_obj->misc.next_access_vtime = req->next_access_vtime;
   }
 
@@ -222,8 +225,10 @@ static cache_obj_t *FIFO_Reinsertion_insert(cache_t *cache,
   cache_obj_t *obj = cache_insert_base(cache, req);
   prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
 
-  obj->FIFO_Reinsertion.freq = 0;
-  obj->FIFO_Reinsertion.last_access_vtime = cache->n_req;
+  FIFO_Reinsertion_obj_metadata_t *md =
+      &CACHE_OBJ_MEMBER(cache, obj, FIFO_Reinsertion);
+  md->freq = 0;
+  md->last_access_vtime = cache->n_req;
   obj->misc.next_access_vtime = req->next_access_vtime;
 
   return obj;
@@ -306,8 +311,8 @@ static void FIFO_Reinsertion_evict(cache_t *cache, const request_t *req) {
   for (int i = n_evict; i < params->n_exam_obj; i++) {
     cache_obj = params->metric_list[i].cache_obj;
     move_obj_to_head(&params->q_head, &params->q_tail, cache_obj);
-    cache_obj->FIFO_Reinsertion.freq =
-        (cache_obj->FIFO_Reinsertion.freq + 1) / 2;
+    CACHE_OBJ_MEMBER(cache, cache_obj, FIFO_Reinsertion).freq =
+        (CACHE_OBJ_MEMBER(cache, cache_obj, FIFO_Reinsertion).freq + 1) / 2;
 
     params->n_obj_rewritten += 1;
     params->n_byte_rewritten += cache_obj->obj_size;
@@ -448,14 +453,14 @@ static inline double freq_metric(cache_t *cache, cache_obj_t *cache_obj) {
   /* we add a small rand number to distinguish objects with frequency 0 or same
    * frequency */
   double r = (double)(next_rand() % 1000) / 10000.0;
-  return 1.0e6 * ((double)cache_obj->FIFO_Reinsertion.freq + r) /
-         (double)cache_obj->obj_size;
+  int32_t freq = CACHE_OBJ_MEMBER(cache, cache_obj, FIFO_Reinsertion).freq;
+  return 1.0e6 * ((double)freq + r) / (double)cache_obj->obj_size;
 }
 
 static inline double recency_metric(cache_t *cache, cache_obj_t *cache_obj) {
-  return 1.0e12 /
-         (double)(cache->n_req -
-                  cache_obj->FIFO_Reinsertion.last_access_vtime) /
+  int32_t last_access_vtime =
+      CACHE_OBJ_MEMBER(cache, cache_obj, FIFO_Reinsertion).last_access_vtime;
+  return 1.0e12 / (double)(cache->n_req - last_access_vtime) /
          (double)cache_obj->obj_size;
 }
 
@@ -42,6 +42,7 @@ static void set_default_params(GLCache_params_t *params) {
   params->rank_intvl = 0.02;
   params->merge_consecutive_segs = true;
   params->retrain_intvl = 86400;
+  params->async_train = false;
   params->train_source_y = TRAIN_Y_FROM_ONLINE;
   params->type = LOGCACHE_LEARNED;
 
@@ -53,7 +54,7 @@ const char *GLCache_default_params(void) {
   return "segment-size=100, n-merge=2, "
          "type=learned, rank-intvl=0.02,"
          "merge-consecutive-segs=true, train-source-y=online,"
-         "retrain-intvl=86400";
+         "retrain-intvl=86400, async-train=false";
 }
 
 static void GLCache_parse_init_params(const char *cache_specific_params,
@@ -76,6 +77,9 @@ static void GLCache_parse_init_params(const char *cache_specific_params,
       params->merge_consecutive_segs = atoi(value);
     } else if (strcasecmp(key, "retrain-intvl") == 0) {
       params->retrain_intvl = atoi(value);
+    } else if (strcasecmp(key, "async-train") == 0) {
+      params->async_train =
+          (strcasecmp(value, "true") == 0 || strcmp(value, "1") == 0);
     } else if (strcasecmp(key, "train-source-y") == 0) {
       if (strcasecmp(value, "online") == 0) {
         params->train_source_y = TRAIN_Y_FROM_ONLINE;
@@ -180,6 +184,11 @@ cache_t *GLCache_init(const common_cache_params_t ccache_params,
   init_learner(cache);
   init_cache_state(cache);
 
+  if (params->async_train && (params->type == LOGCACHE_LEARNED ||
+                              params->type == LOGCACHE_ITEM_ORACLE)) {
+    start_train_worker(cache);
+  }
+
   cache->cache_init = GLCache_init;
   cache->cache_free = GLCache_free;
   cache->get = GLCache_get;
@@ -209,6 +218,8 @@ static void GLCache_free(cache_t *cache) {
   bucket_t *bkt = &params->train_bucket;
   segment_t *seg = bkt->first_seg, *next_seg;
 
+  stop_train_worker(cache);
+
   while (seg != NULL) {
     next_seg = seg->next_seg;
     my_free(sizeof(cache_obj_t) * params->segment_size, seg->objs);
@@ -280,8 +291,14 @@ static bool GLCache_get(cache_t *cache, const request_t *req) {
       params->type == LOGCACHE_ITEM_ORACLE) {
     /* generate training data by taking a snapshot */
     learner_t *l = &params->learner;
+    if (params->async_train) {
+      install_trained_model(cache);
+    }
+    /* with async training, a retrain is delayed until the previous one is
+     * installed */
     if (l->last_train_rtime > 0 &&
-        params->curr_rtime - l->last_train_rtime >= params->retrain_intvl + 1) {
+        params->curr_rtime - l->last_train_rtime >= params->retrain_intvl + 1 &&
+        !l->train_pending) {
       train(cache);
       snapshot_segs_to_training_data(cache);
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <glib.h>
 #include <xgboost/c_api.h>
 
 #include "../../../include/libCacheSim/cache.h"
@@ -73,6 +74,21 @@ typedef struct learner {
   int32_t valid_matrix_n_row;
   int32_t inf_matrix_n_row;
 
+  /* asynchronous training: the request thread snapshots the training data
+   * into next_train_dm/next_valid_dm, a worker thread trains next_booster on
+   * them, and the request thread swaps it in when train_done is set,
+   * booster/train_dm/valid_dm are only used by the request thread */
+  GThread *train_thread;
+  GMutex train_mtx;
+  GCond train_cond;
+  bool train_pending; /* a snapshot is submitted and not installed yet */
+  bool train_stop;
+  gint train_done; /* next_booster is ready, read without the lock */
+  BoosterHandle next_booster;
+  DMatrixHandle next_train_dm;
+  DMatrixHandle next_valid_dm;
+  unsigned int next_n_valid_samples;
+  int next_n_trees;
 } learner_t;
 
 typedef struct cache_state {
@@ -180,6 +196,7 @@ typedef struct {
   // lowest utility) or we merge non-consecutive segments based on ranking
   bool merge_consecutive_segs;
   int retrain_intvl;
+  bool async_train;
   train_source_e train_source_y;
   GLCache_type_e type;
   double rank_intvl;
@@ -279,6 +296,12 @@ void seg_hit_update(GLCache_params_t *params, cache_obj_t *cache_obj);
 /************* learning *****************/
 void train(cache_t *cache);
 
+void start_train_worker(cache_t *cache);
+
+void stop_train_worker(cache_t *cache);
+
+bool install_trained_model(cache_t *cache);
+
 void inference(cache_t *cache);
 
 /************* data preparation *****************/
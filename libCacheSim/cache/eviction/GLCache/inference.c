@@ -5,6 +5,17 @@
 #include "obj.h"
 #include "utils.h"
 
+/* XGBoosterPredictFromDense predicts from the feature matrix directly,
+ * which avoids creating a DMatrix (a copy of the matrix) for each ranking */
+#if defined(__has_include)
+#if __has_include(<xgboost/version_config.h>)
+#include <xgboost/version_config.h>
+#if XGBOOST_VER_MAJOR > 1 || (XGBOOST_VER_MAJOR == 1 && XGBOOST_VER_MINOR >= 6)
+#define PREDICT_FROM_DENSE 1
+#endif
+#endif
+#endif
+
 static inline void resize_matrix(GLCache_params_t *params, feature_t **x_p,
                                  pred_t **y_p, int32_t *size_p,
                                  int64_t new_size) {
@@ -52,15 +63,16 @@ static int prepare_inference_data(cache_t *cache) {
       if (--credit == 0) {
         prepare_one_row(cache, curr_seg, false, &x[learner->n_feature * n_segs],
                         NULL);
-        curr_seg = curr_seg->next_seg;
         n_segs++;
 
         credit = inv_sample_ratio;
       }
+      curr_seg = curr_seg->next_seg;
     }
   }
   DEBUG_ASSERT(inv_sample_ratio > 1 || params->n_in_use_segs == n_segs);
 
+#ifndef PREDICT_FROM_DENSE
   if (params->learner.n_inference > 0) {
     safe_call(XGDMatrixFree(learner->inf_dm));
   }
@@ -68,6 +80,7 @@ static int prepare_inference_data(cache_t *cache) {
                                    learner->n_feature, -2, &learner->inf_dm));
 
   safe_call(XGDMatrixSetUIntInfo(learner->inf_dm, "group", &n_segs, 1));
+#endif
 
   return n_segs;
 }
@@ -88,10 +101,27 @@ void inference_xgboost(cache_t *cache) {
 #endif
 
   bst_ulong out_len = 0;
-  // TODO: use XGBoosterPredictFromDense to avoid copy
-  // https://github.com/dmlc/xgboost/blob/36346f8f563ef79bae94604e60483fb0bf4c2661/demo/c-api/inference/inference.c
+#ifdef PREDICT_FROM_DENSE
+  /* see demo/c-api/inference/inference.c in xgboost */
+  static const char *predict_config =
+      "{\"type\": 0, \"training\": false, \"iteration_begin\": 0, "
+      "\"iteration_end\": 0, \"strict_shape\": false, \"missing\": -2.0}";
+  char array_interface[256];
+  snprintf(array_interface, sizeof(array_interface),
+           "{\"data\": [%lu, true], \"shape\": [%d, %d], "
+           "\"typestr\": \"<f4\", \"version\": 3}",
+           (unsigned long)(uintptr_t)learner->inference_x, n_segs,
+           learner->n_feature);
+  const bst_ulong *out_shape;
+  bst_ulong out_dim;
+  safe_call(XGBoosterPredictFromDense(learner->booster, array_interface,
+                                      predict_config, NULL, &out_shape,
+                                      &out_dim, &pred));
+  out_len = out_shape[0];
+#else
   safe_call(XGBoosterPredict(learner->booster, learner->inf_dm, 0, 0, 0,
                              &out_len, &pred));
+#endif
   DEBUG_ASSERT(out_len == n_segs);
 
   segment_t **ranked_segs = params->seg_sel.ranked_segs;
@@ -19,54 +19,41 @@ static void debug_print_feature_matrix(const DMatrixHandle handle,
   printf("\n");
 }
 
-static void train_xgboost(cache_t *cache) {
-  GLCache_params_t *params = cache->eviction_params;
-  learner_t *learner = &params->learner;
-
-  if (learner->n_train != 0) {
-    safe_call(XGBoosterFree(learner->booster));
-    safe_call(XGDMatrixFree(learner->train_dm));
-    safe_call(XGDMatrixFree(learner->valid_dm));
-  }
-
-  prepare_training_data(cache);
-  // debug_print_feature_matrix(learner->train_dm, 20);
-
-  DMatrixHandle eval_dmats[2] = {learner->train_dm, learner->valid_dm};
+/* train a booster on the given training and validation data,
+ * it does not touch the cache, so it can run on the training worker */
+static BoosterHandle train_xgboost_model(DMatrixHandle train_dm,
+                                         DMatrixHandle valid_dm,
+                                         unsigned int n_valid_samples,
+                                         int *n_trees) {
+  BoosterHandle booster;
+  DMatrixHandle eval_dmats[2] = {train_dm, valid_dm};
   static const char *eval_names[2] = {"train", "valid"};
   const char *eval_result;
   double train_loss, valid_loss, last_valid_loss = 0;
   int n_stable_iter = 0;
 
-  safe_call(XGBoosterCreate(eval_dmats, 1, &learner->booster));
-  safe_call(XGBoosterSetParam(learner->booster, "booster", "gbtree"));
-  safe_call(XGBoosterSetParam(learner->booster, "verbosity", "1"));
-  safe_call(XGBoosterSetParam(learner->booster, "nthread", "1"));
+  safe_call(XGBoosterCreate(eval_dmats, 1, &booster));
+  safe_call(XGBoosterSetParam(booster, "booster", "gbtree"));
+  safe_call(XGBoosterSetParam(booster, "verbosity", "1"));
+  safe_call(XGBoosterSetParam(booster, "nthread", "1"));
 #if OBJECTIVE == REG
-  safe_call(
-      XGBoosterSetParam(learner->booster, "objective", "reg:squarederror"));
+  safe_call(XGBoosterSetParam(booster, "objective", "reg:squarederror"));
 #elif OBJECTIVE == LTR
-  safe_call(XGBoosterSetParam(learner->booster, "objective", "rank:pairwise"));
+  safe_call(XGBoosterSetParam(booster, "objective", "rank:pairwise"));
 #endif
 
   for (int i = 0; i < N_TRAIN_ITER; ++i) {
     // Update the model performance for each iteration
-    safe_call(XGBoosterUpdateOneIter(learner->booster, i, learner->train_dm));
-    if (learner->n_valid_samples < 10) continue;
-    safe_call(XGBoosterEvalOneIter(learner->booster, i, eval_dmats, eval_names,
-                                   2, &eval_result));
+    safe_call(XGBoosterUpdateOneIter(booster, i, train_dm));
+    if (n_valid_samples < 10) continue;
+    safe_call(XGBoosterEvalOneIter(booster, i, eval_dmats, eval_names, 2,
+                                   &eval_result));
 #if OBJECTIVE == REG
     char *train_pos = strstr(eval_result, "train-rmse:") + 11;
     char *valid_pos = strstr(eval_result, "valid-rmse") + 11;
     train_loss = strtof(train_pos, NULL);
     valid_loss = strtof(valid_pos, NULL);
 
-    // DEBUG("%.2lf hour, cache size %.2lf MB, iter %d, train loss %.4lf, valid
-    // loss %.4lf\n",
-    //     (double) params->curr_rtime / 3600.0,
-    //     (double) cache->cache_size / 1024.0 / 1024.0,
-    //     i, train_loss, valid_loss);
-
     if (fabs(last_valid_loss - valid_loss) / valid_loss < 0.01) {
       n_stable_iter += 1;
       if (n_stable_iter > 2) {
@@ -84,10 +71,37 @@ static void train_xgboost(cache_t *cache) {
 #error
 #endif
   }
+
+  *n_trees = 0;
 #ifndef __APPLE__
-  safe_call(XGBoosterBoostedRounds(learner->booster, &learner->n_trees));
+  safe_call(XGBoosterBoostedRounds(booster, n_trees));
 #endif
 
+  return booster;
+}
+
+static void free_model(learner_t *learner) {
+  if (learner->booster != NULL) {
+    safe_call(XGBoosterFree(learner->booster));
+    safe_call(XGDMatrixFree(learner->train_dm));
+    safe_call(XGDMatrixFree(learner->valid_dm));
+    learner->booster = NULL;
+  }
+}
+
+static void train_xgboost(cache_t *cache) {
+  GLCache_params_t *params = cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  free_model(learner);
+
+  prepare_training_data(cache);
+  // debug_print_feature_matrix(learner->train_dm, 20);
+
+  learner->booster =
+      train_xgboost_model(learner->train_dm, learner->valid_dm,
+                          learner->n_valid_samples, &learner->n_trees);
+
   DEBUG(
       "%.2lf hour, cache size %.2lf MB, vtime %ld, train/valid %d/%d samples, "
       "%d trees, "
@@ -107,6 +121,145 @@ static void train_xgboost(cache_t *cache) {
 #endif
 }
 
+static gpointer train_worker(gpointer data) {
+  learner_t *learner = (learner_t *)data;
+
+  g_mutex_lock(&learner->train_mtx);
+  while (true) {
+    while (!learner->train_stop &&
+           !(learner->train_pending && !g_atomic_int_get(&learner->train_done))) {
+      g_cond_wait(&learner->train_cond, &learner->train_mtx);
+    }
+    if (learner->train_stop) {
+      break;
+    }
+
+    /* the request thread does not touch the snapshot while train_pending */
+    DMatrixHandle train_dm = learner->next_train_dm;
+    DMatrixHandle valid_dm = learner->next_valid_dm;
+    unsigned int n_valid_samples = learner->next_n_valid_samples;
+    g_mutex_unlock(&learner->train_mtx);
+
+    int n_trees;
+    BoosterHandle booster =
+        train_xgboost_model(train_dm, valid_dm, n_valid_samples, &n_trees);
+
+    g_mutex_lock(&learner->train_mtx);
+    learner->next_booster = booster;
+    learner->next_n_trees = n_trees;
+    g_atomic_int_set(&learner->train_done, 1);
+  }
+  g_mutex_unlock(&learner->train_mtx);
+
+  return NULL;
+}
+
+void start_train_worker(cache_t *cache) {
+  GLCache_params_t *params = (GLCache_params_t *)cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  g_mutex_init(&learner->train_mtx);
+  g_cond_init(&learner->train_cond);
+  learner->train_pending = false;
+  learner->train_stop = false;
+  learner->train_done = 0;
+  learner->train_thread = g_thread_new("GLCache-train", train_worker, learner);
+}
+
+void stop_train_worker(cache_t *cache) {
+  GLCache_params_t *params = (GLCache_params_t *)cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  if (learner->train_thread == NULL) {
+    return;
+  }
+
+  /* wait for the training in progress (if any) to finish */
+  g_mutex_lock(&learner->train_mtx);
+  learner->train_stop = true;
+  g_cond_signal(&learner->train_cond);
+  g_mutex_unlock(&learner->train_mtx);
+  g_thread_join(learner->train_thread);
+  learner->train_thread = NULL;
+
+  if (learner->train_pending) {
+    if (g_atomic_int_get(&learner->train_done)) {
+      safe_call(XGBoosterFree(learner->next_booster));
+    }
+    safe_call(XGDMatrixFree(learner->next_train_dm));
+    safe_call(XGDMatrixFree(learner->next_valid_dm));
+    learner->train_pending = false;
+  }
+  free_model(learner);
+
+  g_mutex_clear(&learner->train_mtx);
+  g_cond_clear(&learner->train_cond);
+}
+
+/**
+ * @brief swap in the model trained by the worker if it is ready
+ *
+ * @return true if a new model is installed
+ */
+bool install_trained_model(cache_t *cache) {
+  GLCache_params_t *params = (GLCache_params_t *)cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  if (!g_atomic_int_get(&learner->train_done)) {
+    return false;
+  }
+
+  free_model(learner);
+
+  g_mutex_lock(&learner->train_mtx);
+  learner->booster = learner->next_booster;
+  learner->train_dm = learner->next_train_dm;
+  learner->valid_dm = learner->next_valid_dm;
+  learner->n_trees = learner->next_n_trees;
+  learner->next_booster = NULL;
+  learner->train_pending = false;
+  g_atomic_int_set(&learner->train_done, 0);
+  g_mutex_unlock(&learner->train_mtx);
+
+  learner->n_train += 1;
+  /* re-rank the segments with the new model */
+  params->seg_sel.ranked_seg_pos = INT32_MAX;
+
+  DEBUG("%.2lf hour, cache size %.2lf MB, vtime %ld, install model %d, %d trees\n",
+        (double)params->curr_rtime / 3600.0,
+        (double)cache->cache_size / 1024.0 / 1024.0, (long)params->curr_vtime,
+        learner->n_train, learner->n_trees);
+
+  return true;
+}
+
+/* snapshot the training data and hand it to the training worker,
+ * the caller makes sure the worker is not busy */
+static void submit_training_data(cache_t *cache) {
+  GLCache_params_t *params = (GLCache_params_t *)cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  /* train_pending is only set and cleared by the request thread */
+  DEBUG_ASSERT(!learner->train_pending);
+
+  /* prepare_training_data writes the DMatrix to train_dm/valid_dm,
+   * which belong to the installed model, so we save and restore them */
+  DMatrixHandle curr_train_dm = learner->train_dm;
+  DMatrixHandle curr_valid_dm = learner->valid_dm;
+  prepare_training_data(cache);
+
+  g_mutex_lock(&learner->train_mtx);
+  learner->next_train_dm = learner->train_dm;
+  learner->next_valid_dm = learner->valid_dm;
+  learner->next_n_valid_samples = learner->n_valid_samples;
+  learner->train_pending = true;
+  g_cond_signal(&learner->train_cond);
+  g_mutex_unlock(&learner->train_mtx);
+
+  learner->train_dm = curr_train_dm;
+  learner->valid_dm = curr_valid_dm;
+}
+
 void train(cache_t *cache) {
   GLCache_params_t *params = (GLCache_params_t *)cache->eviction_params;
 
@@ -118,14 +271,20 @@ void train(cache_t *cache) {
 
     safe_call(XGBoosterLoadModel(learner->booster, s));
     INFO("Load model %s\n", s);
+    params->learner.n_train += 1;
   }
 #else
-  train_xgboost(cache);
+  if (params->async_train) {
+    /* n_train is increased when the model is installed */
+    submit_training_data(cache);
+  } else {
+    train_xgboost(cache);
+    params->learner.n_train += 1;
+  }
 #endif
 
   uint64_t end_time = gettime_usec();
   // INFO("training time %.4lf sec\n", (end_time - start_time) / 1000000.0);
-  params->learner.n_train += 1;
   params->learner.last_train_rtime = params->curr_rtime;
   params->learner.n_train_samples = 0;
   params->learner.n_valid_samples = 0;
@@ -70,6 +70,7 @@ cache_t *Hyperbolic_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(hyperbolic));
 
   return cache;
 }
@@ -130,7 +131,7 @@ static cache_obj_t *Hyperbolic_find(cache_t *cache, const request_t *req,
   cache_obj_t *cache_obj = cache_find_base(cache, req, update_cache);
 
   if (update_cache && cache_obj) {
-    cache_obj->hyperbolic.freq++;
+    CACHE_OBJ_MEMBER(cache, cache_obj, hyperbolic).freq++;
   }
 
   return cache_obj;
@@ -148,8 +149,10 @@ static cache_obj_t *Hyperbolic_find(cache_t *cache, const request_t *req,
  */
 static cache_obj_t *Hyperbolic_insert(cache_t *cache, const request_t *req) {
   cache_obj_t *cached_obj = cache_insert_base(cache, req);
-  cached_obj->hyperbolic.freq = 1;
-  cached_obj->hyperbolic.vtime_enter_cache = cache->n_req;
+  Hyperbolic_obj_metadata_t *md =
+      &CACHE_OBJ_MEMBER(cache, cached_obj, hyperbolic);
+  md->freq = 1;
+  md->vtime_enter_cache = cache->n_req;
 
   return cached_obj;
 }
@@ -170,9 +173,10 @@ static cache_obj_t *Hyperbolic_to_evict(cache_t *cache, const request_t *req) {
   double best_candidate_score = 1.0e16, sampled_obj_score;
   for (int i = 0; i < params->n_sample; i++) {
     sampled_obj = hashtable_rand_obj(cache->hashtable);
-    double age =
-        (double)(cache->n_req - sampled_obj->hyperbolic.vtime_enter_cache);
-    sampled_obj_score = 1.0e8 * (double)sampled_obj->hyperbolic.freq / age;
+    Hyperbolic_obj_metadata_t *md =
+        &CACHE_OBJ_MEMBER(cache, sampled_obj, hyperbolic);
+    double age = (double)(cache->n_req - md->vtime_enter_cache);
+    sampled_obj_score = 1.0e8 * (double)md->freq / age;
     if (best_candidate_score > sampled_obj_score) {
       best_candidate = sampled_obj;
       best_candidate_score = sampled_obj_score;
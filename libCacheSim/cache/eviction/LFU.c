@@ -53,6 +53,7 @@ static cache_obj_t *LFU_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *LFU_to_evict(cache_t *cache, const request_t *req);
 static void LFU_evict(cache_t *cache, const request_t *req);
 static bool LFU_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t LFU_get_metadata_bytes(const cache_t *cache);
 static void LFU_remove_obj(cache_t *cache, cache_obj_t *obj);
 
 /* internal functions */
@@ -83,6 +84,7 @@ cache_t *LFU_init(const common_cache_params_t ccache_params,
   cache->insert = LFU_insert;
   cache->evict = LFU_evict;
   cache->remove = LFU_remove;
+  cache->get_metadata_bytes = LFU_get_metadata_bytes;
   cache->to_evict = LFU_to_evict;
 
   if (ccache_params.consider_obj_metadata) {
@@ -90,6 +92,7 @@ cache_t *LFU_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(lfu));
 
   LFU_params_t *params = my_malloc_n(LFU_params_t, 1);
   memset(params, 0, sizeof(LFU_params_t));
@@ -124,6 +127,12 @@ static void LFU_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t LFU_get_metadata_bytes(const cache_t *cache) {
+  LFU_params_t *params = (LFU_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) + (int64_t)sizeof(LFU_params_t) +
+         FREQ_MAP_GET_METADATA_BYTES(params->freq_map);
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -169,34 +178,35 @@ static cache_obj_t *LFU_find(cache_t *cache, const request_t *req,
   cache_obj_t *cache_obj = cache_find_base(cache, req, update_cache);
 
   if (cache_obj && likely(update_cache)) {
+    LFU_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, lfu);
     /* freq incr and move to next freq node */
-    cache_obj->lfu.freq += 1;
-    if (params->max_freq < cache_obj->lfu.freq) {
-      params->max_freq = cache_obj->lfu.freq;
+    md->freq += 1;
+    if (params->max_freq < md->freq) {
+      params->max_freq = md->freq;
     }
 
     // find the freq_node this object belongs to and update its info
-    gpointer old_key = GSIZE_TO_POINTER(cache_obj->lfu.freq - 1);
+    gpointer old_key = GSIZE_TO_POINTER(md->freq - 1);
     freq_node_t *old_node = g_hash_table_lookup(params->freq_map, old_key);
     DEBUG_ASSERT(old_node != NULL);
-    DEBUG_ASSERT(old_node->freq == cache_obj->lfu.freq - 1);
+    DEBUG_ASSERT(old_node->freq == md->freq - 1);
     DEBUG_ASSERT(old_node->n_obj > 0);
     old_node->n_obj -= 1;
     remove_obj_from_list(&old_node->first_obj, &old_node->last_obj, cache_obj);
 
     // find the new freq_node this object should move to
-    gpointer new_key = GSIZE_TO_POINTER(cache_obj->lfu.freq);
+    gpointer new_key = GSIZE_TO_POINTER(md->freq);
     freq_node_t *new_node = g_hash_table_lookup(params->freq_map, new_key);
     if (new_node == NULL) {
       new_node = my_malloc_n(freq_node_t, 1);
       memset(new_node, 0, sizeof(freq_node_t));
-      new_node->freq = cache_obj->lfu.freq;
+      new_node->freq = md->freq;
       g_hash_table_insert(params->freq_map, new_key, new_node);
       VVVERBOSE("allocate new %ld %d %p %p\n", new_node->freq, new_node->n_obj,
                 new_node->first_obj, new_node->last_obj);
     } else {
       // it could be new_node is empty
-      DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
+      DEBUG_ASSERT(new_node->freq == md->freq);
     }
 
     append_obj_to_tail(&new_node->first_obj, &new_node->last_obj, cache_obj);
@@ -234,7 +244,7 @@ static cache_obj_t *LFU_insert(cache_t *cache, const request_t *req) {
   freq_node_t *freq_one_node = params->freq_one_node;
 
   cache_obj_t *cache_obj = cache_insert_base(cache, req);
-  cache_obj->lfu.freq = 1;
+  CACHE_OBJ_MEMBER(cache, cache_obj, lfu).freq = 1;
   freq_one_node->n_obj += 1;
 
   append_obj_to_tail(&freq_one_node->first_obj, &freq_one_node->last_obj,
@@ -295,9 +305,9 @@ void LFU_remove_obj(cache_t *cache, cache_obj_t *obj) {
   assert(obj != NULL);
   LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
 
-  gpointer key = GSIZE_TO_POINTER(obj->lfu.freq);
+  gpointer key = GSIZE_TO_POINTER(CACHE_OBJ_MEMBER(cache, obj, lfu).freq);
   freq_node_t *freq_node = g_hash_table_lookup(params->freq_map, key);
-  DEBUG_ASSERT(freq_node->freq == obj->lfu.freq);
+  DEBUG_ASSERT(freq_node->freq == CACHE_OBJ_MEMBER(cache, obj, lfu).freq);
   DEBUG_ASSERT(freq_node->n_obj > 0);
 
   freq_node->n_obj--;
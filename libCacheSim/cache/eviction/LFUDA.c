@@ -36,6 +36,7 @@ static cache_obj_t *LFUDA_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *LFUDA_to_evict(cache_t *cache, const request_t *req);
 static void LFUDA_evict(cache_t *cache, const request_t *req);
 static bool LFUDA_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t LFUDA_get_metadata_bytes(const cache_t *cache);
 static void LFUDA_remove_obj(cache_t *cache, cache_obj_t *obj);
 
 /* internal functions */
@@ -66,6 +67,7 @@ cache_t *LFUDA_init(const common_cache_params_t ccache_params,
   cache->insert = LFUDA_insert;
   cache->evict = LFUDA_evict;
   cache->remove = LFUDA_remove;
+  cache->get_metadata_bytes = LFUDA_get_metadata_bytes;
   cache->to_evict = LFUDA_to_evict;
 
   if (ccache_params.consider_obj_metadata) {
@@ -73,6 +75,7 @@ cache_t *LFUDA_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(lfu));
 
   LFUDA_params_t *params = my_malloc_n(LFUDA_params_t, 1);
   cache->eviction_params = params;
@@ -105,6 +108,12 @@ static void LFUDA_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t LFUDA_get_metadata_bytes(const cache_t *cache) {
+  LFUDA_params_t *params = (LFUDA_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) + (int64_t)sizeof(LFUDA_params_t) +
+         FREQ_MAP_GET_METADATA_BYTES(params->freq_map);
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -150,16 +159,17 @@ static cache_obj_t *LFUDA_find(cache_t *cache, const request_t *req,
   cache_obj_t *cache_obj = cache_find_base(cache, req, update_cache);
 
   if (cache_obj && likely(update_cache)) {
+    LFU_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, lfu);
     /* freq incr and move to next freq node */
-    cache_obj->lfu.freq += params->min_freq;
-    params->max_freq = params->max_freq < cache_obj->lfu.freq
-                           ? cache_obj->lfu.freq
+    md->freq += params->min_freq;
+    params->max_freq = params->max_freq < md->freq
+                           ? md->freq
                            : params->max_freq;
 
-    gpointer old_key = GSIZE_TO_POINTER(cache_obj->lfu.freq - params->min_freq);
+    gpointer old_key = GSIZE_TO_POINTER(md->freq - params->min_freq);
     freq_node_t *old_node = g_hash_table_lookup(params->freq_map, old_key);
     DEBUG_ASSERT(old_node != NULL);
-    DEBUG_ASSERT(old_node->freq == cache_obj->lfu.freq - params->min_freq);
+    DEBUG_ASSERT(old_node->freq == md->freq - params->min_freq);
     DEBUG_ASSERT(old_node->n_obj > 0);
     old_node->n_obj--;
     remove_obj_from_list(&old_node->first_obj, &old_node->last_obj, cache_obj);
@@ -172,18 +182,18 @@ static cache_obj_t *LFUDA_find(cache_t *cache, const request_t *req,
       update_min_freq(params);
     }
 
-    gpointer new_key = GSIZE_TO_POINTER(cache_obj->lfu.freq);
+    gpointer new_key = GSIZE_TO_POINTER(md->freq);
     freq_node_t *new_node = g_hash_table_lookup(params->freq_map, new_key);
     if (new_node == NULL) {
       new_node = my_malloc_n(freq_node_t, 1);
       memset(new_node, 0, sizeof(freq_node_t));
-      new_node->freq = cache_obj->lfu.freq;
+      new_node->freq = md->freq;
       g_hash_table_insert(params->freq_map, new_key, new_node);
       VVVERBOSE("allocate new %ld %d %p %p\n", new_node->freq, new_node->n_obj,
                 new_node->first_obj, new_node->last_obj);
     } else {
       // it could be new_node is empty
-      DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
+      DEBUG_ASSERT(new_node->freq == md->freq);
     }
 
     append_obj_to_tail(&new_node->first_obj, &new_node->last_obj, cache_obj);
@@ -207,17 +217,18 @@ static cache_obj_t *LFUDA_find(cache_t *cache, const request_t *req,
 static cache_obj_t *LFUDA_insert(cache_t *cache, const request_t *req) {
   LFUDA_params_t *params = (LFUDA_params_t *)(cache->eviction_params);
   cache_obj_t *cache_obj = cache_insert_base(cache, req);
-  cache_obj->lfu.freq = params->min_freq + 1;
+  LFU_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, lfu);
+  md->freq = params->min_freq + 1;
 
-  gpointer key = GSIZE_TO_POINTER(cache_obj->lfu.freq);
+  gpointer key = GSIZE_TO_POINTER(md->freq);
   freq_node_t *new_node = g_hash_table_lookup(params->freq_map, key);
   if (new_node == NULL) {
     new_node = my_malloc_n(freq_node_t, 1);
     memset(new_node, 0, sizeof(freq_node_t));
-    new_node->freq = cache_obj->lfu.freq;
+    new_node->freq = md->freq;
     g_hash_table_insert(params->freq_map, key, new_node);
   } else {
-    DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
+    DEBUG_ASSERT(new_node->freq == md->freq);
   }
 
   append_obj_to_tail(&new_node->first_obj, &new_node->last_obj, cache_obj);
@@ -278,9 +289,9 @@ static void LFUDA_remove_obj(cache_t *cache, cache_obj_t *obj) {
   assert(obj != NULL);
   LFUDA_params_t *params = (LFUDA_params_t *)(cache->eviction_params);
 
-  gpointer key = GSIZE_TO_POINTER(obj->lfu.freq);
+  gpointer key = GSIZE_TO_POINTER(CACHE_OBJ_MEMBER(cache, obj, lfu).freq);
   freq_node_t *freq_node = g_hash_table_lookup(params->freq_map, key);
-  DEBUG_ASSERT(freq_node->freq == obj->lfu.freq);
+  DEBUG_ASSERT(freq_node->freq == CACHE_OBJ_MEMBER(cache, obj, lfu).freq);
   DEBUG_ASSERT(freq_node->n_obj > 0);
 
   freq_node->n_obj--;
@@ -374,7 +385,7 @@ static int _verify(cache_t *cache) {
       prev_obj = NULL;
       while (cache_obj != NULL) {
         n_obj++;
-        DEBUG_ASSERT(cache_obj->lfu.freq == freq);
+        DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, cache_obj, lfu).freq == freq);
         DEBUG_ASSERT(cache_obj->queue.prev == prev_obj);
         prev_obj = cache_obj;
         cache_obj = cache_obj->queue.next;
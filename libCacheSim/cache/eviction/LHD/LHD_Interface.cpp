@@ -4,7 +4,6 @@
 
 #include "../../../dataStructure/hashtable/hashtable.h"
 #include "lhd.hpp"
-#include "repl.hpp"
 
 using namespace repl;
 
@@ -18,7 +17,7 @@ typedef struct {
   int associativity;
   int admission;
 
-  candidate_t to_evict_candidate;
+  cache_obj_t *to_evict_candidate;
 } LHD_params_t;
 
 // ***********************************************************************
@@ -74,11 +73,10 @@ cache_t *LHD_init(const common_cache_params_t ccache_params,
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = LHD_get_occupied_byte;
   cache->get_n_obj = LHD_get_n_obj;
-  cache->to_evict_candidate =
-      static_cast<cache_obj_t *>(malloc(sizeof(cache_obj_t)));
 
   if (ccache_params.consider_obj_metadata) {
-    cache->obj_md_size = 8 * 3 + 1;  // two age, one time stamp
+    // one time stamp, two hit ages, one class id and the explorer flag
+    cache->obj_md_size = 8 + 2 * 2 + 1 + 1;
   } else {
     cache->obj_md_size = 0;
   }
@@ -109,7 +107,6 @@ static void LHD_free(cache_t *cache) {
   auto *params = static_cast<LHD_params_t *>(cache->eviction_params);
   auto *lhd = static_cast<repl::LHD *>(params->LHD_cache);
   delete lhd;
-  free(cache->to_evict_candidate);
   my_free(sizeof(LHD_params_t), params);
   cache_struct_free(cache);
 }
@@ -158,24 +155,19 @@ static cache_obj_t *LHD_find(cache_t *cache, const request_t *req,
   auto *params = static_cast<LHD_params_t *>(cache->eviction_params);
   auto *lhd = static_cast<repl::LHD *>(params->LHD_cache);
 
-  auto id = repl::candidate_t::make(req);
-  auto itr = lhd->sizeMap.find(id);
-  bool hit = (itr != lhd->sizeMap.end());
-
-  if (!hit) {
-    return NULL;
+  cache_obj_t *obj = cache_find_base(cache, req, update_cache);
+  if (obj == NULL || !update_cache) {
+    return obj;
   }
 
-  if (update_cache) {
-    if (itr->second != req->obj_size) {
-      cache->occupied_byte -= itr->second;
-      cache->occupied_byte += req->obj_size;
-      itr->second = req->obj_size;
-    }
-    lhd->update(id, req);
+  lhd->update(obj, req, false);
+  if (obj->obj_size != req->obj_size) {
+    cache->occupied_byte -= obj->obj_size;
+    cache->occupied_byte += req->obj_size;
+    obj->obj_size = req->obj_size;
   }
 
-  return reinterpret_cast<cache_obj_t *>(0x1);
+  return obj;
 }
 
 /**
@@ -192,19 +184,10 @@ static cache_obj_t *LHD_find(cache_t *cache, const request_t *req,
 static cache_obj_t *LHD_insert(cache_t *cache, const request_t *req) {
   auto *params = static_cast<LHD_params_t *>(cache->eviction_params);
   auto *lhd = static_cast<repl::LHD *>(params->LHD_cache);
-  auto id = repl::candidate_t::make(req);
-
-#if defined(TRACK_EVICTION_V_AGE)
-  id.create_time = CURR_TIME(cache, req);
-#endif
-
-  lhd->sizeMap[id] = req->obj_size;
-  lhd->update(id, req);
+  cache_obj_t *obj = cache_insert_base(cache, req);
+  lhd->update(obj, req, true);
 
-  cache->occupied_byte += req->obj_size + cache->obj_md_size;
-  cache->n_obj += 1;
-
-  return NULL;
+  return obj;
 }
 
 /**
@@ -224,14 +207,8 @@ static cache_obj_t *LHD_to_evict(cache_t *cache, const request_t *req) {
 
   cache->to_evict_candidate_gen_vtime = cache->n_req;
 
-  repl::candidate_t victim = lhd->rank(req);
-  auto victimItr = lhd->sizeMap.find(victim);
-  assert(victimItr != lhd->sizeMap.end());
-
-  params->to_evict_candidate = victim;
-
-  cache->to_evict_candidate->obj_id = victim.id;
-  cache->to_evict_candidate->obj_size = victimItr->second;
+  params->to_evict_candidate = lhd->rank(req);
+  cache->to_evict_candidate = params->to_evict_candidate;
 
   return cache->to_evict_candidate;
 }
@@ -249,7 +226,7 @@ static void LHD_evict(cache_t *cache, const request_t *req) {
   auto *params = static_cast<LHD_params_t *>(cache->eviction_params);
   auto *lhd = static_cast<repl::LHD *>(params->LHD_cache);
 
-  repl::candidate_t victim;
+  cache_obj_t *victim;
   if (cache->to_evict_candidate_gen_vtime == cache->n_req) {
     victim = params->to_evict_candidate;
     cache->to_evict_candidate_gen_vtime = -1;
@@ -257,29 +234,8 @@ static void LHD_evict(cache_t *cache, const request_t *req) {
     victim = lhd->rank(req);
   }
 
-  auto victimItr = lhd->sizeMap.find(victim);
-  if (victimItr == lhd->sizeMap.end()) {
-    std::cerr << "Couldn't find victim: " << victim << std::endl;
-  }
-  assert(victimItr != lhd->sizeMap.end());
-
-  DEBUG_ASSERT(cache->occupied_byte >= victimItr->second);
-  cache->occupied_byte -= (victimItr->second + cache->obj_md_size);
-  cache->n_obj -= 1;
-
-#if defined(TRACK_EVICTION_V_AGE)
-  {
-    cache_obj_t obj;
-    obj.obj_id = victim.id;
-    obj.create_time = victim.create_time;
-    record_eviction_age(cache, &obj,
-                        CURR_TIME(cache, req) - victim.create_time);
-  }
-#endif
-
-
   lhd->replaced(victim);
-  lhd->sizeMap.erase(victimItr);
+  cache_evict_base(cache, victim, true);
 }
 
 /**
@@ -298,24 +254,13 @@ static void LHD_evict(cache_t *cache, const request_t *req) {
 static bool LHD_remove(cache_t *cache, const obj_id_t obj_id) {
   auto *params = static_cast<LHD_params_t *>(cache->eviction_params);
   auto *lhd = static_cast<repl::LHD *>(params->LHD_cache);
-  repl::candidate_t id{DEFAULT_APP_ID, (int64_t)obj_id};
-
-  auto itr = lhd->sizeMap.find(id);
-  if (itr == lhd->sizeMap.end()) {
+  cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
+  if (obj == NULL) {
     return false;
   }
 
-  cache->occupied_byte -= (itr->second + cache->obj_md_size);
-  cache->n_obj -= 1;
-  lhd->sizeMap.erase(itr);
-  auto idx = lhd->indices[id];
-  lhd->indices.erase(id);
-  lhd->tags[idx] = lhd->tags.back();
-  lhd->tags.pop_back();
-
-  if (idx < lhd->tags.size()) {
-    lhd->indices[lhd->tags[idx].id] = idx;
-  }
+  lhd->removed(obj);
+  cache_remove_obj_base(cache, obj, true);
 
   return true;
 }
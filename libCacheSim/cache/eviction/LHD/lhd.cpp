@@ -1,7 +1,14 @@
 #include "lhd.hpp"
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
 #include <sstream>
 
+#include "../../../dataStructure/hashtable/hashtable.h"
 #include "../../../utils/include/mymath.h"
 #include "constants.hpp"
 
@@ -11,7 +18,7 @@ LHD::LHD(int _associativity, int _admissions, cache_t* _cache)
     : ASSOCIATIVITY(_associativity),
       ADMISSIONS(_admissions),
       cache(_cache),
-      recentlyAdmitted(ADMISSIONS, INVALID_CANDIDATE) {
+      recentlyAdmitted(ADMISSIONS, INVALID_OBJ_ID) {
   nextReconfiguration = ACCS_PER_RECONFIGURATION;
   explorerBudget = cache->cache_size * EXPLORER_BUDGET_FRACTION;
 
@@ -20,21 +27,74 @@ LHD::LHD(int _associativity, int _admissions, cache_t* _cache)
     auto& cl = classes.back();
     cl.hits.resize(MAX_AGE, 0);
     cl.evictions.resize(MAX_AGE, 0);
-    cl.hitDensities.resize(MAX_AGE, 0);
   }
+  hitDensities.resize(NUM_CLASSES * MAX_AGE, 0);
 
   // Initialize policy to ~GDSF by default.
   // jason: why is this GDSF? and why the index of class is used in density
   for (uint32_t c = 0; c < NUM_CLASSES; c++) {
     for (age_t a = 0; a < MAX_AGE; a++) {
-      classes[c].hitDensities[a] = 1. * (c + 1) / (a + 1);
+      hitDensities[c * MAX_AGE + a] = 1. * (c + 1) / (a + 1);
     }
   }
+
+  uint32_t maxCandidates = std::max(ASSOCIATIVITY, 8u) + ADMISSIONS;
+  candObjs.resize(maxCandidates);
+  candIdx.resize(maxCandidates);
+  candSize.resize(maxCandidates);
+  candBonus.resize(maxCandidates);
+  candRank.resize(maxCandidates);
 }
 
-candidate_t LHD::rank(const request_t* req) {
-  uint64_t victim = -1;
-  rank_t victimRank = std::numeric_limits<rank_t>::max();
+void LHD::computeCandidateRanks(uint32_t n) {
+  const rank_t* densities = hitDensities.data();
+  uint32_t i = 0;
+
+  // a negative index means the age has overflowed, such objects are
+  // evicted first
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256 lowest = _mm256_set1_ps(std::numeric_limits<rank_t>::lowest());
+  for (; i + 8 <= n; i += 8) {
+    __m256i idx = _mm256_loadu_si256((const __m256i*)&candIdx[i]);
+    __m256 overflow = _mm256_castsi256_ps(_mm256_cmpgt_epi32(zero, idx));
+    __m256 density =
+        _mm256_i32gather_ps(densities, _mm256_max_epi32(idx, zero), 4);
+    density = _mm256_div_ps(density, _mm256_loadu_ps(&candSize[i]));
+    density = _mm256_add_ps(density, _mm256_loadu_ps(&candBonus[i]));
+    _mm256_storeu_ps(&candRank[i],
+                     _mm256_blendv_ps(density, lowest, overflow));
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 lowest = _mm_set1_ps(std::numeric_limits<rank_t>::lowest());
+  for (; i + 4 <= n; i += 4) {
+    __m128i idx = _mm_loadu_si128((const __m128i*)&candIdx[i]);
+    __m128 overflow = _mm_castsi128_ps(_mm_cmpgt_epi32(zero, idx));
+    // SSE2 has no gather
+    __m128 density = _mm_setr_ps(densities[std::max(candIdx[i], 0)],
+                                 densities[std::max(candIdx[i + 1], 0)],
+                                 densities[std::max(candIdx[i + 2], 0)],
+                                 densities[std::max(candIdx[i + 3], 0)]);
+    density = _mm_div_ps(density, _mm_loadu_ps(&candSize[i]));
+    density = _mm_add_ps(density, _mm_loadu_ps(&candBonus[i]));
+    density = _mm_or_ps(_mm_and_ps(overflow, lowest),
+                        _mm_andnot_ps(overflow, density));
+    _mm_storeu_ps(&candRank[i], density);
+  }
+#endif
+
+  for (; i < n; i++) {
+    if (candIdx[i] < 0) {
+      candRank[i] = std::numeric_limits<rank_t>::lowest();
+    } else {
+      candRank[i] = densities[candIdx[i]] / candSize[i] + candBonus[i];
+    }
+  }
+}
+
+cache_obj_t* LHD::rank(const request_t* req) {
+  uint32_t n = 0;
 
   // Sample few candidates early in the trace so that we converge
   // quickly to a reasonable policy.
@@ -44,88 +104,93 @@ candidate_t LHD::rank(const request_t* req) {
   // system.
   uint32_t candidates = (numReconfigurations > 50) ? ASSOCIATIVITY : 8;
 
+  // sample all candidates first and prefetch their metadata so that the
+  // cache misses on the objects overlap
   for (uint32_t i = 0; i < candidates; i++) {
-    auto idx = next_rand() % tags.size();
-    auto& tag = tags[idx];
-    rank_t rank = getHitDensity(tag);
-
-    if (rank < victimRank) {
-      victim = idx;
-      victimRank = rank;
-    }
+    cache_obj_t* obj = objs[next_rand() % objs.size()];
+    __builtin_prefetch(obj, 0, 1);
+    candObjs[n++] = obj;
   }
 
   for (uint32_t i = 0; i < ADMISSIONS; i++) {
-    auto itr = indices.find(recentlyAdmitted[i]);
-    if (itr == indices.end()) {
+    cache_obj_t* obj =
+        hashtable_find_obj_id(cache->hashtable, recentlyAdmitted[i]);
+    if (obj == NULL) {
       continue;
     }
+    candObjs[n++] = obj;
+  }
+
+  assert(n > 0);
+
+  for (uint32_t i = 0; i < n; i++) {
+    const cache_obj_t* obj = candObjs[i];
+    auto age = getAge(obj);
+    candIdx[i] = (age == MAX_AGE - 1)
+                     ? -1
+                     : (int32_t)(obj->LHD.class_id * MAX_AGE + age);
+#ifdef BYTE_MISS_RATIO
+    candSize[i] = 1;
+#else
+    candSize[i] = (rank_t)obj->obj_size;
+#endif
+    candBonus[i] = obj->LHD.explorer ? 1 : 0;
+  }
 
-    auto idx = itr->second;
-    auto& tag = tags[idx];
-    assert(tag.id == recentlyAdmitted[i]);
-    rank_t rank = getHitDensity(tag);
+  computeCandidateRanks(n);
 
-    if (rank < victimRank) {
-      victim = idx;
-      victimRank = rank;
+  uint32_t victim = 0;
+  rank_t victimRank = std::numeric_limits<rank_t>::max();
+  for (uint32_t i = 0; i < n; i++) {
+    if (candRank[i] < victimRank) {
+      victim = i;
+      victimRank = candRank[i];
     }
   }
 
-  assert(victim != (uint64_t)-1);
-
   ewmaVictimHitDensity =
       EWMA_DECAY * ewmaVictimHitDensity + (1 - EWMA_DECAY) * victimRank;
 
-  return tags[victim].id;
+  return candObjs[victim];
 }
 
-void LHD::update(candidate_t id, const request_t* req) {
-  auto itr = indices.find(id);
-  bool insert = (itr == indices.end());
-
-  Tag* tag;
+void LHD::update(cache_obj_t* obj, const request_t* req, bool insert) {
   if (insert) {
-    tags.push_back(Tag{});
-    tag = &tags.back();
-    indices[id] = tags.size() - 1;
+    obj->LHD.pos = (int32_t)objs.size();
+    objs.push_back(obj);
 
-    tag->lastLastHitAge = MAX_AGE;
-    tag->lastHitAge = 0;
-    tag->id = id;
+    obj->LHD.last_last_hit_age = MAX_AGE;
+    obj->LHD.last_hit_age = 0;
   } else {
-    tag = &tags[itr->second];
-    assert(tag->id == id);
-    auto age = getAge(*tag);
-    auto& cl = getClass(*tag);
+    auto age = getAge(obj);
+    auto& cl = getClass(obj);
     cl.hits[age] += 1;
 
-    if (tag->explorer) {
-      explorerBudget += tag->size;
+    if (obj->LHD.explorer) {
+      explorerBudget += (rank_t)obj->obj_size;
     }
 
-    tag->lastLastHitAge = tag->lastHitAge;
-    tag->lastHitAge = age;
+    obj->LHD.last_last_hit_age = obj->LHD.last_hit_age;
+    obj->LHD.last_hit_age = age;
   }
 
-  tag->timestamp = timestamp;
-  tag->app = DEFAULT_APP_ID % APP_CLASSES;
-  tag->size = req->obj_size;
+  obj->LHD.last_access_vtime = timestamp;
+  obj->LHD.class_id = getClassId(obj);
 
   // with some probability, some candidates will never be evicted
   // ... but limit how many resources we spend on doing this
   bool explore = (next_rand() % EXPLORE_INVERSE_PROBABILITY) == 0;
   if (explore && explorerBudget > 0 && numReconfigurations < 50) {
-    tag->explorer = true;
-    explorerBudget -= tag->size;
+    obj->LHD.explorer = true;
+    explorerBudget -= (rank_t)req->obj_size;
   } else {
-    tag->explorer = false;
+    obj->LHD.explorer = false;
   }
 
   // If this candidate looks like something that should be
   // evicted, track it.
-  if (insert && !explore && getHitDensity(*tag) < ewmaVictimHitDensity) {
-    recentlyAdmitted[recentlyAdmittedHead++ % ADMISSIONS] = id;
+  if (insert && !explore && getHitDensity(obj) < ewmaVictimHitDensity) {
+    recentlyAdmitted[recentlyAdmittedHead++ % ADMISSIONS] = obj->obj_id;
   }
 
   ++timestamp;
@@ -137,30 +202,26 @@ void LHD::update(candidate_t id, const request_t* req) {
   }
 }
 
-void LHD::replaced(candidate_t id) {
-  auto itr = indices.find(id);
-  assert(itr != indices.end());
-  auto index = itr->second;
-
+void LHD::replaced(cache_obj_t* obj) {
   // Record stats before removing item
-  auto& tag = tags[index];
-  assert(tag.id == id);
-  auto age = getAge(tag);
-  auto& cl = getClass(tag);
+  auto age = getAge(obj);
+  auto& cl = getClass(obj);
   cl.evictions[age] += 1;
 
-  if (tag.explorer) {
-    explorerBudget += tag.size;
+  if (obj->LHD.explorer) {
+    explorerBudget += (rank_t)obj->obj_size;
   }
 
-  // Remove tag for replaced item and update index
-  indices.erase(itr);
-  tags[index] = tags.back();
-  tags.pop_back();
+  removed(obj);
+}
 
-  if (index < tags.size()) {
-    indices[tags[index].id] = index;
-  }
+void LHD::removed(cache_obj_t* obj) {
+  // move the last object into the slot of the removed object
+  int32_t pos = obj->LHD.pos;
+  assert(objs[pos] == obj);
+  objs[pos] = objs.back();
+  objs[pos]->LHD.pos = pos;
+  objs.pop_back();
 }
 
 void LHD::reconfigure() {
@@ -178,13 +239,7 @@ void LHD::reconfigure() {
 
   // Just printfs ...
   for (uint32_t c = 0; c < classes.size(); c++) {
-    auto& cl = classes[c];
-    // printf("Class %d | hits %g, evictions %g, hitRate %g\n",
-    //        c,
-    //        cl.totalHits, cl.totalEvictions,
-    //        cl.totalHits / (cl.totalHits + cl.totalEvictions));
-
-    dumpClassRanks(cl);
+    dumpClassRanks(c);
   }
   //    printf("LHD | hits %g, evictions %g, hitRate %g | overflows %lu (%g) |
   //    cumulativeHitRate nan\n",
@@ -228,29 +283,31 @@ void LHD::modelHitDensity() {
       lifetimeUnconditioned += totalEvents;
 
       if (totalEvents > 1e-5) {
-        classes[c].hitDensities[a] = totalHits / lifetimeUnconditioned;
+        hitDensities[c * MAX_AGE + a] = totalHits / lifetimeUnconditioned;
       } else {
-        classes[c].hitDensities[a] = 0.;
+        hitDensities[c * MAX_AGE + a] = 0.;
       }
     }
   }
 }
 
-void LHD::dumpClassRanks(Class& cl) {
+void LHD::dumpClassRanks(uint32_t c) {
   if (!DUMP_RANKS) {
     return;
   }
 
+  auto& cl = classes[c];
+
   // float objectAvgSize = cl.sizeAccumulator / cl.totalHits; // +
   // cl.totalEvictions);
-  float objectAvgSize = 1. * cache->occupied_byte / sizeMap.size();
+  float objectAvgSize = 1. * cache->occupied_byte / objs.size();
   rank_t left;
 
   left = cl.totalHits + cl.totalEvictions;
   std::cout << "Ranks for avg object (" << objectAvgSize << "): ";
   for (age_t a = 0; a < MAX_AGE; a++) {
     std::stringstream rankStr;
-    rank_t density = cl.hitDensities[a] / objectAvgSize;
+    rank_t density = hitDensities[c * MAX_AGE + a] / objectAvgSize;
     rankStr << density << ", ";
     std::cout << rankStr.str();
 
@@ -300,7 +357,7 @@ void LHD::adaptAgeCoarsening() {
   ewmaNumObjects *= EWMA_DECAY;
   ewmaNumObjectsMass *= EWMA_DECAY;
 
-  ewmaNumObjects += sizeMap.size();
+  ewmaNumObjects += objs.size();
   ewmaNumObjectsMass += 1.;
 
   rank_t numObjects = ewmaNumObjects / ewmaNumObjectsMass;
@@ -6,7 +6,9 @@
 #include <vector>
 
 #include "../../../include/libCacheSim/cache.h"
-#include "repl.hpp"
+#include "../../../include/libCacheSim/cacheObj.h"
+#include "../../../include/libCacheSim/request.h"
+#include "constants.hpp"
 
 namespace repl {
 
@@ -17,17 +19,8 @@ class LHD {
   typedef uint64_t age_t;
   typedef float rank_t;
 
-  // info we track about each object
-  struct Tag {
-    age_t timestamp;
-    age_t lastHitAge;
-    age_t lastLastHitAge;
-    uint32_t app;
-
-    candidate_t id;
-    rank_t size;  // stored redundantly with cache
-    bool explorer;
-  };
+  // the per-object metadata (timestamp, hit ages, class, explorer) is
+  // stored in cache_obj_t (obj->LHD), see LHD_obj_metadata_t
 
   // info we track about each class of objects
   struct Class {
@@ -35,29 +28,28 @@ class LHD {
     std::vector<rank_t> evictions;
     rank_t totalHits = 0;
     rank_t totalEvictions = 0;
-
-    std::vector<rank_t> hitDensities;
   };
 
   LHD(int _associativity, int _admissions, cache_t *cache);
   ~LHD() {}
 
-  // called whenever and object is referenced
-  void update(candidate_t id, const request_t *req);
+  // called whenever and object is referenced, insert is true if the object
+  // has just been inserted into the cache
+  void update(cache_obj_t *obj, const request_t *req, bool insert);
 
   // called when an object is evicted
-  void replaced(candidate_t id);
+  void replaced(cache_obj_t *obj);
 
-  // called to find a victim upon a cache miss
-  candidate_t rank(const request_t *req);
+  // called when an object is removed by the user, no stats are recorded
+  void removed(cache_obj_t *obj);
 
-  void dumpStats(LHDCache::Cache *cache) {}
+  // called to find a victim upon a cache miss
+  cache_obj_t *rank(const request_t *req);
 
-  std::unordered_map<candidate_t, uint32_t> sizeMap;
-  // object metadata; indices maps object id -> metadata
-  std::vector<Tag> tags;
+  // all objects in the cache, objs[obj->LHD.pos] == obj,
+  // candidates are sampled from this array
+  std::vector<cache_obj_t *> objs;
   std::vector<Class> classes;
-  std::unordered_map<candidate_t, uint64_t> indices;
 
  private:
   // CONSTANTS ///////////////////////////
@@ -73,6 +65,7 @@ class LHD {
   // cache.) alternatively, you could do bypassing and randomly
   // admit objects as "explorers" (see below).
   const uint32_t ADMISSIONS = 8;
+  static constexpr obj_id_t INVALID_OBJ_ID = (obj_id_t)-1;
 
   // escape local minima by having some small fraction of cache
   // space allocated to objects that aren't evicted. 1% seems to be
@@ -121,8 +114,20 @@ class LHD {
 
   //  misc::Rand rand;
 
+  // the hit density of all classes in one flat array,
+  // the hit density of class c at age a is at c * MAX_AGE + a
+  std::vector<rank_t> hitDensities;
+
+  // scratch space for the candidates evaluated in rank(),
+  // laid out so that the densities can be computed with SIMD
+  std::vector<cache_obj_t *> candObjs;
+  std::vector<int32_t> candIdx;
+  std::vector<rank_t> candSize;
+  std::vector<rank_t> candBonus;
+  std::vector<rank_t> candRank;
+
   // see ADMISSIONS above
-  std::vector<candidate_t> recentlyAdmitted;
+  std::vector<obj_id_t> recentlyAdmitted;
   int recentlyAdmittedHead = 0;
   rank_t ewmaVictimHitDensity = 0;
 
@@ -143,37 +148,20 @@ class LHD {
     return log;
   }
 
-  inline uint32_t getClassId(const Tag &tag) const {
-    uint32_t hitAgeId = hitAgeClass(tag.lastHitAge + tag.lastLastHitAge);
-    // uint32_t hitAgeId = hitAgeClass(tag.lastHitAge);
-    return tag.app * HIT_AGE_CLASSES + hitAgeId;
+  inline uint32_t getClassId(const cache_obj_t *obj) const {
+    uint32_t hitAgeId = hitAgeClass((age_t)obj->LHD.last_hit_age +
+                                    (age_t)obj->LHD.last_last_hit_age);
+    return (DEFAULT_APP_ID % APP_CLASSES) * HIT_AGE_CLASSES + hitAgeId;
   }
 
-  inline uint32_t getClassIdBySize(const Tag &tag) const {
-    uint32_t hitSizeId = 0;
-    uint64_t size = (uint64_t)tag.size;
-    return tag.app * HIT_AGE_CLASSES + ((uint64_t)log(size)) % HIT_AGE_CLASSES;
+  inline Class &getClass(const cache_obj_t *obj) {
+    return classes[obj->LHD.class_id];
   }
 
-  inline uint32_t getClassIdBySizeAndAge(const Tag &tag) const {
-    if (tag.lastHitAge == 0) return getClassIdBySize(tag);
-
-    uint32_t hitSizeId = 0;
-    uint64_t size = (uint64_t)tag.size;
-    return tag.app * HIT_AGE_CLASSES +
-           ((uint64_t)log(size) + (uint64_t)log(tag.lastHitAge)) %
-               HIT_AGE_CLASSES;
-  }
-
-  inline Class &getClass(const Tag &tag) {
-    // return classes[getClassIdBySizeAndAge(tag)];
-    // return classes[getClassIdBySize(tag)];
-    return classes[getClassId(tag)];
-  }
-
-  inline age_t getAge(Tag tag) {
+  inline age_t getAge(const cache_obj_t *obj) {
     timestamp_t age =
-        (timestamp - (timestamp_t)tag.timestamp) >> ageCoarseningShift;
+        (timestamp - (timestamp_t)obj->LHD.last_access_vtime) >>
+        ageCoarseningShift;
 
     if (age >= MAX_AGE) {
       ++overflows;
@@ -183,28 +171,32 @@ class LHD {
     }
   }
 
-  inline rank_t getHitDensity(const Tag &tag) {
-    auto age = getAge(tag);
+  inline rank_t getHitDensity(const cache_obj_t *obj) {
+    auto age = getAge(obj);
     if (age == MAX_AGE - 1) {
       return std::numeric_limits<rank_t>::lowest();
     }
-    auto &cl = getClass(tag);
 #ifdef BYTE_MISS_RATIO
-    rank_t density = cl.hitDensities[age];
+    rank_t density = hitDensities[obj->LHD.class_id * MAX_AGE + age];
 #else
-    rank_t density = cl.hitDensities[age] / tag.size;
+    rank_t density = hitDensities[obj->LHD.class_id * MAX_AGE + age] /
+                     (rank_t)obj->obj_size;
 #endif
-    if (tag.explorer) {
+    if (obj->LHD.explorer) {
       density += 1.;
     }
     return density;
   }
 
+  // compute the hit density of the first n candidates in candIdx,
+  // candSize and candBonus into candRank
+  void computeCandidateRanks(uint32_t n);
+
   void reconfigure();
   void adaptAgeCoarsening();
   void updateClass(Class &cl);
   void modelHitDensity();
-  void dumpClassRanks(Class &cl);
+  void dumpClassRanks(uint32_t c);
 };
 
 }  // namespace repl
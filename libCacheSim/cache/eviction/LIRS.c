@@ -41,6 +41,7 @@ static cache_obj_t *LIRS_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *LIRS_to_evict(cache_t *cache, const request_t *req);
 static void LIRS_evict(cache_t *cache, const request_t *req);
 static bool LIRS_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t LIRS_get_metadata_bytes(const cache_t *cache);
 
 /* internal functions */
 bool LIRS_can_insert(cache_t *cache, const request_t *req);
@@ -83,6 +84,7 @@ cache_t *LIRS_init(const common_cache_params_t ccache_params,
   cache->evict = LIRS_evict;
   cache->remove = LIRS_remove;
   cache->to_evict = LIRS_to_evict;
+  cache->get_metadata_bytes = LIRS_get_metadata_bytes;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 8 * 2;
@@ -111,6 +113,10 @@ cache_t *LIRS_init(const common_cache_params_t ccache_params,
   params->LRU_s = LRU_init(ccache_params_s, NULL);
   params->LRU_q = LRU_init(ccache_params_q, NULL);
   params->LRU_nh = LRU_init(ccache_params_nh, NULL);
+  /* LIRS keeps its metadata in the objects of the stacks */
+  cache_set_obj_struct_size(params->LRU_s, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->LRU_q, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->LRU_nh, sizeof(cache_obj_t));
 
   return cache;
 }
@@ -129,6 +135,15 @@ static void LIRS_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t LIRS_get_metadata_bytes(const cache_t *cache) {
+  LIRS_params_t *params = (LIRS_params_t *)(cache->eviction_params);
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(LIRS_params_t) +
+         params->LRU_s->get_metadata_bytes(params->LRU_s) +
+         params->LRU_q->get_metadata_bytes(params->LRU_q) +
+         params->LRU_nh->get_metadata_bytes(params->LRU_nh);
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -570,7 +585,7 @@ static cache_obj_t *hit_RD_HIRinQ(cache_t *cache, cache_obj_t *cache_obj_q) {
   if (req_local == NULL) {
     req_local = new_request();
   }
-  copy_cache_obj_to_request(req_local, cache_obj_q);
+  copy_cache_obj_to_request(req_local, params->LRU_q, cache_obj_q);
 
   while (params->lirs_count + cache_obj_q->obj_size > params->lirs_limit) {
     evictLIR(cache);
@@ -592,7 +607,7 @@ static void evictLIR(cache_t *cache) {
   if (req_local == NULL) {
     req_local = new_request();
   }
-  copy_cache_obj_to_request(req_local, obj_to_evict);
+  copy_cache_obj_to_request(req_local, params->LRU_s, obj_to_evict);
   params->lirs_count -= obj_to_evict->obj_size;
   params->LRU_s->evict(params->LRU_s, NULL);
 
@@ -628,7 +643,7 @@ static bool evictHIR(cache_t *cache) {
   if (req_local == NULL) {
     req_local = new_request();
   }
-  copy_cache_obj_to_request(req_local, obj_to_evict);
+  copy_cache_obj_to_request(req_local, params->LRU_q, obj_to_evict);
 
   params->hirs_count -= obj_to_evict->obj_size;
   params->LRU_q->evict(params->LRU_q, NULL);
@@ -11,71 +11,120 @@ using namespace chrono;
 using namespace std;
 using namespace lrb;
 
-void LRBCache::train() {
-    ++n_retrain;
+BoosterHandle LRBCache::train(TrainingData *data) {
     auto timeBegin = chrono::system_clock::now();
-    if (booster) LGBM_BoosterFree(booster);
+    BoosterHandle new_booster = nullptr;
     // create training dataset
     DatasetHandle trainData;
     LGBM_DatasetCreateFromCSR(
-            static_cast<void *>(training_data->indptr.data()),
+            static_cast<void *>(data->indptr.data()),
             C_API_DTYPE_INT32,
-            training_data->indices.data(),
-            static_cast<void *>(training_data->data.data()),
+            data->indices.data(),
+            static_cast<void *>(data->data.data()),
             C_API_DTYPE_FLOAT64,
-            training_data->indptr.size(),
-            training_data->data.size(),
+            data->indptr.size(),
+            data->data.size(),
             n_feature,  //remove future t
-            map_to_string(training_params).c_str(),
+            training_params_str.c_str(),
             nullptr,
             &trainData);
 
     LGBM_DatasetSetField(trainData,
                          "label",
-                         static_cast<void *>(training_data->labels.data()),
-                         training_data->labels.size(),
+                         static_cast<void *>(data->labels.data()),
+                         data->labels.size(),
                          C_API_DTYPE_FLOAT32);
 
     // init booster
-    LGBM_BoosterCreate(trainData, map_to_string(training_params).c_str(), &booster);
+    LGBM_BoosterCreate(trainData, training_params_str.c_str(), &new_booster);
     // train
-    for (int i = 0; i < stoi(training_params["num_iterations"]); i++) {
+    for (int i = 0; i < num_iterations; i++) {
         int isFinished;
-        LGBM_BoosterUpdateOneIter(booster, &isFinished);
+        LGBM_BoosterUpdateOneIter(new_booster, &isFinished);
         if (isFinished) {
             break;
         }
     }
 
     int64_t len;
-    vector<double> result(training_data->indptr.size() - 1);
-    LGBM_BoosterPredictForCSR(booster,
-                              static_cast<void *>(training_data->indptr.data()),
+    vector<double> result(data->indptr.size() - 1);
+    LGBM_BoosterPredictForCSR(new_booster,
+                              static_cast<void *>(data->indptr.data()),
                               C_API_DTYPE_INT32,
-                              training_data->indices.data(),
-                              static_cast<void *>(training_data->data.data()),
+                              data->indices.data(),
+                              static_cast<void *>(data->data.data()),
                               C_API_DTYPE_FLOAT64,
-                              training_data->indptr.size(),
-                              training_data->data.size(),
+                              data->indptr.size(),
+                              data->data.size(),
                               n_feature,  //remove future t
                               C_API_PREDICT_NORMAL,
                               0,
-                              atoi(training_params["num_iterations"].c_str()),
-                              map_to_string(training_params).c_str(),
+                              num_iterations,
+                              training_params_str.c_str(),
                               &len,
                               result.data());
 
 
     double se = 0;
     for (int i = 0; i < result.size(); ++i) {
-        auto diff = result[i] - training_data->labels[i];
+        auto diff = result[i] - data->labels[i];
         se += diff * diff;
     }
-    training_loss = training_loss * 0.99 + se / batch_size * 0.01;
+    //only the thread that trains writes the stats
+    training_loss.store(training_loss.load() * 0.99 + se / batch_size * 0.01);
 
     LGBM_DatasetFree(trainData);
-    training_time = 0.95 * training_time +
-                    0.05 * chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - timeBegin).count();
+    training_time.store(0.95 * training_time.load() +
+                        0.05 * chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - timeBegin).count());
+
+    return new_booster;
+}
+
+void LRBCache::submit_training_data() {
+    //batch_size ~>= batch_size
+    if (training_data->labels.size() < batch_size) {
+        return;
+    }
+
+    if (!async_training) {
+        if (booster) LGBM_BoosterFree(booster);
+        booster = train(training_data);
+        ++n_retrain;
+        training_data->clear();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(training_mtx);
+        if (training_busy) {
+            //the worker is still training on the previous batch
+            ++n_dropped_batch;
+        } else {
+            std::swap(training_data, training_snapshot);
+            training_busy = true;
+        }
+    }
+    training_cv.notify_one();
+    training_data->clear();
+}
+
+void LRBCache::training_loop() {
+    std::unique_lock<std::mutex> lock(training_mtx);
+    while (true) {
+        training_cv.wait(lock, [this] { return training_stop || training_busy; });
+        if (training_stop) {
+            return;
+        }
+
+        //training_snapshot is not touched by the request thread while busy
+        lock.unlock();
+        BoosterHandle new_booster = train(training_snapshot);
+        //a model that has not been picked up yet is superseded
+        BoosterHandle old_booster = pending_booster.exchange(new_booster, std::memory_order_acq_rel);
+        if (old_booster) LGBM_BoosterFree(old_booster);
+        lock.lock();
+        training_busy = false;
+    }
 }
 
 void LRBCache::sample() {
@@ -128,6 +177,8 @@ bool LRBCache::lookup(const SimpleRequest &req) {
     bool ret;
     ++current_seq;
 
+    install_booster();
+
     forget();
 
     //first update the metadata: insert/update, which can trigger pending data.mature
@@ -153,17 +204,13 @@ bool LRBCache::lookup(const SimpleRequest &req) {
                 training_data->emplace_back(meta, sample_time, future_distance, meta._key, max_hash_edc_idx, edc_windows, hash_edc);
                 ++training_data_distribution[1];
             }
-            //batch_size ~>= batch_size
-            if (training_data->labels.size() >= batch_size) {
-                train();
-                training_data->clear();
-            }
+            submit_training_data();
             meta._sample_times.clear();
             meta._sample_times.shrink_to_fit();
         }
 
         //make this update after update training, otherwise the last timestamp will change
-        meta.update(current_seq, n_extra_fields, max_hash_edc_idx, edc_windows, hash_edc);
+        meta.update(extra_pool, current_seq, n_extra_fields, max_hash_edc_idx, edc_windows, hash_edc);
         if (list_idx) {
             negative_candidate_queue->erase(forget_timestamp);
             negative_candidate_queue->insert({current_seq % memory_window, req.id});
@@ -212,11 +259,7 @@ void LRBCache::forget() {
                 training_data->emplace_back(meta, sample_time, future_distance, meta._key, max_hash_edc_idx, edc_windows, hash_edc);
                 ++training_data_distribution[0];
             }
-            //batch_size ~>= batch_size
-            if (training_data->labels.size() >= batch_size) {
-                train();
-                training_data->clear();
-            }
+            submit_training_data();
             meta._sample_times.clear();
             meta._sample_times.shrink_to_fit();
         }
@@ -373,8 +416,8 @@ pair<uint64_t, uint32_t> LRBCache::rank() {
                               n_feature,  //remove future t
                               C_API_PREDICT_NORMAL,
                               0,
-                              atoi(training_params["num_iterations"].c_str()),
-                              map_to_string(inference_params).c_str(),
+                              num_iterations,
+                              inference_params_str.c_str(),
                               &len,
                               scores);
     if (!(current_seq % 10000))
@@ -431,11 +474,7 @@ void LRBCache::evict_with_candidate(pair<uint64_t, uint32_t> &epair) {
                 training_data->emplace_back(meta, sample_time, future_distance, meta._key, max_hash_edc_idx, edc_windows, hash_edc);
                 ++training_data_distribution[0];
             }
-            //batch_size ~>= batch_size
-            if (training_data->labels.size() >= batch_size) {
-                train();
-                training_data->clear();
-            }
+            submit_training_data();
             meta._sample_times.clear();
             meta._sample_times.shrink_to_fit();
         }
@@ -443,7 +482,7 @@ void LRBCache::evict_with_candidate(pair<uint64_t, uint32_t> &epair) {
         in_cache_lru_queue.dq.erase(meta.p_last_request);
         meta.p_last_request = in_cache_lru_queue.dq.end();
         //above is suppose to be below, but to make sure the action is correct
-        meta.free();
+        meta.free(extra_pool);
         _currentSize -= meta._size;
         key_map.erase(key);
 
@@ -477,7 +516,7 @@ void LRBCache::evict_with_candidate(pair<uint64_t, uint32_t> &epair) {
 
 void LRBCache::remove_from_outcache_metas(Meta &meta, unsigned int &pos, const uint64_t &key) {
     //free the actual content
-    meta.free();
+    meta.free(extra_pool);
     //TODO: can add a function to delete from a queue with (key, pos)
     //evict
     uint32_t tail_pos = out_cache_metas.size() - 1;
@@ -17,6 +17,10 @@
 #include <sstream>
 #include <fstream>
 #include <list>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace webcachesim;
 using namespace std;
@@ -34,22 +38,22 @@ namespace lrb {
 
 
 struct MetaExtra {
-    //vector overhead = 24 (8 pointer, 8 size, 8 allocation)
-    //40 + 24 + 4*x + 1
-    //65 byte at least
-    //189 byte at most
+    //40 + 4 * 31 + 1 = 165 byte, allocated from MetaExtraPool
     //not 1 hit wonder
     float _edc[10];
-    vector<uint32_t> _past_distances;
+    //fixed-width ring of past distances,
+    //the latest one is at (_past_distance_idx - 1) % max_n_past_distances
+    uint32_t _past_distances[max_n_past_distances];
     //the next index to put the distance
     uint8_t _past_distance_idx = 1;
 
-    MetaExtra(const uint32_t &distance,
+    void init(const uint32_t &distance,
     uint32_t max_hash_edc_idx,
     vector<uint32_t> &edc_windows,
     const vector<double> &hash_edc
     ) {
-        _past_distances = vector<uint32_t>(1, distance);
+        _past_distances[0] = distance;
+        _past_distance_idx = 1;
         for (uint8_t i = 0; i < n_edc_feature; ++i) {
             uint32_t _distance_idx = min(uint32_t(distance / edc_windows[i]), max_hash_edc_idx);
             _edc[i] = hash_edc[_distance_idx] + 1;
@@ -62,11 +66,7 @@ struct MetaExtra {
         const vector<double> &hash_edc
     ) {
         uint8_t distance_idx = _past_distance_idx % max_n_past_distances;
-        if (_past_distances.size() < max_n_past_distances)
-            _past_distances.emplace_back(distance);
-        else
-            _past_distances[distance_idx] = distance;
-        assert(_past_distances.size() <= max_n_past_distances);
+        _past_distances[distance_idx] = distance;
         _past_distance_idx = _past_distance_idx + (uint8_t) 1;
         if (_past_distance_idx >= max_n_past_distances * 2)
             _past_distance_idx -= max_n_past_distances;
@@ -75,6 +75,56 @@ struct MetaExtra {
             _edc[i] = _edc[i] * hash_edc[_distance_idx] + 1;
         }
     }
+
+    uint8_t n_past_distances() const {
+        return min(_past_distance_idx, max_n_past_distances);
+    }
+};
+
+/*
+ * MetaExtra is allocated from large chunks instead of one new per object,
+ * freed entries are reused through a free list, the chunks never move so
+ * Meta can keep a pointer
+ */
+class MetaExtraPool {
+public:
+    static const uint32_t chunk_size = 65536;
+
+    MetaExtraPool() = default;
+    MetaExtraPool(const MetaExtraPool &) = delete;
+    MetaExtraPool &operator=(const MetaExtraPool &) = delete;
+
+    ~MetaExtraPool() {
+        for (auto *chunk: chunks)
+            delete[] chunk;
+    }
+
+    MetaExtra *alloc() {
+        if (!free_list.empty()) {
+            auto *extra = free_list.back();
+            free_list.pop_back();
+            return extra;
+        }
+        if (chunks.empty() || n_used_in_chunk == chunk_size) {
+            chunks.push_back(new MetaExtra[chunk_size]);
+            n_used_in_chunk = 0;
+        }
+        return &chunks.back()[n_used_in_chunk++];
+    }
+
+    void free(MetaExtra *extra) {
+        free_list.push_back(extra);
+    }
+
+    size_t memory_overhead() const {
+        return chunks.size() * chunk_size * sizeof(MetaExtra) +
+               free_list.capacity() * sizeof(MetaExtra *);
+    }
+
+private:
+    vector<MetaExtra *> chunks;
+    vector<MetaExtra *> free_list;
+    uint32_t n_used_in_chunk = 0;
 };
 
 class Meta {
@@ -102,11 +152,15 @@ public:
         _sample_times.emplace_back(sample_t);
     }
 
-    void free() {
-        delete _extra;
+    void free(MetaExtraPool &pool) {
+        if (_extra) {
+            pool.free(_extra);
+            _extra = nullptr;
+        }
     }
 
-    void update(const uint32_t &past_timestamp, uint32_t n_extra_fields,
+    void update(MetaExtraPool &pool,
+                const uint32_t &past_timestamp, uint32_t n_extra_fields,
                 uint32_t max_hash_edc_idx,
                 vector<uint32_t> &edc_windows,
                 const vector<double> &hash_edc
@@ -115,7 +169,8 @@ public:
         uint32_t _distance = past_timestamp - _past_timestamp;
         assert(_distance);
         if (!_extra) {
-            _extra = new MetaExtra(_distance, max_hash_edc_idx, edc_windows, hash_edc);
+            _extra = pool.alloc();
+            _extra->init(_distance, max_hash_edc_idx, edc_windows, hash_edc);
         } else
             _extra->update(_distance, max_hash_edc_idx, edc_windows, hash_edc);
         //timestamp
@@ -125,7 +180,7 @@ public:
     int feature_overhead() {
         int ret = sizeof(Meta);
         if (_extra)
-            ret += sizeof(MetaExtra) - sizeof(_sample_times) + _extra->_past_distances.capacity() * sizeof(uint32_t);
+            ret += sizeof(MetaExtra) - sizeof(_sample_times);
         return ret;
     }
 
@@ -282,6 +337,7 @@ public:
     sparse_hash_map<uint64_t, KeyMapEntryT> key_map;
     vector<InCacheMeta> in_cache_metas;
     vector<Meta> out_cache_metas;
+    MetaExtraPool extra_pool;
 
     InCacheLRUQueue in_cache_lru_queue;
     shared_ptr<sparse_hash_map<uint64_t, uint64_t>> negative_candidate_queue;
@@ -290,14 +346,36 @@ public:
     // sample_size: use n_memorize keys + random choose (sample_rate - n_memorize) keys
     uint sample_rate = 64;
 
-    double training_loss = 0;
+    //written by the training thread when async_training is enabled
+    std::atomic<double> training_loss{0};
     int32_t n_force_eviction = 0;
 
-    double training_time = 0;
+    std::atomic<double> training_time{0};
     double inference_time = 0;
 
     BoosterHandle booster = nullptr;
 
+    /*
+     * by default, the model is trained synchronously when a batch of
+     * training data is full, so the results are deterministic.
+     * With async_training, training runs on a worker thread: a full batch of
+     * training data is handed to the worker (training_snapshot) and the new
+     * model is published in pending_booster, the request thread picks it up
+     * in install_booster(), so requests never wait for training and the model
+     * used for inference is only touched by the request thread.
+     * If the worker is still busy when the next batch is ready, the batch is
+     * dropped, so the miss ratio depends on the thread timing.
+     */
+    bool async_training = false;
+    TrainingData *training_snapshot = nullptr;
+    std::thread training_thread;
+    std::mutex training_mtx;
+    std::condition_variable training_cv;
+    bool training_busy = false;
+    bool training_stop = false;
+    std::atomic<BoosterHandle> pending_booster{nullptr};
+    int n_dropped_batch = 0;
+
     unordered_map<string, string> training_params = {
             //don't use alias here. C api may not recognize
             {"boosting",         "gbdt"},
@@ -314,6 +392,10 @@ public:
     };
 
     unordered_map<string, string> inference_params;
+    // the params above as strings, built once in init_with_params
+    string training_params_str;
+    string inference_params_str;
+    int num_iterations = 32;
 
     enum ObjectiveT : uint8_t {
         byte_miss_ratio = 0, object_miss_ratio = 1
@@ -350,6 +432,8 @@ public:
                 training_params["num_threads"] = it.second;
             } else if (it.first == "num_leaves") {
                 training_params["num_leaves"] = it.second;
+            } else if (it.first == "async_training") {
+                async_training = (it.second == "true" || it.second == "1");
             } else if (it.first == "byte_million_req") {
                 byte_million_req = stoull(it.second);
             } else if (it.first == "n_edc_feature") {
@@ -397,7 +481,30 @@ public:
             training_params["categorical_feature"] = categorical_feature;
         }
         inference_params = training_params;
+        training_params_str = map_to_string(training_params);
+        inference_params_str = map_to_string(inference_params);
+        num_iterations = stoi(training_params["num_iterations"]);
         training_data = new TrainingData(n_feature, memory_window);
+        if (async_training) {
+            training_snapshot = new TrainingData(n_feature, memory_window);
+            training_thread = std::thread(&LRBCache::training_loop, this);
+        }
+    }
+
+    ~LRBCache() override {
+        if (training_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(training_mtx);
+                training_stop = true;
+            }
+            training_cv.notify_one();
+            training_thread.join();
+        }
+        BoosterHandle pending = pending_booster.exchange(nullptr);
+        if (pending) LGBM_BoosterFree(pending);
+        if (booster) LGBM_BoosterFree(booster);
+        delete training_data;
+        delete training_snapshot;
     }
 
     string map_to_string(unordered_map<string, string> &map) {
@@ -422,7 +529,25 @@ public:
     //sample, rank the 1st and return
     pair<uint64_t, uint32_t> rank();
 
-    void train();
+    //train a new model on data, thread-safe w.r.t. the request thread
+    BoosterHandle train(TrainingData *data);
+
+    //hand training_data to the worker (or train synchronously) once it is full
+    void submit_training_data();
+
+    void training_loop();
+
+    //switch to the model published by the worker if there is one
+    void install_booster() {
+        if (pending_booster.load(std::memory_order_relaxed) == nullptr)
+            return;
+        BoosterHandle new_booster = pending_booster.exchange(nullptr, std::memory_order_acquire);
+        if (new_booster) {
+            if (booster) LGBM_BoosterFree(booster);
+            booster = new_booster;
+            ++n_retrain;
+        }
+    }
 
     void sample();
 
@@ -450,14 +575,14 @@ public:
             if (nullptr == meta._extra) {
                 ++distribution[0];
             } else {
-                ++distribution[meta._extra->_past_distances.size()];
+                ++distribution[meta._extra->n_past_distances()];
             }
         }
         for (auto &meta: out_cache_metas) {
             if (nullptr == meta._extra) {
                 ++distribution[0];
             } else {
-                ++distribution[meta._extra->_past_distances.size()];
+                ++distribution[meta._extra->n_past_distances()];
             }
         }
         return distribution;
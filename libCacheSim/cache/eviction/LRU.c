@@ -33,6 +33,8 @@ static cache_obj_t *LRU_to_evict(cache_t *cache, const request_t *req);
 static void LRU_evict(cache_t *cache, const request_t *req);
 static bool LRU_remove(cache_t *cache, const obj_id_t obj_id);
 static void LRU_print_cache(const cache_t *cache);
+static bool LRU_save_state(const cache_t *cache, FILE *f);
+static bool LRU_load_state(cache_t *cache, FILE *f);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -62,12 +64,16 @@ cache_t *LRU_init(const common_cache_params_t ccache_params,
   cache->can_insert = cache_can_insert_default;
   cache->get_n_obj = cache_get_n_obj_default;
   cache->print_cache = LRU_print_cache;
+  cache->save_state = LRU_save_state;
+  cache->load_state = LRU_load_state;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 8 * 2;
   } else {
     cache->obj_md_size = 0;
   }
+  /* the objects only need the queue pointers */
+  cache_set_obj_struct_size(cache, CACHE_OBJ_HEADER_SIZE);
 
 #ifdef USE_BELADY
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "LRU_Belady");
@@ -280,6 +286,23 @@ static void LRU_print_cache(const cache_t *cache) {
   printf("END\n");
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                       snapshot functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+static bool LRU_save_state(const cache_t *cache, FILE *f) {
+  LRU_params_t *params = (LRU_params_t *)cache->eviction_params;
+  return cache_snapshot_write_tag(f, "LRU") &&
+         cache_save_obj_list(cache, f, params->q_tail);
+}
+
+static bool LRU_load_state(cache_t *cache, FILE *f) {
+  LRU_params_t *params = (LRU_params_t *)cache->eviction_params;
+  return cache_snapshot_check_tag(f, "LRU") &&
+         cache_load_obj_list(cache, f, &params->q_head, &params->q_tail) >= 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -71,14 +71,17 @@ static cache_obj_t *LeCaR_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *LeCaR_to_evict(cache_t *cache, const request_t *req);
 static void LeCaR_evict(cache_t *cache, const request_t *req);
 static bool LeCaR_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t LeCaR_get_metadata_bytes(const cache_t *cache);
 
 /* internal */
 static void verify_ghost_lru_integrity(cache_t *cache, LeCaR_params_t *params);
 static inline void update_LFU_min_freq(LeCaR_params_t *params);
 static inline freq_node_t *get_min_freq_node(LeCaR_params_t *params);
-static inline void remove_obj_from_freq_node(LeCaR_params_t *params,
+static inline void remove_obj_from_freq_node(cache_t *cache,
+                                             LeCaR_params_t *params,
                                              cache_obj_t *cache_obj);
-static inline void insert_obj_info_freq_node(LeCaR_params_t *params,
+static inline void insert_obj_info_freq_node(cache_t *cache,
+                                             LeCaR_params_t *params,
                                              cache_obj_t *cache_obj);
 
 static void update_weight(cache_t *cache, int64_t t, double *w_update,
@@ -114,6 +117,7 @@ cache_t *LeCaR_init(const common_cache_params_t ccache_params,
   cache->insert = LeCaR_insert;
   cache->evict = LeCaR_evict;
   cache->remove = LeCaR_remove;
+  cache->get_metadata_bytes = LeCaR_get_metadata_bytes;
   cache->to_evict = LeCaR_to_evict;
 
   if (ccache_params.consider_obj_metadata) {
@@ -121,6 +125,7 @@ cache_t *LeCaR_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(LeCaR));
 
   cache->eviction_params = my_malloc_n(LeCaR_params_t, 1);
   LeCaR_params_t *params = (LeCaR_params_t *)(cache->eviction_params);
@@ -176,6 +181,12 @@ static void LeCaR_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t LeCaR_get_metadata_bytes(const cache_t *cache) {
+  LeCaR_params_t *params = (LeCaR_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) + (int64_t)sizeof(LeCaR_params_t) +
+         FREQ_MAP_GET_METADATA_BYTES(params->freq_map);
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -226,9 +237,10 @@ static cache_obj_t *LeCaR_find(cache_t *cache, const request_t *req,
   if (cache_obj == NULL) {
     return NULL;
   }
+  LeCaR_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, LeCaR);
 
   if (!update_cache) {
-    if (cache_obj->LeCaR.is_ghost) {
+    if (md->is_ghost) {
       return NULL;
     } else {
       return cache_obj;
@@ -236,21 +248,21 @@ static cache_obj_t *LeCaR_find(cache_t *cache, const request_t *req,
   }
 
   // if it is a ghost object, update its weight
-  if (cache_obj->LeCaR.is_ghost) {
-    if (cache_obj->LeCaR.evict_expert == 1) {
+  if (md->is_ghost) {
+    if (md->evict_expert == 1) {
       // evicted by expert LRU
       params->n_hit_lru_history++;
-      int64_t t = cache->n_req - cache_obj->LeCaR.eviction_vtime;
+      int64_t t = cache->n_req - md->eviction_vtime;
       update_weight(cache, t, &params->w_lru, &params->w_lfu);
 
       remove_obj_from_list(&params->ghost_lru_head, &params->ghost_lru_tail,
                            cache_obj);
       params->lru_g_occupied_byte -= (cache_obj->obj_size + cache->obj_md_size);
       hashtable_delete(cache->hashtable, cache_obj);
-    } else if (cache_obj->LeCaR.evict_expert == 2) {
+    } else if (md->evict_expert == 2) {
       // evicted by expert LFU
       params->n_hit_lfu_history++;
-      int64_t t = cache->n_req - cache_obj->LeCaR.eviction_vtime;
+      int64_t t = cache->n_req - md->eviction_vtime;
       update_weight(cache, t, &params->w_lfu, &params->w_lru);
 
       remove_obj_from_list(&params->ghost_lfu_head, &params->ghost_lfu_tail,
@@ -258,7 +270,7 @@ static cache_obj_t *LeCaR_find(cache_t *cache, const request_t *req,
       params->lfu_g_occupied_byte -= (cache_obj->obj_size + cache->obj_md_size);
       hashtable_delete(cache->hashtable, cache_obj);
     } else {
-      assert(cache_obj->LeCaR.evict_expert == -1);
+      assert(md->evict_expert == -1);
       hashtable_delete(cache->hashtable, cache_obj);
       // the two experts both pick this object, do nothing
       ;
@@ -271,28 +283,28 @@ static cache_obj_t *LeCaR_find(cache_t *cache, const request_t *req,
 
     // update LFU state
     // it is possible that this is the only object in the cache
-    remove_obj_from_freq_node(params, cache_obj);
+    remove_obj_from_freq_node(cache, params, cache_obj);
 
     /* freq incr and move to next freq node */
-    cache_obj->LeCaR.freq += 1;
-    if (params->max_freq < cache_obj->LeCaR.freq) {
-      params->max_freq = cache_obj->LeCaR.freq;
+    md->freq += 1;
+    if (params->max_freq < md->freq) {
+      params->max_freq = md->freq;
     }
 
-    insert_obj_info_freq_node(params, cache_obj);
+    insert_obj_info_freq_node(cache, params, cache_obj);
     if (cache->n_obj == 1) {
       update_LFU_min_freq(params);
     }
 
     /* it is possible that we update freq to a higher freq
      * when remove_obj_from_freq_node */
-    if (cache_obj->LeCaR.freq < params->min_freq) {
-      params->min_freq = cache_obj->LeCaR.freq;
+    if (md->freq < params->min_freq) {
+      params->min_freq = md->freq;
       VVERBOSE("update min freq to %d\n", (int)params->min_freq);
     }
   }
 
-  if (cache_obj == NULL || cache_obj->LeCaR.is_ghost) {
+  if (cache_obj == NULL || md->is_ghost) {
     return NULL;
   } else {
     return cache_obj;
@@ -316,22 +328,24 @@ cache_obj_t *LeCaR_insert(cache_t *cache, const request_t *req) {
 
   // LRU and hash table insert
   cache_obj_t *cache_obj = cache_insert_base(cache, req);
+  LeCaR_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, LeCaR);
 
   prepend_obj_to_head(&params->q_head, &params->q_tail, cache_obj);
-  cache_obj->LeCaR.freq = 1;
-  cache_obj->LeCaR.is_ghost = false;
-  cache_obj->LeCaR.evict_expert = 0;
-  cache_obj->LeCaR.eviction_vtime = 0;
+  md->freq = 1;
+  md->is_ghost = false;
+  md->evict_expert = 0;
+  md->eviction_vtime = 0;
 
   // LFU insert
   params->min_freq = 1;
   freq_node_t *freq_one_node = params->freq_one_node;
   freq_one_node->n_obj += 1;
-  cache_obj->LeCaR.lfu_prev = freq_one_node->last_obj;
+  md->lfu_prev = freq_one_node->last_obj;
 
   if (freq_one_node->last_obj != NULL) {
     DEBUG_ASSERT(freq_one_node->first_obj != NULL);
-    freq_one_node->last_obj->LeCaR.lfu_next = cache_obj;
+    CACHE_OBJ_MEMBER(cache, freq_one_node->last_obj, LeCaR).lfu_next =
+        cache_obj;
   } else {
     DEBUG_ASSERT(freq_one_node->first_obj == NULL);
     freq_one_node->first_obj = cache_obj;
@@ -405,15 +419,15 @@ static void LeCaR_evict(cache_t *cache, const request_t *req) {
     cache_obj = lfu_choice;
   }
 
-  cache_obj->LeCaR.is_ghost = true;
-  cache_obj->LeCaR.evict_expert = -1;
-  cache_obj->LeCaR.eviction_vtime = cache->n_req;
+  CACHE_OBJ_MEMBER(cache, cache_obj, LeCaR).is_ghost = true;
+  CACHE_OBJ_MEMBER(cache, cache_obj, LeCaR).evict_expert = -1;
+  CACHE_OBJ_MEMBER(cache, cache_obj, LeCaR).eviction_vtime = cache->n_req;
 
   // update LRU chain state
   remove_obj_from_list(&params->q_head, &params->q_tail, cache_obj);
 
   // update LFU chain state
-  remove_obj_from_freq_node(params, cache_obj);
+  remove_obj_from_freq_node(cache, params, cache_obj);
 
   // update cache state
   DEBUG_ASSERT(cache->occupied_byte >= cache_obj->obj_size);
@@ -470,47 +484,47 @@ void LeCaR_evict(cache_t *cache, const request_t *req) {
 
     if (lru_candidate == lfu_candidate) {
       assert(obj_to_evict == lru_candidate);
-      obj_to_evict->LeCaR.evict_expert = -1;
+      CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert = -1;
 
     } else if (obj_to_evict == lru_candidate) {
       // evicted from LRU
-      obj_to_evict->LeCaR.evict_expert = 1;
+      CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert = 1;
 
     } else {
       // mark as ghost object
-      obj_to_evict->LeCaR.evict_expert = 2;
+      CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert = 2;
     }
 
   } else {
     if (lru_candidate == lfu_candidate) {
       obj_to_evict = lru_candidate;
-      obj_to_evict->LeCaR.evict_expert = -1;
+      CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert = -1;
     } else {
       double r = ((double)(next_rand() % 100)) / 100.0;
       if (r < params->w_lru) {
         obj_to_evict = lru_candidate;
-        obj_to_evict->LeCaR.evict_expert = 1;
+        CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert = 1;
       } else {
         obj_to_evict = lfu_candidate;
-        obj_to_evict->LeCaR.evict_expert = 2;
+        CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert = 2;
       }
     }
   }
 
-  obj_to_evict->LeCaR.is_ghost = true;
-  obj_to_evict->LeCaR.eviction_vtime = cache->n_req;
+  CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).is_ghost = true;
+  CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).eviction_vtime = cache->n_req;
 
   // update LRU chain state
   remove_obj_from_list(&params->q_head, &params->q_tail, obj_to_evict);
 
   // update LFU chain state
-  remove_obj_from_freq_node(params, obj_to_evict);
+  remove_obj_from_freq_node(cache, params, obj_to_evict);
 
   // update cache state
   cache_evict_base(cache, obj_to_evict, false);
 
   // update history
-  if (obj_to_evict->LeCaR.evict_expert == 1) {
+  if (CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert == 1) {
     prepend_obj_to_head(&params->ghost_lru_head, &params->ghost_lru_tail,
                         obj_to_evict);
     params->lru_g_occupied_byte += obj_to_evict->obj_size + cache->obj_md_size;
@@ -524,7 +538,7 @@ void LeCaR_evict(cache_t *cache, const request_t *req) {
                            ghost_to_evict);
       hashtable_delete(cache->hashtable, ghost_to_evict);
     }
-  } else if (obj_to_evict->LeCaR.evict_expert == 2) {
+  } else if (CACHE_OBJ_MEMBER(cache, obj_to_evict, LeCaR).evict_expert == 2) {
     prepend_obj_to_head(&params->ghost_lfu_head, &params->ghost_lfu_tail,
                         obj_to_evict);
     params->lfu_g_occupied_byte += obj_to_evict->obj_size + cache->obj_md_size;
@@ -569,7 +583,7 @@ bool LeCaR_remove(cache_t *cache, obj_id_t obj_id) {
   remove_obj_from_list(&params->q_head, &params->q_tail, obj);
 
   // remove from LFU
-  remove_obj_from_freq_node(params, obj);
+  remove_obj_from_freq_node(cache, params, obj);
 
   // remove from hash table and update cache state
   cache_remove_obj_base(cache, obj, true);
@@ -675,12 +689,15 @@ static inline freq_node_t *get_min_freq_node(LeCaR_params_t *params) {
   return min_freq_node;
 }
 
-static inline void remove_obj_from_freq_node(LeCaR_params_t *params,
+static inline void remove_obj_from_freq_node(cache_t *cache,
+                                             LeCaR_params_t *params,
                                              cache_obj_t *cache_obj) {
-  freq_node_t *freq_node = g_hash_table_lookup(
-      params->freq_map, GSIZE_TO_POINTER(cache_obj->LeCaR.freq));
+  LeCaR_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, LeCaR);
+  cache_obj_t *prev = md->lfu_prev, *next = md->lfu_next;
+  freq_node_t *freq_node =
+      g_hash_table_lookup(params->freq_map, GSIZE_TO_POINTER(md->freq));
   DEBUG_ASSERT(freq_node != NULL);
-  DEBUG_ASSERT(freq_node->freq == cache_obj->LeCaR.freq);
+  DEBUG_ASSERT(freq_node->freq == md->freq);
   DEBUG_ASSERT(freq_node->n_obj > 0);
   VVERBOSE("remove object from freq node %p (freq %ld, %u obj)\n", freq_node,
            freq_node->freq, freq_node->n_obj);
@@ -688,61 +705,57 @@ static inline void remove_obj_from_freq_node(LeCaR_params_t *params,
 
   if (cache_obj == freq_node->first_obj) {
     VVVERBOSE("remove object from freq node --- object is the first object\n");
-    freq_node->first_obj = cache_obj->LeCaR.lfu_next;
-    if (cache_obj->LeCaR.lfu_next != NULL)
-      ((cache_obj_t *)(cache_obj->LeCaR.lfu_next))->LeCaR.lfu_prev = NULL;
+    freq_node->first_obj = next;
+    if (next != NULL) CACHE_OBJ_MEMBER(cache, next, LeCaR).lfu_prev = NULL;
   }
 
   if (cache_obj == freq_node->last_obj) {
     VVVERBOSE("remove object from freq node --- object is the last object\n");
-    freq_node->last_obj = cache_obj->LeCaR.lfu_prev;
-    if (cache_obj->LeCaR.lfu_prev != NULL)
-      ((cache_obj_t *)(cache_obj->LeCaR.lfu_prev))->LeCaR.lfu_next = NULL;
+    freq_node->last_obj = prev;
+    if (prev != NULL) CACHE_OBJ_MEMBER(cache, prev, LeCaR).lfu_next = NULL;
   }
 
-  if (cache_obj->LeCaR.lfu_prev != NULL)
-    ((cache_obj_t *)(cache_obj->LeCaR.lfu_prev))->LeCaR.lfu_next =
-        cache_obj->LeCaR.lfu_next;
+  if (prev != NULL) CACHE_OBJ_MEMBER(cache, prev, LeCaR).lfu_next = next;
 
-  if (cache_obj->LeCaR.lfu_next != NULL)
-    ((cache_obj_t *)(cache_obj->LeCaR.lfu_next))->LeCaR.lfu_prev =
-        cache_obj->LeCaR.lfu_prev;
+  if (next != NULL) CACHE_OBJ_MEMBER(cache, next, LeCaR).lfu_prev = prev;
 
-  cache_obj->LeCaR.lfu_prev = NULL;
-  cache_obj->LeCaR.lfu_next = NULL;
+  md->lfu_prev = NULL;
+  md->lfu_next = NULL;
 
   if (freq_node->freq == params->min_freq && freq_node->n_obj == 0) {
     update_LFU_min_freq(params);
   }
 }
 
-static inline void insert_obj_info_freq_node(LeCaR_params_t *params,
+static inline void insert_obj_info_freq_node(cache_t *cache,
+                                             LeCaR_params_t *params,
                                              cache_obj_t *cache_obj) {
+  LeCaR_obj_metadata_t *md = &CACHE_OBJ_MEMBER(cache, cache_obj, LeCaR);
   // find the new freq_node this object should move to
-  freq_node_t *new_node = g_hash_table_lookup(
-      params->freq_map, GSIZE_TO_POINTER(cache_obj->LeCaR.freq));
+  freq_node_t *new_node =
+      g_hash_table_lookup(params->freq_map, GSIZE_TO_POINTER(md->freq));
   if (new_node == NULL) {
     new_node = my_malloc_n(freq_node_t, 1);
     memset(new_node, 0, sizeof(freq_node_t));
-    new_node->freq = cache_obj->LeCaR.freq;
-    g_hash_table_insert(params->freq_map,
-                        GSIZE_TO_POINTER(cache_obj->LeCaR.freq), new_node);
+    new_node->freq = md->freq;
+    g_hash_table_insert(params->freq_map, GSIZE_TO_POINTER(md->freq),
+                        new_node);
   } else {
-    DEBUG_ASSERT(new_node->freq == cache_obj->LeCaR.freq);
+    DEBUG_ASSERT(new_node->freq == md->freq);
   }
 
   /* add to tail of the list */
   if (new_node->last_obj != NULL) {
-    new_node->last_obj->LeCaR.lfu_next = cache_obj;
-    cache_obj->LeCaR.lfu_prev = new_node->last_obj;
+    CACHE_OBJ_MEMBER(cache, new_node->last_obj, LeCaR).lfu_next = cache_obj;
+    md->lfu_prev = new_node->last_obj;
   } else {
     DEBUG_ASSERT(new_node->first_obj == NULL);
     DEBUG_ASSERT(new_node->n_obj == 0);
     new_node->first_obj = cache_obj;
-    cache_obj->LeCaR.lfu_prev = NULL;
+    md->lfu_prev = NULL;
   }
 
-  cache_obj->LeCaR.lfu_next = NULL;
+  md->lfu_next = NULL;
   new_node->last_obj = cache_obj;
   new_node->n_obj += 1;
 }
@@ -59,6 +59,16 @@ static inline int64_t LeCaRv0_get_n_obj(const cache_t *cache) {
   return params->LRU->get_n_obj(params->LRU);
 }
 
+static int64_t LeCaRv0_get_metadata_bytes(const cache_t *cache) {
+  LeCaRv0_params_t *params = (LeCaRv0_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(LeCaRv0_params_t) +
+         params->LRU->get_metadata_bytes(params->LRU) +
+         params->LRU_g->get_metadata_bytes(params->LRU_g) +
+         params->LFU->get_metadata_bytes(params->LFU) +
+         params->LFU_g->get_metadata_bytes(params->LFU_g);
+}
+
 static inline int64_t LeCaRv0_get_occupied_byte(const cache_t *cache) {
   LeCaRv0_params_t *params = (LeCaRv0_params_t *)(cache->eviction_params);
   DEBUG_ASSERT(params->LRU->get_occupied_byte(params->LRU) ==
@@ -89,6 +99,7 @@ cache_t *LeCaRv0_init(const common_cache_params_t ccache_params,
   cache->remove = LeCaRv0_remove;
   cache->to_evict = LeCaRv0_to_evict;
   cache->get_n_obj = LeCaRv0_get_n_obj;
+  cache->get_metadata_bytes = LeCaRv0_get_metadata_bytes;
   cache->get_occupied_byte = LeCaRv0_get_occupied_byte;
 
   if (ccache_params.consider_obj_metadata) {
@@ -115,6 +126,11 @@ cache_t *LeCaRv0_init(const common_cache_params_t ccache_params,
 
   params->LRU_g = LRU_init(ccache_params_g, NULL);
   params->LFU_g = LRU_init(ccache_params_g, NULL);
+  /* the lists share the objects' metadata */
+  cache_set_obj_struct_size(params->LRU, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->LFU, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->LRU_g, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->LFU_g, sizeof(cache_obj_t));
 
   return cache;
 }
@@ -262,13 +278,13 @@ static void LeCaRv0_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *lfu_candidate = params->LFU->to_evict(params->LFU, req);
 
   if (lru_candidate->obj_id == lfu_candidate->obj_id) {
-    copy_cache_obj_to_request(req_local, lru_candidate);
+    copy_cache_obj_to_request(req_local, params->LRU, lru_candidate);
     params->LFU->remove(params->LFU, lru_candidate->obj_id);
     params->LRU->evict(params->LRU, req);
   } else {
     double r = ((double)(next_rand() % 100)) / 100.0;
     if (r < params->w_lru) {
-      copy_cache_obj_to_request(req_local, lru_candidate);
+      copy_cache_obj_to_request(req_local, params->LRU, lru_candidate);
       params->LFU->remove(params->LFU, lru_candidate->obj_id);
       params->LRU->evict(params->LRU, req);
       DEBUG_ASSERT(!params->LRU_g->find(params->LRU_g, req_local, false));
@@ -276,7 +292,7 @@ static void LeCaRv0_evict(cache_t *cache, const request_t *req) {
       cache_obj_t *obj = params->LRU_g->find(params->LRU_g, req_local, false);
       obj->LeCaR.eviction_vtime = cache->n_req;
     } else {
-      copy_cache_obj_to_request(req_local, lfu_candidate);
+      copy_cache_obj_to_request(req_local, params->LFU, lfu_candidate);
       params->LRU->remove(params->LRU, lfu_candidate->obj_id);
       params->LFU->evict(params->LFU, req);
       DEBUG_ASSERT(!params->LFU_g->find(params->LFU_g, req_local, false));
@@ -60,6 +60,7 @@ cache_t *MRU_init(const common_cache_params_t ccache_params,
   cache->evict = MRU_evict;
   cache->to_evict = MRU_to_evict;
   cache->remove = MRU_remove;
+  cache_set_obj_struct_size(cache, CACHE_OBJ_HEADER_SIZE);
 
   cache->eviction_params = malloc(sizeof(MRU_params_t));
   MRU_params_t *params = (MRU_params_t *)cache->eviction_params;
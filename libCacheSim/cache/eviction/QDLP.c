@@ -62,6 +62,7 @@ static void QDLP_evict(cache_t *cache, const request_t *req);
 static bool QDLP_remove(cache_t *cache, const obj_id_t obj_id);
 static inline int64_t QDLP_get_occupied_byte(const cache_t *cache);
 static inline int64_t QDLP_get_n_obj(const cache_t *cache);
+static int64_t QDLP_get_metadata_bytes(const cache_t *cache);
 static inline bool QDLP_can_insert(cache_t *cache, const request_t *req);
 static void QDLP_parse_params(cache_t *cache,
                                 const char *cache_specific_params);
@@ -85,6 +86,7 @@ cache_t *QDLP_init(const common_cache_params_t ccache_params,
   cache->remove = QDLP_remove;
   cache->to_evict = QDLP_to_evict;
   cache->get_n_obj = QDLP_get_n_obj;
+  cache->get_metadata_bytes = QDLP_get_metadata_bytes;
   cache->get_occupied_byte = QDLP_get_occupied_byte;
   cache->can_insert = QDLP_can_insert;
 
@@ -153,6 +155,13 @@ cache_t *QDLP_init(const common_cache_params_t ccache_params,
     ERROR("QDLP does not support %s \n", params->main_cache_type);
   }
 
+  /* QDLP keeps its metadata in the objects of the sub-caches */
+  cache_set_obj_struct_size(params->fifo, sizeof(cache_obj_t));
+  if (params->fifo_ghost != NULL) {
+    cache_set_obj_struct_size(params->fifo_ghost, sizeof(cache_obj_t));
+  }
+  cache_set_obj_struct_size(params->main_cache, sizeof(cache_obj_t));
+
 #if defined(TRACK_EVICTION_V_AGE)
   if (params->fifo_ghost != NULL) {
     params->fifo_ghost->track_eviction_age = false;
@@ -354,7 +363,7 @@ static void QDLP_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = fifo->to_evict(fifo, req);
   assert(obj != NULL);
   // need to copy the object before it is evicted
-  copy_cache_obj_to_request(params->req_local, obj);
+  copy_cache_obj_to_request(params->req_local, fifo, obj);
 
   if (obj->misc.freq >= params->move_to_main_threshold) {
     // get will insert to and evict from main cache
@@ -416,6 +425,18 @@ static inline int64_t QDLP_get_n_obj(const cache_t *cache) {
          params->main_cache->get_n_obj(params->main_cache);
 }
 
+static int64_t QDLP_get_metadata_bytes(const cache_t *cache) {
+  QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(QDLP_params_t) +
+                   params->fifo->get_metadata_bytes(params->fifo) +
+                   params->main_cache->get_metadata_bytes(params->main_cache);
+  if (params->fifo_ghost != NULL) {
+    n_byte += params->fifo_ghost->get_metadata_bytes(params->fifo_ghost);
+  }
+  return n_byte;
+}
+
 static inline bool QDLP_can_insert(cache_t *cache, const request_t *req) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
 
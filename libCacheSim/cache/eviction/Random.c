@@ -58,6 +58,7 @@ cache_t *Random_init(const common_cache_params_t ccache_params,
   cache->to_evict = Random_to_evict;
   cache->evict = Random_evict;
   cache->remove = Random_remove;
+  cache_set_obj_struct_size(cache, CACHE_OBJ_HEADER_SIZE);
 
   return cache;
 }
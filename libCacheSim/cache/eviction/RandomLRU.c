@@ -57,6 +57,7 @@ cache_t *RandomLRU_init(const common_cache_params_t ccache_params, const char *c
   ccache_params_copy.hashpower = MAX(12, ccache_params_copy.hashpower - 8);
 
   cache_t *cache = cache_struct_init("RandomLRU", ccache_params_copy, cache_specific_params);
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(Random));
   cache->cache_init = RandomLRU_init;
   cache->cache_free = RandomLRU_free;
   cache->get = RandomLRU_get;
@@ -127,7 +128,7 @@ static bool RandomLRU_get(cache_t *cache, const request_t *req) { return cache_g
 static cache_obj_t *RandomLRU_find(cache_t *cache, const request_t *req, const bool update_cache) {
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
   if (obj != NULL && update_cache) {
-    obj->Random.last_access_vtime = cache->n_req;
+    CACHE_OBJ_MEMBER(cache, obj, Random).last_access_vtime = cache->n_req;
   }
 
   return obj;
@@ -145,7 +146,7 @@ static cache_obj_t *RandomLRU_find(cache_t *cache, const request_t *req, const b
  */
 static cache_obj_t *RandomLRU_insert(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = cache_insert_base(cache, req);
-  obj->Random.last_access_vtime = cache->n_req;
+  CACHE_OBJ_MEMBER(cache, obj, Random).last_access_vtime = cache->n_req;
 
   return obj;
 }
@@ -181,6 +182,7 @@ static int compare_access_time(const void *p1, const void *p2) {
   const cache_obj_t *obj1 = *(const cache_obj_t **)p1;
   const cache_obj_t *obj2 = *(const cache_obj_t **)p2;
 
+  // qsort does not pass the cache, Random is checked when it is updated
   if (obj1->Random.last_access_vtime < obj2->Random.last_access_vtime) {
     return -1;
   } else if (obj1->Random.last_access_vtime > obj2->Random.last_access_vtime) {
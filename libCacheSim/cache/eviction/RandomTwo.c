@@ -51,6 +51,7 @@ cache_t *RandomTwo_init(const common_cache_params_t ccache_params,
 
   cache_t *cache =
       cache_struct_init("RandomTwo", ccache_params_copy, cache_specific_params);
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(Random));
   cache->cache_init = RandomTwo_init;
   cache->cache_free = RandomTwo_free;
   cache->get = RandomTwo_get;
@@ -113,7 +114,7 @@ static cache_obj_t *RandomTwo_find(cache_t *cache, const request_t *req,
                                    const bool update_cache) {
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
   if (obj != NULL && update_cache) {
-    obj->Random.last_access_vtime = cache->n_req;
+    CACHE_OBJ_MEMBER(cache, obj, Random).last_access_vtime = cache->n_req;
   }
 
   return obj;
@@ -131,7 +132,7 @@ static cache_obj_t *RandomTwo_find(cache_t *cache, const request_t *req,
  */
 static cache_obj_t *RandomTwo_insert(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = cache_insert_base(cache, req);
-  obj->Random.last_access_vtime = cache->n_req;
+  CACHE_OBJ_MEMBER(cache, obj, Random).last_access_vtime = cache->n_req;
 
   return obj;
 }
@@ -149,8 +150,8 @@ static cache_obj_t *RandomTwo_insert(cache_t *cache, const request_t *req) {
 static cache_obj_t *RandomTwo_to_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *obj_to_evict1 = hashtable_rand_obj(cache->hashtable);
   cache_obj_t *obj_to_evict2 = hashtable_rand_obj(cache->hashtable);
-  if (obj_to_evict1->Random.last_access_vtime <
-      obj_to_evict2->Random.last_access_vtime)
+  if (CACHE_OBJ_MEMBER(cache, obj_to_evict1, Random).last_access_vtime <
+      CACHE_OBJ_MEMBER(cache, obj_to_evict2, Random).last_access_vtime)
     return obj_to_evict1;
   else
     return obj_to_evict2;
@@ -167,8 +168,8 @@ static cache_obj_t *RandomTwo_to_evict(cache_t *cache, const request_t *req) {
 static void RandomTwo_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *obj_to_evict1 = hashtable_rand_obj(cache->hashtable);
   cache_obj_t *obj_to_evict2 = hashtable_rand_obj(cache->hashtable);
-  if (obj_to_evict1->Random.last_access_vtime <
-      obj_to_evict2->Random.last_access_vtime)
+  if (CACHE_OBJ_MEMBER(cache, obj_to_evict1, Random).last_access_vtime <
+      CACHE_OBJ_MEMBER(cache, obj_to_evict2, Random).last_access_vtime)
     cache_evict_base(cache, obj_to_evict1, true);
   else
     cache_evict_base(cache, obj_to_evict2, true);
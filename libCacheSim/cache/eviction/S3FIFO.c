@@ -69,9 +69,14 @@ static void S3FIFO_evict(cache_t *cache, const request_t *req);
 static bool S3FIFO_remove(cache_t *cache, const obj_id_t obj_id);
 static inline int64_t S3FIFO_get_occupied_byte(const cache_t *cache);
 static inline int64_t S3FIFO_get_n_obj(const cache_t *cache);
+static int64_t S3FIFO_get_metadata_bytes(const cache_t *cache);
 static inline bool S3FIFO_can_insert(cache_t *cache, const request_t *req);
 static void S3FIFO_parse_params(cache_t *cache,
                                 const char *cache_specific_params);
+static bool S3FIFO_save_state(const cache_t *cache, FILE *f);
+static bool S3FIFO_load_state(cache_t *cache, FILE *f);
+static bool S3FIFO_set_params(cache_t *cache,
+                              const char *cache_specific_params);
 
 static void S3FIFO_evict_fifo(cache_t *cache, const request_t *req);
 static void S3FIFO_evict_main(cache_t *cache, const request_t *req);
@@ -95,8 +100,12 @@ cache_t *S3FIFO_init(const common_cache_params_t ccache_params,
   cache->remove = S3FIFO_remove;
   cache->to_evict = S3FIFO_to_evict;
   cache->get_n_obj = S3FIFO_get_n_obj;
+  cache->get_metadata_bytes = S3FIFO_get_metadata_bytes;
   cache->get_occupied_byte = S3FIFO_get_occupied_byte;
   cache->can_insert = S3FIFO_can_insert;
+  cache->save_state = S3FIFO_save_state;
+  cache->load_state = S3FIFO_load_state;
+  cache->set_params = S3FIFO_set_params;
 
   cache->obj_md_size = 0;
 
@@ -133,6 +142,13 @@ cache_t *S3FIFO_init(const common_cache_params_t ccache_params,
   ccache_params_local.cache_size = main_cache_size;
   params->main_cache = FIFO_init(ccache_params_local, NULL);
 
+  /* S3FIFO keeps its metadata in the objects of the sub-caches */
+  cache_set_obj_struct_size(params->fifo, sizeof(cache_obj_t));
+  if (params->fifo_ghost != NULL) {
+    cache_set_obj_struct_size(params->fifo_ghost, sizeof(cache_obj_t));
+  }
+  cache_set_obj_struct_size(params->main_cache, sizeof(cache_obj_t));
+
 #if defined(TRACK_EVICTION_V_AGE)
   if (params->fifo_ghost != NULL) {
     params->fifo_ghost->track_eviction_age = false;
@@ -329,7 +345,7 @@ static void S3FIFO_evict_fifo(cache_t *cache, const request_t *req) {
     cache_obj_t *obj_to_evict = fifo->to_evict(fifo, req);
     DEBUG_ASSERT(obj_to_evict != NULL);
     // need to copy the object before it is evicted
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, fifo, obj_to_evict);
 
     if (obj_to_evict->S3FIFO.freq >= params->move_to_main_threshold) {
 #if defined(TRACK_DEMOTION)
@@ -384,7 +400,7 @@ static void S3FIFO_evict_main(cache_t *cache, const request_t *req) {
 #if defined(TRACK_EVICTION_V_AGE)
     int64_t create_time = obj_to_evict->create_time;
 #endif
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, main, obj_to_evict);
     if (freq >= 1) {
       // we need to evict first because the object to insert has the same obj_id
       // main->evict(main, req);
@@ -475,6 +491,18 @@ static inline int64_t S3FIFO_get_n_obj(const cache_t *cache) {
          params->main_cache->get_n_obj(params->main_cache);
 }
 
+static int64_t S3FIFO_get_metadata_bytes(const cache_t *cache) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(S3FIFO_params_t) +
+                   params->fifo->get_metadata_bytes(params->fifo) +
+                   params->main_cache->get_metadata_bytes(params->main_cache);
+  if (params->fifo_ghost != NULL) {
+    n_byte += params->fifo_ghost->get_metadata_bytes(params->fifo_ghost);
+  }
+  return n_byte;
+}
+
 static inline bool S3FIFO_can_insert(cache_t *cache, const request_t *req) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
 
@@ -529,6 +557,82 @@ static void S3FIFO_parse_params(cache_t *cache,
   free(old_params_str);
 }
 
+/* only move-to-main-threshold can be changed on a warm cache, the size
+ * ratios decide the sizes of the sub-caches */
+static bool S3FIFO_set_params(cache_t *cache,
+                              const char *cache_specific_params) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  double fifo_size_ratio = params->fifo_size_ratio;
+  double ghost_size_ratio = params->ghost_size_ratio;
+  int move_to_main_threshold = params->move_to_main_threshold;
+
+  S3FIFO_parse_params(cache, cache_specific_params);
+  if (params->fifo_size_ratio != fifo_size_ratio ||
+      params->ghost_size_ratio != ghost_size_ratio) {
+    WARN("%s cannot change fifo-size-ratio or ghost-size-ratio of a warm "
+         "cache\n",
+         cache->cache_name);
+    params->fifo_size_ratio = fifo_size_ratio;
+    params->ghost_size_ratio = ghost_size_ratio;
+    params->move_to_main_threshold = move_to_main_threshold;
+    return false;
+  }
+
+  snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "S3FIFO-%.4lf-%d",
+           params->fifo_size_ratio, params->move_to_main_threshold);
+  return true;
+}
+
+// ***********************************************************************
+// ****                                                               ****
+// ****                       snapshot functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+/* the small FIFO, the ghost and the main FIFO are saved as sub-caches */
+static bool S3FIFO_save_state(const cache_t *cache, FILE *f) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  int64_t stat[6] = {params->n_obj_admit_to_fifo,  params->n_obj_admit_to_main,
+                     params->n_obj_move_to_main,   params->n_byte_admit_to_fifo,
+                     params->n_byte_admit_to_main, params->n_byte_move_to_main};
+  bool has_ghost = params->fifo_ghost != NULL;
+
+  return cache_snapshot_write_tag(f, "S3FIFO") &&
+         fwrite(stat, sizeof(stat), 1, f) == 1 &&
+         fwrite(&has_ghost, sizeof(bool), 1, f) == 1 &&
+         cache_save_state(params->fifo, f) &&
+         (!has_ghost || cache_save_state(params->fifo_ghost, f)) &&
+         cache_save_state(params->main_cache, f);
+}
+
+/* the sub-caches must have the same sizes as the saved cache, so
+ * fifo-size-ratio and ghost-size-ratio cannot change, while
+ * move-to-main-threshold can */
+static bool S3FIFO_load_state(cache_t *cache, FILE *f) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  int64_t stat[6];
+  bool has_ghost;
+  if (!cache_snapshot_check_tag(f, "S3FIFO") ||
+      fread(stat, sizeof(stat), 1, f) != 1 ||
+      fread(&has_ghost, sizeof(bool), 1, f) != 1) {
+    return false;
+  }
+  if (has_ghost != (params->fifo_ghost != NULL)) {
+    WARN("snapshot and cache differ in whether a ghost queue is used\n");
+    return false;
+  }
+
+  params->n_obj_admit_to_fifo = stat[0];
+  params->n_obj_admit_to_main = stat[1];
+  params->n_obj_move_to_main = stat[2];
+  params->n_byte_admit_to_fifo = stat[3];
+  params->n_byte_admit_to_main = stat[4];
+  params->n_byte_move_to_main = stat[5];
+
+  return cache_load_state(params->fifo, f) &&
+         (!has_ghost || cache_load_state(params->fifo_ghost, f)) &&
+         cache_load_state(params->main_cache, f);
+}
+
 #ifdef __cplusplus
 }
 #endif
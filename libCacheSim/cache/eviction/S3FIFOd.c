@@ -63,6 +63,7 @@ static void S3FIFOd_evict(cache_t *cache, const request_t *req);
 static bool S3FIFOd_remove(cache_t *cache, const obj_id_t obj_id);
 static inline int64_t S3FIFOd_get_occupied_byte(const cache_t *cache);
 static inline int64_t S3FIFOd_get_n_obj(const cache_t *cache);
+static int64_t S3FIFOd_get_metadata_bytes(const cache_t *cache);
 static inline bool S3FIFOd_can_insert(cache_t *cache, const request_t *req);
 static void S3FIFOd_parse_params(cache_t *cache,
                                 const char *cache_specific_params);
@@ -85,6 +86,7 @@ cache_t *S3FIFOd_init(const common_cache_params_t ccache_params,
   cache->remove = S3FIFOd_remove;
   cache->to_evict = S3FIFOd_to_evict;
   cache->get_n_obj = S3FIFOd_get_n_obj;
+  cache->get_metadata_bytes = S3FIFOd_get_metadata_bytes;
   cache->get_occupied_byte = S3FIFOd_get_occupied_byte;
   cache->can_insert = S3FIFOd_can_insert;
 
@@ -144,11 +146,17 @@ cache_t *S3FIFOd_init(const common_cache_params_t ccache_params,
   } else {
     ERROR("S3FIFOd does not support %s \n", params->main_cache_type);
   }
+  /* S3FIFOd keeps its metadata in the objects of the sub-caches */
+  cache_set_obj_struct_size(params->fifo, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->fifo_ghost, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->main_cache, sizeof(cache_obj_t));
 
   ccache_params_local.cache_size = ccache_params.cache_size / 10;
   ccache_params_local.hashpower -= 4;
   params->fifo_eviction = FIFO_init(ccache_params_local, NULL);
   params->main_cache_eviction = FIFO_init(ccache_params_local, NULL);
+  cache_set_obj_struct_size(params->fifo_eviction, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->main_cache_eviction, sizeof(cache_obj_t));
   snprintf(params->fifo_eviction->cache_name, CACHE_NAME_ARRAY_LEN,
            "FIFO-evicted");
   snprintf(params->main_cache_eviction->cache_name, CACHE_NAME_ARRAY_LEN, "%s",
@@ -411,7 +419,7 @@ static void S3FIFOd_evict(cache_t *cache, const request_t *req) {
 #if defined(TRACK_EVICTION_V_AGE)
     record_eviction_age(cache, obj, CURR_TIME(cache, req) - obj->create_time);
 #endif
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, main, obj);
     params->main_cache_eviction->get(params->main_cache_eviction,
                                      params->req_local);
     main->evict(main, req);
@@ -422,7 +430,7 @@ static void S3FIFOd_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = fifo->to_evict(fifo, req);
   assert(obj != NULL);
   // need to copy the object before it is evicted
-  copy_cache_obj_to_request(params->req_local, obj);
+  copy_cache_obj_to_request(params->req_local, fifo, obj);
 
 #if defined(TRACK_EVICTION_V_AGE)
   if (obj->misc.freq >= params->move_to_main_threshold) {
@@ -436,7 +444,7 @@ static void S3FIFOd_evict(cache_t *cache, const request_t *req) {
     while (main->get_occupied_byte(main) > main->cache_size) {
       // evict from main cache
       obj = main->to_evict(main, req);
-      copy_cache_obj_to_request(params->req_local, obj);
+      copy_cache_obj_to_request(params->req_local, main, obj);
       params->main_cache_eviction->get(params->main_cache_eviction,
                                        params->req_local);
       main->evict(main, req);
@@ -464,7 +472,7 @@ static void S3FIFOd_evict(cache_t *cache, const request_t *req) {
     while (main->get_occupied_byte(main) > main->cache_size) {
       // evict from main cache
       obj = main->to_evict(main, req);
-      copy_cache_obj_to_request(params->req_local, obj);
+      copy_cache_obj_to_request(params->req_local, main, obj);
       params->main_cache_eviction->get(params->main_cache_eviction,
                                        params->req_local);
       main->evict(main, req);
@@ -512,6 +520,20 @@ static inline int64_t S3FIFOd_get_n_obj(const cache_t *cache) {
          params->main_cache->get_n_obj(params->main_cache);
 }
 
+static int64_t S3FIFOd_get_metadata_bytes(const cache_t *cache) {
+  S3FIFOd_params_t *params = (S3FIFOd_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(S3FIFOd_params_t) +
+                   params->fifo->get_metadata_bytes(params->fifo) +
+                   params->main_cache->get_metadata_bytes(params->main_cache) +
+                   params->fifo_eviction->get_metadata_bytes(params->fifo_eviction) +
+                   params->main_cache_eviction->get_metadata_bytes(params->main_cache_eviction);
+  if (params->fifo_ghost != NULL) {
+    n_byte += params->fifo_ghost->get_metadata_bytes(params->fifo_ghost);
+  }
+  return n_byte;
+}
+
 static inline bool S3FIFOd_can_insert(cache_t *cache, const request_t *req) {
   S3FIFOd_params_t *params = (S3FIFOd_params_t *)cache->eviction_params;
 
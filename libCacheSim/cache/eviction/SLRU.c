@@ -42,6 +42,8 @@ static cache_obj_t *SLRU_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *SLRU_to_evict(cache_t *cache, const request_t *req);
 static void SLRU_evict(cache_t *cache, const request_t *req);
 static bool SLRU_remove(cache_t *cache, const obj_id_t obj_id);
+static bool SLRU_save_state(const cache_t *cache, FILE *f);
+static bool SLRU_load_state(cache_t *cache, FILE *f);
 
 /* internal function */
 static void SLRU_promote_to_next_seg(cache_t *cache, const request_t *req,
@@ -113,12 +115,15 @@ cache_t *SLRU_init(const common_cache_params_t ccache_params,
   cache->remove = SLRU_remove;
   cache->to_evict = SLRU_to_evict;
   cache->can_insert = SLRU_can_insert;
+  cache->save_state = SLRU_save_state;
+  cache->load_state = SLRU_load_state;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 8 * 2;
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(SLRU));
 
   cache->eviction_params = (SLRU_params_t *)malloc(sizeof(SLRU_params_t));
   SLRU_params_t *params = (SLRU_params_t *)(cache->eviction_params);
@@ -255,16 +260,16 @@ static cache_obj_t *SLRU_find(cache_t *cache, const request_t *req,
   }
 #endif
 
-  if (obj->SLRU.lru_id == params->n_seg - 1) {
+  if (CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id == params->n_seg - 1) {
     move_obj_to_head(&params->lru_heads[params->n_seg - 1],
                      &params->lru_tails[params->n_seg - 1], obj);
   } else {
     SLRU_promote_to_next_seg(cache, req, obj);
 
-    while (params->lru_n_bytes[obj->SLRU.lru_id] >
-           params->lru_max_n_bytes[obj->SLRU.lru_id]) {
+    while (params->lru_n_bytes[CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id] >
+           params->lru_max_n_bytes[CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id]) {
       // if the LRU is full
-      SLRU_cool(cache, req, obj->SLRU.lru_id);
+      SLRU_cool(cache, req, CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id);
     }
     DEBUG_ASSERT(cache->occupied_byte <= cache->cache_size);
   }
@@ -314,7 +319,7 @@ static cache_obj_t *SLRU_insert(cache_t *cache, const request_t *req) {
 
   prepend_obj_to_head(&params->lru_heads[nth_seg], &params->lru_tails[nth_seg],
                       obj);
-  obj->SLRU.lru_id = nth_seg;
+  CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id = nth_seg;
   params->lru_n_bytes[nth_seg] += req->obj_size + cache->obj_md_size;
   params->lru_n_objs[nth_seg]++;
 
@@ -360,11 +365,12 @@ static void SLRU_evict(cache_t *cache, const request_t *req) {
 
   cache_obj_t *obj = SLRU_to_evict(cache, req);
 
-  params->lru_n_bytes[obj->SLRU.lru_id] -= obj->obj_size + cache->obj_md_size;
-  params->lru_n_objs[obj->SLRU.lru_id]--;
+  int lru_id = CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id;
+  params->lru_n_bytes[lru_id] -= obj->obj_size + cache->obj_md_size;
+  params->lru_n_objs[lru_id]--;
 
-  remove_obj_from_list(&params->lru_heads[obj->SLRU.lru_id],
-                       &params->lru_tails[obj->SLRU.lru_id], obj);
+  remove_obj_from_list(&params->lru_heads[lru_id], &params->lru_tails[lru_id],
+                       obj);
   cache_evict_base(cache, obj, true);
 }
 
@@ -389,8 +395,9 @@ static bool SLRU_remove(cache_t *cache, const obj_id_t obj_id) {
     return false;
   }
 
-  remove_obj_from_list(&(params->lru_heads[obj->SLRU.lru_id]),
-                       &(params->lru_tails[obj->SLRU.lru_id]), obj);
+  int lru_id = CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id;
+  remove_obj_from_list(&(params->lru_heads[lru_id]),
+                       &(params->lru_tails[lru_id]), obj);
   cache_remove_obj_base(cache, obj, true);
 
   return true;
@@ -492,11 +499,11 @@ static void SLRU_cool(cache_t *cache, const request_t *req, const int id) {
 
   cache_obj_t *obj = params->lru_tails[id];
   DEBUG_ASSERT(obj != NULL);
-  DEBUG_ASSERT(obj->SLRU.lru_id == id);
+  DEBUG_ASSERT(CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id == id);
   remove_obj_from_list(&params->lru_heads[id], &params->lru_tails[id], obj);
   prepend_obj_to_head(&params->lru_heads[id - 1], &params->lru_tails[id - 1],
                       obj);
-  obj->SLRU.lru_id = id - 1;
+  CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id = id - 1;
   params->lru_n_bytes[id] -= obj->obj_size;
   params->lru_n_bytes[id - 1] += obj->obj_size;
   params->lru_n_objs[id]--;
@@ -517,12 +524,12 @@ static void SLRU_promote_to_next_seg(cache_t *cache, const request_t *req,
   SLRU_params_t *params = (SLRU_params_t *)(cache->eviction_params);
   DEBUG_PRINT_CACHE_STATE(cache, params, req);
 
-  int id = obj->SLRU.lru_id;
+  int id = CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id;
   remove_obj_from_list(&params->lru_heads[id], &params->lru_tails[id], obj);
   params->lru_n_bytes[id] -= obj->obj_size + cache->obj_md_size;
   params->lru_n_objs[id]--;
 
-  obj->SLRU.lru_id += 1;
+  CACHE_OBJ_MEMBER(cache, obj, SLRU).lru_id += 1;
   prepend_obj_to_head(&params->lru_heads[id + 1], &params->lru_tails[id + 1],
                       obj);
   params->lru_n_bytes[id + 1] += obj->obj_size + cache->obj_md_size;
@@ -578,6 +585,52 @@ bool SLRU_get_debug(cache_t *cache, const request_t *req) {
   return cache_hit;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                       snapshot functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+static bool SLRU_save_state(const cache_t *cache, FILE *f) {
+  SLRU_params_t *params = (SLRU_params_t *)cache->eviction_params;
+  if (!cache_snapshot_write_tag(f, "SLRU") ||
+      fwrite(&params->n_seg, sizeof(int), 1, f) != 1) {
+    return false;
+  }
+
+  for (int i = 0; i < params->n_seg; i++) {
+    if (!cache_save_obj_list(cache, f, params->lru_tails[i])) return false;
+  }
+  return true;
+}
+
+/* the segments must have the same number as the saved cache */
+static bool SLRU_load_state(cache_t *cache, FILE *f) {
+  SLRU_params_t *params = (SLRU_params_t *)cache->eviction_params;
+  int n_seg;
+  if (!cache_snapshot_check_tag(f, "SLRU") ||
+      fread(&n_seg, sizeof(int), 1, f) != 1) {
+    return false;
+  }
+  if (n_seg != params->n_seg) {
+    WARN("snapshot has %d segments, but the cache has %d\n", n_seg,
+         params->n_seg);
+    return false;
+  }
+
+  for (int i = 0; i < params->n_seg; i++) {
+    if (cache_load_obj_list(cache, f, &params->lru_heads[i],
+                            &params->lru_tails[i]) < 0) {
+      return false;
+    }
+    for (cache_obj_t *obj = params->lru_heads[i]; obj != NULL;
+         obj = obj->queue.next) {
+      params->lru_n_bytes[i] += obj->obj_size + cache->obj_md_size;
+      params->lru_n_objs[i]++;
+    }
+  }
+  return true;
+}
+
 #ifdef __cplusplus
 extern "C"
 }
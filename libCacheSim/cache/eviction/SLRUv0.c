@@ -45,6 +45,7 @@ static void SLRUv0_cool(cache_t *cache, const request_t *req, int i);
 static inline bool SLRUv0_can_insert(cache_t *cache, const request_t *req);
 static inline int64_t SLRUv0_get_occupied_byte(const cache_t *cache);
 static inline int64_t SLRUv0_get_n_obj(const cache_t *cache);
+static int64_t SLRUv0_get_metadata_bytes(const cache_t *cache);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -74,6 +75,7 @@ cache_t *SLRUv0_init(const common_cache_params_t ccache_params,
   cache->can_insert = SLRUv0_can_insert;
   cache->get_occupied_byte = SLRUv0_get_occupied_byte;
   cache->get_n_obj = SLRUv0_get_n_obj;
+  cache->get_metadata_bytes = SLRUv0_get_metadata_bytes;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 8 * 2;
@@ -98,6 +100,10 @@ cache_t *SLRUv0_init(const common_cache_params_t ccache_params,
   for (int i = 1; i < params->n_seg; i++) {
     params->LRUs[i] = LRU_init(ccache_params_local, NULL);
   }
+  /* the objects move between the segments with their metadata */
+  for (int i = 0; i < params->n_seg; i++) {
+    cache_set_obj_struct_size(params->LRUs[i], sizeof(cache_obj_t));
+  }
   params->req_local = new_request();
 
   return cache;
@@ -337,6 +343,16 @@ static inline int64_t SLRUv0_get_n_obj(const cache_t *cache) {
   return n_obj;
 }
 
+static int64_t SLRUv0_get_metadata_bytes(const cache_t *cache) {
+  SLRUv0_params_t *params = (SLRUv0_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(SLRUv0_params_t);
+  for (int i = 0; i < params->n_seg; i++) {
+    n_byte += params->LRUs[i]->get_metadata_bytes(params->LRUs[i]);
+  }
+  return n_byte;
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                parameter set up functions                     ****
@@ -407,7 +423,7 @@ static void SLRUv0_cool(cache_t *cache, const request_t *req, int i) {
 
   // the evicted object move to lower lru
   cache_obj_t *obj_evicted = lru->to_evict(lru, req);
-  copy_cache_obj_to_request(saved_req, obj_evicted);
+  copy_cache_obj_to_request(saved_req, lru, obj_evicted);
   lru->evict(lru, NULL);
 
   // If lower LRUs are full
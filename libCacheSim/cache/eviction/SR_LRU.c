@@ -26,6 +26,7 @@ static bool SR_LRU_remove(cache_t *cache, const obj_id_t obj_id);
 static bool SR_LRU_can_insert(cache_t *cache, const request_t *req);
 static int64_t SR_LRU_get_occupied_byte(const cache_t *cache);
 static int64_t SR_LRU_get_n_obj(const cache_t *cache);
+static int64_t SR_LRU_get_metadata_bytes(const cache_t *cache);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -55,6 +56,7 @@ cache_t *SR_LRU_init(const common_cache_params_t ccache_params,
   cache->can_insert = SR_LRU_can_insert;
   cache->get_occupied_byte = SR_LRU_get_occupied_byte;
   cache->get_n_obj = SR_LRU_get_n_obj;
+  cache->get_metadata_bytes = SR_LRU_get_metadata_bytes;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 2;
@@ -73,6 +75,10 @@ cache_t *SR_LRU_init(const common_cache_params_t ccache_params,
   ccache_params_local.cache_size /= 2;
   params->SR_list = LRU_init(ccache_params_local, NULL);
   params->R_list = LRU_init(ccache_params_local, NULL);
+  /* SR-LRU keeps its metadata in the objects of the lists */
+  cache_set_obj_struct_size(params->H_list, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->SR_list, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->R_list, sizeof(cache_obj_t));
   params->C_demoted = 0;
   params->C_new = 0;
 
@@ -166,7 +172,7 @@ static cache_obj_t *SR_LRU_find(cache_t *cache, const request_t *req,
   } else if (cache_hit_SR && likely(update_cache)) {
     // On a cache hit where requested obj is in SR, it is moved to the MRU
     // position of R. Move hit obj from SR to R.
-    copy_cache_obj_to_request(params->req_local, obj_SR);
+    copy_cache_obj_to_request(params->req_local, SR, obj_SR);
     obj_R = R->insert(R, params->req_local);
     SR->remove(SR, req->obj_id);
 
@@ -174,7 +180,7 @@ static cache_obj_t *SR_LRU_find(cache_t *cache, const request_t *req,
     while (R->get_occupied_byte(R) > R->cache_size) {
       DEBUG_ASSERT(R->get_occupied_byte(R) > 0);
       cache_obj_t *obj_from_R = R->to_evict(R, req);
-      copy_cache_obj_to_request(params->req_local, obj_from_R);
+      copy_cache_obj_to_request(params->req_local, R, obj_from_R);
       cache_obj_t *obj_in_SR = SR->insert(SR, params->req_local);
       if (!obj_from_R->SR_LRU.demoted) {
         params->C_demoted += 1;
@@ -247,7 +253,7 @@ static cache_obj_t *SR_LRU_insert(cache_t *cache, const request_t *req) {
       DEBUG_ASSERT(R->get_occupied_byte(R) != 0);
 
       cache_obj_t *evicted_obj = R->to_evict(R, req);
-      copy_cache_obj_to_request(params->req_local, evicted_obj);
+      copy_cache_obj_to_request(params->req_local, R, evicted_obj);
       SR->insert(SR, params->req_local);
 
       // Mark the obj as demoted
@@ -295,7 +301,7 @@ static cache_obj_t *SR_LRU_insert(cache_t *cache, const request_t *req) {
   while (SR->get_occupied_byte(SR) > SR->cache_size) {
     // The LRU item of SR is evicted to H.
     cache_obj_t *obj_to_evict = SR->to_evict(SR, req);
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, SR, obj_to_evict);
     H->insert(H, params->req_local);
 
     if (params->other_cache) {
@@ -366,9 +372,11 @@ static void SR_LRU_evict(cache_t *cache, const request_t *req) {
   cache_t *SR = params->SR_list;
   cache_t *H = params->H_list;
 
+  /* SR_LRU_to_evict picks the victim from R when SR is empty */
+  cache_t *victim_list = SR->get_occupied_byte(SR) > 0 ? SR : R;
   cache_obj_t *obj_to_evict = SR_LRU_to_evict(cache, req);
   assert(obj_to_evict != NULL);
-  copy_cache_obj_to_request(params->req_local, obj_to_evict);
+  copy_cache_obj_to_request(params->req_local, victim_list, obj_to_evict);
   // SR eviction happens later
   cache_obj_t *obj_inserted = H->insert(H, params->req_local);
 
@@ -420,14 +428,14 @@ static bool SR_LRU_remove(cache_t *cache, const obj_id_t obj_id) {
   cache_obj_t *obj = R->find(R, params->req_local, false);
   if (obj != NULL) {
     in_R = true;
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, R, obj);
   } else {
     obj = SR->find(SR, params->req_local, false);
     if (obj == NULL) {
       return false;
     }
     in_SR = true;
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, SR, obj);
   }
 
   // Remove should remove the obj and push it to history
@@ -489,6 +497,15 @@ static int64_t SR_LRU_get_n_obj(const cache_t *cache) {
          params->SR_list->get_n_obj(params->SR_list);
 }
 
+static int64_t SR_LRU_get_metadata_bytes(const cache_t *cache) {
+  SR_LRU_params_t *params = (SR_LRU_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(SR_LRU_params_t) +
+         params->SR_list->get_metadata_bytes(params->SR_list) +
+         params->R_list->get_metadata_bytes(params->R_list) +
+         params->H_list->get_metadata_bytes(params->H_list);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -60,6 +60,7 @@ cache_t *Sieve_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(sieve));
 
   cache->eviction_params = my_malloc(Sieve_params_t);
   memset(cache->eviction_params, 0, sizeof(Sieve_params_t));
@@ -126,7 +127,7 @@ static cache_obj_t *Sieve_find(cache_t *cache, const request_t *req,
                                const bool update_cache) {
   cache_obj_t *cache_obj = cache_find_base(cache, req, update_cache);
   if (cache_obj != NULL && update_cache) {
-    cache_obj->sieve.freq = 1;
+    CACHE_OBJ_MEMBER(cache, cache_obj, sieve).freq = 1;
   }
 
   return cache_obj;
@@ -147,7 +148,7 @@ static cache_obj_t *Sieve_insert(cache_t *cache, const request_t *req) {
   Sieve_params_t *params = cache->eviction_params;
   cache_obj_t *obj = cache_insert_base(cache, req);
   prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
-  obj->sieve.freq = 0;
+  CACHE_OBJ_MEMBER(cache, obj, sieve).freq = 0;
 
   return obj;
 }
@@ -172,14 +173,16 @@ static cache_obj_t *Sieve_to_evict_with_freq(cache_t *cache,
   if (pointer == NULL) pointer = params->q_tail;
 
   /* find the first untouched */
-  while (pointer != NULL && pointer->sieve.freq > to_evict_freq) {
+  while (pointer != NULL &&
+         CACHE_OBJ_MEMBER(cache, pointer, sieve).freq > to_evict_freq) {
     pointer = pointer->queue.prev;
   }
 
   /* if we have finished one around, start from the tail */
   if (pointer == NULL) {
     pointer = params->q_tail;
-    while (pointer != NULL && pointer->sieve.freq > to_evict_freq) {
+    while (pointer != NULL &&
+         CACHE_OBJ_MEMBER(cache, pointer, sieve).freq > to_evict_freq) {
       pointer = pointer->queue.prev;
     }
   }
@@ -221,8 +224,8 @@ static void Sieve_evict(cache_t *cache, const request_t *req) {
   /* if we have run one full around or first eviction */
   cache_obj_t *obj = params->pointer == NULL ? params->q_tail : params->pointer;
 
-  while (obj->sieve.freq > 0) {
-    obj->sieve.freq -= 1;
+  while (CACHE_OBJ_MEMBER(cache, obj, sieve).freq > 0) {
+    CACHE_OBJ_MEMBER(cache, obj, sieve).freq -= 1;
     obj = obj->queue.prev == NULL ? params->q_tail : obj->queue.prev;
   }
 
@@ -36,6 +36,7 @@ static cache_obj_t *Size_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *Size_to_evict(cache_t *cache, const request_t *req);
 static void Size_evict(cache_t *cache, const request_t *req);
 static bool Size_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t Size_get_metadata_bytes(const cache_t *cache);
 static void Size_remove_obj(cache_t *cache, cache_obj_t *obj);
 
 // ***********************************************************************
@@ -55,6 +56,7 @@ cache_t *Size_init(const common_cache_params_t ccache_params,
                      __attribute__((unused))
                      const char *cache_specific_params) {
   cache_t *cache = cache_struct_init("Size", ccache_params, cache_specific_params);
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(Size));
   cache->cache_init = Size_init;
   cache->cache_free = Size_free;
   cache->get = Size_get;
@@ -63,6 +65,7 @@ cache_t *Size_init(const common_cache_params_t ccache_params,
   cache->evict = Size_evict;
   cache->to_evict = Size_to_evict;
   cache->remove = Size_remove;
+  cache->get_metadata_bytes = Size_get_metadata_bytes;
 
   Size_params_t *params = my_malloc(Size_params_t);
   cache->eviction_params = params;
@@ -88,6 +91,12 @@ static void Size_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t Size_get_metadata_bytes(const cache_t *cache) {
+  Size_params_t *params = (Size_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) + (int64_t)sizeof(Size_params_t) +
+         pqueue_get_metadata_bytes(params->pq, sizeof(pq_node_t));
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -143,8 +152,9 @@ static cache_obj_t *Size_find(cache_t *cache, const request_t *req,
   }
 
   pqueue_pri_t pri = {.pri = req->obj_size};
-  pqueue_change_priority(params->pq, pri,
-                         (pq_node_t *)(cached_obj->Size.pq_node));
+  pqueue_change_priority(
+      params->pq, pri,
+      (pq_node_t *)(CACHE_OBJ_MEMBER(cache, cached_obj, Size).pq_node));
   return cached_obj;
 }
 
@@ -167,7 +177,7 @@ static cache_obj_t *Size_insert(cache_t *cache, const request_t *req) {
   node->obj_id = req->obj_id;
   node->pri.pri = req->obj_size;
   pqueue_insert(params->pq, (void *)node);
-  cached_obj->Size.pq_node = node;
+  CACHE_OBJ_MEMBER(cache, cached_obj, Size).pq_node = node;
 
   return cached_obj;
 }
@@ -204,9 +214,9 @@ static void Size_evict(cache_t *cache,
 
   cache_obj_t *obj_to_evict =
       hashtable_find_obj_id(cache->hashtable, node->obj_id);
-  DEBUG_ASSERT(node == obj_to_evict->Size.pq_node);
+  DEBUG_ASSERT(node == CACHE_OBJ_MEMBER(cache, obj_to_evict, Size).pq_node);
 
-  obj_to_evict->Size.pq_node = NULL;
+  CACHE_OBJ_MEMBER(cache, obj_to_evict, Size).pq_node = NULL;
   my_free(sizeof(pq_node_t), node);
 
   cache_evict_base(cache, obj_to_evict, true);
@@ -216,11 +226,11 @@ static void Size_remove_obj(cache_t *cache, cache_obj_t *obj) {
   Size_params_t *params = cache->eviction_params;
   DEBUG_ASSERT(obj != NULL);
 
-  if (obj->Size.pq_node != NULL) {
+  if (CACHE_OBJ_MEMBER(cache, obj, Size).pq_node != NULL) {
     /* if it is NULL, it means we have deleted the entry in pq before this */
-    pqueue_remove(params->pq, obj->Size.pq_node);
-    my_free(sizeof(pq_node_t), obj->Size.pq_node);
-    obj->Size.pq_node = NULL;
+    pqueue_remove(params->pq, CACHE_OBJ_MEMBER(cache, obj, Size).pq_node);
+    my_free(sizeof(pq_node_t), CACHE_OBJ_MEMBER(cache, obj, Size).pq_node);
+    CACHE_OBJ_MEMBER(cache, obj, Size).pq_node = NULL;
   }
 
   cache_remove_obj_base(cache, obj, true);
@@ -15,7 +15,8 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
-#include "../../dataStructure/minimalIncrementCBF.h"
+#include "../../dataStructure/countMinSketch.h"
+#include "../../dataStructure/hash/hash.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -32,9 +33,9 @@ typedef struct WTinyLFU_params {
   cache_t *main_cache;  // any eviction policy
   double window_size;
   int64_t n_admit_bytes;
-  struct minimalIncrementCBF *CBF;
-  size_t max_request_num;
-  size_t request_counter;
+  /* the frequency of objects, it grows with the number of objects in the
+   * main cache, and ages itself */
+  count_min_sketch_t *cms;
   char main_cache_type[32];
 
   request_t *req_local;
@@ -42,6 +43,14 @@ typedef struct WTinyLFU_params {
 
 static const char *DEFAULT_PARAMS = "main-cache=SLRU,window-size=0.01";
 
+/* the initial size of the frequency sketch, it grows when the main cache has
+ * more objects */
+#define WTINYLFU_CMS_INIT_N_OBJ 1024
+
+static inline uint64_t WTinyLFU_obj_hv(obj_id_t obj_id) {
+  return get_hash_value_int_64(&obj_id);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                   function declarations                       ****
@@ -62,6 +71,7 @@ static void WTinyLFU_parse_params(cache_t *cache,
 bool WTinyLFU_can_insert(cache_t *cache, const request_t *req);
 static int64_t WTinyLFU_get_occupied_byte(const cache_t *cache);
 static int64_t WTinyLFU_get_n_obj(const cache_t *cache);
+static int64_t WTinyLFU_get_metadata_bytes(const cache_t *cache);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -92,6 +102,7 @@ cache_t *WTinyLFU_init(const common_cache_params_t ccache_params,
   cache->can_insert = WTinyLFU_can_insert;
   cache->get_occupied_byte = WTinyLFU_get_occupied_byte;
   cache->get_n_obj = WTinyLFU_get_n_obj;
+  cache->get_metadata_bytes = WTinyLFU_get_metadata_bytes;
 
   cache->eviction_params =
       (WTinyLFU_params_t *)malloc(sizeof(WTinyLFU_params_t));
@@ -143,6 +154,9 @@ cache_t *WTinyLFU_init(const common_cache_params_t ccache_params,
   } else {
     ERROR("WTinyLFU does not support %s \n", params->main_cache_type);
   }
+  /* the objects move from the window to the main cache with misc */
+  cache_set_obj_struct_size(params->LRU, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->main_cache, sizeof(cache_obj_t));
 
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "WTinyLFU-w%.2lf-%s",
            params->window_size, params->main_cache_type);
@@ -150,26 +164,8 @@ cache_t *WTinyLFU_init(const common_cache_params_t ccache_params,
   params->req_local = new_request();
   params->n_admit_bytes = 0;
 
-  params->max_request_num =
-      32 * params->main_cache->cache_size;  // sample size is 32
-
-  params->CBF =
-      (struct minimalIncrementCBF *)malloc(sizeof(struct minimalIncrementCBF));
-  DEBUG_ASSERT(params->CBF != NULL);
-  params->CBF->ready = 0;
-
-  // TODO @ Ziyue: how to set entries and error rate?
-  int ret = minimalIncrementCBF_init(params->CBF,
-                                     params->main_cache->cache_size, 0.001);
-  if (ret != 0) {
-    ERROR("CBF init failed\n");
-  }
-
-#ifdef DEBUG_MODE
-  minimalIncrementCBF_print(params->CBF);
-#endif
-
-  params->request_counter = 0;  // initialize request counter
+  /* the counters are halved every 10 * n_obj additions */
+  params->cms = create_count_min_sketch(WTINYLFU_CMS_INIT_N_OBJ, 0);
 
 #if defined(TRACK_DEMOTION)
   params->LRU->track_demotion = false;
@@ -189,8 +185,7 @@ static void WTinyLFU_free(cache_t *cache) {
   params->LRU->cache_free(params->LRU);
   params->main_cache->cache_free(params->main_cache);
 
-  minimalIncrementCBF_free(params->CBF);
-  free(params->CBF);
+  free_count_min_sketch(params->cms);
   free_request(params->req_local);
 
   cache_struct_free(cache);
@@ -222,14 +217,8 @@ static cache_obj_t *WTinyLFU_find(cache_t *cache, const request_t *req,
   }
 
   if (obj_main != NULL) {
-    // frequency update
-    minimalIncrementCBF_add(params->CBF, (void *)&req->obj_id, sizeof(obj_id_t));
-
-    params->request_counter++;
-    if (params->request_counter >= params->max_request_num) {
-      params->request_counter = 0;
-      minimalIncrementCBF_decay(params->CBF);
-    }
+    // frequency update, the sketch ages the counters
+    count_min_sketch_add(params->cms, WTinyLFU_obj_hv(req->obj_id));
   }
 
   return obj;
@@ -241,7 +230,9 @@ cache_obj_t *WTinyLFU_insert(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = NULL;
   obj = params->LRU->insert(params->LRU, req);
 
-  minimalIncrementCBF_add(params->CBF, (void *)&req->obj_id, sizeof(obj_id_t));
+  count_min_sketch_ensure_capacity(
+      params->cms, params->main_cache->get_n_obj(params->main_cache) + 1);
+  count_min_sketch_add(params->cms, WTinyLFU_obj_hv(req->obj_id));
 
 #if defined(TRACK_DEMOTION)
   obj->create_time = cache->n_req;
@@ -269,7 +260,7 @@ static void WTinyLFU_evict(cache_t *cache, const request_t *req) {
       DEBUG_ASSERT(window_victim != NULL);
 
       // window victim req is different from req
-      copy_cache_obj_to_request(params->req_local, window_victim);
+      copy_cache_obj_to_request(params->req_local, window, window_victim);
 
       /** only when main_cache is full, evict an obj from the main_cache **/
 
@@ -292,18 +283,21 @@ static void WTinyLFU_evict(cache_t *cache, const request_t *req) {
         cache_obj_t *main_cache_victim = main->to_evict(main, req);
         DEBUG_ASSERT(main_cache_victim != NULL);
         // if window_victim is more frequent, insert it into main_cache
-        if (minimalIncrementCBF_estimate(params->CBF,
-                                         (void *)&window_victim->obj_id,
-                                         sizeof(window_victim->obj_id)) >
-            minimalIncrementCBF_estimate(params->CBF,
-                                         (void *)&main_cache_victim->obj_id,
-                                         sizeof(main_cache_victim->obj_id))) {
+        if (count_min_sketch_estimate(
+                params->cms, WTinyLFU_obj_hv(window_victim->obj_id)) >
+            count_min_sketch_estimate(
+                params->cms, WTinyLFU_obj_hv(main_cache_victim->obj_id))) {
 #if defined(TRACK_DEMOTION)
           printf("%ld keep %ld %ld\n", cache->n_req, window_victim->create_time,
                  window_victim->misc.next_access_vtime);
 #endif
 
-          main->evict(main, req);
+          // objects have different sizes, one eviction may not be enough
+          while (main->get_occupied_byte(main) + params->req_local->obj_size +
+                     cache->obj_md_size >
+                 main->cache_size) {
+            main->evict(main, req);
+          }
 
           bool ret = window->remove(window, window_victim->obj_id);
           DEBUG_ASSERT(ret);
@@ -323,8 +317,8 @@ static void WTinyLFU_evict(cache_t *cache, const request_t *req) {
         }
       }
       // TODO @ Ziyue: add doorkeeper
-      minimalIncrementCBF_add(params->CBF, (void *)(&params->req_local->obj_id),
-                              sizeof(obj_id_t));
+      count_min_sketch_add(params->cms,
+                           WTinyLFU_obj_hv(params->req_local->obj_id));
     } else {
       DEBUG_ASSERT(window->get_occupied_byte(window) == 0);
       return main->evict(main, req);
@@ -347,8 +341,6 @@ static void WTinyLFU_parse_params(cache_t *cache,
                                   const char *cache_specific_params) {
   WTinyLFU_params_t *params = (WTinyLFU_params_t *)cache->eviction_params;
 
-  // params->max_request_num = 32 * cache->cache_size; // 32 * cache_size
-
   char *params_str = strdup(cache_specific_params);
   while (params_str != NULL && params_str[0] != '\0') {
     /* different parameters are separated by comma,
@@ -406,6 +398,15 @@ static int64_t WTinyLFU_get_n_obj(const cache_t *cache) {
   return n_obj;
 }
 
+static int64_t WTinyLFU_get_metadata_bytes(const cache_t *cache) {
+  WTinyLFU_params_t *params = (WTinyLFU_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(WTinyLFU_params_t) +
+         params->LRU->get_metadata_bytes(params->LRU) +
+         params->main_cache->get_metadata_bytes(params->main_cache) +
+         count_min_sketch_get_metadata_bytes(params->cms);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,7 @@ static cache_obj_t *GDSF_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *GDSF_to_evict(cache_t *cache, const request_t *req);
 static void GDSF_evict(cache_t *cache, const request_t *req);
 static bool GDSF_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t GDSF_get_metadata_bytes(const cache_t *cache);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -62,6 +63,7 @@ cache_t *GDSF_init(const common_cache_params_t ccache_params,
   cache->evict = GDSF_evict;
   cache->to_evict = NULL;
   cache->remove = GDSF_remove;
+  cache->get_metadata_bytes = GDSF_get_metadata_bytes;
 
   if (ccache_params.consider_obj_metadata) {
     // freq + priority
@@ -69,6 +71,7 @@ cache_t *GDSF_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(lfu));
 
   return cache;
 }
@@ -83,6 +86,11 @@ static void GDSF_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t GDSF_get_metadata_bytes(const cache_t *cache) {
+  auto *params = reinterpret_cast<eviction::GDSF *>(cache->eviction_params);
+  return cache_get_metadata_bytes_default(cache) + params->get_metadata_bytes();
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -129,13 +137,14 @@ static cache_obj_t *GDSF_find(cache_t *cache, const request_t *req,
   /* this does not consider object size change */
   if (obj != nullptr && update_cache) {
     /* update frequency */
-    obj->lfu.freq += 1;
+    int64_t &freq = CACHE_OBJ_MEMBER(cache, obj, lfu).freq;
+    freq += 1;
 
     auto itr = gdsf->itr_map[obj];
     gdsf->pq.erase(itr);
 
     double pri =
-        gdsf->pri_last_evict + (double)(obj->lfu.freq) * 1.0e6 / obj->obj_size;
+        gdsf->pri_last_evict + (double)(freq) * 1.0e6 / obj->obj_size;
     itr = gdsf->pq.emplace(obj, pri, cache->n_req).first;
     gdsf->itr_map[obj] = itr;
   }
@@ -158,7 +167,7 @@ static cache_obj_t *GDSF_insert(cache_t *cache, const request_t *req) {
   auto *gdsf = reinterpret_cast<eviction::GDSF *>(cache->eviction_params);
 
   cache_obj_t *obj = cache_insert_base(cache, req);
-  obj->lfu.freq = 1;
+  CACHE_OBJ_MEMBER(cache, obj, lfu).freq = 1;
 
   double pri = gdsf->pri_last_evict + 1.0e6 / obj->obj_size;
 
@@ -36,6 +36,7 @@ static cache_obj_t *LFUCpp_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *LFUCpp_to_evict(cache_t *cache, const request_t *req);
 static void LFUCpp_evict(cache_t *cache, const request_t *req);
 static bool LFUCpp_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t LFUCpp_get_metadata_bytes(const cache_t *cache);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -64,6 +65,7 @@ cache_t *LFUCpp_init(const common_cache_params_t ccache_params,
   cache->insert = LFUCpp_insert;
   cache->evict = LFUCpp_evict;
   cache->remove = LFUCpp_remove;
+  cache->get_metadata_bytes = LFUCpp_get_metadata_bytes;
 
   if (ccache_params.consider_obj_metadata) {
     // freq
@@ -71,6 +73,7 @@ cache_t *LFUCpp_init(const common_cache_params_t ccache_params,
   } else {
     cache->obj_md_size = 0;
   }
+  cache_set_obj_struct_size(cache, CACHE_OBJ_SIZE_WITH(lfu));
 
   return cache;
 }
@@ -86,6 +89,11 @@ static void LFUCpp_free(cache_t *cache) {
   cache_struct_free(cache);
 }
 
+static int64_t LFUCpp_get_metadata_bytes(const cache_t *cache) {
+  auto *params = reinterpret_cast<eviction::LFUCpp *>(cache->eviction_params);
+  return cache_get_metadata_bytes_default(cache) + params->get_metadata_bytes();
+}
+
 /**
  * @brief this function is the user facing API
  * it performs the following logic
@@ -130,10 +138,11 @@ static cache_obj_t *LFUCpp_find(cache_t *cache, const request_t *req,
   auto *lfu = static_cast<eviction::LFUCpp *>(cache->eviction_params);
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
   if (obj != nullptr && update_cache) {
-    obj->lfu.freq++;
+    int64_t &freq = CACHE_OBJ_MEMBER(cache, obj, lfu).freq;
+    freq++;
     auto itr = lfu->itr_map[obj];
     lfu->pq.erase(itr);
-    itr = lfu->pq.emplace(obj, (double)obj->lfu.freq, cache->n_req).first;
+    itr = lfu->pq.emplace(obj, (double)freq, cache->n_req).first;
     lfu->itr_map[obj] = itr;
   }
 
@@ -155,7 +164,7 @@ static cache_obj_t *LFUCpp_insert(cache_t *cache, const request_t *req) {
   auto *lfu = static_cast<eviction::LFUCpp *>(cache->eviction_params);
 
   cache_obj_t *obj = cache_insert_base(cache, req);
-  obj->lfu.freq = 1;
+  CACHE_OBJ_MEMBER(cache, obj, lfu).freq = 1;
 
   auto itr = lfu->pq.emplace_hint(lfu->pq.begin(), obj, 1.0, cache->n_req);
   lfu->itr_map[obj] = itr;
@@ -92,6 +92,18 @@ class abstractRank {
     return true;
   }
 
+  /* the bytes used by pq and itr_map, a tree node has three pointers and a
+   * color besides the value, a hash map node has a next pointer and the
+   * value, and the buckets are pointers */
+  inline int64_t get_metadata_bytes() const {
+    int64_t pq_node_byte = sizeof(pq_node_type) + 4 * sizeof(void *);
+    int64_t map_node_byte =
+        sizeof(void *) + sizeof(decltype(itr_map)::value_type);
+    return (int64_t)sizeof(abstractRank) + (int64_t)pq.size() * pq_node_byte +
+           (int64_t)itr_map.size() * map_node_byte +
+           (int64_t)itr_map.bucket_count() * (int64_t)sizeof(void *);
+  }
+
   std::set<pq_node_type> pq{};
   std::unordered_map<cache_obj_t *, std::set<pq_node_type>::iterator> itr_map{};
 
@@ -53,6 +53,7 @@ static void LP_ARC_evict(cache_t *cache, const request_t *req);
 static bool LP_ARC_remove(cache_t *cache, const obj_id_t obj_id);
 static int64_t LP_ARC_get_occupied_byte(const cache_t *cache);
 static int64_t LP_ARC_get_n_obj(const cache_t *cache);
+static int64_t LP_ARC_get_metadata_bytes(const cache_t *cache);
 
 /* internal functions */
 
@@ -94,6 +95,7 @@ cache_t *LP_ARC_init(const common_cache_params_t ccache_params,
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = LP_ARC_get_occupied_byte;
   cache->get_n_obj = LP_ARC_get_n_obj;
+  cache->get_metadata_bytes = LP_ARC_get_metadata_bytes;
 
   if (ccache_params.consider_obj_metadata) {
     // two pointer + ghost metadata
@@ -111,6 +113,11 @@ cache_t *LP_ARC_init(const common_cache_params_t ccache_params,
   params->B1 = LRU_init(ccache_params_local, NULL);
   params->T2 = Clock_init(ccache_params_local, NULL);
   params->B2 = LRU_init(ccache_params_local, NULL);
+  /* the objects move between the sub-caches with their metadata */
+  cache_set_obj_struct_size(params->T1, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->B1, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->T2, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->B2, sizeof(cache_obj_t));
 
   params->curr_obj_in_L1_ghost = false;
   params->curr_obj_in_L2_ghost = false;
@@ -352,6 +359,16 @@ static int64_t LP_ARC_get_n_obj(const cache_t *cache) {
   return params->T1->get_n_obj(params->T1) + params->T2->get_n_obj(params->T2);
 }
 
+static int64_t LP_ARC_get_metadata_bytes(const cache_t *cache) {
+  LP_ARC_params_t *params = (LP_ARC_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(LP_ARC_params_t) +
+         params->T1->get_metadata_bytes(params->T1) +
+         params->B1->get_metadata_bytes(params->B1) +
+         params->T2->get_metadata_bytes(params->T2) +
+         params->B2->get_metadata_bytes(params->B2);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                  cache internal functions                     ****
@@ -393,7 +410,7 @@ static void _LP_ARC_replace(cache_t *cache, const request_t *req) {
     // delete the LRU in L1 data, move to L1_ghost
     cache_obj_t *obj = params->T1->to_evict(params->T1, req);
     DEBUG_ASSERT(obj != NULL);
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, params->T1, obj);
     bool in_g = params->B1->get(params->B1, params->req_local);
     DEBUG_ASSERT(in_g == false);
     params->T1->evict(params->T1, req);
@@ -401,7 +418,7 @@ static void _LP_ARC_replace(cache_t *cache, const request_t *req) {
     // delete the item in L2 data, move to L2_ghost
     cache_obj_t *obj = params->T2->to_evict(params->T2, req);
     DEBUG_ASSERT(obj != NULL);
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, params->T2, obj);
     bool in_g = params->B2->get(params->B2, params->req_local);
     DEBUG_ASSERT(in_g == false);
     params->T2->evict(params->T2, req);
@@ -47,6 +47,7 @@ static bool LP_SFIFO_remove(cache_t *cache, const obj_id_t obj_id);
 static inline bool LP_SFIFO_can_insert(cache_t *cache, const request_t *req);
 static inline int64_t LP_SFIFO_get_occupied_byte(const cache_t *cache);
 static inline int64_t LP_SFIFO_get_n_obj(const cache_t *cache);
+static int64_t LP_SFIFO_get_metadata_bytes(const cache_t *cache);
 static void LP_SFIFO_demote(cache_t *cache, const request_t *req, int seg_id);
 
 // ***********************************************************************
@@ -73,6 +74,7 @@ cache_t *LP_SFIFO_init(const common_cache_params_t ccache_params,
   cache->to_evict = LP_SFIFO_to_evict;
   cache->get_occupied_byte = LP_SFIFO_get_occupied_byte;
   cache->get_n_obj = LP_SFIFO_get_n_obj;
+  cache->get_metadata_bytes = LP_SFIFO_get_metadata_bytes;
   cache->can_insert = LP_SFIFO_can_insert;
 
   cache->obj_md_size = 0;
@@ -95,6 +97,8 @@ cache_t *LP_SFIFO_init(const common_cache_params_t ccache_params,
   for (int i = 0; i < params->n_seg; i++) {
     ccache_params_local.cache_size = params->per_seg_max_size[i];
     params->fifos[i] = FIFO_init(ccache_params_local, NULL);
+    /* the objects move between the segments with their metadata */
+    cache_set_obj_struct_size(params->fifos[i], sizeof(cache_obj_t));
   }
 
   return cache;
@@ -268,7 +272,7 @@ static void LP_SFIFO_evict(cache_t *cache, const request_t *req) {
     if (seg_id_to_upsert >= params->n_seg) {
       seg_id_to_upsert = params->n_seg - 1;
     }
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, params->fifos[0], obj);
     params->fifos[0]->evict(params->fifos[0], req);
     // if (seg_id_to_upsert != 1)
     //   printf("insert to %d\n", seg_id_to_upsert);
@@ -301,7 +305,7 @@ static void LP_SFIFO_demote(cache_t *cache, const request_t *req, int seg_id) {
          params->per_seg_max_size[seg_id]) {
     obj = curr_fifo->to_evict(curr_fifo, req);
     int freq = obj->SFIFO.freq;
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, curr_fifo, obj);
     curr_fifo->evict(curr_fifo, req);
 
     obj = next_fifo->insert(next_fifo, params->req_local);
@@ -444,6 +448,16 @@ static inline int64_t LP_SFIFO_get_n_obj(const cache_t *cache) {
   return n_obj;
 }
 
+static int64_t LP_SFIFO_get_metadata_bytes(const cache_t *cache) {
+  LP_SFIFO_params_t *params = (LP_SFIFO_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(LP_SFIFO_params_t);
+  for (int i = 0; i < params->n_seg; i++) {
+    n_byte += params->fifos[i]->get_metadata_bytes(params->fifos[i]);
+  }
+  return n_byte;
+}
+
 
 #ifdef __cplusplus
 extern "C"
@@ -56,6 +56,7 @@ static void LP_TwoQ_evict(cache_t *cache, const request_t *req);
 static bool LP_TwoQ_remove(cache_t *cache, const obj_id_t obj_id);
 static inline int64_t LP_TwoQ_get_occupied_byte(const cache_t *cache);
 static inline int64_t LP_TwoQ_get_n_obj(const cache_t *cache);
+static int64_t LP_TwoQ_get_metadata_bytes(const cache_t *cache);
 static inline bool LP_TwoQ_can_insert(cache_t *cache, const request_t *req);
 static void LP_TwoQ_parse_params(cache_t *cache,
                                  const char *cache_specific_params);
@@ -84,6 +85,7 @@ cache_t *LP_TwoQ_init(const common_cache_params_t ccache_params,
   cache->remove = LP_TwoQ_remove;
   cache->to_evict = LP_TwoQ_to_evict;
   cache->get_n_obj = LP_TwoQ_get_n_obj;
+  cache->get_metadata_bytes = LP_TwoQ_get_metadata_bytes;
   cache->get_occupied_byte = LP_TwoQ_get_occupied_byte;
   cache->can_insert = LP_TwoQ_can_insert;
 
@@ -115,6 +117,11 @@ cache_t *LP_TwoQ_init(const common_cache_params_t ccache_params,
   // params->Am = LRU_init(ccache_params_local, NULL);
   params->Am = Clock_init(ccache_params_local, NULL);
 
+  /* the objects move between the sub-caches with their metadata */
+  cache_set_obj_struct_size(params->Ain, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->Aout, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->Am, sizeof(cache_obj_t));
+
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "LP-TwoQ-Clock");
 
   return cache;
@@ -274,7 +281,7 @@ static void LP_TwoQ_evict(cache_t *cache, const request_t *req) {
     cache_obj_t *obj = Ain->to_evict(Ain, req);
     assert(obj != NULL);
     // need to copy the object before it is evicted
-    copy_cache_obj_to_request(params->req_local, obj);
+    copy_cache_obj_to_request(params->req_local, Ain, obj);
     Aout->get(Aout, params->req_local);
     Ain->evict(Ain, req);
   } else {
@@ -324,6 +331,15 @@ static inline int64_t LP_TwoQ_get_n_obj(const cache_t *cache) {
          params->Am->get_n_obj(params->Am);
 }
 
+static int64_t LP_TwoQ_get_metadata_bytes(const cache_t *cache) {
+  LP_TwoQ_params_t *params = (LP_TwoQ_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(LP_TwoQ_params_t) +
+         params->Ain->get_metadata_bytes(params->Ain) +
+         params->Aout->get_metadata_bytes(params->Aout) +
+         params->Am->get_metadata_bytes(params->Am);
+}
+
 static inline bool LP_TwoQ_can_insert(cache_t *cache, const request_t *req) {
   LP_TwoQ_params_t *params = (LP_TwoQ_params_t *)cache->eviction_params;
 
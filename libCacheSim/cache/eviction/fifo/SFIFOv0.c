@@ -56,6 +56,7 @@ static void SFIFOv0_cool(cache_t *cache, const request_t *req, int i);
 static inline bool SFIFOv0_can_insert(cache_t *cache, const request_t *req);
 static inline int64_t SFIFOv0_get_occupied_byte(const cache_t *cache);
 static inline int64_t SFIFOv0_get_n_obj(const cache_t *cache);
+static int64_t SFIFOv0_get_metadata_bytes(const cache_t *cache);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -85,6 +86,7 @@ cache_t *SFIFOv0_init(const common_cache_params_t ccache_params,
   cache->can_insert = SFIFOv0_can_insert;
   cache->get_occupied_byte = SFIFOv0_get_occupied_byte;
   cache->get_n_obj = SFIFOv0_get_n_obj;
+  cache->get_metadata_bytes = SFIFOv0_get_metadata_bytes;
 
   cache->obj_md_size = 0;
 
@@ -104,6 +106,8 @@ cache_t *SFIFOv0_init(const common_cache_params_t ccache_params,
   ccache_params_local.hashpower /= MIN(16, ccache_params_local.hashpower - 4);
   for (int i = 0; i < params->n_queues; i++) {
     params->FIFOs[i] = FIFO_init(ccache_params_local, NULL);
+    /* the objects move between the segments with their metadata */
+    cache_set_obj_struct_size(params->FIFOs[i], sizeof(cache_obj_t));
   }
   params->req_local = new_request();
 
@@ -365,6 +369,16 @@ static inline int64_t SFIFOv0_get_n_obj(const cache_t *cache) {
   return n_obj;
 }
 
+static int64_t SFIFOv0_get_metadata_bytes(const cache_t *cache) {
+  SFIFOv0_params_t *params = (SFIFOv0_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(SFIFOv0_params_t);
+  for (int i = 0; i < params->n_queues; i++) {
+    n_byte += params->FIFOs[i]->get_metadata_bytes(params->FIFOs[i]);
+  }
+  return n_byte;
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                parameter set up functions                     ****
@@ -435,7 +449,7 @@ static void SFIFOv0_cool(cache_t *cache, const request_t *req, int i) {
 
   // the evicted object move to lower fifo
   cache_obj_t *obj_evicted = fifo->to_evict(fifo, req);
-  copy_cache_obj_to_request(params->req_local, obj_evicted);
+  copy_cache_obj_to_request(params->req_local, fifo, obj_evicted);
   fifo->evict(fifo, NULL);
 
   // If lower FIFOs are full
@@ -64,6 +64,7 @@ static void S3LRU_evict(cache_t *cache, const request_t *req);
 static bool S3LRU_remove(cache_t *cache, const obj_id_t obj_id);
 static inline int64_t S3LRU_get_occupied_byte(const cache_t *cache);
 static inline int64_t S3LRU_get_n_obj(const cache_t *cache);
+static int64_t S3LRU_get_metadata_bytes(const cache_t *cache);
 static inline bool S3LRU_can_insert(cache_t *cache, const request_t *req);
 static void S3LRU_parse_params(cache_t *cache,
                                const char *cache_specific_params);
@@ -90,6 +91,7 @@ cache_t *S3LRU_init(const common_cache_params_t ccache_params,
   cache->remove = S3LRU_remove;
   cache->to_evict = S3LRU_to_evict;
   cache->get_n_obj = S3LRU_get_n_obj;
+  cache->get_metadata_bytes = S3LRU_get_metadata_bytes;
   cache->get_occupied_byte = S3LRU_get_occupied_byte;
   cache->can_insert = S3LRU_can_insert;
 
@@ -138,6 +140,13 @@ cache_t *S3LRU_init(const common_cache_params_t ccache_params,
     exit(1);
   }
 
+  /* S3LRU keeps its metadata in the objects of the sub-caches */
+  cache_set_obj_struct_size(params->LRU, sizeof(cache_obj_t));
+  if (params->LRU_ghost != NULL) {
+    cache_set_obj_struct_size(params->LRU_ghost, sizeof(cache_obj_t));
+  }
+  cache_set_obj_struct_size(params->main_cache, sizeof(cache_obj_t));
+
 #if defined(TRACK_EVICTION_V_AGE)
   if (params->LRU_ghost != NULL) {
     params->LRU_ghost->track_eviction_age = false;
@@ -333,7 +342,7 @@ static void S3LRU_evict_LRU(cache_t *cache, const request_t *req) {
 
   while (!has_evicted && LRU->get_occupied_byte(LRU) > 0) {
     cache_obj_t *obj_to_evict = LRU->to_evict(LRU, req);
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, LRU, obj_to_evict);
 
     if (!params->promote_on_hit &&
         obj_to_evict->S3FIFO.freq >= params->move_to_main_threshold) {
@@ -441,6 +450,18 @@ static inline int64_t S3LRU_get_n_obj(const cache_t *cache) {
          params->main_cache->get_n_obj(params->main_cache);
 }
 
+static int64_t S3LRU_get_metadata_bytes(const cache_t *cache) {
+  S3LRU_params_t *params = (S3LRU_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(S3LRU_params_t) +
+                   params->LRU->get_metadata_bytes(params->LRU) +
+                   params->main_cache->get_metadata_bytes(params->main_cache);
+  if (params->LRU_ghost != NULL) {
+    n_byte += params->LRU_ghost->get_metadata_bytes(params->LRU_ghost);
+  }
+  return n_byte;
+}
+
 static inline bool S3LRU_can_insert(cache_t *cache, const request_t *req) {
   S3LRU_params_t *params = (S3LRU_params_t *)cache->eviction_params;
 
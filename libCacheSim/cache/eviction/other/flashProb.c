@@ -56,6 +56,7 @@ static void flashProb_evict(cache_t *cache, const request_t *req);
 static bool flashProb_remove(cache_t *cache, const obj_id_t obj_id);
 static inline int64_t flashProb_get_occupied_byte(const cache_t *cache);
 static inline int64_t flashProb_get_n_obj(const cache_t *cache);
+static int64_t flashProb_get_metadata_bytes(const cache_t *cache);
 static void flashProb_parse_params(cache_t *cache,
                                    const char *cache_specific_params);
 
@@ -77,6 +78,7 @@ cache_t *flashProb_init(const common_cache_params_t ccache_params,
   cache->remove = flashProb_remove;
   cache->to_evict = flashProb_to_evict;
   cache->get_n_obj = flashProb_get_n_obj;
+  cache->get_metadata_bytes = flashProb_get_metadata_bytes;
   cache->get_occupied_byte = flashProb_get_occupied_byte;
 
   cache->obj_md_size = 0;
@@ -135,6 +137,9 @@ cache_t *flashProb_init(const common_cache_params_t ccache_params,
   } else {
     ERROR("flashProb does not support %s\n", params->disk_cache_type);
   }
+  /* the objects move from the ram to the disk with their metadata */
+  cache_set_obj_struct_size(params->ram, sizeof(cache_obj_t));
+  cache_set_obj_struct_size(params->disk, sizeof(cache_obj_t));
 
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "flashProb-%.4lf-%s-%.4lf-%s",
            params->ram_size_ratio, 
@@ -295,7 +300,7 @@ static void flashProb_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = ram->to_evict(ram, req);
   assert(obj != NULL);
   // need to copy the object before it is evicted
-  copy_cache_obj_to_request(params->req_local, obj);
+  copy_cache_obj_to_request(params->req_local, ram, obj);
 
   // remove from RAM, but do not update stat
   ram->remove(ram, params->req_local->obj_id);
@@ -343,6 +348,14 @@ static inline int64_t flashProb_get_n_obj(const cache_t *cache) {
          params->disk->get_n_obj(params->disk);
 }
 
+static int64_t flashProb_get_metadata_bytes(const cache_t *cache) {
+  flashProb_params_t *params = (flashProb_params_t *)cache->eviction_params;
+  return cache_get_metadata_bytes_default(cache) +
+         (int64_t)sizeof(flashProb_params_t) +
+         params->ram->get_metadata_bytes(params->ram) +
+         params->disk->get_metadata_bytes(params->disk);
+}
+
 // static inline bool flashProb_can_insert(cache_t *cache, const request_t *req) {
 //   flashProb_params_t *params = (flashProb_params_t *)cache->eviction_params;
 
@@ -99,6 +99,7 @@ static void S3FIFOdv2_evict(cache_t *cache, const request_t *req);
 static bool S3FIFOdv2_remove(cache_t *cache, const obj_id_t obj_id);
 static inline int64_t S3FIFOdv2_get_occupied_byte(const cache_t *cache);
 static inline int64_t S3FIFOdv2_get_n_obj(const cache_t *cache);
+static int64_t S3FIFOdv2_get_metadata_bytes(const cache_t *cache);
 static inline bool S3FIFOdv2_can_insert(cache_t *cache, const request_t *req);
 static void S3FIFOdv2_parse_params(cache_t *cache,
                                    const char *cache_specific_params);
@@ -125,6 +126,7 @@ cache_t *S3FIFOdv2_init(const common_cache_params_t ccache_params,
   cache->remove = S3FIFOdv2_remove;
   cache->to_evict = S3FIFOdv2_to_evict;
   cache->get_n_obj = S3FIFOdv2_get_n_obj;
+  cache->get_metadata_bytes = S3FIFOdv2_get_metadata_bytes;
   cache->get_occupied_byte = S3FIFOdv2_get_occupied_byte;
   cache->can_insert = S3FIFOdv2_can_insert;
 
@@ -179,6 +181,13 @@ cache_t *S3FIFOdv2_init(const common_cache_params_t ccache_params,
   ccache_params_local.cache_size = main_cache_size;
   params->main_cache = FIFO_init(ccache_params_local, NULL);
 
+  /* S3FIFO keeps its metadata in the objects of the sub-caches */
+  cache_set_obj_struct_size(params->fifo, sizeof(cache_obj_t));
+  if (params->fifo_ghost != NULL) {
+    cache_set_obj_struct_size(params->fifo_ghost, sizeof(cache_obj_t));
+  }
+  cache_set_obj_struct_size(params->main_cache, sizeof(cache_obj_t));
+
 #if defined(TRACK_EVICTION_V_AGE)
   if (params->fifo_ghost != NULL) {
     params->fifo_ghost->track_eviction_age = false;
@@ -667,7 +676,7 @@ static void S3FIFOdv2_evict_fifo(cache_t *cache, const request_t *req) {
     cache_obj_t *obj_to_evict = fifo->to_evict(fifo, req);
     DEBUG_ASSERT(obj_to_evict != NULL);
     // need to copy the object before it is evicted
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, fifo, obj_to_evict);
     size_t pos = MIN(obj_to_evict->S3FIFO.freq, MAX_FREQ_THRESHOLD - 1);
     params->eviction_freq_cnt[pos] += 1;
 
@@ -730,7 +739,7 @@ static void S3FIFOdv2_evict_main(cache_t *cache, const request_t *req) {
 #if defined(TRACK_EVICTION_V_AGE)
     int64_t create_time = obj_to_evict->create_time;
 #endif
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    copy_cache_obj_to_request(params->req_local, main, obj_to_evict);
     params->main_freq_cnt[log2_ull(freq)] -= 1;
     if (freq >= params->main_reinsert_threshold) {
       // we need to evict first because the object to insert has the same obj_id
@@ -822,6 +831,18 @@ static inline int64_t S3FIFOdv2_get_n_obj(const cache_t *cache) {
          params->main_cache->get_n_obj(params->main_cache);
 }
 
+static int64_t S3FIFOdv2_get_metadata_bytes(const cache_t *cache) {
+  S3FIFOdv2_params_t *params = (S3FIFOdv2_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(S3FIFOdv2_params_t) +
+                   params->fifo->get_metadata_bytes(params->fifo) +
+                   params->main_cache->get_metadata_bytes(params->main_cache);
+  if (params->fifo_ghost != NULL) {
+    n_byte += params->fifo_ghost->get_metadata_bytes(params->fifo_ghost);
+  }
+  return n_byte;
+}
+
 static inline bool S3FIFOdv2_can_insert(cache_t *cache, const request_t *req) {
   S3FIFOdv2_params_t *params = (S3FIFOdv2_params_t *)cache->eviction_params;
 
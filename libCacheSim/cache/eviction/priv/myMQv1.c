@@ -53,6 +53,7 @@ static void myMQv1_evict(cache_t *cache, const request_t *req);
 static bool myMQv1_remove(cache_t *cache, const obj_id_t obj_id);
 static int64_t myMQv1_get_occupied_byte(const cache_t *cache);
 static int64_t myMQv1_get_n_obj(const cache_t *cache);
+static int64_t myMQv1_get_metadata_bytes(const cache_t *cache);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -81,6 +82,7 @@ cache_t *myMQv1_init(const common_cache_params_t ccache_params,
   cache->to_evict = myMQv1_to_evict;
   cache->get_occupied_byte = myMQv1_get_occupied_byte;
   cache->get_n_obj = myMQv1_get_n_obj;
+  cache->get_metadata_bytes = myMQv1_get_metadata_bytes;
   cache->can_insert = cache_can_insert_default;
   cache->obj_md_size = 0;
 
@@ -101,6 +103,8 @@ cache_t *myMQv1_init(const common_cache_params_t ccache_params,
     ccache_params_local.cache_size = params->cache_sizes[i];
     params->caches[i] = FIFO_init(ccache_params, NULL);
     params->ghost_caches[i] = FIFO_init(ccache_params_local, NULL);
+    cache_set_obj_struct_size(params->caches[i], sizeof(cache_obj_t));
+    cache_set_obj_struct_size(params->ghost_caches[i], sizeof(cache_obj_t));
   }
 
   // snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "myMQv1", 0.25);
@@ -265,6 +269,19 @@ static int64_t myMQv1_get_n_obj(const cache_t *cache) {
   return n_obj;
 }
 
+static int64_t myMQv1_get_metadata_bytes(const cache_t *cache) {
+  myMQv1_params_t *params = (myMQv1_params_t *)cache->eviction_params;
+  int64_t n_byte = cache_get_metadata_bytes_default(cache) +
+                   (int64_t)sizeof(myMQv1_params_t);
+  for (int i = 0; i < params->n_caches; i++) {
+    n_byte += params->caches[i]->get_metadata_bytes(params->caches[i]);
+  }
+  for (int i = 0; i < params->n_caches; i++) {
+    n_byte += params->ghost_caches[i]->get_metadata_bytes(params->ghost_caches[i]);
+  }
+  return n_byte;
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                  parameter set up functions                   ****
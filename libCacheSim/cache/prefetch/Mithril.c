@@ -1,6 +1,15 @@
 //
 //  a Mithril module that supports different obj size
 //
+//  the recording, mining and prefetch tables are keyed by the full 64-bit
+//  obj_id using open-addressing maps (dataStructure/idMap.h), the size of an
+//  obj is carried in the tables instead of a map of all requested objs, so
+//  the memory is bounded by the metadata size, not the number of objs
+//
+//  when the mining table is full, it is sorted into a snapshot and mined
+//  either at once (mining-step=0) or mining-step rows at the end of each
+//  request, so that a request does not stall on mining
+//
 //
 //  Mithril.c
 //  libCacheSim
@@ -20,9 +29,7 @@
 #include "../../include/libCacheSim/prefetchAlgo/Mithril.h"
 #include "glibconfig.h"
 
-#define TRACK_BLOCK 192618l
 #define SANITY_CHECK 1
-#define PROFILING
 // #define debug
 
 #ifdef __cplusplus
@@ -41,17 +48,18 @@ static inline void _Mithril_record_entry(cache_t *Mithril,
 static inline void _Mithril_rec_min_support_one(cache_t *Mithril,
                                                 const request_t *req);
 static inline gint _Mithril_get_total_num_of_ts(gint64 *row, gint row_length);
-static void _Mithril_mining(cache_t *Mithril);
+static void _Mithril_start_mining(cache_t *Mithril);
+static void _Mithril_mining(cache_t *Mithril, gint n_row);
 
-static void _Mithril_add_to_prefetch_table(cache_t *Mithril, gpointer gp1,
-                                           gpointer gp2);
+static void _Mithril_add_to_prefetch_table(cache_t *Mithril, obj_id_t src,
+                                           obj_id_t dst, gint64 dst_size);
 
 const char *Mithril_default_params(void) {
   return "lookahead-range=20, "
          "max-support=8, min-support=2, confidence=1, pf-list-size=2, "
          "rec-trigger=miss, block-size=1, max-metadata-size=0.1, "
-         "cycle-time=2, mining-threshold=5120, sequential-type=0, "
-         "sequential-K=-1, AMP-pthreshold=-1";
+         "cycle-time=2, mining-threshold=5120, mining-step=0, "
+         "sequential-type=0, sequential-K=-1, AMP-pthreshold=-1";
 }
 
 static void set_Mithril_default_init_params(
@@ -66,6 +74,7 @@ static void set_Mithril_default_init_params(
   init_params->max_metadata_size = 0.1;
   init_params->cycle_time = 2;
   init_params->mining_threshold = MINING_THRESHOLD;
+  init_params->mining_step = 0;
 
   init_params->sequential_type = 0;
   init_params->sequential_K = -1;
@@ -76,6 +85,7 @@ static void set_Mithril_default_init_params(
 static void Mithril_parse_init_params(const char *cache_specific_params,
                                       Mithril_init_params_t *init_params) {
   char *params_str = strdup(cache_specific_params);
+  char *old_params_str = params_str;
 
   while (params_str != NULL && params_str[0] != '\0') {
     char *key = strsep((char **)&params_str, "=");
@@ -113,6 +123,8 @@ static void Mithril_parse_init_params(const char *cache_specific_params,
       init_params->cycle_time = atoi(value);
     } else if (strcasecmp(key, "mining-threshold") == 0) {
       init_params->mining_threshold = atoi(value);
+    } else if (strcasecmp(key, "mining-step") == 0) {
+      init_params->mining_step = atoi(value);
     } else if (strcasecmp(key, "sequential-type") == 0) {
       init_params->sequential_type = atoi(value);
     } else if (strcasecmp(key, "sequential-K") == 0) {
@@ -129,6 +141,12 @@ static void Mithril_parse_init_params(const char *cache_specific_params,
       exit(1);
     }
   }
+  free(old_params_str);
+
+  if (init_params->mining_step < 0) {
+    ERROR("Mithril's mining-step must be non-negative, got %d\n",
+          init_params->mining_step);
+  }
 }
 
 static void set_Mithril_params(Mithril_params_t *Mithril_params,
@@ -141,6 +159,7 @@ static void set_Mithril_params(Mithril_params_t *Mithril_params,
   Mithril_params->cycle_time = init_params->cycle_time;
   Mithril_params->pf_list_size = init_params->pf_list_size;
   Mithril_params->mining_threshold = init_params->mining_threshold;
+  Mithril_params->mining_step = init_params->mining_step;
 
   Mithril_params->block_size = init_params->block_size;
   Mithril_params->sequential_type = init_params->sequential_type;
@@ -176,21 +195,23 @@ static void set_Mithril_params(Mithril_params_t *Mithril_params,
       (gint)ceil((double)Mithril_params->min_support / (double)4) + 1;
   rmtable->mtable_row_len =
       (gint)ceil((double)Mithril_params->max_support / (double)4) + 1;
-  rmtable->mining_table =
-      g_array_sized_new(FALSE, TRUE, sizeof(int64_t) * rmtable->mtable_row_len,
-                        Mithril_params->mtable_size);
-  rmtable->hashtable =
-      g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
-  Mithril_params->prefetch_hashtable =
-      g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
-  Mithril_params->cache_size_map =
-      g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+
+  gint mtable_size = Mithril_params->mtable_size;
+  rmtable->mining_table = g_new0(gint64, mtable_size * rmtable->mtable_row_len);
+  rmtable->mtable_obj_size = g_new0(gint64, mtable_size);
+  rmtable->mining_snapshot =
+      g_new0(gint64, mtable_size * rmtable->mtable_row_len);
+  rmtable->snapshot_obj_size = g_new0(gint64, mtable_size);
+  rmtable->n_snapshot_row = 0;
+  rmtable->snapshot_next_row = 0;
+  rmtable->sort_idx = g_new0(gint, mtable_size);
+  rmtable->sort_buf = g_new0(gint, mtable_size);
+
+  Mithril_params->prefetch_hashtable = create_id_map(PREFETCH_TABLE_SHARD_SIZE);
 
   if (Mithril_params->output_statistics) {
-    Mithril_params->prefetched_hashtable_Mithril =
-        g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
-    Mithril_params->prefetched_hashtable_sequential =
-        g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+    Mithril_params->prefetched_hashtable_Mithril = create_id_map(1024);
+    Mithril_params->prefetched_hashtable_sequential = create_id_map(1024);
   }
 
   Mithril_params->ptable_cur_row = 1;
@@ -199,8 +220,12 @@ static void set_Mithril_params(Mithril_params_t *Mithril_params,
   // 0
   Mithril_params->ptable_array =
       g_new0(gint64 *, max_num_of_shards_in_prefetch_table);
+  Mithril_params->ptable_obj_size =
+      g_new0(gint64 *, max_num_of_shards_in_prefetch_table);
   Mithril_params->ptable_array[0] = g_new0(
       gint64, PREFETCH_TABLE_SHARD_SIZE * (Mithril_params->pf_list_size + 1));
+  Mithril_params->ptable_obj_size[0] = g_new0(
+      gint64, PREFETCH_TABLE_SHARD_SIZE * (Mithril_params->pf_list_size + 1));
 
   Mithril_params->ts = 0;
 
@@ -210,6 +235,7 @@ static void set_Mithril_params(Mithril_params_t *Mithril_params,
   Mithril_params->num_of_prefetch_sequential = 0;
   Mithril_params->num_of_check = 0;
 
+  gint64 n_tracked_obj = mtable_size;
   if (Mithril_params->max_support != 1) {
     rmtable->n_rows_in_rtable =
         (gint64)(cache_size * Mithril_params->block_size *
@@ -220,11 +246,14 @@ static void set_Mithril_params(Mithril_params_t *Mithril_params,
     rmtable->recording_table = g_new0(
         gint64, rmtable->n_rows_in_rtable *
                     rmtable->rtable_row_len);  // this should begins with 1
+    rmtable->rtable_obj_size = g_new0(gint64, rmtable->n_rows_in_rtable);
     Mithril_params->cur_metadata_size +=
         (((gint64)ceil((double)init_params->min_support / (double)4 + 1) * 8 +
           4) *
          rmtable->n_rows_in_rtable);
+    n_tracked_obj += rmtable->n_rows_in_rtable;
   }
+  rmtable->hashtable = create_id_map(n_tracked_obj);
 }
 
 // ***********************************************************************
@@ -234,8 +263,7 @@ static void set_Mithril_params(Mithril_params_t *Mithril_params,
 // ****   create, free, clone, handle_find, handle_evict, prefetch    ****
 // ***********************************************************************
 /**
- 1. record the request in cache_size_map for being aware of prefetching object's
- size in the future.
+ 1. update the statistics of prefetched objs.
  2. record entry if rec_trigger is not evict.
 
  @param cache the cache struct
@@ -247,23 +275,14 @@ static void Mithril_handle_find(cache_t *cache, const request_t *req,
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
 
-  /*use cache_size_map to record the current requested obj's size*/
-  g_hash_table_insert(Mithril_params->cache_size_map,
-                      GINT_TO_POINTER(req->obj_id),
-                      GINT_TO_POINTER(req->obj_size));
-
   if (Mithril_params->output_statistics) {
-    if (g_hash_table_contains(Mithril_params->prefetched_hashtable_Mithril,
-                              GINT_TO_POINTER(req->obj_id))) {
+    if (id_map_remove(Mithril_params->prefetched_hashtable_Mithril,
+                      req->obj_id)) {
       Mithril_params->hit_on_prefetch_Mithril += 1;
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(req->obj_id));
     }
-    if (g_hash_table_contains(Mithril_params->prefetched_hashtable_sequential,
-                              GINT_TO_POINTER(req->obj_id))) {
+    if (id_map_remove(Mithril_params->prefetched_hashtable_sequential,
+                      req->obj_id)) {
       Mithril_params->hit_on_prefetch_sequential += 1;
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_sequential,
-                          GINT_TO_POINTER(req->obj_id));
     }
   }
 
@@ -291,13 +310,12 @@ void Mithril_handle_evict(cache_t *cache, const request_t *check_req) {
   if (Mithril_params->output_statistics) {
     obj_id_t check_id = check_req->obj_id;
 
-    gint type = GPOINTER_TO_INT(
-        g_hash_table_lookup(Mithril_params->prefetched_hashtable_Mithril,
-                            GINT_TO_POINTER(check_id)));
+    gint type = (gint)id_map_get(Mithril_params->prefetched_hashtable_Mithril,
+                                 check_id);
     if (type != 0 && type < Mithril_params->cycle_time) {
       // give one more chance
-      g_hash_table_insert(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(check_id), GINT_TO_POINTER(type + 1));
+      id_map_put(Mithril_params->prefetched_hashtable_Mithril, check_id,
+                 type + 1);
 
       while ((long)cache->get_occupied_byte(cache) + check_req->obj_size +
                  cache->obj_md_size >
@@ -311,17 +329,16 @@ void Mithril_handle_evict(cache_t *cache, const request_t *check_req) {
         _Mithril_record_entry(cache, check_req);
       }
 
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(check_req->obj_id));
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_sequential,
-                          GINT_TO_POINTER(check_req->obj_id));
+      id_map_remove(Mithril_params->prefetched_hashtable_Mithril, check_id);
+      id_map_remove(Mithril_params->prefetched_hashtable_sequential, check_id);
     }
   }
 }
 
 /**
  prefetch some objs associated with req->obj_id by searching prefetch_hashtable
- and ptable_array and evict when space is full.
+ and ptable_array and evict when space is full, then mine the next
+ mining-step rows of the mining snapshot.
 
  @param cache the cache struct
  @param req the request containing the request
@@ -331,8 +348,8 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
 
-  gint prefetch_table_index = GPOINTER_TO_INT(g_hash_table_lookup(
-      Mithril_params->prefetch_hashtable, GINT_TO_POINTER(req->obj_id)));
+  gint prefetch_table_index =
+      (gint)id_map_get(Mithril_params->prefetch_hashtable, req->obj_id);
 
   gint dim1 =
       (gint)floor(prefetch_table_index / (double)PREFETCH_TABLE_SHARD_SIZE);
@@ -349,9 +366,8 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
       if (Mithril_params->ptable_array[dim1][dim2 + i] == 0) {
         break;
       }
-      new_req->obj_id = Mithril_params->ptable_array[dim1][dim2 + i];
-      new_req->obj_size = GPOINTER_TO_INT(g_hash_table_lookup(
-          Mithril_params->cache_size_map, GINT_TO_POINTER(new_req->obj_id)));
+      new_req->obj_id = (obj_id_t)Mithril_params->ptable_array[dim1][dim2 + i] - 1;
+      new_req->obj_size = Mithril_params->ptable_obj_size[dim1][dim2 + i];
 
       if (Mithril_params->output_statistics) {
         Mithril_params->num_of_check += 1;
@@ -371,9 +387,8 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
       if (Mithril_params->output_statistics) {
         Mithril_params->num_of_prefetch_Mithril += 1;
 
-        g_hash_table_insert(Mithril_params->prefetched_hashtable_Mithril,
-                            GINT_TO_POINTER(new_req->obj_id),
-                            GINT_TO_POINTER(1));
+        id_map_put(Mithril_params->prefetched_hashtable_Mithril,
+                   new_req->obj_id, 1);
       }
     }
   }
@@ -385,40 +400,47 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
     new_req->obj_id = req->obj_id + 1;
     new_req->obj_size = req->obj_size;  // same size
 
-    if (cache->find(cache, new_req, false)) {
-      my_free(sizeof(request_t), new_req);
-      return;
-    }
-
-    // use this, not add because we need to record stat when evicting
+    if (!cache->find(cache, new_req, false)) {
+      // use this, not add because we need to record stat when evicting
+      while ((long)cache->get_occupied_byte(cache) + new_req->obj_size +
+                 cache->obj_md_size >
+             cache->cache_size) {
+        cache->evict(cache, new_req);
+      }
+      cache->insert(cache, new_req);
 
-    while ((long)cache->get_occupied_byte(cache) + new_req->obj_size +
-               cache->obj_md_size >
-           cache->cache_size) {
-      cache->evict(cache, new_req);
+      if (Mithril_params->output_statistics) {
+        Mithril_params->num_of_prefetch_sequential += 1;
+        id_map_put(Mithril_params->prefetched_hashtable_Mithril,
+                   new_req->obj_id, 1);
+      }
     }
-    cache->insert(cache, new_req);
+  }
+  my_free(sizeof(request_t), new_req);
 
-    if (Mithril_params->output_statistics) {
-      Mithril_params->num_of_prefetch_sequential += 1;
-      g_hash_table_insert(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(new_req->obj_id), GINT_TO_POINTER(1));
-    }
+  rec_mining_t *rmtable = Mithril_params->rmtable;
+  if (rmtable->snapshot_next_row < rmtable->n_snapshot_row - 1) {
+    _Mithril_mining(cache, Mithril_params->mining_step);
   }
-  my_free(sizeof(request), new_req);
 
   Mithril_params->ts++;
 }
 
 void free_Mithril_prefetcher(prefetcher_t *prefetcher) {
   Mithril_params_t *Mithril_params = (Mithril_params_t *)prefetcher->params;
+  rec_mining_t *rmtable = Mithril_params->rmtable;
 
-  g_hash_table_destroy(Mithril_params->prefetch_hashtable);
-  g_hash_table_destroy(Mithril_params->cache_size_map);
-  g_hash_table_destroy(Mithril_params->rmtable->hashtable);
-  g_free(Mithril_params->rmtable->recording_table);
-  g_array_free(Mithril_params->rmtable->mining_table, TRUE);
-  g_free(Mithril_params->rmtable);
+  free_id_map(Mithril_params->prefetch_hashtable);
+  free_id_map(rmtable->hashtable);
+  g_free(rmtable->recording_table);
+  g_free(rmtable->rtable_obj_size);
+  g_free(rmtable->mining_table);
+  g_free(rmtable->mtable_obj_size);
+  g_free(rmtable->mining_snapshot);
+  g_free(rmtable->snapshot_obj_size);
+  g_free(rmtable->sort_idx);
+  g_free(rmtable->sort_buf);
+  g_free(rmtable);
 
   int i = 0;
   gint max_num_of_shards_in_prefetch_table =
@@ -428,16 +450,18 @@ void free_Mithril_prefetcher(prefetcher_t *prefetcher) {
   while (i < max_num_of_shards_in_prefetch_table) {
     if (Mithril_params->ptable_array[i]) {
       g_free(Mithril_params->ptable_array[i]);
+      g_free(Mithril_params->ptable_obj_size[i]);
     } else {
       break;
     }
     i++;
   }
   g_free(Mithril_params->ptable_array);
+  g_free(Mithril_params->ptable_obj_size);
 
   if (Mithril_params->output_statistics) {
-    g_hash_table_destroy(Mithril_params->prefetched_hashtable_Mithril);
-    g_hash_table_destroy(Mithril_params->prefetched_hashtable_sequential);
+    free_id_map(Mithril_params->prefetched_hashtable_Mithril);
+    free_id_map(Mithril_params->prefetched_hashtable_sequential);
   }
   my_free(sizeof(Mithril_params_t), Mithril_params);
   if (prefetcher->init_params) {
@@ -446,6 +470,13 @@ void free_Mithril_prefetcher(prefetcher_t *prefetcher) {
   my_free(sizeof(prefetcher_t), prefetcher);
 }
 
+/* the tables as counted by Mithril against max-metadata-size */
+static int64_t Mithril_get_metadata_bytes(const prefetcher_t *prefetcher) {
+  const Mithril_params_t *Mithril_params = prefetcher->params;
+  return (int64_t)(sizeof(Mithril_params_t) + sizeof(rec_mining_t)) +
+         Mithril_params->cur_metadata_size;
+}
+
 prefetcher_t *clone_Mithril_prefetcher(prefetcher_t *prefetcher,
                                        uint64_t cache_size) {
   return create_Mithril_prefetcher(prefetcher->init_params, cache_size);
@@ -477,6 +508,7 @@ prefetcher_t *create_Mithril_prefetcher(const char *init_params,
   prefetcher->handle_evict = Mithril_handle_evict;
   prefetcher->free = free_Mithril_prefetcher;
   prefetcher->clone = clone_Mithril_prefetcher;
+  prefetcher->get_metadata_bytes = Mithril_get_metadata_bytes;
   if (init_params) {
     prefetcher->init_params = strdup(init_params);
   }
@@ -510,110 +542,125 @@ static inline bool _Mithril_check_sequential(cache_t *cache,
       break;
     }
   }
+  my_free(sizeof(request_t), new_req);
   return is_sequential;
 }
 
-static inline void _Mithril_rec_min_support_one(cache_t *cache,
-                                                const request_t *req) {
-  Mithril_params_t *Mithril_params =
-      (Mithril_params_t *)(cache->prefetcher->params);
-  rec_mining_t *rmtable = Mithril_params->rmtable;
+/**
+ append a row to the mining table
 
-#ifdef TRACK_BLOCK
-  if (req->obj_id == TRACK_BLOCK) {
-    int old_pos = GPOINTER_TO_INT(
-        g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(req->obj_id)));
-    printf("insert %ld, old pos %d", TRACK_BLOCK, old_pos);
-    if (old_pos == 0)
-      printf("\n");
-    else
-      printf(", block at old_pos %ld\n",
-             (long)*(gint64 *)GET_ROW_IN_MTABLE(Mithril_params, old_pos - 1));
+ @return the order of the new row
+ */
+static inline gint _Mithril_append_mining_row(Mithril_params_t *Mithril_params,
+                                              gint64 *row, gint row_len,
+                                              gint64 obj_size) {
+  rec_mining_t *rmtable = Mithril_params->rmtable;
 
-  } else {
-    gint64 b = TRACK_BLOCK;
-    int old_pos = GPOINTER_TO_INT(
-        g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(b)));
-    if (old_pos != 0) {
-      ERROR("ts %lu, checking %ld, %ld is found at pos %d\n",
-            (unsigned long)Mithril_params->ts, (long)TRACK_BLOCK,
-            (long)*(gint64 *)GET_ROW_IN_MTABLE(Mithril_params, old_pos - 1),
-            old_pos);
-      abort();
-    }
+#ifdef SANITY_CHECK
+  if (rmtable->n_avail_mining >= Mithril_params->mtable_size) {
+    ERROR(
+        "mining table length reaches limit, but no mining, "
+        "entry %d, threshold %d\n",
+        rmtable->n_avail_mining, Mithril_params->mtable_size);
   }
 #endif
 
-  int i;
-  // check the obj_id in hashtable for training
-  gint index = GPOINTER_TO_INT(
-      g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(req->obj_id)));
-  if (index == 0) {
-    // the node is not in the recording/mining data, should be added
-    gint64 array_ele[rmtable->mtable_row_len];
-    // gpointer hash_key;
-    array_ele[0] = req->obj_id;
-    // hash_key = GET_ROW_IN_MTABLE(Mithril_params,
-    // rmtable->mining_table->len);
+  gint row_idx = rmtable->n_avail_mining++;
+  gint64 *row_in_mtable = GET_ROW_IN_MTABLE(Mithril_params, row_idx);
+  memcpy(row_in_mtable, row, sizeof(TS_REPRESENTATION) * row_len);
+  /** clear the rest of the row,
+   *  this is important as
+   *  we don't clear the content of the table after mining
+   **/
+  memset(row_in_mtable + row_len, 0,
+         sizeof(TS_REPRESENTATION) * (rmtable->mtable_row_len - row_len));
+  rmtable->mtable_obj_size[row_idx] = obj_size;
+  return row_idx;
+}
+
+/**
+ remove a too frequent obj from the mining table, the last row is moved to
+ its position, and it is stored in the hashtable as index
+ */
+static inline void _Mithril_drop_mining_row(Mithril_params_t *Mithril_params,
+                                            gint row_idx, gint64 index) {
+  rec_mining_t *rmtable = Mithril_params->rmtable;
+  gint64 *row_in_mtable = GET_ROW_IN_MTABLE(Mithril_params, row_idx);
 
-    for (i = 1; i < rmtable->mtable_row_len; i++) array_ele[i] = 0;
-    array_ele[1] = ADD_TS(array_ele[1], Mithril_params->ts);
+  if (!id_map_remove(rmtable->hashtable, (obj_id_t)row_in_mtable[0])) {
+    ERROR("removing from rmtable failed for mining table entry\n");
+  }
 
-    g_array_append_val(rmtable->mining_table, array_ele);
-    rmtable->n_avail_mining++;
+  gint last_row = rmtable->n_avail_mining - 1;
+  if (row_idx != last_row) {
+    memcpy(row_in_mtable, GET_ROW_IN_MTABLE(Mithril_params, last_row),
+           sizeof(TS_REPRESENTATION) * rmtable->mtable_row_len);
+    rmtable->mtable_obj_size[row_idx] = rmtable->mtable_obj_size[last_row];
+    id_map_put(rmtable->hashtable, (obj_id_t)row_in_mtable[0], index);
+  }
+  rmtable->n_avail_mining--;
+}
 
-    // all index is real row number + 1
-    g_hash_table_insert(rmtable->hashtable, GINT_TO_POINTER(req->obj_id),
-                        GINT_TO_POINTER(rmtable->mining_table->len));
+/**
+ add a timestamp to a row of the mining table,
+ if the obj already has max_support timestamps, it is too frequent and dropped
+
+ @param index the value of the obj in the hashtable
+ */
+static inline void _Mithril_add_ts_in_mtable(Mithril_params_t *Mithril_params,
+                                             const request_t *req, gint row_idx,
+                                             gint64 index) {
+  rec_mining_t *rmtable = Mithril_params->rmtable;
+  gint64 *row_in_mtable = GET_ROW_IN_MTABLE(Mithril_params, row_idx);
 
 #ifdef SANITY_CHECK
-    gint64 *row_in_mtable =
-        GET_ROW_IN_MTABLE(Mithril_params, rmtable->mining_table->len - 1);
-    if (req->obj_id != row_in_mtable[0]) {
-      ERROR("after inserting, hashtable mining not consistent %ld %ld\n",
-            (long)req->obj_id, (long)row_in_mtable[0]);
-      abort();
-    }
+  if ((gint64)req->obj_id != row_in_mtable[0]) {
+    ERROR(
+        "ts %lu, inconsistent entry in mtable and mining hashtable, "
+        "current request %lu, mining table %lu\n",
+        (unsigned long)Mithril_params->ts, (unsigned long)req->obj_id,
+        (unsigned long)row_in_mtable[0]);
+  }
 #endif
-  } else {
-    /* in mining table */
-    gint64 *row_in_mtable = GET_ROW_IN_MTABLE(Mithril_params, index - 1);
 
-#ifdef SANITY_CHECK
-    if (req->obj_id != row_in_mtable[0]) {
-      ERROR("ts %lu, hashtable mining found position not correct %ld %ld\n",
-            (unsigned long)Mithril_params->ts, (long)req->obj_id,
-            (long)row_in_mtable[0]);
-      abort();
+  int i;
+  int timestamps_length = 0;
+  for (i = 1; i < rmtable->mtable_row_len; i++) {
+    timestamps_length += NUM_OF_TS(row_in_mtable[i]);
+    if (NUM_OF_TS(row_in_mtable[i]) < 4) {
+      row_in_mtable[i] = ADD_TS(row_in_mtable[i], Mithril_params->ts);
+      break;
     }
-#endif
+  }
+  rmtable->mtable_obj_size[row_idx] = req->obj_size;
 
-    int timestamps_length = 0;
+  if (timestamps_length == Mithril_params->max_support) {
+    /* no timestamp added, drop this request, it is too frequent */
+    _Mithril_drop_mining_row(Mithril_params, row_idx, index);
+  }
+}
 
-    for (i = 1; i < rmtable->mtable_row_len; i++) {
-      timestamps_length += NUM_OF_TS(row_in_mtable[i]);
-      if (NUM_OF_TS(row_in_mtable[i]) < 4) {
-        row_in_mtable[i] = ADD_TS(row_in_mtable[i], Mithril_params->ts);
-        break;
-      }
-    }
-    if (timestamps_length == Mithril_params->max_support) {
-      /* no timestamp added, drop this request, it is too frequent */
-      if (!g_hash_table_remove(rmtable->hashtable,
-                               GINT_TO_POINTER(row_in_mtable[0]))) {
-        ERROR("removing from rmtable failed for mining table entry\n");
-      }
+static inline void _Mithril_rec_min_support_one(cache_t *cache,
+                                                const request_t *req) {
+  Mithril_params_t *Mithril_params =
+      (Mithril_params_t *)(cache->prefetcher->params);
+  rec_mining_t *rmtable = Mithril_params->rmtable;
 
-      g_array_remove_index_fast(rmtable->mining_table, index - 1);
+  // check the obj_id in hashtable for training
+  gint index = (gint)id_map_get(rmtable->hashtable, req->obj_id);
+  if (index == 0) {
+    // the node is not in the recording/mining data, should be added
+    gint64 array_ele[2];
+    array_ele[0] = (gint64)req->obj_id;
+    array_ele[1] = ADD_TS((gint64)0, Mithril_params->ts);
+    gint row_idx =
+        _Mithril_append_mining_row(Mithril_params, array_ele, 2, req->obj_size);
 
-      // if array is moved, need to update hashtable
-      if (index - 1 != (long)rmtable->mining_table->len) {
-        g_hash_table_replace(rmtable->hashtable,
-                             GINT_TO_POINTER(row_in_mtable[0]),
-                             GINT_TO_POINTER(index));
-      }
-      rmtable->n_avail_mining--;
-    }
+    // all index is real row number + 1
+    id_map_put(rmtable->hashtable, req->obj_id, row_idx + 1);
+  } else {
+    /* in mining table */
+    _Mithril_add_ts_in_mtable(Mithril_params, req, index - 1, index);
   }
 }
 
@@ -640,24 +687,21 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
   } else {
     gint64 *row_in_rtable;
     // check the obj_id in hashtable for training
-    gint index = GPOINTER_TO_INT(
-        g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(req->obj_id)));
+    gint index = (gint)id_map_get(rmtable->hashtable, req->obj_id);
 
     if (index == 0) {
       // the node is not in the recording/mining data, should be added
       row_in_rtable = GET_CUR_ROW_IN_RTABLE(Mithril_params);
 
 #ifdef SANITY_CHECK
-      if (row_in_rtable[0] != 0) {
+      if (row_in_rtable[1] != 0) {
         ERROR("recording table is not clean\n");
-        abort();
       }
 #endif
 
-      row_in_rtable[0] = req->obj_id;
-      // row_in_rtable is a pointer to the block number
-      g_hash_table_insert(rmtable->hashtable, GINT_TO_POINTER(row_in_rtable[0]),
-                          GINT_TO_POINTER(rmtable->rtable_cur_row));
+      row_in_rtable[0] = (gint64)req->obj_id;
+      rmtable->rtable_obj_size[rmtable->rtable_cur_row] = req->obj_size;
+      id_map_put(rmtable->hashtable, req->obj_id, rmtable->rtable_cur_row);
 
       row_in_rtable[1] = ADD_TS(row_in_rtable[1], Mithril_params->ts);
 
@@ -671,31 +715,22 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
       row_in_rtable =
           GET_ROW_IN_RTABLE(Mithril_params, rmtable->rtable_cur_row);
 
-      if (row_in_rtable[0] != 0) {
+      if (row_in_rtable[1] != 0) {
         /** clear current row,
          *  this is because the recording table is full
          *  and we need to begin from beginning
          *  and current position has old resident,
          *  we need to remove them
          **/
-        if (!g_hash_table_contains(rmtable->hashtable,
-                                   GINT_TO_POINTER(row_in_rtable[0]))) {
+        if (!id_map_remove(rmtable->hashtable, (obj_id_t)row_in_rtable[0])) {
           ERROR(
               "remove old entry from recording table, "
               "but it is not in recording hashtable, "
-              "block %ld, recording table pos %ld, ts %ld ",
-              (long)row_in_rtable[0], (long)rmtable->rtable_cur_row,
+              "block %lu, recording table pos %ld, ts %ld\n",
+              (unsigned long)row_in_rtable[0], (long)rmtable->rtable_cur_row,
               (long)Mithril_params->ts);
-
-          long temp = rmtable->rtable_cur_row - 1;
-          fprintf(stderr, "previous line block %ld\n",
-                  *(long *)(GET_ROW_IN_RTABLE(Mithril_params, temp)));
-          abort();
         }
 
-        g_hash_table_remove(rmtable->hashtable,
-                            GINT_TO_POINTER(row_in_rtable[0]));
-
         /* clear recording table */
         for (i = 0; i < rmtable->rtable_row_len; i++) {
           row_in_rtable[i] = 0;
@@ -712,52 +747,7 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
        **/
       if (index < 0) {
         /* in mining table */
-        gint64 *row_in_mtable = GET_ROW_IN_MTABLE(Mithril_params, -index - 1);
-
-#ifdef SANITY_CHECK
-        if (req->obj_id != row_in_mtable[0]) {
-          ERROR(
-              "inconsistent entry in mtable "
-              "and mining hashtable current request %ld, "
-              "mining table %ld\n",
-              (long)req->obj_id, (long)row_in_mtable[0]);
-          abort();
-        }
-#endif
-        int timestamps_length = 0;
-
-        for (i = 1; i < rmtable->mtable_row_len; i++) {
-          timestamps_length += NUM_OF_TS(row_in_mtable[i]);
-          if (NUM_OF_TS(row_in_mtable[i]) < 4) {
-            row_in_mtable[i] = ADD_TS(row_in_mtable[i], Mithril_params->ts);
-            break;
-          }
-        }
-        if (timestamps_length == Mithril_params->max_support) {
-          /* no timestamp added, drop this request, it is too frequent */
-          if (!g_hash_table_remove(rmtable->hashtable,
-                                   GINT_TO_POINTER(row_in_mtable[0]))) {
-            ERROR("removing from rmtable failed for mining table entry\n");
-          }
-
-          /** for dataType c, now the pointer to string has been freed,
-           *  so mining table entry is incorrect,
-           *  but mining table entry will be deleted, so it is OK
-           */
-
-          g_array_remove_index_fast(rmtable->mining_table, -index - 1);
-
-          /** if the removed block is not the last entry,
-           *  g_array_remove_index_fast uses the last entry to fill in
-           *  the old position, so we need to update its index
-           **/
-          if (-index - 1 != (long)rmtable->mining_table->len) {
-            g_hash_table_replace(rmtable->hashtable,
-                                 GINT_TO_POINTER(row_in_mtable[0]),
-                                 GINT_TO_POINTER(index));
-          }
-          rmtable->n_avail_mining--;
-        }
+        _Mithril_add_ts_in_mtable(Mithril_params, req, -index - 1, index);
       } else {
         /* in recording table */
         row_in_rtable = GET_ROW_IN_RTABLE(Mithril_params, index);
@@ -766,10 +756,9 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
         int timestamps_length = 0;
 
 #ifdef SANITY_CHECK
-        if (req->obj_id != row_in_rtable[0]) {
-          ERROR("Hashtable recording found position not correct %ld %ld\n",
-                (long)req->obj_id, (long) row_in_rtable[0]);
-          abort();
+        if ((gint64)req->obj_id != row_in_rtable[0]) {
+          ERROR("Hashtable recording found position not correct %lu %lu\n",
+                (unsigned long)req->obj_id, (unsigned long)row_in_rtable[0]);
         }
 #endif
 
@@ -780,52 +769,25 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
             break;
           }
         }
+        rmtable->rtable_obj_size[index] = req->obj_size;
 
         if (timestamps_length == Mithril_params->min_support - 1) {
           /* time to move to mining table */
-          // gint64 *array_ele = malloc(sizeof(gint64) *
-          // rmtable->mtable_row_len);
-          gint64 array_ele[rmtable->mtable_row_len];
-          memcpy(array_ele, row_in_rtable,
-                 sizeof(TS_REPRESENTATION) * rmtable->rtable_row_len);
-
-          /** clear the rest of array,
-           *  this is important as
-           *  we don't clear the content of array after mining
-           **/
-          memset(array_ele + rmtable->rtable_row_len, 0,
-                 sizeof(TS_REPRESENTATION) *
-                     (rmtable->mtable_row_len - rmtable->rtable_row_len));
-#ifdef SANITY_CHECK
-          if ((long)rmtable->mining_table->len >= Mithril_params->mtable_size) {
-            /* if this happens, array will re-malloc, which will make
-             * the hashtable key not reliable when obj_id_type is l */
-            ERROR(
-                "mining table length reaches limit, but no mining, "
-                "entry %d, size %u, threshold %d\n",
-                rmtable->n_avail_mining, rmtable->mining_table->len,
-                Mithril_params->mtable_size);
-            abort();
-          }
-#endif
-          g_array_append_val(rmtable->mining_table, array_ele);
-          rmtable->n_avail_mining++;
-
-          if (index != rmtable->rtable_cur_row - 1 &&
-              rmtable->rtable_cur_row >= 2) {
+          gint row_idx = _Mithril_append_mining_row(
+              Mithril_params, row_in_rtable, rmtable->rtable_row_len,
+              req->obj_size);
+
+          gboolean move_last_row =
+              index != rmtable->rtable_cur_row - 1 &&
+              rmtable->rtable_cur_row >= 2;
+          if (move_last_row) {
             /** moved row is not the last entry in recording table
              *  move last row to current position
              **/
-
-#ifdef SANITY_CHECK
-            if (row_in_rtable == cur_row_in_rtable)
-              ERROR("FOUND SRC DEST same, ts %ld %p %p %ld %ld %d %ld\n",
-                    (long)Mithril_params->ts, row_in_rtable, cur_row_in_rtable,
-                    (long)*row_in_rtable, (long)*cur_row_in_rtable, index,
-                    (long)rmtable->rtable_cur_row - 1);
-#endif
             memcpy(row_in_rtable, cur_row_in_rtable,
                    sizeof(TS_REPRESENTATION) * rmtable->rtable_row_len);
+            rmtable->rtable_obj_size[index] =
+                rmtable->rtable_obj_size[rmtable->rtable_cur_row - 1];
           }
           if (rmtable->rtable_cur_row >= 2) {
             for (i = 0; i < rmtable->rtable_row_len; i++) {
@@ -838,37 +800,20 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
             for (i = 0; i < rmtable->rtable_row_len; i++) row_in_rtable[i] = 0;
           }
 
-          gint64 *inserted_row_in_mtable =
-              GET_ROW_IN_MTABLE(Mithril_params, rmtable->mining_table->len - 1);
-
-#ifdef SANITY_CHECK
-          if (inserted_row_in_mtable[0] != (gint64)req->obj_id) {
-            ERROR("current block %ld, moving mining row block %ld\n",
-                  (long)req->obj_id, (long)inserted_row_in_mtable[0]);
-            abort();
-          }
-#endif
           /** because we don't want to have zero as index,
            *  so we add one before taking negative,
            *  in other words, the range of mining table index
            *  is -1 ~ -max_index-1, mapping to 0~max_index
            */
-          g_hash_table_replace(
-              rmtable->hashtable, GINT_TO_POINTER(inserted_row_in_mtable[0]),
-              GINT_TO_POINTER(-((gint)rmtable->mining_table->len - 1 + 1)));
+          id_map_put(rmtable->hashtable, req->obj_id, -(row_idx + 1));
 
-          if (index != rmtable->rtable_cur_row - 1 &&
-              rmtable->rtable_cur_row >= 2)
+          if (move_last_row)
             // last entry in the recording table is moved up index position
-            g_hash_table_replace(rmtable->hashtable,
-                                 GINT_TO_POINTER(row_in_rtable[0]),
-                                 GINT_TO_POINTER(index));
+            id_map_put(rmtable->hashtable, (obj_id_t)row_in_rtable[0], index);
 
           // one entry has been moved to mining table, shrinking recording
           // table size by 1
           if (rmtable->rtable_cur_row >= 2) rmtable->rtable_cur_row--;
-
-          // free(array_ele);
         }
       }
     }
@@ -876,8 +821,7 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
   if (rmtable->n_avail_mining >= Mithril_params->mtable_size ||
       (Mithril_params->min_support == 1 &&
        rmtable->n_avail_mining > Mithril_params->mining_threshold / 8)) {
-    _Mithril_mining(cache);
-    rmtable->n_avail_mining = 0;
+    _Mithril_start_mining(cache);
   }
 }
 
@@ -892,73 +836,111 @@ static inline gint _Mithril_get_total_num_of_ts(gint64 *row, gint row_length) {
   return count;
 }
 
-gint mining_table_entry_cmp(gconstpointer a, gconstpointer b) {
-  return (gint)GET_NTH_TS(a, 1) - (gint)GET_NTH_TS(b, 1);
-}
-
-/* in debug */
-void print_one_line(gpointer key, gpointer value, gpointer user_data) {
-  gint src_key = GPOINTER_TO_INT(key);
-  gint prefetch_table_index = GPOINTER_TO_INT(value);
-  Mithril_params_t *Mithril_params = (Mithril_params_t *)user_data;
-  gint dim1 =
-      (gint)floor(prefetch_table_index / (double)PREFETCH_TABLE_SHARD_SIZE);
-  gint dim2 = prefetch_table_index % PREFETCH_TABLE_SHARD_SIZE *
-              (Mithril_params->pf_list_size + 1);
-  printf("src %d, prefetch ", src_key);
-  for (int i = 1; i < Mithril_params->pf_list_size + 1; i++) {
-    printf("%ld ", (long)Mithril_params->ptable_array[dim1][dim2 + i]);
+/**
+ stable merge sort of the mining table rows by the first timestamp,
+ the sorted order of rows is stored in rmtable->sort_idx
+ */
+static void _Mithril_sort_mining_table(Mithril_params_t *Mithril_params) {
+  rec_mining_t *rmtable = Mithril_params->rmtable;
+  gint n = rmtable->n_avail_mining;
+  gint *idx = rmtable->sort_idx, *buf = rmtable->sort_buf;
+
+  for (gint i = 0; i < n; i++) idx[i] = i;
+
+  for (gint width = 1; width < n; width *= 2) {
+    for (gint lo = 0; lo < n; lo += 2 * width) {
+      gint mid = MIN(lo + width, n), hi = MIN(lo + 2 * width, n);
+      gint l = lo, r = mid, k = lo;
+      while (l < mid && r < hi) {
+        /* take from the left run on ties to keep the sort stable */
+        if (GET_NTH_TS(GET_ROW_IN_MTABLE(Mithril_params, idx[r]), 1) <
+            GET_NTH_TS(GET_ROW_IN_MTABLE(Mithril_params, idx[l]), 1)) {
+          buf[k++] = idx[r++];
+        } else {
+          buf[k++] = idx[l++];
+        }
+      }
+      while (l < mid) buf[k++] = idx[l++];
+      while (r < hi) buf[k++] = idx[r++];
+    }
+    gint *tmp = idx;
+    idx = buf;
+    buf = tmp;
   }
-  printf("\n");
-}
-
-/* in debug */
-void print_prefetch_table(Mithril_params_t *Mithril_params) {
-  g_hash_table_foreach(Mithril_params->prefetch_hashtable, print_one_line,
-                       Mithril_params);
+  rmtable->sort_idx = idx;
+  rmtable->sort_buf = buf;
 }
 
 /**
- the mining function, it is called when mining table is ready
+ move the mining table into the mining snapshot sorted by the first timestamp,
+ the objs in the mining table start over in the recording table,
+ the previous snapshot is finished first
 
  @param Mithril the cache struct
  */
-static void _Mithril_mining(cache_t *cache) {
+static void _Mithril_start_mining(cache_t *cache) {
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
   rec_mining_t *rmtable = Mithril_params->rmtable;
+  gint row_len = rmtable->mtable_row_len;
+  gint i;
 
-#ifdef PROFILING
-  GTimer *timer = g_timer_new();
-  gulong microsecond;
-  g_timer_start(timer);
-#endif
+  if (rmtable->snapshot_next_row < rmtable->n_snapshot_row - 1) {
+    _Mithril_mining(cache, rmtable->n_snapshot_row);
+  }
 
-  int i, j, k;
+  /* remove all objs in the mining table from the hashtable */
+  for (i = 0; i < rmtable->n_avail_mining; i++) {
+    id_map_remove(rmtable->hashtable,
+                  (obj_id_t)*GET_ROW_IN_MTABLE(Mithril_params, i));
+  }
 
-  /* first sort mining table, then do the mining */
-  /* first remove all elements from hashtable, otherwise after sort, it will
-   mess up for obj_id_type l but we can't do this for dataType c, otherwise
-   the string will be freed during remove in hashtable
-   */
-  gint64 *item = (gint64 *)rmtable->mining_table->data;
-  for (i = 0; i < (int)rmtable->mining_table->len; i++) {
-    g_hash_table_remove(rmtable->hashtable, GINT_TO_POINTER(*item));
-    item += rmtable->mtable_row_len;
+  _Mithril_sort_mining_table(Mithril_params);
+  for (i = 0; i < rmtable->n_avail_mining; i++) {
+    gint src = rmtable->sort_idx[i];
+    memcpy(GET_ROW_IN_MSNAPSHOT(Mithril_params, i),
+           GET_ROW_IN_MTABLE(Mithril_params, src),
+           sizeof(TS_REPRESENTATION) * row_len);
+    rmtable->snapshot_obj_size[i] = rmtable->mtable_obj_size[src];
   }
+  rmtable->n_snapshot_row = rmtable->n_avail_mining;
+  rmtable->snapshot_next_row = 0;
+  rmtable->n_avail_mining = 0;
+
+  DEBUG("ts %lu, start mining %d rows\n", (unsigned long)Mithril_params->ts,
+        rmtable->n_snapshot_row);
+
+  if (Mithril_params->mining_step == 0) {
+    _Mithril_mining(cache, rmtable->n_snapshot_row);
+  }
+}
+
+/**
+ the mining function, it mines the next n_row rows of the mining snapshot,
+ each row is associated with the following rows within lookahead range
+
+ @param Mithril the cache struct
+ @param n_row the number of rows to mine
+ */
+static void _Mithril_mining(cache_t *cache, gint n_row) {
+  Mithril_params_t *Mithril_params =
+      (Mithril_params_t *)(cache->prefetcher->params);
+  rec_mining_t *rmtable = Mithril_params->rmtable;
 
-  g_array_sort(rmtable->mining_table, mining_table_entry_cmp);
+  int i, j, k;
+  gint n_snapshot_row = rmtable->n_snapshot_row;
+  gint end = MIN(rmtable->snapshot_next_row + n_row, n_snapshot_row - 1);
 
   gboolean associated_flag, first_flag;
   gint64 *item1, *item2;
   gint num_of_ts1, num_of_ts2, shorter_length;
-  for (i = 0; i < (long)rmtable->mining_table->len - 1; i++) {
-    item1 = GET_ROW_IN_MTABLE(Mithril_params, i);
+  for (i = rmtable->snapshot_next_row; i < end; i++) {
+    item1 = GET_ROW_IN_MSNAPSHOT(Mithril_params, i);
     num_of_ts1 = _Mithril_get_total_num_of_ts(item1, rmtable->mtable_row_len);
     first_flag = TRUE;
 
-    for (j = i + 1; j < (long)rmtable->mining_table->len; j++) {
-      item2 = GET_ROW_IN_MTABLE(Mithril_params, j);
+    for (j = i + 1; j < n_snapshot_row; j++) {
+      item2 = GET_ROW_IN_MSNAPSHOT(Mithril_params, j);
 
       // check first timestamp
       if (GET_NTH_TS(item2, 1) - GET_NTH_TS(item1, 1) >
@@ -1001,44 +983,34 @@ static void _Mithril_mining(cache_t *cache) {
       }
       if (associated_flag) {
         // finally, add to prefetch table
-        _Mithril_add_to_prefetch_table(cache, GINT_TO_POINTER(item1[0]),
-                                       GINT_TO_POINTER(item2[0]));
+        _Mithril_add_to_prefetch_table(cache, (obj_id_t)item1[0],
+                                       (obj_id_t)item2[0],
+                                       rmtable->snapshot_obj_size[j]);
       }
     }
   }
-
-  // may be just following?
-  rmtable->mining_table->len = 0;
-
-#ifdef PROFILING
-  printf("ts: %lu, clearing training data takes %lf seconds\n",
-         (unsigned long)Mithril_params->ts,
-         g_timer_elapsed(timer, &microsecond));
-  g_timer_stop(timer);
-  g_timer_destroy(timer);
-#endif
-
-#ifdef debug
-  print_prefetch_table(Mithril_params);
-#endif
+  rmtable->snapshot_next_row = end;
 }
 
 /**
  add two associated block into prefetch table
 
  @param Mithril the cache struct
- @param gp1 pointer to the first block
- @param gp2 pointer to the second block
+ @param src the first block
+ @param dst the second block, which is prefetched when src is requested
+ @param dst_size the size of the second block
  */
-static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
-                                           gpointer gp2) {
-  /** currently prefetch table can only support up to 2^31 entries,
-   * and this function assumes the platform is 64 bit */
+static void _Mithril_add_to_prefetch_table(cache_t *cache, obj_id_t src,
+                                           obj_id_t dst, gint64 dst_size) {
+  /** currently prefetch table can only support up to 2^31 entries */
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
+  gint64 **ptable = Mithril_params->ptable_array;
+  gint64 **ptable_obj_size = Mithril_params->ptable_obj_size;
+  gint64 dst_entry = (gint64)dst + 1;
 
-  gint prefetch_table_index = GPOINTER_TO_INT(
-      g_hash_table_lookup(Mithril_params->prefetch_hashtable, gp1));
+  gint prefetch_table_index =
+      (gint)id_map_get(Mithril_params->prefetch_hashtable, src);
   gint dim1 =
       (gint)floor(prefetch_table_index / (double)PREFETCH_TABLE_SHARD_SIZE);
   gint dim2 = prefetch_table_index % PREFETCH_TABLE_SHARD_SIZE *
@@ -1050,42 +1022,36 @@ static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
     // already have an entry in prefetch table, just add to that entry
     gboolean insert = TRUE;
 
-    for (i = 1; i < Mithril_params->pf_list_size + 1; i++) {
-      // if this element is already in
-      // the array, then don't need add
-      // again ATTENTION: the following
-      // assumes a 64 bit platform
 #ifdef SANITY_CHECK
-      if (Mithril_params->ptable_array[dim1][dim2] != GPOINTER_TO_INT(gp1)) {
-        fprintf(stderr, "ERROR prefetch table pos wrong %d %ld, dim %d %d\n",
-                GPOINTER_TO_INT(gp1),
-                (long)Mithril_params->ptable_array[dim1][dim2], dim1, dim2);
-        exit(1);
-      }
+    if (ptable[dim1][dim2] != (gint64)src) {
+      ERROR("prefetch table pos wrong %lu %lu, dim %d %d\n",
+            (unsigned long)src, (unsigned long)ptable[dim1][dim2], dim1, dim2);
+    }
 #endif
-      if ((Mithril_params->ptable_array[dim1][dim2 + i]) == 0) break;
-      if ((Mithril_params->ptable_array[dim1][dim2 + i]) ==
-          GPOINTER_TO_INT(gp2)) {
+
+    for (i = 1; i < Mithril_params->pf_list_size + 1; i++) {
+      // if this element is already in the array, then don't need add again
+      if (ptable[dim1][dim2 + i] == 0) break;
+      if (ptable[dim1][dim2 + i] == dst_entry) {
         /* update score here, not implemented yet */
+        ptable_obj_size[dim1][dim2 + i] = dst_size;
         insert = FALSE;
       }
     }
 
     if (insert) {
       if (i == Mithril_params->pf_list_size + 1) {
-        // list full, randomly pick one for replacement
-        //                i = rand()%Mithril_params->pf_list_size + 1;
-
-        // use FIFO
+        // list full, use FIFO for replacement
         int j;
         for (j = 2; j < Mithril_params->pf_list_size + 1; j++) {
-          Mithril_params->ptable_array[dim1][dim2 + j - 1] =
-              Mithril_params->ptable_array[dim1][dim2 + j];
+          ptable[dim1][dim2 + j - 1] = ptable[dim1][dim2 + j];
+          ptable_obj_size[dim1][dim2 + j - 1] = ptable_obj_size[dim1][dim2 + j];
         }
         i = Mithril_params->pf_list_size;
       }
       // new add at position i
-      Mithril_params->ptable_array[dim1][dim2 + i] = GPOINTER_TO_INT(gp2);
+      ptable[dim1][dim2 + i] = dst_entry;
+      ptable_obj_size[dim1][dim2 + i] = dst_size;
     }
   } else {
     // does not have entry, need to add a new entry
@@ -1099,29 +1065,19 @@ static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
      to replace the entry at ptable_cur_row by set the entry it points to as
      0, delete from prefetch_hashtable and add new entry */
     if (Mithril_params->ptable_is_full) {
-      g_hash_table_remove(
-          Mithril_params->prefetch_hashtable,
-          GINT_TO_POINTER(Mithril_params->ptable_array[dim1][dim2]));
+      id_map_remove(Mithril_params->prefetch_hashtable,
+                    (obj_id_t)ptable[dim1][dim2]);
 
-      memset(&(Mithril_params->ptable_array[dim1][dim2]), 0,
+      memset(&(ptable[dim1][dim2]), 0,
              sizeof(gint64) * (Mithril_params->pf_list_size + 1));
     }
 
-    Mithril_params->ptable_array[dim1][dim2 + 1] = GPOINTER_TO_INT(gp2);
-    Mithril_params->ptable_array[dim1][dim2] = GPOINTER_TO_INT(gp1);
+    ptable[dim1][dim2 + 1] = dst_entry;
+    ptable_obj_size[dim1][dim2 + 1] = dst_size;
+    ptable[dim1][dim2] = (gint64)src;
 
-#ifdef SANITY_CHECK
-    // make sure gp1 is not in prefetch_hashtable
-    if (g_hash_table_contains(Mithril_params->prefetch_hashtable, gp1)) {
-      gpointer gp =
-          g_hash_table_lookup(Mithril_params->prefetch_hashtable, gp1);
-      printf("contains %d, value %d, %d\n", GPOINTER_TO_INT(gp1),
-             GPOINTER_TO_INT(gp), prefetch_table_index);
-    }
-#endif
-
-    g_hash_table_insert(Mithril_params->prefetch_hashtable, gp1,
-                        GINT_TO_POINTER(Mithril_params->ptable_cur_row));
+    id_map_put(Mithril_params->prefetch_hashtable, src,
+               Mithril_params->ptable_cur_row);
 
     // check current shard is full or not
     if ((Mithril_params->ptable_cur_row + 1) % PREFETCH_TABLE_SHARD_SIZE == 0) {
@@ -1130,9 +1086,12 @@ static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
               PREFETCH_TABLE_SHARD_SIZE *
                   (Mithril_params->pf_list_size * 8 + 8 + 4) <
           Mithril_params->max_metadata_size) {
-        Mithril_params->ptable_array[dim1 + 1] =
-            g_new0(gint64, PREFETCH_TABLE_SHARD_SIZE *
-                               (Mithril_params->pf_list_size + 1));
+        ptable[dim1 + 1] = g_new0(
+            gint64,
+            PREFETCH_TABLE_SHARD_SIZE * (Mithril_params->pf_list_size + 1));
+        ptable_obj_size[dim1 + 1] = g_new0(
+            gint64,
+            PREFETCH_TABLE_SHARD_SIZE * (Mithril_params->pf_list_size + 1));
         gint required_meta_data_size =
             PREFETCH_TABLE_SHARD_SIZE *
             (Mithril_params->pf_list_size * 8 + 8 + 4);
@@ -1140,15 +1099,6 @@ static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
 
         // For the general purpose, it has been decided not to consider the
         // metadata overhead of the prefetcher
-
-        // if(consider_metasize) {
-        //   Mithril->cache_size =
-        //       Mithril->cache_size -
-        //       (gint)((Mithril_params->cur_metadata_size) /
-        //                                    Mithril_params->block_size);
-        //   cache->cache_size = Mithril->cache_size;
-        //   // delay the eviction
-        // }
       } else {
         Mithril_params->ptable_is_full = TRUE;
         Mithril_params->ptable_cur_row = 1;
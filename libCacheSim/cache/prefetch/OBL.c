@@ -144,6 +144,12 @@ void free_OBL_prefetcher(prefetcher_t *prefetcher) {
   my_free(sizeof(prefetcher_t), prefetcher);
 }
 
+static int64_t OBL_get_metadata_bytes(const prefetcher_t *prefetcher) {
+  const OBL_params_t *OBL_params = prefetcher->params;
+  return (int64_t)sizeof(OBL_params_t) +
+         OBL_params->sequential_confidence_k * (int64_t)sizeof(obj_id_t);
+}
+
 prefetcher_t *clone_OBL_prefetcher(prefetcher_t *prefetcher, uint64_t cache_size) {
   return create_OBL_prefetcher(prefetcher->init_params, cache_size);
 }
@@ -169,6 +175,7 @@ prefetcher_t *create_OBL_prefetcher(const char *init_params, uint64_t cache_size
   prefetcher->handle_evict = NULL;
   prefetcher->free = free_OBL_prefetcher;
   prefetcher->clone = clone_OBL_prefetcher;
+  prefetcher->get_metadata_bytes = OBL_get_metadata_bytes;
   if (init_params) {
     prefetcher->init_params = strdup(init_params);
   }
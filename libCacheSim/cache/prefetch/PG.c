@@ -202,6 +202,12 @@ void free_PG_prefetcher(prefetcher_t *prefetcher) {
   my_free(sizeof(prefetcher_t), prefetcher);
 }
 
+/* the graph as counted by PG against max-metadata-size */
+static int64_t PG_get_metadata_bytes(const prefetcher_t *prefetcher) {
+  const PG_params_t *PG_params = prefetcher->params;
+  return (int64_t)sizeof(PG_params_t) + (int64_t)PG_params->cur_metadata_size;
+}
+
 prefetcher_t *clone_PG_prefetcher(prefetcher_t *prefetcher, uint64_t cache_size) {
   return create_PG_prefetcher(prefetcher->init_params, cache_size);
 }
@@ -229,6 +235,7 @@ prefetcher_t *create_PG_prefetcher(const char *init_params, uint64_t cache_size)
   prefetcher->handle_evict = PG_handle_evict;
   prefetcher->free = free_PG_prefetcher;
   prefetcher->clone = clone_PG_prefetcher;
+  prefetcher->get_metadata_bytes = PG_get_metadata_bytes;
   if (init_params) {
     prefetcher->init_params = strdup(init_params);
   }
@@ -0,0 +1,384 @@
+//
+//  a multi-stream stride prefetcher for block storage, each object (logical
+//  block address) should be uniform in size.
+//
+//  a fixed-size stream table tracks the recent access streams, a request
+//  continues a stream if it is k strides (1 <= k <= the number of prefetched
+//  strides) after the last access, otherwise it trains the closest stream
+//  that is not confirmed (within max-stride blocks), or replaces the least
+//  recently used stream. A stream is confirmed after min-confidence accesses
+//  with the same stride, and then keeps depth blocks prefetched ahead of its
+//  last access.
+//
+//  depth adapts to the prefetch feedback: it doubles (up to max-depth) when
+//  a depth worth of its prefetched blocks are requested (observed in
+//  handle_find), and halves (down to 1) when one of its prefetched blocks is
+//  evicted before being requested.
+//
+//  params:
+//    n-stream=32 the number of streams in the stream table
+//    max-stride=64 the max distance (in blocks) between two accesses of a
+//                  stream
+//    min-confidence=2 the number of accesses with the same stride before
+//                     prefetching
+//    init-depth=4 the number of blocks prefetched ahead for a new stream
+//    max-depth=64
+//    block-size=0 the size of a prefetched block, 0 uses the size of the
+//                 request that triggers the prefetch
+//
+//
+//  Stride.c
+//  libCacheSim
+//
+#include "../../include/libCacheSim/prefetchAlgo/Stride.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/types.h>
+
+#include "../../include/libCacheSim/prefetchAlgo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the value of a prefetched block in Stride_params_t->prefetched */
+#define ENCODE_PF_STREAM(idx, generation) \
+  (((int64_t)(generation) << 32) | (uint32_t)(idx))
+#define PF_STREAM_IDX(v) ((int32_t)((v) & 0xffffffff))
+#define PF_STREAM_GENERATION(v) ((uint32_t)((uint64_t)(v) >> 32))
+
+const char *Stride_default_params(void) {
+  return "n-stream=32, max-stride=64, min-confidence=2, init-depth=4, "
+         "max-depth=64, block-size=0";
+}
+
+static void set_Stride_default_init_params(Stride_init_params_t *init_params) {
+  init_params->n_stream = 32;
+  init_params->max_stride = 64;
+  init_params->min_confidence = 2;
+  init_params->init_depth = 4;
+  init_params->max_depth = 64;
+  init_params->block_size = 0;
+}
+
+static void Stride_parse_init_params(const char *cache_specific_params,
+                                     Stride_init_params_t *init_params) {
+  char *params_str = strdup(cache_specific_params);
+  char *old_params_str = params_str;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+    if (strcasecmp(key, "n-stream") == 0) {
+      init_params->n_stream = atoi(value);
+    } else if (strcasecmp(key, "max-stride") == 0) {
+      init_params->max_stride = atol(value);
+    } else if (strcasecmp(key, "min-confidence") == 0) {
+      init_params->min_confidence = atoi(value);
+    } else if (strcasecmp(key, "init-depth") == 0) {
+      init_params->init_depth = atoi(value);
+    } else if (strcasecmp(key, "max-depth") == 0) {
+      init_params->max_depth = atoi(value);
+    } else if (strcasecmp(key, "block-size") == 0) {
+      init_params->block_size = atol(value);
+    } else if (strcasecmp(key, "print") == 0 ||
+               strcasecmp(key, "default") == 0) {
+      printf("default params: %s\n", Stride_default_params());
+      exit(0);
+    } else {
+      ERROR("Stride does not have parameter %s\n", key);
+      printf("default params: %s\n", Stride_default_params());
+      exit(1);
+    }
+  }
+  free(old_params_str);
+}
+
+static void set_Stride_params(Stride_params_t *Stride_params,
+                              Stride_init_params_t *init_params,
+                              uint64_t cache_size) {
+  if (init_params->n_stream <= 0 || init_params->max_stride <= 0 ||
+      init_params->min_confidence <= 0 || init_params->init_depth <= 0 ||
+      init_params->max_depth < init_params->init_depth ||
+      init_params->block_size < 0) {
+    ERROR(
+        "Stride requires positive n-stream, max-stride, min-confidence and "
+        "init-depth, max-depth >= init-depth, and non-negative block-size\n");
+  }
+
+  memset(Stride_params, 0, sizeof(Stride_params_t));
+  Stride_params->n_stream = init_params->n_stream;
+  Stride_params->max_stride = init_params->max_stride;
+  Stride_params->min_confidence = init_params->min_confidence;
+  Stride_params->init_depth = init_params->init_depth;
+  Stride_params->max_depth = init_params->max_depth;
+  Stride_params->block_size = init_params->block_size;
+  Stride_params->pf_stream_idx = -1;
+
+  Stride_params->streams = (stride_stream_t *)calloc(
+      Stride_params->n_stream, sizeof(stride_stream_t));
+  Stride_params->prefetched = create_id_map(
+      (int64_t)Stride_params->n_stream * Stride_params->max_depth);
+}
+
+/******************** Stride help function ********************/
+/**
+ find the stream that req continues or trains, or replace the least recently
+ used stream with a new stream starting at req
+
+ @return the index of the stream
+ */
+static int32_t _Stride_update_streams(Stride_params_t *Stride_params,
+                                      const request_t *req) {
+  stride_stream_t *streams = Stride_params->streams;
+  int32_t cont_idx = -1, train_idx = -1, victim_idx = 0;
+  int64_t cont_k = 0, train_dist = 0;
+
+  for (int32_t i = 0; i < Stride_params->n_stream; i++) {
+    stride_stream_t *s = &streams[i];
+    if (!s->valid) {
+      if (streams[victim_idx].valid) victim_idx = i;
+      continue;
+    }
+    if (streams[victim_idx].valid &&
+        s->last_access < streams[victim_idx].last_access) {
+      victim_idx = i;
+    }
+
+    int64_t diff = (int64_t)(req->obj_id - s->last_block);
+    if (diff == 0) continue;
+
+    /* k strides after the last access, within the prefetched strides */
+    if (s->stride != 0 && diff % s->stride == 0) {
+      int64_t k = diff / s->stride;
+      if (k >= 1 && k <= MAX(s->n_ahead, 1) &&
+          (cont_idx == -1 || k < cont_k)) {
+        cont_idx = i;
+        cont_k = k;
+      }
+    }
+
+    if (s->confidence < Stride_params->min_confidence &&
+        ABS(diff) <= Stride_params->max_stride &&
+        (train_idx == -1 || ABS(diff) < train_dist)) {
+      train_idx = i;
+      train_dist = ABS(diff);
+    }
+  }
+
+  stride_stream_t *s;
+  int32_t idx;
+  if (cont_idx != -1) {
+    idx = cont_idx;
+    s = &streams[idx];
+    s->n_ahead = (int32_t)MAX(s->n_ahead - cont_k, 0);
+    if (s->confidence < Stride_params->min_confidence) s->confidence += 1;
+  } else if (train_idx != -1) {
+    idx = train_idx;
+    s = &streams[idx];
+    int64_t diff = (int64_t)(req->obj_id - s->last_block);
+    if (diff == s->stride) {
+      s->confidence += 1;
+    } else {
+      s->stride = diff;
+      s->confidence = 1;
+    }
+    s->n_ahead = 0;
+  } else {
+    idx = victim_idx;
+    s = &streams[idx];
+    s->stride = 0;
+    s->confidence = 0;
+    s->depth = Stride_params->init_depth;
+    s->n_ahead = 0;
+    s->n_hit = 0;
+    s->generation += 1;
+    s->valid = true;
+  }
+  s->last_block = req->obj_id;
+  s->last_access = Stride_params->n_req;
+
+  return idx;
+}
+
+/* return the stream that prefetched obj_id if it has not been replaced */
+static stride_stream_t *_Stride_get_pf_stream(Stride_params_t *Stride_params,
+                                              int64_t v) {
+  stride_stream_t *s = &Stride_params->streams[PF_STREAM_IDX(v)];
+  if (!s->valid || s->generation != PF_STREAM_GENERATION(v)) return NULL;
+  return s;
+}
+
+/**************************************************************************
+ **                      prefetcher interfaces
+ **
+ ** create, free, clone, handle_find, handle_insert, handle_evict, prefetch
+ **************************************************************************/
+prefetcher_t *create_Stride_prefetcher(const char *init_params,
+                                       uint64_t cache_size);
+/**
+ use the request as the feedback of the stream that prefetched it, and find
+ the stream of the request, if the stream is confirmed, prefetch for it.
+
+ @param cache the cache struct
+ @param req the request containing the request
+ @return
+*/
+static void Stride_handle_find(cache_t *cache, const request_t *req,
+                               bool hit) {
+  Stride_params_t *Stride_params = (Stride_params_t *)(cache->prefetcher->params);
+  Stride_params->n_req += 1;
+
+  int64_t v;
+  if (id_map_find(Stride_params->prefetched, req->obj_id, &v)) {
+    id_map_remove(Stride_params->prefetched, req->obj_id);
+    Stride_params->n_prefetch_hit += 1;
+    stride_stream_t *s = _Stride_get_pf_stream(Stride_params, v);
+    if (s != NULL && ++s->n_hit >= s->depth) {
+      s->depth = MIN(s->depth * 2, Stride_params->max_depth);
+      s->n_hit = 0;
+    }
+  }
+
+  int32_t idx = _Stride_update_streams(Stride_params, req);
+  Stride_params->pf_stream_idx =
+      Stride_params->streams[idx].confidence >= Stride_params->min_confidence
+          ? idx
+          : -1;
+}
+
+/**
+ a prefetched block that is evicted before being requested halves the depth
+ of its stream
+
+ @param cache the cache struct
+ @param req the request containing the request
+ @return
+*/
+static void Stride_handle_evict(cache_t *cache, const request_t *check_req) {
+  Stride_params_t *Stride_params = (Stride_params_t *)(cache->prefetcher->params);
+
+  int64_t v;
+  if (id_map_find(Stride_params->prefetched, check_req->obj_id, &v)) {
+    id_map_remove(Stride_params->prefetched, check_req->obj_id);
+    Stride_params->n_prefetch_unused += 1;
+    stride_stream_t *s = _Stride_get_pf_stream(Stride_params, v);
+    if (s != NULL) {
+      s->depth = MAX(s->depth / 2, 1);
+      s->n_hit = 0;
+    }
+  }
+}
+
+/**
+ prefetch the blocks of the stream of the request until depth blocks are
+ prefetched ahead of its last access
+
+ @param cache the cache struct
+ @param req the request containing the request
+ @return
+ */
+void Stride_prefetch(cache_t *cache, const request_t *req) {
+  Stride_params_t *Stride_params = (Stride_params_t *)(cache->prefetcher->params);
+  if (Stride_params->pf_stream_idx < 0) return;
+
+  int32_t idx = Stride_params->pf_stream_idx;
+  Stride_params->pf_stream_idx = -1;
+  stride_stream_t *s = &Stride_params->streams[idx];
+
+  request_t *new_req = new_request();
+  new_req->obj_size =
+      Stride_params->block_size > 0 ? Stride_params->block_size : req->obj_size;
+  while (s->n_ahead < s->depth) {
+    int64_t offset = s->stride * (s->n_ahead + 1);
+    /* do not wrap around the block address space */
+    if (offset < 0 && s->last_block < (obj_id_t)(-offset)) break;
+    s->n_ahead += 1;
+
+    new_req->obj_id = s->last_block + offset;
+    if (cache->find(cache, new_req, false)) {
+      continue;
+    }
+
+    while ((long)cache->get_occupied_byte(cache) + new_req->obj_size +
+               cache->obj_md_size >
+           (long)cache->cache_size) {
+      cache->evict(cache, new_req);
+    }
+    cache->insert(cache, new_req);
+    id_map_put(Stride_params->prefetched, new_req->obj_id,
+               ENCODE_PF_STREAM(idx, s->generation));
+    Stride_params->n_prefetch += 1;
+  }
+  free_request(new_req);
+}
+
+void free_Stride_prefetcher(prefetcher_t *prefetcher) {
+  Stride_params_t *Stride_params = (Stride_params_t *)prefetcher->params;
+  DEBUG("Stride prefetched %ld blocks, %ld used, %ld evicted unused\n",
+        (long)Stride_params->n_prefetch, (long)Stride_params->n_prefetch_hit,
+        (long)Stride_params->n_prefetch_unused);
+  free(Stride_params->streams);
+  free_id_map(Stride_params->prefetched);
+
+  my_free(sizeof(Stride_params_t), Stride_params);
+  if (prefetcher->init_params) {
+    free(prefetcher->init_params);
+  }
+  my_free(sizeof(prefetcher_t), prefetcher);
+}
+
+static int64_t Stride_get_metadata_bytes(const prefetcher_t *prefetcher) {
+  const Stride_params_t *Stride_params = prefetcher->params;
+  return (int64_t)sizeof(Stride_params_t) +
+         Stride_params->n_stream * (int64_t)sizeof(stride_stream_t) +
+         id_map_get_metadata_bytes(Stride_params->prefetched);
+}
+
+prefetcher_t *clone_Stride_prefetcher(prefetcher_t *prefetcher,
+                                      uint64_t cache_size) {
+  return create_Stride_prefetcher(prefetcher->init_params, cache_size);
+}
+
+prefetcher_t *create_Stride_prefetcher(const char *init_params,
+                                       uint64_t cache_size) {
+  Stride_init_params_t *Stride_init_params = my_malloc(Stride_init_params_t);
+  memset(Stride_init_params, 0, sizeof(Stride_init_params_t));
+
+  set_Stride_default_init_params(Stride_init_params);
+  if (init_params != NULL) {
+    Stride_parse_init_params(init_params, Stride_init_params);
+  }
+
+  Stride_params_t *Stride_params = my_malloc(Stride_params_t);
+  set_Stride_params(Stride_params, Stride_init_params, cache_size);
+
+  prefetcher_t *prefetcher = (prefetcher_t *)my_malloc(prefetcher_t);
+  memset(prefetcher, 0, sizeof(prefetcher_t));
+  prefetcher->params = Stride_params;
+  prefetcher->prefetch = Stride_prefetch;
+  prefetcher->handle_find = Stride_handle_find;
+  prefetcher->handle_insert = NULL;
+  prefetcher->handle_evict = Stride_handle_evict;
+  prefetcher->free = free_Stride_prefetcher;
+  prefetcher->clone = clone_Stride_prefetcher;
+  prefetcher->get_metadata_bytes = Stride_get_metadata_bytes;
+  if (init_params) {
+    prefetcher->init_params = strdup(init_params);
+  }
+
+  my_free(sizeof(Stride_init_params_t), Stride_init_params);
+  return prefetcher;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -49,23 +49,25 @@ inline static int test_bit_set_bit(unsigned char *buf, unsigned int x,
   }
 }
 
-static int bloom_check_add(struct bloom *bloom, const void *buffer, int len,
-                           int add) {
+/* the k bit positions are derived from one 64-bit hash value using double
+ * hashing (Kirsch and Mitzenmacher), the position is mapped to [0, bits)
+ * using multiply-shift instead of modulo */
+static int bloom_check_add_hash(struct bloom *bloom, uint64_t hv, int add) {
   if (bloom->ready == 0) {
     printf("bloom at %p not initialized!\n", (void *)bloom);
     return -1;
   }
 
   int hits = 0;
-  //  register unsigned int a = murmurhash2(buffer, len, 0x9747b28c);
-  //  register unsigned int b = murmurhash2(buffer, len, a);
-  register unsigned int a = XXH64(buffer, len, HASH_SEED0);
-  register unsigned int b = XXH64(buffer, len, HASH_SEED1);
-  register unsigned int x;
-  register unsigned int i;
+  uint32_t a = (uint32_t)hv;
+  uint32_t b = (uint32_t)(hv >> 32) | 1;
+  uint32_t x;
+  int i;
 
   for (i = 0; i < bloom->hashes; i++) {
-    x = (a + i * b) % bloom->bits;
+    x = (uint32_t)(((uint64_t)(uint32_t)(a + (uint32_t)i * b) *
+                    (uint64_t)bloom->bits) >>
+                   32);
     if (test_bit_set_bit(bloom->bf, x, add)) {
       hits++;
     } else if (!add) {
@@ -81,6 +83,11 @@ static int bloom_check_add(struct bloom *bloom, const void *buffer, int len,
   return 0;
 }
 
+static int bloom_check_add(struct bloom *bloom, const void *buffer, int len,
+                           int add) {
+  return bloom_check_add_hash(bloom, XXH64(buffer, len, HASH_SEED0), add);
+}
+
 int bloom_init_size(struct bloom *bloom, int entries, double error,
                     unsigned int cache_size) {
   return bloom_init(bloom, entries, error);
@@ -128,6 +135,14 @@ int bloom_add(struct bloom *bloom, const void *buffer, int len) {
   return bloom_check_add(bloom, buffer, len, 1);
 }
 
+int bloom_check_hash(struct bloom *bloom, uint64_t hv) {
+  return bloom_check_add_hash(bloom, hv, 0);
+}
+
+int bloom_add_hash(struct bloom *bloom, uint64_t hv) {
+  return bloom_check_add_hash(bloom, hv, 1);
+}
+
 void bloom_print(struct bloom *bloom) {
   printf("bloom at %p\n", (void *)bloom);
   printf(" ->entries = %d\n", bloom->entries);
@@ -8,6 +8,8 @@
 #ifndef _BLOOM_H
 #define _BLOOM_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -118,6 +120,24 @@ int bloom_check(struct bloom * bloom, const void * buffer, int len);
 int bloom_add(struct bloom * bloom, const void * buffer, int len);
 
 
+/** ***************************************************************************
+ * Same as bloom_check() and bloom_add(), but take a 64-bit hash value of the
+ * element computed by the caller (e.g., req->hv), so that an element is
+ * hashed once no matter how many filters it is checked against.
+ *
+ * Parameters:
+ * -----------
+ *     bloom  - Pointer to an allocated struct bloom (see above).
+ *     hv     - The 64-bit hash value of the element.
+ *
+ * Return: same as bloom_check() and bloom_add()
+ *
+ */
+int bloom_check_hash(struct bloom * bloom, uint64_t hv);
+
+int bloom_add_hash(struct bloom * bloom, uint64_t hv);
+
+
 /** ***************************************************************************
  * Print (to stdout) info about this bloom filter. Debugging aid.
  *
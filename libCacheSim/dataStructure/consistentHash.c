@@ -0,0 +1,199 @@
+//
+// Created by Juncheng Yang on 2019-06-21.
+//
+// modified from libketama
+//
+
+#include "consistentHash.h"
+
+#include "../include/libCacheSim/logging.h"
+#include "hash/hash.h"
+#include "ketama/md5.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static int ch_ring_compare(const void *a, const void *b) {
+  vnode_t *node_a = (vnode_t *)a;
+  vnode_t *node_b = (vnode_t *)b;
+  return (node_a->point < node_b->point)
+             ? -1
+             : ((node_a->point > node_b->point) ? 1 : 0);
+}
+
+static void md5_digest(const char *const inString, unsigned char md5pword[16]) {
+  md5_state_t md5state;
+
+  md5_init(&md5state);
+  md5_append(&md5state, (unsigned char *)inString, (int)strlen(inString));
+  md5_finish(&md5state, md5pword);
+}
+
+static unsigned int ketama_hash(const char *const inString) {
+  unsigned char digest[16];
+  md5_digest(inString, digest);
+  return (unsigned int)((digest[3] << 24) | (digest[2] << 16) |
+                        (digest[1] << 8) | digest[0]);
+}
+
+ring_t *ch_ring_create_ring(int n_server, double *weight) {
+  /* the number of points of a server is rounded down from its weight, so
+   * count the points before allocating */
+  unsigned int n_point = 0;
+  for (int i = 0; i < n_server; i++) {
+    unsigned int ks = N_VNODE_PER_SERVER / 4;
+    if (weight != NULL)
+      ks = (unsigned int)floor(weight[i] * (double)n_server *
+                               (N_VNODE_PER_SERVER / 4));
+    n_point += ks * 4;
+  }
+
+  vnode_t *vnodes = (vnode_t *)malloc(sizeof(vnode_t) * (n_point + 1));
+  ring_t *ring = (ring_t *)malloc(sizeof(ring_t));
+  ring->n_server = n_server;
+  ring->vnodes = vnodes;
+
+  unsigned int k, cnt = 0;
+  for (int i = 0; i < n_server; i++) {
+    // default all servers have the same weight
+    unsigned int ks = N_VNODE_PER_SERVER / 4;
+    if (weight != NULL)
+      ks = (unsigned int)floor(weight[i] * (double)n_server *
+                               (N_VNODE_PER_SERVER / 4));
+
+    for (k = 0; k < ks; k++) {
+      /* 40 hashes, 4 numbers per hash = 160 points per server */
+      char ss[30];
+      unsigned char digest[16];
+
+      sprintf(ss, "%u-%u", i, k);
+      md5_digest(ss, digest);
+
+      /* Use successive 4-bytes from hash as numbers for the points on the
+       * circle: */
+      for (int h = 0; h < 4; h++) {
+        vnodes[cnt].point = (digest[3 + h * 4] << 24) |
+                            (digest[2 + h * 4] << 16) |
+                            (digest[1 + h * 4] << 8) | digest[h * 4];
+
+        vnodes[cnt].server_id = i;
+        cnt++;
+      }
+    }
+  }
+  ring->n_point = cnt;
+  if (cnt == 0) {
+    ERROR("consistent hash ring has no point, check the server weights\n");
+  }
+
+  /* Sorts in ascending order of "point" */
+  qsort((void *)vnodes, cnt, sizeof(vnode_t), ch_ring_compare);
+
+  return ring;
+}
+
+/* find the first vnode whose point is at or after h, wrap around to the
+ * first vnode if h is larger than all points */
+static unsigned int ch_ring_get_vnode_idx_from_hash(unsigned int h,
+                                                    const ring_t *const ring) {
+  const vnode_t *vnodes = ring->vnodes;
+  unsigned int lowp = 0, highp = ring->n_point;
+
+  while (lowp < highp) {
+    unsigned int midp = lowp + (highp - lowp) / 2;
+    if (vnodes[midp].point < h)
+      lowp = midp + 1;
+    else
+      highp = midp;
+  }
+
+  return lowp == ring->n_point ? 0 : lowp;
+}
+
+static inline unsigned int ch_ring_hash_uint64(uint64_t obj_id) {
+  uint64_t hv = get_hash_value_int_64(&obj_id);
+  return (unsigned int)(hv ^ (hv >> 32));
+}
+
+int ch_ring_get_server(const char *const key, const ring_t *const ring) {
+  return ring->vnodes[ch_ring_get_vnode_idx_from_hash(ketama_hash(key), ring)]
+      .server_id;
+}
+
+int ch_ring_get_server_from_uint64(uint64_t obj_id, const ring_t *const ring) {
+  return ring
+      ->vnodes[ch_ring_get_vnode_idx_from_hash(ch_ring_hash_uint64(obj_id),
+                                               ring)]
+      .server_id;
+}
+
+/* walk the ring clockwise from start_vnode_idx and collect up to n distinct
+ * servers that are not marked in chosen_server */
+static unsigned int ch_ring_walk(const ring_t *const ring,
+                                 unsigned int start_vnode_idx,
+                                 const unsigned int n, unsigned int *idxs,
+                                 bool *chosen_server) {
+  const vnode_t *vnodes = ring->vnodes;
+  unsigned int i = 0;
+  for (unsigned int vnode_pos = 0; vnode_pos < ring->n_point && i < n;
+       vnode_pos++) {
+    unsigned int server_id =
+        vnodes[(start_vnode_idx + vnode_pos) % ring->n_point].server_id;
+    if (!chosen_server[server_id]) {
+      idxs[i++] = server_id;
+      chosen_server[server_id] = true;
+    }
+  }
+  return i;
+}
+
+/* n: the number of servers that's going to retrieve */
+void ch_ring_get_servers(const char *const key, const ring_t *const ring,
+                         const unsigned int n, unsigned int *idxs) {
+  bool chosen_server[ring->n_server];
+  memset(chosen_server, 0, sizeof(bool) * ring->n_server);
+  unsigned int start = ch_ring_get_vnode_idx_from_hash(ketama_hash(key), ring);
+  if (ch_ring_walk(ring, start, n, idxs, chosen_server) < n) {
+    ERROR(
+        "searched all points on the consistent hash ring, but cannot find %u "
+        "servers\n",
+        n);
+  }
+}
+
+void ch_ring_get_available_servers(const char *const key,
+                                   const ring_t *const ring,
+                                   const unsigned int n, unsigned int *idxs,
+                                   const char *server_unavailability) {
+  bool chosen_server[ring->n_server];
+  for (unsigned int i = 0; i < ring->n_server; i++)
+    chosen_server[i] = server_unavailability[i] != 0;
+  unsigned int start = ch_ring_get_vnode_idx_from_hash(ketama_hash(key), ring);
+  if (ch_ring_walk(ring, start, n, idxs, chosen_server) < n) {
+    ERROR(
+        "searched all %u points on the consistent hash ring, but cannot find "
+        "%u available servers\n",
+        ring->n_point, n);
+  }
+}
+
+unsigned int ch_ring_get_available_servers_from_uint64(
+    uint64_t obj_id, const ring_t *const ring, const unsigned int n,
+    unsigned int *idxs, const bool *server_available) {
+  bool chosen_server[ring->n_server];
+  for (unsigned int i = 0; i < ring->n_server; i++)
+    chosen_server[i] = !server_available[i];
+  unsigned int start =
+      ch_ring_get_vnode_idx_from_hash(ch_ring_hash_uint64(obj_id), ring);
+  return ch_ring_walk(ring, start, n, idxs, chosen_server);
+}
+
+void ch_ring_destroy_ring(ring_t *ring) {
+  free(ring->vnodes);
+  free(ring);
+}
+
+#ifdef __cplusplus
+}
+#endif
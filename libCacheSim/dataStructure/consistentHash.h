@@ -1,6 +1,10 @@
 //
 // Created by Juncheng Yang on 2019-06-21.
 //
+// a consistent hash ring modified from libketama, each server has
+// N_VNODE_PER_SERVER points (scaled by its weight) on a 32-bit ring, and a
+// key is mapped to the server of the first point at or after its hash
+//
 
 #ifndef CONSISTENT_HASH_H_
 #define CONSISTENT_HASH_H_
@@ -9,11 +13,12 @@
 extern "C" {
 #endif
 
+#include <inttypes.h>
 #include <math.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <inttypes.h>
 
 #define N_VNODE_PER_SERVER 160
 
@@ -22,19 +27,18 @@ typedef struct {
   unsigned int server_id;
 } vnode_t;
 
-typedef struct {
+typedef struct ring {
   unsigned int n_point;
   unsigned int n_server;
   vnode_t *vnodes;
 } ring_t;
 
-// typedef int (*compfn)(const void *, const void *);
-
 /**
  * @brief create a consistent hash ring with n servers
  *
  * @param n_server
- * @param weight null if all servers have the same weight
+ * @param weight null if all servers have the same weight, otherwise the
+ * normalized weights (sum to 1)
  * @return ring_t*
  */
 ring_t *ch_ring_create_ring(int n_server, double *weight);
@@ -44,14 +48,13 @@ ring_t *ch_ring_create_ring(int n_server, double *weight);
  *
  * @param key
  * @param ring
- * @return vnode_t*
+ * @return int
  */
-// vnode_t *ch_ring_get_server(const char *const key, const ring_t *const ring);
-
 int ch_ring_get_server(const char *const key, const ring_t *const ring);
 
 /**
- * @brief retrieve the server id from the consistent hash ring
+ * @brief retrieve the server id from the consistent hash ring, the key is
+ * the 64-bit hash value of the object id
  *
  * @param obj_id
  * @param ring
@@ -85,6 +88,23 @@ void ch_ring_get_available_servers(const char *const key,
                                    const unsigned int n, unsigned int *idxs,
                                    const char *server_unavailability);
 
+/**
+ * @brief retrieve up to n consecutive available server ids of an object
+ * from the consistent hash ring, the first one is the primary server
+ *
+ * @param obj_id
+ * @param ring
+ * @param n
+ * @param idxs
+ * @param server_available server_available[i] is whether server i is
+ * available
+ * @return the number of servers found, which is less than n if there are
+ * fewer than n available servers
+ */
+unsigned int ch_ring_get_available_servers_from_uint64(
+    uint64_t obj_id, const ring_t *const ring, const unsigned int n,
+    unsigned int *idxs, const bool *server_available);
+
 /**
  * @brief destroy consistent hash ring
  *
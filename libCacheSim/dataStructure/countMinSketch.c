@@ -0,0 +1,211 @@
+/*
+ * Refer to countMinSketch.h for documentation on the public interfaces.
+ */
+
+#include "countMinSketch.h"
+
+#include "../include/libCacheSim/logging.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CMS_HAS_AVX2_PATH
+#endif
+
+/* keeps the lower 3 bits of each 4-bit counter after a word is shifted right
+ * by one, so that a counter does not get the lowest bit of its neighbor */
+#define CMS_HALVE_MASK 0x7777777777777777ULL
+
+/* the lower bits of hv choose the block, the upper 32 bits choose the counters,
+ * counter i is in word 2 * i or 2 * i + 1 of the block */
+static inline void cms_locate(const count_min_sketch_t *cms, uint64_t hv,
+                              int64_t word_idx[4], int64_t shift[4]) {
+  int64_t block = (int64_t)(hv & cms->block_mask) * CMS_BLOCK_N_WORD;
+  uint32_t h = (uint32_t)(hv >> 32);
+  for (int i = 0; i < 4; i++) {
+    uint32_t b = h >> (i * 8);
+    word_idx[i] = block + 2 * i + (b & 1);
+    shift[i] = (int64_t)(((b >> 1) & 15) << 2);
+  }
+}
+
+/**************** scalar path ****************/
+static int cms_estimate_scalar(const uint64_t *table, const int64_t word_idx[4],
+                               const int64_t shift[4]) {
+  int min_cnt = CMS_COUNTER_MAX;
+  for (int i = 0; i < 4; i++) {
+    int cnt = (int)((table[word_idx[i]] >> shift[i]) & 0xf);
+    if (cnt < min_cnt) min_cnt = cnt;
+  }
+  return min_cnt;
+}
+
+static int cms_add_scalar(uint64_t *table, const int64_t word_idx[4],
+                          const int64_t shift[4]) {
+  int cnt[4];
+  int min_cnt = CMS_COUNTER_MAX;
+  for (int i = 0; i < 4; i++) {
+    cnt[i] = (int)((table[word_idx[i]] >> shift[i]) & 0xf);
+    if (cnt[i] < min_cnt) min_cnt = cnt[i];
+  }
+  if (min_cnt == CMS_COUNTER_MAX) return min_cnt;
+
+  for (int i = 0; i < 4; i++) {
+    if (cnt[i] == min_cnt) table[word_idx[i]] += 1ULL << shift[i];
+  }
+  return min_cnt + 1;
+}
+
+/**************** AVX2 path ****************/
+#ifdef CMS_HAS_AVX2_PATH
+__attribute__((target("avx2"))) static inline __m256i cms_counters_avx2(
+    const uint64_t *table, __m256i vidx, __m256i vshift, __m256i *words) {
+  *words = _mm256_i64gather_epi64((const long long *)table, vidx, 8);
+  return _mm256_and_si256(_mm256_srlv_epi64(*words, vshift),
+                          _mm256_set1_epi64x(0xf));
+}
+
+/* the minimum of the four 64-bit lanes, each less than 16 */
+__attribute__((target("avx2"))) static inline int cms_min_avx2(__m256i cnt) {
+  __m256i m = _mm256_min_epu32(
+      cnt, _mm256_permute4x64_epi64(cnt, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm256_min_epu32(m,
+                       _mm256_permute4x64_epi64(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm256_cvtsi256_si32(m);
+}
+
+__attribute__((target("avx2"))) static int cms_estimate_avx2(
+    const uint64_t *table, const int64_t word_idx[4], const int64_t shift[4]) {
+  __m256i words;
+  __m256i cnt = cms_counters_avx2(
+      table, _mm256_loadu_si256((const __m256i *)word_idx),
+      _mm256_loadu_si256((const __m256i *)shift), &words);
+  return cms_min_avx2(cnt);
+}
+
+__attribute__((target("avx2"))) static int cms_add_avx2(
+    uint64_t *table, const int64_t word_idx[4], const int64_t shift[4]) {
+  __m256i words;
+  __m256i vshift = _mm256_loadu_si256((const __m256i *)shift);
+  __m256i cnt = cms_counters_avx2(
+      table, _mm256_loadu_si256((const __m256i *)word_idx), vshift, &words);
+  int min_cnt = cms_min_avx2(cnt);
+  if (min_cnt == CMS_COUNTER_MAX) return min_cnt;
+
+  /* add 1 to the counters equal to the minimum */
+  __m256i is_min = _mm256_cmpeq_epi64(cnt, _mm256_set1_epi64x(min_cnt));
+  __m256i inc =
+      _mm256_and_si256(is_min, _mm256_sllv_epi64(_mm256_set1_epi64x(1), vshift));
+  uint64_t new_words[4];
+  _mm256_storeu_si256((__m256i *)new_words, _mm256_add_epi64(words, inc));
+
+  /* the four words are different */
+  for (int i = 0; i < 4; i++) table[word_idx[i]] = new_words[i];
+  return min_cnt + 1;
+}
+#endif
+
+/**************** aging ****************/
+static inline void cms_age_one_block(count_min_sketch_t *cms) {
+  uint64_t *block = cms->table + cms->age_cursor * CMS_BLOCK_N_WORD;
+  for (int i = 0; i < CMS_BLOCK_N_WORD; i++) {
+    block[i] = (block[i] >> 1) & CMS_HALVE_MASK;
+  }
+  cms->age_cursor = (cms->age_cursor + 1) & (int64_t)cms->block_mask;
+}
+
+/**************** public interface ****************/
+static void cms_alloc_table(count_min_sketch_t *cms, int64_t n_obj) {
+  /* one word (16 counters) per object, at least one block */
+  int64_t n_word = CMS_BLOCK_N_WORD;
+  while (n_word < n_obj) n_word *= 2;
+
+  cms->n_obj = n_obj;
+  cms->n_block = n_word / CMS_BLOCK_N_WORD;
+  cms->block_mask = (uint64_t)cms->n_block - 1;
+  if (posix_memalign((void **)&cms->table, 64, n_word * sizeof(uint64_t)) !=
+      0) {
+    ERROR("count-min sketch at %p failed to allocate %lld words\n",
+          (void *)cms, (long long)n_word);
+  }
+  memset(cms->table, 0, n_word * sizeof(uint64_t));
+
+  cms->n_add_per_block_age = cms->sample_size / cms->n_block;
+  if (cms->n_add_per_block_age < 1) cms->n_add_per_block_age = 1;
+  cms->n_add_since_block_age = 0;
+  cms->age_cursor = 0;
+}
+
+count_min_sketch_t *create_count_min_sketch(int64_t n_obj,
+                                            int64_t sample_size) {
+  count_min_sketch_t *cms =
+      (count_min_sketch_t *)malloc(sizeof(count_min_sketch_t));
+  memset(cms, 0, sizeof(count_min_sketch_t));
+  if (n_obj < 1) n_obj = 1;
+  cms->sample_size = sample_size > 0 ? sample_size : 10 * n_obj;
+  cms_alloc_table(cms, n_obj);
+
+#ifdef CMS_HAS_AVX2_PATH
+  cms->use_simd = __builtin_cpu_supports("avx2");
+#endif
+
+  return cms;
+}
+
+void free_count_min_sketch(count_min_sketch_t *cms) {
+  free(cms->table);
+  free(cms);
+}
+
+int count_min_sketch_estimate(const count_min_sketch_t *cms, uint64_t hv) {
+  int64_t word_idx[4], shift[4];
+  cms_locate(cms, hv, word_idx, shift);
+#ifdef CMS_HAS_AVX2_PATH
+  if (cms->use_simd) return cms_estimate_avx2(cms->table, word_idx, shift);
+#endif
+  return cms_estimate_scalar(cms->table, word_idx, shift);
+}
+
+int count_min_sketch_add(count_min_sketch_t *cms, uint64_t hv) {
+  int64_t word_idx[4], shift[4];
+  cms_locate(cms, hv, word_idx, shift);
+
+  int cnt;
+#ifdef CMS_HAS_AVX2_PATH
+  if (cms->use_simd) {
+    cnt = cms_add_avx2(cms->table, word_idx, shift);
+  } else {
+    cnt = cms_add_scalar(cms->table, word_idx, shift);
+  }
+#else
+  cnt = cms_add_scalar(cms->table, word_idx, shift);
+#endif
+
+  if (++cms->n_add_since_block_age >= cms->n_add_per_block_age) {
+    cms->n_add_since_block_age = 0;
+    cms_age_one_block(cms);
+  }
+
+  return cnt;
+}
+
+bool count_min_sketch_ensure_capacity(count_min_sketch_t *cms, int64_t n_obj) {
+  if (n_obj <= cms->n_block * CMS_BLOCK_N_WORD) {
+    return false;
+  }
+
+  /* keep the sample size proportional to the number of objects */
+  cms->sample_size = cms->sample_size / cms->n_obj * n_obj;
+  free(cms->table);
+  cms_alloc_table(cms, n_obj);
+  return true;
+}
+
+void count_min_sketch_reset(count_min_sketch_t *cms) {
+  memset(cms->table, 0, cms->n_block * CMS_BLOCK_N_WORD * sizeof(uint64_t));
+  cms->n_add_since_block_age = 0;
+  cms->age_cursor = 0;
+}
@@ -0,0 +1,84 @@
+#ifndef _COUNT_MIN_SKETCH_H
+#define _COUNT_MIN_SKETCH_H
+
+/**
+ * a Count-Min sketch of 4-bit counters used to estimate the frequency of
+ * objects (e.g., in TinyLFU), the table is divided into 64-byte blocks, and
+ * the 4 counters of an object are in one block (one counter in each pair of
+ * 64-bit words), so an update or a query touches one cache line, the 4
+ * counters are read and updated using AVX2 if the CPU supports it
+ *
+ * counters saturate at 15, and are halved to age the frequency, instead of
+ * halving the whole table every sample_size additions, one block is halved
+ * every sample_size / n_block additions, so that the cost is spread over the
+ * requests
+ *
+ * the caller computes the 64-bit hash of the object (e.g., req->hv) once
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMS_COUNTER_MAX 15
+/* each block has 8 words of 16 4-bit counters */
+#define CMS_BLOCK_N_WORD 8
+
+typedef struct count_min_sketch {
+  uint64_t *table;
+  int64_t n_block;
+  uint64_t block_mask;
+  /* the number of objects the sketch is sized for */
+  int64_t n_obj;
+
+  /* all counters are halved once every sample_size additions */
+  int64_t sample_size;
+  int64_t n_add_per_block_age;
+  int64_t n_add_since_block_age;
+  int64_t age_cursor;
+
+  /* read and update the counters using AVX2 */
+  bool use_simd;
+} count_min_sketch_t;
+
+/**
+ * @brief create a sketch for n_obj objects (16 counters per object), the
+ * counters are halved every sample_size additions, 0 uses 10 * n_obj
+ */
+count_min_sketch_t *create_count_min_sketch(int64_t n_obj,
+                                            int64_t sample_size);
+
+void free_count_min_sketch(count_min_sketch_t *cms);
+
+/* the estimated frequency of the object with hash value hv */
+int count_min_sketch_estimate(const count_min_sketch_t *cms, uint64_t hv);
+
+/* increase the counters of the object with the smallest count (conservative
+ * update) and return the new estimate */
+int count_min_sketch_add(count_min_sketch_t *cms, uint64_t hv);
+
+/**
+ * @brief grow the sketch if it is sized for fewer than n_obj objects, the
+ * counters are reset when the sketch grows
+ *
+ * @return true if the sketch is resized
+ */
+bool count_min_sketch_ensure_capacity(count_min_sketch_t *cms, int64_t n_obj);
+
+void count_min_sketch_reset(count_min_sketch_t *cms);
+
+/* the bytes used by the sketch */
+static inline int64_t count_min_sketch_get_metadata_bytes(
+    const count_min_sketch_t *cms) {
+  return (int64_t)sizeof(count_min_sketch_t) +
+         cms->n_block * CMS_BLOCK_N_WORD * (int64_t)sizeof(uint64_t);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,6 +30,7 @@ extern "C" {
 #include <string.h>
 #include <sys/mman.h>
 
+#include "../../include/libCacheSim/const.h"
 #include "../../include/libCacheSim/logging.h"
 #include "../../include/libCacheSim/macro.h"
 #include "../../utils/include/mymath.h"
@@ -78,10 +79,58 @@ static inline void add_to_bucket(hashtable_t *hashtable,
 #endif
 }
 
-/* free object, called by other functions when iterating through the hashtable
- */
-static inline void foreach_free_obj(cache_obj_t *cache_obj, void *user_data) {
-  my_free(sizeof(cache_obj_t), cache_obj);
+/************************ object pool ************************/
+/* the objects are carved from chunks that grow from OBJ_CHUNK_MIN_SIZE to
+ * OBJ_CHUNK_MAX_SIZE, so a small cache (e.g., a ghost list) does not pay for
+ * a large chunk, each chunk starts with the pointer to the previous chunk */
+#define OBJ_CHUNK_MIN_SIZE (4 * KiB)
+#define OBJ_CHUNK_MAX_SIZE (2 * MiB)
+#define OBJ_CHUNK_HEADER_SIZE sizeof(void *)
+
+static void _add_obj_chunk(hashtable_t *hashtable) {
+  size_t chunk_size = hashtable->next_chunk_size;
+  char *chunk = (char *)malloc(chunk_size);
+  ASSERT_NOT_NULL(chunk, "allocate %zu B object chunk failed\n", chunk_size);
+  *(void **)chunk = hashtable->obj_chunks;
+  hashtable->obj_chunks = chunk;
+  hashtable->chunk_pos = chunk + OBJ_CHUNK_HEADER_SIZE;
+  hashtable->chunk_end = chunk + chunk_size;
+  if (hashtable->next_chunk_size < OBJ_CHUNK_MAX_SIZE) {
+    hashtable->next_chunk_size *= 2;
+  }
+}
+
+static inline cache_obj_t *_alloc_obj(hashtable_t *hashtable) {
+  cache_obj_t *cache_obj = hashtable->free_objs;
+  if (cache_obj != NULL) {
+    hashtable->free_objs = cache_obj->hash_next;
+  } else {
+    if (hashtable->chunk_pos + hashtable->obj_struct_size >
+        hashtable->chunk_end) {
+      _add_obj_chunk(hashtable);
+    }
+    cache_obj = (cache_obj_t *)hashtable->chunk_pos;
+    hashtable->chunk_pos += hashtable->obj_struct_size;
+  }
+  memset(cache_obj, 0, hashtable->obj_struct_size);
+  return cache_obj;
+}
+
+static inline void _free_obj(hashtable_t *hashtable, cache_obj_t *cache_obj) {
+  cache_obj->hash_next = hashtable->free_objs;
+  hashtable->free_objs = cache_obj;
+}
+
+static void _free_obj_chunks(hashtable_t *hashtable) {
+  void *chunk = hashtable->obj_chunks;
+  while (chunk != NULL) {
+    void *prev_chunk = *(void **)chunk;
+    free(chunk);
+    chunk = prev_chunk;
+  }
+  hashtable->obj_chunks = NULL;
+  hashtable->free_objs = NULL;
+  hashtable->chunk_pos = hashtable->chunk_end = NULL;
 }
 
 /************************ hashtable func ************************/
@@ -105,9 +154,24 @@ hashtable_t *create_chained_hashtable_v2(const uint16_t hashpower) {
   hashtable->external_obj = false;
   hashtable->hashpower = hashpower;
   hashtable->n_obj = 0;
+  hashtable->obj_struct_size = sizeof(cache_obj_t);
+  hashtable->next_chunk_size = OBJ_CHUNK_MIN_SIZE;
   return hashtable;
 }
 
+void chained_hashtable_set_obj_struct_size_v2(hashtable_t *hashtable,
+                                              size_t obj_struct_size) {
+  DEBUG_ASSERT(hashtable->n_obj == 0);
+  DEBUG_ASSERT(obj_struct_size <= sizeof(cache_obj_t));
+  /* keep the objects 8-byte aligned */
+  obj_struct_size = (obj_struct_size + 7) & ~(size_t)7;
+  if (obj_struct_size != hashtable->obj_struct_size) {
+    /* the carved objects have the old size */
+    _free_obj_chunks(hashtable);
+    hashtable->obj_struct_size = (uint32_t)obj_struct_size;
+  }
+}
+
 cache_obj_t *chained_hashtable_find_obj_id_v2(const hashtable_t *hashtable,
                                               const obj_id_t obj_id) {
   cache_obj_t *cache_obj = NULL;
@@ -142,7 +206,8 @@ cache_obj_t *chained_hashtable_insert_v2(hashtable_t *hashtable,
     _chained_hashtable_expand_v2(hashtable);
   }
 
-  cache_obj_t *new_cache_obj = create_cache_obj_from_request(req);
+  cache_obj_t *new_cache_obj = _alloc_obj(hashtable);
+  copy_request_to_cache_obj(new_cache_obj, req);
   add_to_bucket(hashtable, new_cache_obj);
   hashtable->n_obj += 1;
   return new_cache_obj;
@@ -169,7 +234,7 @@ void chained_hashtable_delete_v2(hashtable_t *hashtable,
                 hashmask(hashtable->hashpower);
   if (hashtable->ptr_table[hv] == cache_obj) {
     hashtable->ptr_table[hv] = cache_obj->hash_next;
-    if (!hashtable->external_obj) free_cache_obj(cache_obj);
+    if (!hashtable->external_obj) _free_obj(hashtable, cache_obj);
     return;
   }
 
@@ -195,7 +260,7 @@ void chained_hashtable_delete_v2(hashtable_t *hashtable,
   DEBUG_ASSERT(cur_obj != NULL);
   cur_obj->hash_next = cache_obj->hash_next;
   if (!hashtable->external_obj) {
-    free_cache_obj(cache_obj);
+    _free_obj(hashtable, cache_obj);
   }
 }
 
@@ -208,7 +273,7 @@ bool chained_hashtable_try_delete_v2(hashtable_t *hashtable,
   if (hashtable->ptr_table[hv] == cache_obj) {
     hashtable->ptr_table[hv] = cache_obj->hash_next;
     hashtable->n_obj -= 1;
-    if (!hashtable->external_obj) free_cache_obj(cache_obj);
+    if (!hashtable->external_obj) _free_obj(hashtable, cache_obj);
     return true;
   }
 
@@ -241,7 +306,7 @@ bool chained_hashtable_try_delete_v2(hashtable_t *hashtable,
   if (cur_obj != NULL) {
     cur_obj->hash_next = cache_obj->hash_next;
     hashtable->n_obj -= 1;
-    if (!hashtable->external_obj) free_cache_obj(cache_obj);
+    if (!hashtable->external_obj) _free_obj(hashtable, cache_obj);
     return true;
   }
   return false;
@@ -271,7 +336,7 @@ bool chained_hashtable_delete_obj_id_v2(hashtable_t *hashtable,
   // the object to remove is the first object in the hash bucket
   if (cur_obj->obj_id == obj_id) {
     hashtable->ptr_table[hv] = cur_obj->hash_next;
-    if (!hashtable->external_obj) free_cache_obj(cur_obj);
+    if (!hashtable->external_obj) _free_obj(hashtable, cur_obj);
     hashtable->n_obj -= 1;
     return true;
   }
@@ -286,7 +351,7 @@ bool chained_hashtable_delete_obj_id_v2(hashtable_t *hashtable,
   // the object to remove is in the hash bucket
   if (cur_obj != NULL) {
     prev_obj->hash_next = cur_obj->hash_next;
-    if (!hashtable->external_obj) free_cache_obj(cur_obj);
+    if (!hashtable->external_obj) _free_obj(hashtable, cur_obj);
     hashtable->n_obj -= 1;
     return true;
   }
@@ -315,8 +380,7 @@ void chained_hashtable_foreach_v2(hashtable_t *hashtable,
 }
 
 void free_chained_hashtable_v2(hashtable_t *hashtable) {
-  if (!hashtable->external_obj)
-    chained_hashtable_foreach_v2(hashtable, foreach_free_obj, NULL);
+  _free_obj_chunks(hashtable);
   my_free(sizeof(cache_obj_t *) * hashsize(hashtable->hashpower),
           hashtable->ptr_table);
   my_free(sizeof(hashtable_t), hashtable);
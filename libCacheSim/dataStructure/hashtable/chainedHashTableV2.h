@@ -42,6 +42,10 @@ void chained_hashtable_delete_v2(hashtable_t *hashtable,
 
 cache_obj_t *chained_hashtable_rand_obj_v2(const hashtable_t *hashtable);
 
+/* set the bytes allocated for each object, the hash table must be empty */
+void chained_hashtable_set_obj_struct_size_v2(hashtable_t *hashtable,
+                                              size_t obj_struct_size);
+
 void chained_hashtable_foreach_v2(hashtable_t *hashtable,
                                   hashtable_iter iter_func, void *user_data);
 
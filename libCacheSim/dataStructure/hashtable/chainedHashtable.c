@@ -107,6 +107,7 @@ hashtable_t *create_chained_hashtable(const uint16_t hash_power) {
   hashtable->hashpower = hash_power;
   hashtable->n_obj = 0;
   hashtable->external_obj = false;
+  hashtable->obj_struct_size = sizeof(cache_obj_t);
   return hashtable;
 }
 
@@ -34,6 +34,8 @@ extern "C" {
 #define free_hashtable(hashtable) free_chained_hashtable(hashtable)
 #define hashtable_add_ptr_to_monitoring(hashtable, ptr) \
   chained_hashtable_add_ptr_to_monitoring(hashtable, ptr)
+/* the objects are stored in the table, so they are always full size */
+#define hashtable_set_obj_struct_size(hashtable, size)
 #define HASHTABLE_VER 1
 
 #elif HASHTABLE_TYPE == CHAINED_HASHTABLEV2
@@ -59,6 +61,8 @@ extern "C" {
   chained_hashtable_foreach_v2(hashtable, iter_func, user_data)
 #define free_hashtable(hashtable) free_chained_hashtable_v2(hashtable)
 #define hashtable_add_ptr_to_monitoring(hashtable, ptr)
+#define hashtable_set_obj_struct_size(hashtable, size) \
+  chained_hashtable_set_obj_struct_size_v2(hashtable, size)
 #define HASHTABLE_VER 2
 
 #elif HASHTABLE_TYPE == CUCKCOO_HASHTABLE
@@ -68,6 +72,26 @@ extern "C" {
 #error not implemented
 #endif
 
+/**
+ * @brief the bytes used by the hash table, the bucket array and the objects,
+ * the objects of hashtable V1 are counted as if they are all chained, so
+ * this is an upper bound for V1
+ *
+ * @param hashtable
+ * @return int64_t
+ */
+static inline int64_t hashtable_get_metadata_bytes(
+    const hashtable_t *hashtable) {
+#if HASHTABLE_VER == 1
+  int64_t bucket_size = (int64_t)sizeof(cache_obj_t);
+#else
+  int64_t bucket_size = (int64_t)sizeof(cache_obj_t *);
+#endif
+  return (int64_t)sizeof(hashtable_t) +
+         (int64_t)hashsize(hashtable->hashpower) * bucket_size +
+         (int64_t)hashtable->n_obj * (int64_t)hashtable->obj_struct_size;
+}
+
 static inline void _print_hashtable_elememnt(cache_obj_t *cache_obj,
                                              void *newline) {
   static const char *SEPARATORS[] = {", ", "\n"};
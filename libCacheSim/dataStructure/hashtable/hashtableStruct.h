@@ -29,6 +29,15 @@ typedef struct hashtable {
   uint16_t hashpower;
   bool external_obj; /* whether the object should be allocated by hash table,
                         this should be true most of the time */
+  /* the bytes allocated for each object (hashtable V2), objects are carved
+   * from chunks owned by the hash table, and the deleted objects are linked
+   * by hash_next in free_objs to be reused */
+  uint32_t obj_struct_size;
+  cache_obj_t *free_objs;
+  void *obj_chunks;
+  char *chunk_pos;
+  char *chunk_end;
+  size_t next_chunk_size;
   union {
     // used for hashtable V1, these cache_obj pointers are used by external
     // modules, so if hashtable needs to move the obj, their pointer need to be
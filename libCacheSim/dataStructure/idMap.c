@@ -0,0 +1,164 @@
+/*
+ * Refer to idMap.h for documentation on the public interfaces.
+ */
+
+#include "idMap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+
+#define ID_MAP_MIN_N_BUCKET 16
+
+/* the finalizer of splitmix64, object ids are often sequential (e.g., block
+ * numbers), so the bits need to be mixed before masking */
+static inline uint64_t id_map_hash(obj_id_t key) {
+  uint64_t x = (uint64_t)key;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+static id_map_entry_t *alloc_entries(int64_t n_bucket) {
+  id_map_entry_t *entries = calloc(n_bucket, sizeof(id_map_entry_t));
+  if (entries == NULL) {
+    ERROR("failed to allocate id map with %ld buckets\n", (long)n_bucket);
+  }
+  return entries;
+}
+
+/* the key is not 0 and not in the map, and the map has an empty bucket */
+static inline void insert_new(id_map_t *map, obj_id_t key, int64_t value) {
+  uint64_t pos = id_map_hash(key) & map->mask;
+  while (map->entries[pos].key != 0) {
+    pos = (pos + 1) & map->mask;
+  }
+  map->entries[pos].key = key;
+  map->entries[pos].value = value;
+}
+
+static void resize(id_map_t *map, int64_t n_bucket) {
+  id_map_entry_t *old_entries = map->entries;
+  int64_t old_n_bucket = map->n_bucket;
+
+  map->entries = alloc_entries(n_bucket);
+  map->n_bucket = n_bucket;
+  map->mask = (uint64_t)n_bucket - 1;
+  for (int64_t i = 0; i < old_n_bucket; i++) {
+    if (old_entries[i].key != 0) {
+      insert_new(map, old_entries[i].key, old_entries[i].value);
+    }
+  }
+  free(old_entries);
+}
+
+id_map_t *create_id_map(int64_t n_entry) {
+  int64_t n_bucket = ID_MAP_MIN_N_BUCKET;
+  while (n_bucket * 3 / 4 < n_entry) n_bucket *= 2;
+
+  id_map_t *map = my_malloc(id_map_t);
+  memset(map, 0, sizeof(id_map_t));
+  map->entries = alloc_entries(n_bucket);
+  map->n_bucket = n_bucket;
+  map->mask = (uint64_t)n_bucket - 1;
+  return map;
+}
+
+void free_id_map(id_map_t *map) {
+  free(map->entries);
+  my_free(sizeof(id_map_t), map);
+}
+
+/* return the bucket of key, or -1 if the key is not in the map */
+static inline int64_t find_pos(const id_map_t *map, obj_id_t key) {
+  uint64_t pos = id_map_hash(key) & map->mask;
+  while (map->entries[pos].key != 0) {
+    if (map->entries[pos].key == key) return (int64_t)pos;
+    pos = (pos + 1) & map->mask;
+  }
+  return -1;
+}
+
+bool id_map_find(const id_map_t *map, obj_id_t key, int64_t *value) {
+  if (key == 0) {
+    if (map->has_zero_key && value != NULL) *value = map->zero_key_value;
+    return map->has_zero_key;
+  }
+
+  int64_t pos = find_pos(map, key);
+  if (pos < 0) return false;
+  if (value != NULL) *value = map->entries[pos].value;
+  return true;
+}
+
+int64_t id_map_get(const id_map_t *map, obj_id_t key) {
+  int64_t value = 0;
+  id_map_find(map, key, &value);
+  return value;
+}
+
+void id_map_put(id_map_t *map, obj_id_t key, int64_t value) {
+  if (key == 0) {
+    if (!map->has_zero_key) map->n_entry += 1;
+    map->has_zero_key = true;
+    map->zero_key_value = value;
+    return;
+  }
+
+  uint64_t pos = id_map_hash(key) & map->mask;
+  while (map->entries[pos].key != 0) {
+    if (map->entries[pos].key == key) {
+      map->entries[pos].value = value;
+      return;
+    }
+    pos = (pos + 1) & map->mask;
+  }
+
+  if ((map->n_entry + 1) * 4 > map->n_bucket * 3) {
+    resize(map, map->n_bucket * 2);
+    insert_new(map, key, value);
+  } else {
+    map->entries[pos].key = key;
+    map->entries[pos].value = value;
+  }
+  map->n_entry += 1;
+}
+
+bool id_map_remove(id_map_t *map, obj_id_t key) {
+  if (key == 0) {
+    if (!map->has_zero_key) return false;
+    map->has_zero_key = false;
+    map->n_entry -= 1;
+    return true;
+  }
+
+  int64_t found = find_pos(map, key);
+  if (found < 0) return false;
+
+  /* shift the following entries of the probe sequence backward, an entry can
+   * move to the hole if its home bucket is not in (hole, pos] */
+  uint64_t hole = (uint64_t)found;
+  uint64_t pos = hole;
+  while (true) {
+    pos = (pos + 1) & map->mask;
+    if (map->entries[pos].key == 0) break;
+    uint64_t home = id_map_hash(map->entries[pos].key) & map->mask;
+    if (((pos - home) & map->mask) >= ((pos - hole) & map->mask)) {
+      map->entries[hole] = map->entries[pos];
+      hole = pos;
+    }
+  }
+  map->entries[hole].key = 0;
+  map->entries[hole].value = 0;
+  map->n_entry -= 1;
+  return true;
+}
+
+void id_map_clear(id_map_t *map) {
+  memset(map->entries, 0, sizeof(id_map_entry_t) * map->n_bucket);
+  map->n_entry = 0;
+  map->has_zero_key = false;
+  map->zero_key_value = 0;
+}
@@ -0,0 +1,81 @@
+#ifndef _ID_MAP_H
+#define _ID_MAP_H
+
+/**
+ * an open-addressing hash map from 64-bit object ids to 64-bit values, it is
+ * used to replace glib hash tables keyed by GINT_TO_POINTER(obj_id), which
+ * truncate the id and allocate a node for each entry
+ *
+ * the entries (key and value) are stored in one flat array with linear
+ * probing, and removal shifts the following entries backward, so there is no
+ * tombstone, the array doubles when the load factor reaches 0.75, key 0 marks
+ * an empty bucket, so the entry of object 0 is stored separately
+ *
+ * the map does not distinguish a value of 0 from a missing entry in
+ * id_map_get, use id_map_find if 0 is a valid value
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  obj_id_t key;
+  int64_t value;
+} id_map_entry_t;
+
+typedef struct id_map {
+  id_map_entry_t *entries;
+  uint64_t mask;
+  int64_t n_bucket;
+  int64_t n_entry;
+
+  /* the entry of obj_id 0 */
+  bool has_zero_key;
+  int64_t zero_key_value;
+} id_map_t;
+
+/**
+ * @brief create a map that holds n_entry entries without resizing
+ */
+id_map_t *create_id_map(int64_t n_entry);
+
+void free_id_map(id_map_t *map);
+
+/* return whether the key is in the map, and store its value in *value */
+bool id_map_find(const id_map_t *map, obj_id_t key, int64_t *value);
+
+/* return the value of key, or 0 if the key is not in the map */
+int64_t id_map_get(const id_map_t *map, obj_id_t key);
+
+static inline bool id_map_contains(const id_map_t *map, obj_id_t key) {
+  return id_map_find(map, key, NULL);
+}
+
+/* insert the key or replace its value */
+void id_map_put(id_map_t *map, obj_id_t key, int64_t value);
+
+/* return whether the key was in the map */
+bool id_map_remove(id_map_t *map, obj_id_t key);
+
+void id_map_clear(id_map_t *map);
+
+static inline int64_t id_map_size(const id_map_t *map) {
+  return map->n_entry;
+}
+
+static inline int64_t id_map_get_metadata_bytes(const id_map_t *map) {
+  return (int64_t)sizeof(id_map_t) +
+         map->n_bucket * (int64_t)sizeof(id_map_entry_t);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
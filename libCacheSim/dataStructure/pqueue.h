@@ -118,6 +118,18 @@ void pqueue_free(pqueue_t *q);
  */
 size_t pqueue_size(pqueue_t *q);
 
+/**
+ * return the bytes used by the queue, the slots and the items.
+ * @param q the queue
+ * @param node_size the bytes of each item
+ */
+static inline int64_t pqueue_get_metadata_bytes(const pqueue_t *q,
+                                                size_t node_size) {
+  /* the first slot is not used */
+  return (int64_t)sizeof(pqueue_t) + (int64_t)(q->avail * sizeof(void *)) +
+         (int64_t)((q->size - 1) * node_size);
+}
+
 /**
  * insert an item into the queue.
  * @param q the queue
@@ -0,0 +1,43 @@
+/*
+ * Refer to spscQueue.h for documentation on the public interfaces.
+ */
+
+#include "spscQueue.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+
+spsc_queue_t *create_spsc_queue(int64_t capacity, size_t item_size) {
+  int64_t n_slot = 2;
+  while (n_slot < capacity) n_slot *= 2;
+  if (n_slot > (1L << 30)) {
+    ERROR("spsc queue capacity %ld is too large\n", (long)capacity);
+  }
+
+  spsc_queue_t *queue = NULL;
+  if (posix_memalign((void **)&queue, 64, sizeof(spsc_queue_t)) != 0) {
+    ERROR("failed to allocate spsc queue\n");
+  }
+  memset(queue, 0, sizeof(spsc_queue_t));
+  queue->mask = (gint)(n_slot - 1);
+  queue->item_size = item_size;
+  queue->items = malloc((size_t)n_slot * item_size);
+  if (queue->items == NULL) {
+    ERROR("failed to allocate spsc queue with %ld items\n", (long)n_slot);
+  }
+  return queue;
+}
+
+void free_spsc_queue(spsc_queue_t *queue) {
+  free(queue->items);
+  free(queue);
+}
+
+void spsc_queue_push(spsc_queue_t *queue, const void *item) {
+  while (!spsc_queue_try_push(queue, item)) {
+    sched_yield();
+  }
+}
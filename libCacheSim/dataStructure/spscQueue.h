@@ -0,0 +1,93 @@
+#ifndef _SPSC_QUEUE_H
+#define _SPSC_QUEUE_H
+
+/**
+ * a bounded single-producer single-consumer queue of fixed-size items, it is
+ * used to pass requests between the simulation threads without locks
+ *
+ * the items are copied into a ring buffer, the producer owns the tail and the
+ * consumer owns the head, the two indexes are on different cache lines so
+ * that the two threads do not invalidate each other's line on every item,
+ * the queue is full when the tail is right before the head
+ *
+ * the producer closes the queue after the last item, the consumer sees the
+ * queue as finished when it is closed and empty
+ */
+
+#include <glib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct spsc_queue {
+  gint tail;
+  char pad0[64 - sizeof(gint)];
+  gint head;
+  char pad1[64 - sizeof(gint)];
+  gint closed;
+  gint mask;
+  size_t item_size;
+  char *items;
+} spsc_queue_t;
+
+/**
+ * @brief create a queue that holds up to capacity - 1 items
+ *
+ * @param capacity rounded up to a power of 2
+ * @param item_size
+ */
+spsc_queue_t *create_spsc_queue(int64_t capacity, size_t item_size);
+
+void free_spsc_queue(spsc_queue_t *queue);
+
+/* called by the producer, return false if the queue is full */
+static inline bool spsc_queue_try_push(spsc_queue_t *queue, const void *item) {
+  gint tail = queue->tail;
+  gint next = (tail + 1) & queue->mask;
+  if (g_atomic_int_get(&queue->head) == next) return false;
+  memcpy(queue->items + (size_t)tail * queue->item_size, item,
+         queue->item_size);
+  g_atomic_int_set(&queue->tail, next);
+  return true;
+}
+
+/* called by the producer, yield until there is space in the queue */
+void spsc_queue_push(spsc_queue_t *queue, const void *item);
+
+/* called by the consumer, return the first item or NULL if the queue is
+ * empty, the item stays valid until spsc_queue_pop */
+static inline void *spsc_queue_peek(spsc_queue_t *queue) {
+  gint head = queue->head;
+  if (g_atomic_int_get(&queue->tail) == head) return NULL;
+  return queue->items + (size_t)head * queue->item_size;
+}
+
+/* called by the consumer after spsc_queue_peek returns an item */
+static inline void spsc_queue_pop(spsc_queue_t *queue) {
+  g_atomic_int_set(&queue->head, (queue->head + 1) & queue->mask);
+}
+
+/* called by the producer after the last push */
+static inline void spsc_queue_close(spsc_queue_t *queue) {
+  g_atomic_int_set(&queue->closed, 1);
+}
+
+/* called by the consumer, true if the queue is closed and all items are
+ * consumed */
+static inline bool spsc_queue_is_finished(spsc_queue_t *queue) {
+  /* read closed before checking emptiness, the items pushed before close are
+   * visible once closed is */
+  if (!g_atomic_int_get(&queue->closed)) return false;
+  return spsc_queue_peek(queue) == NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * Refer to timerWheel.h for documentation on the public interfaces.
+ */
+
+#include "timerWheel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_N_SLOT - 1)
+#define TIMER_WHEEL_INIT_SLOT_CAPACITY 8
+
+/* the time units covered by one slot in the level */
+static inline int64_t level_span(int level) {
+  return 1LL << (TIMER_WHEEL_SLOT_BITS * level);
+}
+
+static void slot_append(timer_wheel_slot_t *slot, obj_id_t obj_id,
+                        uint32_t exp_time) {
+  if (slot->n_entry == slot->capacity) {
+    int32_t new_capacity = slot->capacity == 0 ? TIMER_WHEEL_INIT_SLOT_CAPACITY
+                                               : slot->capacity * 2;
+    timer_wheel_entry_t *entries =
+        realloc(slot->entries, sizeof(timer_wheel_entry_t) * new_capacity);
+    if (entries == NULL) {
+      ERROR("failed to grow timer wheel slot to %d entries\n", new_capacity);
+    }
+    slot->entries = entries;
+    slot->capacity = new_capacity;
+  }
+  slot->entries[slot->n_entry].obj_id = obj_id;
+  slot->entries[slot->n_entry].exp_time = exp_time;
+  slot->n_entry += 1;
+}
+
+static inline void append_entry(timer_wheel_t *tw, int level, int64_t slot_idx,
+                                obj_id_t obj_id, uint32_t exp_time) {
+  slot_append(&tw->slots[level][slot_idx], obj_id, exp_time);
+  tw->level_n_entry[level] += 1;
+  tw->n_entry += 1;
+}
+
+/* place an entry that expires at or after curr_time according to its
+ * remaining time */
+static void place_entry(timer_wheel_t *tw, obj_id_t obj_id, uint32_t exp_time) {
+  int64_t remain = (int64_t)exp_time - tw->curr_time;
+  DEBUG_ASSERT(remain >= 0);
+  int level = 0;
+  while (level < TIMER_WHEEL_N_LEVEL - 1 && remain >= level_span(level + 1)) {
+    level++;
+  }
+  int64_t slot_idx = ((int64_t)exp_time >> (TIMER_WHEEL_SLOT_BITS * level)) &
+                     TIMER_WHEEL_SLOT_MASK;
+  append_entry(tw, level, slot_idx, obj_id, exp_time);
+}
+
+timer_wheel_t *create_timer_wheel(void) {
+  timer_wheel_t *tw = my_malloc(timer_wheel_t);
+  memset(tw, 0, sizeof(timer_wheel_t));
+  return tw;
+}
+
+void free_timer_wheel(timer_wheel_t *tw) {
+  for (int l = 0; l < TIMER_WHEEL_N_LEVEL; l++) {
+    for (int s = 0; s < TIMER_WHEEL_N_SLOT; s++) {
+      free(tw->slots[l][s].entries);
+    }
+  }
+  my_free(sizeof(timer_wheel_t), tw);
+}
+
+void timer_wheel_add(timer_wheel_t *tw, obj_id_t obj_id, uint32_t exp_time) {
+  if ((int64_t)exp_time <= tw->curr_time) {
+    /* the slot of curr_time has been fired, fire at the next time unit */
+    append_entry(tw, 0, (tw->curr_time + 1) & TIMER_WHEEL_SLOT_MASK, obj_id,
+                 exp_time);
+  } else {
+    place_entry(tw, obj_id, exp_time);
+  }
+}
+
+/* move the entries of a higher-level slot to the lower levels, it is called
+ * when curr_time reaches the start of the slot, so the entries have less
+ * remaining time than the span of the level, and the ones that expire at
+ * curr_time are placed in the level-0 slot of curr_time, which fires after
+ * the cascade */
+static void cascade(timer_wheel_t *tw, int level, int64_t slot_idx) {
+  timer_wheel_slot_t *slot = &tw->slots[level][slot_idx];
+  int32_t n_entry = slot->n_entry;
+  slot->n_entry = 0;
+  tw->level_n_entry[level] -= n_entry;
+  tw->n_entry -= n_entry;
+
+  for (int32_t i = 0; i < n_entry; i++) {
+    place_entry(tw, slot->entries[i].obj_id, slot->entries[i].exp_time);
+  }
+}
+
+int64_t timer_wheel_advance(timer_wheel_t *tw, int64_t now,
+                            timer_wheel_expire_func_ptr expire_func,
+                            void *user_data) {
+  int64_t n_expired = 0;
+
+  while (tw->curr_time < now) {
+    if (tw->n_entry == 0) {
+      tw->curr_time = now;
+      break;
+    }
+
+    /* skip to the next time that has work, which is the next time unit if
+     * level 0 has entries, otherwise the start of the next slot of the
+     * lowest non-empty level, when it is cascaded */
+    int level = 0;
+    while (tw->level_n_entry[level] == 0) level++;
+    int64_t next_time;
+    if (level == 0) {
+      next_time = tw->curr_time + 1;
+    } else {
+      next_time = ((tw->curr_time >> (TIMER_WHEEL_SLOT_BITS * level)) + 1)
+                  << (TIMER_WHEEL_SLOT_BITS * level);
+    }
+    if (next_time > now) {
+      tw->curr_time = now;
+      break;
+    }
+    tw->curr_time = next_time;
+
+    /* cascade from the lower levels first, a higher level only cascades
+     * into slots that are later than the ones cascaded at this time */
+    for (int l = 1; l < TIMER_WHEEL_N_LEVEL; l++) {
+      if ((tw->curr_time & (level_span(l) - 1)) != 0) break;
+      int64_t slot_idx =
+          (tw->curr_time >> (TIMER_WHEEL_SLOT_BITS * l)) & TIMER_WHEEL_SLOT_MASK;
+      if (tw->slots[l][slot_idx].n_entry > 0) cascade(tw, l, slot_idx);
+    }
+
+    timer_wheel_slot_t *slot =
+        &tw->slots[0][tw->curr_time & TIMER_WHEEL_SLOT_MASK];
+    int32_t n_entry = slot->n_entry;
+    slot->n_entry = 0;
+    tw->level_n_entry[0] -= n_entry;
+    tw->n_entry -= n_entry;
+    n_expired += n_entry;
+    for (int32_t i = 0; i < n_entry; i++) {
+      expire_func(slot->entries[i].obj_id, slot->entries[i].exp_time,
+                  user_data);
+    }
+  }
+
+  return n_expired;
+}
+
+int64_t timer_wheel_compact(timer_wheel_t *tw,
+                            timer_wheel_keep_func_ptr keep_func,
+                            void *user_data) {
+  int64_t n_removed = 0;
+  for (int l = 0; l < TIMER_WHEEL_N_LEVEL; l++) {
+    for (int s = 0; s < TIMER_WHEEL_N_SLOT; s++) {
+      timer_wheel_slot_t *slot = &tw->slots[l][s];
+      int32_t n_kept = 0;
+      for (int32_t i = 0; i < slot->n_entry; i++) {
+        if (keep_func(slot->entries[i].obj_id, slot->entries[i].exp_time,
+                      user_data)) {
+          slot->entries[n_kept++] = slot->entries[i];
+        }
+      }
+      int32_t n_slot_removed = slot->n_entry - n_kept;
+      slot->n_entry = n_kept;
+      tw->level_n_entry[l] -= n_slot_removed;
+      n_removed += n_slot_removed;
+
+      /* release the memory held by a burst of entries */
+      if (slot->capacity > TIMER_WHEEL_INIT_SLOT_CAPACITY &&
+          n_kept * 4 < slot->capacity) {
+        int32_t new_capacity = n_kept < TIMER_WHEEL_INIT_SLOT_CAPACITY
+                                   ? TIMER_WHEEL_INIT_SLOT_CAPACITY
+                                   : n_kept * 2;
+        timer_wheel_entry_t *entries = realloc(
+            slot->entries, sizeof(timer_wheel_entry_t) * new_capacity);
+        if (entries != NULL) {
+          slot->entries = entries;
+          slot->capacity = new_capacity;
+        }
+      }
+    }
+  }
+  tw->n_entry -= n_removed;
+
+  return n_removed;
+}
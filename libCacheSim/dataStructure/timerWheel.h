@@ -0,0 +1,94 @@
+#ifndef _TIMER_WHEEL_H
+#define _TIMER_WHEEL_H
+
+/**
+ * a hierarchical timing wheel that indexes objects by expiration time, it is
+ * used to remove expired objects as the trace time advances
+ *
+ * there are 4 levels of 256 slots, a slot in level 0 covers one time unit
+ * (second) and a slot in level l covers 256^l time units, so 4 levels cover
+ * the uint32_t expiration time, an object is added to the level that covers
+ * its remaining time, and when the time reaches the start of a higher-level
+ * slot, its objects are moved (cascaded) to the lower levels, so each object
+ * is moved at most 3 times
+ *
+ * the wheel only stores the object id and the expiration time, it is not
+ * updated when an object is evicted or its expiration time changes, the
+ * caller checks whether an expired entry still matches a cached object, and
+ * calls timer_wheel_compact to drop the stale entries
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMER_WHEEL_N_LEVEL 4
+#define TIMER_WHEEL_SLOT_BITS 8
+#define TIMER_WHEEL_N_SLOT (1 << TIMER_WHEEL_SLOT_BITS)
+
+typedef struct {
+  obj_id_t obj_id;
+  uint32_t exp_time;
+} timer_wheel_entry_t;
+
+typedef struct {
+  timer_wheel_entry_t *entries;
+  int32_t n_entry;
+  int32_t capacity;
+} timer_wheel_slot_t;
+
+typedef struct timer_wheel {
+  timer_wheel_slot_t slots[TIMER_WHEEL_N_LEVEL][TIMER_WHEEL_N_SLOT];
+  int64_t level_n_entry[TIMER_WHEEL_N_LEVEL];
+  int64_t n_entry;
+  /* the entries that expire at or before curr_time have been fired */
+  int64_t curr_time;
+} timer_wheel_t;
+
+/* called for each expired entry */
+typedef void (*timer_wheel_expire_func_ptr)(obj_id_t obj_id, uint32_t exp_time,
+                                            void *user_data);
+
+/* return whether an entry should be kept during compaction */
+typedef bool (*timer_wheel_keep_func_ptr)(obj_id_t obj_id, uint32_t exp_time,
+                                          void *user_data);
+
+timer_wheel_t *create_timer_wheel(void);
+
+void free_timer_wheel(timer_wheel_t *tw);
+
+/**
+ * @brief add an object that expires at exp_time, an object that has expired
+ * (exp_time <= curr_time) fires at the next time unit
+ */
+void timer_wheel_add(timer_wheel_t *tw, obj_id_t obj_id, uint32_t exp_time);
+
+/**
+ * @brief advance the wheel to time now, and call expire_func for the entries
+ * that expire at or before now, time does not go backward
+ *
+ * @return the number of expired entries
+ */
+int64_t timer_wheel_advance(timer_wheel_t *tw, int64_t now,
+                            timer_wheel_expire_func_ptr expire_func,
+                            void *user_data);
+
+/**
+ * @brief remove the entries for which keep_func returns false
+ *
+ * @return the number of removed entries
+ */
+int64_t timer_wheel_compact(timer_wheel_t *tw,
+                            timer_wheel_keep_func_ptr keep_func,
+                            void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
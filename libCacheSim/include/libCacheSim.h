@@ -26,8 +26,11 @@
 #include "libCacheSim/sampling.h"
 
 /* cache simulator */
+#include "libCacheSim/cacheCluster.h"
+#include "libCacheSim/cacheHierarchy.h"
 #include "libCacheSim/plugin.h"
 #include "libCacheSim/profilerLRU.h"
+#include "libCacheSim/profilerOPT.h"
 #include "libCacheSim/simulator.h"
 
 #endif  // libCacheSim_H
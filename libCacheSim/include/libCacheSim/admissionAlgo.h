@@ -11,6 +11,8 @@ typedef struct admissioner *(*admissioner_create_func_ptr)(const char *);
 typedef struct admissioner *(*admissioner_clone_func_ptr)(struct admissioner *);
 typedef bool (*cache_admit_func_ptr)(struct admissioner*, const request_t *);
 typedef void (*admissioner_free_func_ptr)(struct admissioner *);
+typedef int64_t (*admissioner_get_metadata_bytes_func_ptr)(
+    const struct admissioner *);
 
 typedef struct admissioner {
   cache_admit_func_ptr admit;
@@ -18,12 +20,15 @@ typedef struct admissioner {
   admissioner_clone_func_ptr clone;
   admissioner_free_func_ptr free;
   void *init_params;
+  /* the bytes of the admission state, NULL if it is negligible */
+  admissioner_get_metadata_bytes_func_ptr get_metadata_bytes;
 } admissioner_t;
 
 admissioner_t *create_bloomfilter_admissioner(const char *init_params);
 admissioner_t *create_prob_admissioner(const char *init_params);
 admissioner_t *create_size_admissioner(const char *init_params);
 admissioner_t *create_adaptsize_admissioner(const char *init_params);
+admissioner_t *create_frequency_admissioner(const char *init_params);
 
 static inline admissioner_t *create_admissioner(const char *admission_algo,
                                                 const char *admission_params) {
@@ -36,6 +41,8 @@ static inline admissioner_t *create_admissioner(const char *admission_algo,
     admissioner = create_size_admissioner(admission_params);
   } else if (strcasecmp(admission_algo, "adaptsize") == 0) {
     admissioner = create_adaptsize_admissioner(admission_params);
+  } else if (strcasecmp(admission_algo, "frequency") == 0 || strcasecmp(admission_algo, "freq") == 0) {
+    admissioner = create_frequency_admissioner(admission_params);
   } else {
     ERROR("admission algo %s not supported\n", admission_algo);
   }
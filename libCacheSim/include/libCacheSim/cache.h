@@ -10,6 +10,7 @@
 #define CACHE_H
 
 #include <math.h>
+#include <stdio.h>
 
 #include "../config.h"
 #include "admissionAlgo.h"
@@ -58,14 +59,25 @@ typedef cache_obj_t *(*cache_to_evict_func_ptr)(cache_t *, const request_t *);
 
 typedef bool (*cache_remove_func_ptr)(cache_t *, const obj_id_t);
 
+typedef bool (*cache_save_state_func_ptr)(const cache_t *, FILE *);
+
+typedef bool (*cache_load_state_func_ptr)(cache_t *, FILE *);
+
+typedef bool (*cache_set_params_func_ptr)(cache_t *, const char *);
+
 typedef void (*cache_remove_obj_func_ptr)(cache_t *, cache_obj_t *obj);
 
 typedef int64_t (*cache_get_occupied_byte_func_ptr)(const cache_t *);
 
 typedef int64_t (*cache_get_n_obj_func_ptr)(const cache_t *);
 
+typedef int64_t (*cache_get_metadata_bytes_func_ptr)(const cache_t *);
+
 typedef void (*cache_print_cache_func_ptr)(const cache_t *);
 
+typedef void (*cache_evict_listener_func_ptr)(cache_t *, const cache_obj_t *,
+                                              void *);
+
 // #define EVICTION_AGE_ARRAY_SZE 40
 #define EVICTION_AGE_ARRAY_SZE 320
 #define EVICTION_AGE_LOG_BASE 1.08
@@ -84,8 +96,17 @@ typedef struct {
 
   /* current trace time, used to determine obj expiration */
   int64_t curr_rtime;
+  /* the objects (bytes) removed because they expired or were evicted */
   int64_t expired_obj_cnt;
   int64_t expired_bytes;
+  int64_t n_eviction;
+  int64_t evicted_bytes;
+  /* the bytes of memory used by the cache's data structures at the end of
+   * the simulation and the largest sampled value during the simulation */
+  int64_t metadata_byte;
+  int64_t max_metadata_byte;
+  /* wall clock time of the simulation */
+  double runtime_sec;
   char cache_name[CACHE_NAME_ARRAY_LEN];
 } cache_stat_t;
 
@@ -106,12 +127,31 @@ struct cache {
   cache_to_evict_func_ptr to_evict;
   cache_get_occupied_byte_func_ptr get_occupied_byte;
   cache_get_n_obj_func_ptr get_n_obj;
+  /* the bytes of memory used by the data structures of the cache, e.g.,
+   * the hash table, objects, ghost entries and sketches, not the cached
+   * data, the algorithms with structures outside the hash table override
+   * cache_get_metadata_bytes_default */
+  cache_get_metadata_bytes_func_ptr get_metadata_bytes;
   cache_print_cache_func_ptr print_cache;
+  /* write/read the eviction state for checkpointing,
+   * NULL if the algorithm does not support snapshot */
+  cache_save_state_func_ptr save_state;
+  cache_load_state_func_ptr load_state;
+  /* change the parameters of a warm cache (e.g., after forking a branch),
+   * NULL if the algorithm does not support it */
+  cache_set_params_func_ptr set_params;
 
   admissioner_t *admissioner;
 
   prefetcher_t *prefetcher;
 
+  /* called by cache_evict_base before the evicted object is freed, it is not
+   * called when an object is removed or expires, and it is not called by
+   * the algorithms that evict from internal sub-caches (e.g., S3FIFO),
+   * NULL if not used */
+  cache_evict_listener_func_ptr evict_listener;
+  void *evict_listener_data;
+
   void *eviction_params;
 
   // other name: logical_time, virtual_time, reference_count
@@ -126,6 +166,18 @@ struct cache {
   int64_t occupied_byte;
   /************ end of private fields *************/
 
+  /* the number of evictions triggered by cache_get_base */
+  int64_t n_eviction;
+  int64_t n_evicted_byte;
+  /* the number of objects removed because they expired, either found on
+   * access or removed by the ttl wheel */
+  int64_t n_expiration;
+  int64_t n_expired_byte;
+  /* indexes the cached objects by expiration time so that cache_get_base
+   * removes the expired objects as the trace time advances,
+   * NULL if TTL is not supported */
+  struct timer_wheel *ttl_wheel;
+
   // because some algorithms choose different candidates
   // each time we want to evict, but we want to make sure
   // that the object returned from to_evict will be evicted
@@ -139,6 +191,10 @@ struct cache {
   int64_t cache_size;
   int64_t default_ttl;
   int32_t obj_md_size;
+  /* whether get_metadata_bytes is charged against cache_size, so that the
+   * cached data and the metadata fit in cache_size, see
+   * cache_get_usable_byte, it is set on the top-level cache only */
+  bool charge_metadata;
 
   /* cache stat is not updated automatically, it is popped up only in
    * some situations */
@@ -170,6 +226,32 @@ static inline common_cache_params_t default_common_cache_params(void) {
   return params;
 }
 
+#define HASH_POWER_MIN 12
+#define HASH_POWER_MAX 32
+
+/**
+ * @brief the initial hashpower for a cache of the given size,
+ * the table is sized for the number of objects the cache can hold, the
+ * hashtable expands if the cache holds more objects (e.g., ghost entries),
+ * so this does not need to be exact
+ *
+ * @param cache_size the cache size in bytes, or in objects if the object
+ *      size is ignored
+ * @param mean_obj_size the mean object size of the trace, 1 if the object
+ *      size is ignored
+ * @return the hashpower
+ */
+static inline int32_t get_hashpower_for_cache_size(uint64_t cache_size,
+                                                   int64_t mean_obj_size) {
+  if (mean_obj_size < 1) mean_obj_size = 1;
+  uint64_t n_obj = cache_size / (uint64_t)mean_obj_size + 1;
+  int32_t hashpower = HASH_POWER_MIN;
+  while (hashpower < HASH_POWER_MAX && (1ULL << hashpower) < n_obj) {
+    hashpower++;
+  }
+  return hashpower;
+}
+
 /**
  * initialize the cache struct, must be called in all cache_init functions
  * @param cache_name
@@ -185,6 +267,55 @@ cache_t *cache_struct_init(const char *cache_name, common_cache_params_t params,
  */
 void cache_struct_free(cache_t *cache);
 
+/**
+ * @brief declare the bytes of cache_obj_t used by the objects of the cache,
+ * the objects are allocated with only these bytes from a per-cache pool,
+ * it must be called before the first insert
+ *
+ * an algorithm calls it in its init with the metadata it uses, e.g.,
+ * CACHE_OBJ_HEADER_SIZE or CACHE_OBJ_SIZE_WITH(clock), and accesses the
+ * metadata with CACHE_OBJ_MEMBER so that debug builds check the bound;
+ * the objects of an algorithm that does not call it (e.g., the composed
+ * algorithms, LHD, LRB and GLCache) have the full cache_obj_t, which is
+ * sizeof(cache_obj_t) rounded up to 8 bytes instead of the packed struct;
+ * a composed algorithm (e.g., S3FIFO) that keeps its metadata in the objects
+ * of its sub-caches calls it on them with sizeof(cache_obj_t)
+ *
+ * @param cache
+ * @param obj_struct_size
+ */
+void cache_set_obj_struct_size(cache_t *cache, size_t obj_struct_size);
+
+/**
+ * @brief the bytes allocated for each object of the cache
+ *
+ * @param cache
+ * @return size_t
+ */
+size_t cache_get_obj_struct_size(const cache_t *cache);
+
+/**
+ * @brief the default get_metadata_bytes, it counts the cache struct, the
+ * hash table (buckets and objects), the ttl wheel, and the state of the
+ * admissioner and the prefetcher
+ *
+ * @param cache
+ * @return int64_t
+ */
+int64_t cache_get_metadata_bytes_default(const cache_t *cache);
+
+/**
+ * @brief the bytes available for the cached data, this is cache_size, or
+ * cache_size minus the metadata bytes if the cache charges its metadata
+ *
+ * @param cache
+ * @return int64_t, which can be negative if the metadata exceeds cache_size
+ */
+static inline int64_t cache_get_usable_byte(const cache_t *cache) {
+  if (!cache->charge_metadata) return cache->cache_size;
+  return cache->cache_size - cache->get_metadata_bytes(cache);
+}
+
 /**
  * @brief create a new cache with the same size and parameters
  *
@@ -241,6 +372,18 @@ bool cache_can_insert_default(cache_t *cache, const request_t *req);
  */
 cache_obj_t *cache_insert_base(cache_t *cache, const request_t *req);
 
+/**
+ * @brief remove the objects that expire before now (exp_time < now), it is
+ * called by cache_get_base with the request time, and can be called to
+ * remove the expired objects without a request, e.g., at the end of a trace,
+ * it does nothing if TTL is not supported
+ *
+ * @param cache
+ * @param now the current trace time
+ * @return the number of objects removed
+ */
+int64_t cache_remove_expired(cache_t *cache, int64_t now);
+
 /**
  * @brief this function is called by all eviction algorithms that
  * need to remove an object from the cache, it updates the cache metadata,
@@ -306,11 +449,11 @@ static inline int64_t cache_get_virtual_time(const cache_t *cache) {
 static inline void print_cache_stat(const cache_t *cache) {
   printf(
       "%s cache size %ld, occupied size %ld, n_req %ld, n_obj %ld, default TTL "
-      "%ld, per_obj_metadata_size %d\n",
+      "%ld, per_obj_metadata_size %d, metadata %ld bytes\n",
       cache->cache_name, (long)cache->cache_size,
       (long)cache->get_occupied_byte(cache), (long)cache->n_req,
       (long)cache->get_n_obj(cache), (long)cache->default_ttl,
-      (int)cache->obj_md_size);
+      (int)cache->obj_md_size, (long)cache->get_metadata_bytes(cache));
 }
 
 /**
@@ -366,6 +509,77 @@ bool dump_eviction_age(const cache_t *cache, const char *ofilepath);
 bool dump_cached_obj_age(cache_t *cache, const request_t *req,
                          const char *ofilepath);
 
+/**
+ * @brief checkpoint the cache to a file so that a warm cache can be reused
+ * by later experiments, it stores the cached objects, their order and
+ * metadata, and the algorithm state, but not the admissioner and prefetcher
+ *
+ * @param cache
+ * @param path
+ * @return whether the snapshot is saved, false if the algorithm does not
+ * support snapshot or the file cannot be written
+ */
+bool cache_save_snapshot(const cache_t *cache, const char *path);
+
+/**
+ * @brief restore a snapshot saved by cache_save_snapshot into an empty cache
+ * created by the same algorithm with the same size, the algorithm parameters
+ * may differ as long as they do not change the layout of the state
+ * (e.g., S3FIFO move-to-main-threshold)
+ *
+ * @param cache
+ * @param path
+ * @return whether the snapshot is loaded, the cache may be partially loaded
+ * and should be freed if this fails
+ */
+bool cache_load_snapshot(cache_t *cache, const char *path);
+
+/**
+ * the functions below are used by the eviction algorithms to implement
+ * save_state and load_state
+ */
+/**
+ * @brief write the common cache state (logical time) and the algorithm
+ * state, this is also used by caches composed of other caches (e.g., S3FIFO)
+ * to save their sub-caches
+ */
+bool cache_save_state(const cache_t *cache, FILE *f);
+
+bool cache_load_state(cache_t *cache, FILE *f);
+
+/**
+ * @brief write an algorithm tag so that loading a snapshot into a different
+ * algorithm fails
+ */
+bool cache_snapshot_write_tag(FILE *f, const char *tag);
+
+bool cache_snapshot_check_tag(FILE *f, const char *tag);
+
+/**
+ * @brief write the objects of a queue from the tail to the head,
+ * each object is stored as its id, size and the metadata after the queue
+ * pointers in the object struct of the cache
+ *
+ * @param cache
+ * @param f
+ * @param q_tail
+ */
+bool cache_save_obj_list(const cache_t *cache, FILE *f,
+                         const cache_obj_t *q_tail);
+
+/**
+ * @brief read a queue saved by cache_save_obj_list, insert the objects into
+ * the hash table and prepend them to the queue so that the order is restored
+ *
+ * @param cache
+ * @param f
+ * @param q_head
+ * @param q_tail
+ * @return the number of objects loaded, -1 on error
+ */
+int64_t cache_load_obj_list(cache_t *cache, FILE *f, cache_obj_t **q_head,
+                            cache_obj_t **q_tail);
+
 #ifdef __cplusplus
 }
 #endif
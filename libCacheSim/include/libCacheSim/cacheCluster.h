@@ -0,0 +1,115 @@
+//
+//  cacheCluster.h
+//
+//  a cluster of cache servers behind a consistent hash ring, the requests are
+//  dispatched to the servers by the object id and each server is simulated by
+//  a worker thread
+//
+
+#ifndef CACHE_CLUSTER_H
+#define CACHE_CLUSTER_H
+
+#include "cache.h"
+#include "reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  CLUSTER_EVENT_ADD_SERVER,
+  CLUSTER_EVENT_REMOVE_SERVER,
+} cluster_event_type_e;
+
+/* a membership change that takes effect before the n_req-th request (0-based)
+ * of the trace, the events must be sorted by n_req */
+typedef struct {
+  int64_t n_req;
+  cluster_event_type_e type;
+  int server_id;
+} cluster_event_t;
+
+typedef struct {
+  /* the caches of the servers, owned by the cluster */
+  cache_t **caches;
+  int n_server;
+  /* the number of servers each object is placed on */
+  int replication;
+  /* the consistent hash ring, see dataStructure/consistentHash.h */
+  struct ring *ring;
+  /* whether a server is in the cluster, a removed server keeps its cache
+   * content, so it comes back warm when it is added again */
+  bool *available;
+} cache_cluster_t;
+
+typedef struct {
+  /* the requests that the server serves as the primary */
+  int64_t n_req;
+  int64_t n_hit;
+  int64_t n_req_byte;
+  int64_t n_hit_byte;
+  /* the requests that the server receives as a replica */
+  int64_t n_replica_req;
+} cluster_server_stat_t;
+
+typedef struct {
+  int n_server;
+  int64_t n_req;
+  /* includes the unserved requests */
+  int64_t n_miss;
+  int64_t n_req_byte;
+  int64_t n_miss_byte;
+  /* the requests that arrive when no server is available */
+  int64_t n_unserved;
+  /* the max over the mean (of all servers) of the requests served by a
+   * server, 1 means perfectly balanced */
+  double load_imbalance;
+  cluster_server_stat_t *server_stats;
+} cluster_stat_t;
+
+/**
+ * create a cluster of n_server servers, the cluster takes the ownership of
+ * the caches and frees them in free_cache_cluster
+ *
+ * @param caches
+ * @param weights the weights of the servers on the ring, sum to 1,
+ * NULL if all servers have the same weight
+ * @param n_server
+ * @param replication the number of servers each object is placed on, the
+ * first one serves the request, the others receive it to stay warm
+ * @return cache_cluster_t*
+ */
+cache_cluster_t *create_cache_cluster(cache_t **caches, const double *weights,
+                                      int n_server, int replication);
+
+void free_cache_cluster(cache_cluster_t *cluster);
+
+/**
+ * run the trace through the cluster, the calling thread reads the trace,
+ * applies the events and dispatches the requests into a single-producer
+ * single-consumer queue per server, each of the num_of_threads workers
+ * simulates a disjoint set of servers, so the result does not depend on
+ * num_of_threads
+ *
+ * the cluster keeps its state (cache content and membership) after the
+ * simulation
+ *
+ * @param cluster
+ * @param reader
+ * @param events can be NULL if n_event is 0
+ * @param n_event
+ * @param num_of_threads
+ * @return cluster_stat_t* freed by free_cluster_stat
+ */
+cluster_stat_t *simulate_cache_cluster(cache_cluster_t *cluster,
+                                       reader_t *reader,
+                                       const cluster_event_t *events,
+                                       int n_event, int num_of_threads);
+
+void free_cluster_stat(cluster_stat_t *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_CLUSTER_H */
@@ -0,0 +1,113 @@
+//
+//  cacheHierarchy.h
+//
+//  a multi-level cache hierarchy simulated in one pass, the misses of each
+//  level are streamed to the next level through in-memory queues, and each
+//  cache runs on its own thread
+//
+
+#ifndef CACHE_HIERARCHY_H
+#define CACHE_HIERARCHY_H
+
+#include "cache.h"
+#include "reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  /* a level keeps the objects it passes to the level above */
+  HIERARCHY_INCLUSIVE,
+  /* a level gives up the objects it passes to the level above, and receives
+   * the objects evicted from the level above */
+  HIERARCHY_EXCLUSIVE,
+} hierarchy_inclusion_e;
+
+typedef enum {
+  /* a write is applied to every level down to the backend */
+  HIERARCHY_WRITE_THROUGH,
+  /* a write is absorbed by the first level, the dirty object is written to the
+   * next level when it is evicted */
+  HIERARCHY_WRITE_BACK,
+} hierarchy_write_policy_e;
+
+/**
+ * the caches of one level
+ *
+ * the first level has one cache per trace, the middle levels have one cache
+ * that receives the stream of the level below (merged by time if the level
+ * below has several caches), the last level can have several caches (e.g.,
+ * different sizes or algorithms), each of them receives the same stream, so
+ * the what-if results of the last level are obtained in one pass
+ */
+typedef struct {
+  cache_t **caches;
+  int n_cache;
+} hierarchy_level_t;
+
+typedef struct {
+  /* the reads and writes that reach the cache, which are the requests of the
+   * trace for the first level, and the requests passed from the level above
+   * for other levels */
+  int64_t n_req;
+  int64_t n_req_byte;
+  int64_t n_hit;
+  int64_t n_hit_byte;
+  int64_t n_write;
+  /* the reads and writes passed to the next level (or the backend) */
+  int64_t n_forward;
+  int64_t n_forward_byte;
+  /* the dirty objects written to the next level (or the backend) */
+  int64_t n_writeback;
+  int64_t n_writeback_byte;
+  /* the objects evicted from the level above and inserted in this cache,
+   * only in exclusive hierarchies */
+  int64_t n_demotion;
+  /* the evictions observed by the hierarchy */
+  int64_t n_eviction;
+  char cache_name[CACHE_NAME_ARRAY_LEN];
+} hierarchy_cache_stat_t;
+
+typedef struct {
+  int n_level;
+  int *n_cache;
+  /* cache_stats[i][j] is the stat of the j-th cache at level i */
+  hierarchy_cache_stat_t **cache_stats;
+} hierarchy_stat_t;
+
+/**
+ * simulate a cache hierarchy, each of the first level caches reads its own
+ * trace, the requests are read or write according to req->op (the ops that
+ * modify the object, e.g., OP_SET and OP_WRITE, are writes)
+ *
+ * each cache runs on its own thread, a level processes the stream of the
+ * level below in the order of (time, index of the cache below), so the
+ * result does not depend on thread scheduling, no intermediate trace is
+ * written
+ *
+ * exclusive caching and write-back need to observe the evictions, so the
+ * caches must evict through cache_evict_base (e.g., LRU, FIFO, LFU, Clock,
+ * ARC), the simulation stops with an error otherwise
+ *
+ * the caches and the readers are not owned by the hierarchy, the readers are
+ * read from their current position
+ *
+ * @param readers one reader per first level cache
+ * @param levels
+ * @param n_level
+ * @param inclusion
+ * @param write_policy
+ * @return hierarchy_stat_t* freed by free_hierarchy_stat
+ */
+hierarchy_stat_t *simulate_cache_hierarchy(
+    reader_t **readers, const hierarchy_level_t *levels, int n_level,
+    hierarchy_inclusion_e inclusion, hierarchy_write_policy_e write_policy);
+
+void free_hierarchy_stat(hierarchy_stat_t *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_HIERARCHY_H */
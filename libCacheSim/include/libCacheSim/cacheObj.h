@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 
 #include "../config.h"
@@ -127,21 +128,34 @@ typedef struct {
   int32_t freq;
 } __attribute__((packed)) Sieve_obj_params_t;
 
+typedef struct {
+  int64_t last_access_vtime;  // LHD timestamp of the last access
+  int32_t pos;                // index in the dense array used for sampling
+  uint16_t last_hit_age;      // coarsened ages at the last two hits
+  uint16_t last_last_hit_age;
+  uint8_t class_id;
+  bool explorer;
+} __attribute__((packed)) LHD_obj_metadata_t;
+
 typedef struct {
   int64_t next_access_vtime;
   int32_t freq;
-} __attribute__((packed)) misc_metadata_t;
+} misc_metadata_t;
 
 // ############################## cache obj ###################################
+/* an object has a header (up to misc) followed by misc and the metadata of
+ * the eviction algorithm, an algorithm declares the bytes it uses with
+ * cache_set_obj_struct_size, and the objects of the cache are allocated with
+ * only these bytes, so an algorithm must not access a member beyond them */
 struct cache_obj;
 typedef struct cache_obj {
   struct cache_obj *hash_next;
   obj_id_t obj_id;
-  uint32_t obj_size;
   struct {
     struct cache_obj *prev;
     struct cache_obj *next;
   } queue;  // for LRU, FIFO, etc.
+  uint32_t obj_size;
 #ifdef SUPPORT_TTL
   uint32_t exp_time;
 #endif
@@ -173,20 +187,49 @@ typedef struct cache_obj {
     LIRS_obj_metadata_t LIRS;
     S3FIFO_obj_metadata_t S3FIFO;
     Sieve_obj_params_t sieve;
+    LHD_obj_metadata_t LHD;
 
 #if defined(ENABLE_GLCACHE) && ENABLE_GLCACHE == 1
     GLCache_obj_metadata_t GLCache;
 #endif
   };
-} __attribute__((packed)) cache_obj_t;
+} cache_obj_t;
+
+/* the bytes of cache_obj_t up to and including a metadata member,
+ * e.g., CACHE_OBJ_SIZE_WITH(misc) and CACHE_OBJ_SIZE_WITH(clock) */
+#define CACHE_OBJ_SIZE_WITH(member) \
+  (offsetof(cache_obj_t, member) + sizeof(((cache_obj_t *)0)->member))
+
+/* the bytes of cache_obj_t used by an algorithm without per-object metadata,
+ * misc is kept when tracking evictions and demotions because it is printed */
+#if defined(TRACK_EVICTION_V_AGE) || defined(TRACK_DEMOTION)
+#define CACHE_OBJ_HEADER_SIZE CACHE_OBJ_SIZE_WITH(misc)
+#else
+#define CACHE_OBJ_HEADER_SIZE offsetof(cache_obj_t, misc)
+#endif
+
+/* access a metadata member of an object of the cache, debug builds check that
+ * the member is within the bytes declared with cache_set_obj_struct_size,
+ * e.g., CACHE_OBJ_MEMBER(cache, obj, clock).freq += 1 */
+#define CACHE_OBJ_MEMBER(cache, obj, member)                    \
+  (*({                                                          \
+    DEBUG_ASSERT(CACHE_OBJ_SIZE_WITH(member) <=                 \
+                 cache_get_obj_struct_size(cache));             \
+    (void)(cache);                                              \
+    &(obj)->member;                                             \
+  }))
 
 struct request;
+struct cache;
 /**
- * copy the cache_obj to req_dest
+ * copy the cache_obj to req_dest, misc is copied only when the cache that
+ * owns cache_obj declares an object size that includes misc
  * @param req_dest
+ * @param cache the cache that owns cache_obj
  * @param cache_obj
  */
 void copy_cache_obj_to_request(struct request *req_dest,
+                               const struct cache *cache,
                                const cache_obj_t *cache_obj);
 
 /**
@@ -62,6 +62,9 @@ typedef enum {
   VALPIN_TRACE,
   // ORACLE_WIKI19t_TRACE,
 
+  /* generated on the fly, no trace file */
+  SYNTHETIC_TRACE,
+
   UNKNOWN_TRACE,
 } __attribute__((__packed__)) trace_type_e;
 
@@ -95,6 +98,7 @@ static char *g_trace_type_name[UNKNOWN_TRACE + 2] = {
     "ORACLE_WIKI19u_TRACE",
     "VALPIN_TRACE",
     // "ORACLE_WIKI19t_TRACE",
+    "SYNTHETIC_TRACE",
     "UNKNOWN_TRACE",
 };
 
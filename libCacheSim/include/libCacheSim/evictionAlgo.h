@@ -25,6 +25,12 @@ typedef struct freq_node {
   uint32_t n_obj;
 } freq_node_t;
 
+/* the bytes used by a GHashTable from frequency to freq_node_t, each entry
+ * of the table has a key, a value and a hash */
+#define FREQ_MAP_GET_METADATA_BYTES(freq_map) \
+  ((int64_t)g_hash_table_size(freq_map) *     \
+   (int64_t)(sizeof(freq_node_t) + 2 * sizeof(void *) + sizeof(guint)))
+
 typedef struct {
   cache_obj_t *q_head;
   cache_obj_t *q_tail;
@@ -0,0 +1,136 @@
+#pragma once
+//
+// record the metrics of each cache over time (per window of trace time or
+// requests) so that the miss ratio over time of every cache in a sweep can be
+// plotted without rerunning the simulation
+//
+// the simulation threads fill a metrics_tracker_t per cache and push one
+// record per window to a queue, a background thread writes the records
+//
+// CSV format, one row per (cache, window)
+//   cache_idx,cache_name,cache_size,window_idx,start_rtime,end_rtime,n_req,
+//   n_miss,n_req_byte,n_miss_byte,miss_ratio,byte_miss_ratio,n_obj,
+//   occupied_byte,n_eviction,eviction_age
+//   eviction_age is a list of bucket:count separated by ';', bucket b has the
+//   evictions with age in (EVICTION_AGE_LOG_BASE^(b-1), EVICTION_AGE_LOG_BASE^b]
+//
+// binary format (little endian, packed), it starts with the 8-byte magic
+// "LCSMTR01" followed by records, each record starts with a uint8_t type
+//   cache record (type 1): int32_t cache_idx, int64_t cache_size,
+//     uint16_t name_len, char name[name_len]
+//   window record (type 2): int32_t cache_idx, int64_t window_idx,
+//     start_rtime, end_rtime, n_req, n_miss, n_req_byte, n_miss_byte, n_obj,
+//     occupied_byte, n_eviction, int32_t n_age_bucket,
+//     {int16_t bucket, int64_t count}[n_age_bucket]
+//
+
+#include "cache.h"
+#include "request.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_BINARY_MAGIC "LCSMTR01"
+
+typedef enum {
+  METRICS_FORMAT_CSV,
+  METRICS_FORMAT_BINARY,
+
+  METRICS_FORMAT_INVALID
+} metrics_format_e;
+
+struct metrics_recorder;
+typedef struct metrics_recorder metrics_recorder_t;
+
+/* the state of one cache, owned by the thread simulating the cache */
+typedef struct {
+  metrics_recorder_t *recorder;
+  int32_t cache_idx;
+  int64_t window_sec;
+  int64_t window_req;
+
+  int64_t window_idx;
+  int64_t window_start_rtime;
+  int64_t n_req;
+  int64_t n_miss;
+  int64_t n_req_byte;
+  int64_t n_miss_byte;
+
+  /* the eviction counters of the cache at the start of the window */
+  int64_t last_n_eviction;
+  int64_t last_eviction_age_cnt[EVICTION_AGE_ARRAY_SZE];
+} metrics_tracker_t;
+
+/**
+ * @brief create a recorder that writes to ofilepath, a window ends after
+ * window_sec seconds of trace time or window_req requests, whichever comes
+ * first, 0 disables the condition
+ */
+metrics_recorder_t *create_metrics_recorder(const char *ofilepath,
+                                            metrics_format_e format,
+                                            int64_t window_sec,
+                                            int64_t window_req);
+
+/* wait for the writer to write all records and close the file */
+void close_metrics_recorder(metrics_recorder_t *recorder);
+
+/* csv if the path ends with .csv, binary otherwise */
+metrics_format_e metrics_format_from_path(const char *ofilepath);
+
+/**
+ * @brief start tracking a cache, the counters of the cache at this point
+ * (e.g., the evictions during warm up) are not reported
+ *
+ * @param recorder
+ * @param cache_idx the id of the cache in the output
+ * @param cache
+ */
+metrics_tracker_t *create_metrics_tracker(metrics_recorder_t *recorder,
+                                          int32_t cache_idx,
+                                          const cache_t *cache);
+
+/* report the current window and start a new one at end_rtime */
+void metrics_tracker_flush(metrics_tracker_t *tracker, const cache_t *cache,
+                           int64_t end_rtime);
+
+/* report the last (partial) window and free the tracker, it must be called
+ * before the cache is freed */
+void free_metrics_tracker(metrics_tracker_t *tracker, const cache_t *cache,
+                          int64_t end_rtime);
+
+/* called after each request that is not used for warm up, the request time
+ * should be relative to the start of the trace */
+static inline void metrics_tracker_record(metrics_tracker_t *tracker,
+                                          const cache_t *cache,
+                                          const request_t *req,
+                                          const bool hit) {
+  if (tracker->window_sec > 0) {
+    int64_t window_end = tracker->window_start_rtime + tracker->window_sec;
+    if ((int64_t)req->clock_time >= window_end) {
+      if (tracker->n_req > 0) {
+        metrics_tracker_flush(tracker, cache, window_end);
+      }
+      /* skip the windows without requests */
+      tracker->window_start_rtime =
+          (int64_t)req->clock_time -
+          ((int64_t)req->clock_time - tracker->window_start_rtime) %
+              tracker->window_sec;
+    }
+  }
+
+  tracker->n_req += 1;
+  tracker->n_req_byte += req->obj_size;
+  if (!hit) {
+    tracker->n_miss += 1;
+    tracker->n_miss_byte += req->obj_size;
+  }
+
+  if (tracker->window_req > 0 && tracker->n_req >= tracker->window_req) {
+    metrics_tracker_flush(tracker, cache, (int64_t)req->clock_time);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,6 +20,8 @@ typedef void (*prefetcher_handle_evict_func_ptr)(cache_t *, const request_t *);
 typedef void (*prefetcher_free_func_ptr)(struct prefetcher *);
 typedef struct prefetcher *(*prefetcher_clone_func_ptr)(struct prefetcher *,
                                                         uint64_t);
+typedef int64_t (*prefetcher_get_metadata_bytes_func_ptr)(
+    const struct prefetcher *);
 
 typedef struct prefetcher {
   void *params;
@@ -30,12 +32,16 @@ typedef struct prefetcher {
   prefetcher_handle_evict_func_ptr handle_evict;
   prefetcher_free_func_ptr free;
   prefetcher_clone_func_ptr clone;
+  /* the bytes of the prefetching state, NULL if it is negligible */
+  prefetcher_get_metadata_bytes_func_ptr get_metadata_bytes;
 } prefetcher_t;
 
 prefetcher_t *create_Mithril_prefetcher(const char *init_paramsm,
                                         uint64_t cache_size);
 prefetcher_t *create_OBL_prefetcher(const char *init_paramsm, uint64_t cache_size);
 prefetcher_t *create_PG_prefetcher(const char *init_paramsm, uint64_t cache_size);
+prefetcher_t *create_Stride_prefetcher(const char *init_paramsm,
+                                       uint64_t cache_size);
 
 static inline prefetcher_t *create_prefetcher(const char *prefetching_algo,
                                               const char *prefetching_params,
@@ -47,6 +53,8 @@ static inline prefetcher_t *create_prefetcher(const char *prefetching_algo,
     prefetcher = create_OBL_prefetcher(prefetching_params, cache_size);
   } else if (strcasecmp(prefetching_algo, "PG") == 0) {
     prefetcher = create_PG_prefetcher(prefetching_params, cache_size);
+  } else if (strcasecmp(prefetching_algo, "Stride") == 0) {
+    prefetcher = create_Stride_prefetcher(prefetching_params, cache_size);
   } else {
     ERROR("prefetching algo %s not supported\n", prefetching_algo);
   }
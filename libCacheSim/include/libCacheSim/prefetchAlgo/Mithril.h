@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "../../../dataStructure/idMap.h"
 #include "../cache.h"
 
 /** related to mining table size,
@@ -75,8 +76,19 @@
  @param row_num the order of row
  @return a pointer to the beginning of the row
  */
-#define GET_ROW_IN_MTABLE(param, row_num)                        \
-  (((TS_REPRESENTATION *)(param)->rmtable->mining_table->data) + \
+#define GET_ROW_IN_MTABLE(param, row_num) \
+  ((param)->rmtable->mining_table +       \
+   (param)->rmtable->mtable_row_len * (row_num))
+
+/**
+ retrieve the row_num row in the mining snapshot
+
+ @param param Mithril_params
+ @param row_num the order of row
+ @return a pointer to the beginning of the row
+ */
+#define GET_ROW_IN_MSNAPSHOT(param, row_num) \
+  ((param)->rmtable->mining_snapshot +       \
    (param)->rmtable->mtable_row_len * (row_num))
 
 /****************************************************************************
@@ -208,6 +220,15 @@ typedef struct {
    **/
   int mining_threshold;
 
+  /** the number of mining table rows mined per request,
+   *  when the mining table is full, it is sorted into a snapshot and
+   *  recording continues in the (now empty) mining table,
+   *  the snapshot is mined mining_step rows at a time at the end of
+   *  each request, so mining does not stall a request,
+   *  0: mine the snapshot at once
+   **/
+  int mining_step;
+
   /** the embedded sequential prefetching method. just use in block or cache
    * line level where obj_size is same.
    * 0: no sequential_prefetching, 1: simple
@@ -233,20 +254,27 @@ typedef struct {
 
 typedef struct {
   /** the hash table for storing block related info,
-   *  currently key is the block number
+   *  key is the block number (the full 64-bit obj_id),
    *  value is the order of row in recording table or mining table,
    *  if the value is positive, it is pointing to recording table,
    *  if it is negative, it is pointing to mining table
    **/
-  GHashTable *hashtable;
+  id_map_t *hashtable;
 
   /** this is the location for storing recording table,
    *  recording table is N*(min_support/4+1) array,
    *  where 4 is the number of timestamps stored in one 64bit integer,
-   *  N is number of entries in recording table, plus one is for label
+   *  N is number of entries in recording table, plus one is for label,
+   *  a row is in use if it has a timestamp, so obj_id 0 can be recorded
    **/
   gint64 *recording_table;
 
+  /** the size of the obj in each row of the recording table,
+   *  it is carried to the mining table and the prefetch table,
+   *  so that there is no map from every requested obj to its size
+   **/
+  gint64 *rtable_obj_size;
+
   /** row len of the recording table,
    *  which is min_suuport/4 + 1 for now
    **/
@@ -271,14 +299,30 @@ typedef struct {
    **/
   gint8 mtable_row_len;
 
-  /** location for mining table,
-   *  use GArray for quick appending
+  /** location for mining table, it has mtable_size rows,
+   *  which is enough because mining starts when it is full
    **/
-  GArray *mining_table;
+  gint64 *mining_table;
+  gint64 *mtable_obj_size;
 
   /** this is the counter for how many obj/blocks
-   *  in the mining table are ready for mining **/
+   *  in the mining table are ready for mining,
+   *  which is the number of rows in the mining table **/
   gint n_avail_mining;
+
+  /** the mining table sorted by the first timestamp,
+   *  it is mined from row snapshot_next_row,
+   *  and the mining is done when snapshot_next_row reaches
+   *  n_snapshot_row - 1
+   **/
+  gint64 *mining_snapshot;
+  gint64 *snapshot_obj_size;
+  gint n_snapshot_row;
+  gint snapshot_next_row;
+
+  /* buffers for sorting the mining table */
+  gint *sort_idx;
+  gint *sort_buf;
 } rec_mining_t;
 
 typedef struct {
@@ -290,6 +334,7 @@ typedef struct {
   gint cycle_time;
   gint pf_list_size;
   gint mining_threshold;
+  gint mining_step;
 
   gint block_size;
   gint sequential_type;
@@ -314,7 +359,7 @@ typedef struct {
   rec_mining_t *rmtable;
 
   /* prefetch hashtable block -> index in ptable_array*/
-  GHashTable *prefetch_hashtable;
+  id_map_t *prefetch_hashtable;
 
   /* the number of current row in prefetch table */
   gint32 ptable_cur_row;
@@ -327,25 +372,28 @@ typedef struct {
   gboolean ptable_is_full;
 
   /** prefetch table,
-   *  this is a two dimension array for storing associations
+   *  this is a two dimension array for storing associations,
+   *  a row is the obj_id followed by pf_list_size associated obj_ids,
+   *  the associated obj_ids are stored as obj_id + 1, 0 is an empty slot
    **/
   gint64 **ptable_array;
 
+  /** the size of the associated objs, same layout as ptable_array **/
+  gint64 **ptable_obj_size;
+
   /** timestamp, currently reference number **/
   guint64 ts;
 
   // for statistics
-  GHashTable *prefetched_hashtable_Mithril;
+  id_map_t *prefetched_hashtable_Mithril;
   guint64 hit_on_prefetch_Mithril;
   guint64 num_of_prefetch_Mithril;
 
-  GHashTable *prefetched_hashtable_sequential;
+  id_map_t *prefetched_hashtable_sequential;
   guint64 hit_on_prefetch_sequential;
   guint64 num_of_prefetch_sequential;
 
   guint64 num_of_check;
-
-  GHashTable *cache_size_map;
 } Mithril_params_t;
 
 #ifdef __cplusplus
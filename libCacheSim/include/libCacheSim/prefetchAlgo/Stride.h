@@ -0,0 +1,72 @@
+#ifndef STRIDE_H
+#define STRIDE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../../../dataStructure/idMap.h"
+#include "../cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* one sequential or strided stream of block accesses */
+typedef struct stride_stream {
+  /* the last accessed block of the stream */
+  obj_id_t last_block;
+  /* the distance between consecutive accesses, in blocks */
+  int64_t stride;
+  /* the number of consecutive accesses with the same stride */
+  int32_t confidence;
+  /* the number of blocks to prefetch ahead of the last access */
+  int32_t depth;
+  /* the number of strides ahead of last_block that have been prefetched */
+  int32_t n_ahead;
+  /* the number of prefetched blocks that are used since depth changed */
+  int32_t n_hit;
+  /* distinguishes the streams that have used this slot */
+  uint32_t generation;
+  bool valid;
+  /* the request count of the last access, for LRU replacement */
+  int64_t last_access;
+} stride_stream_t;
+
+typedef struct Stride_params {
+  stride_stream_t *streams;
+  int32_t n_stream;
+  int64_t max_stride;
+  int32_t min_confidence;
+  int32_t init_depth;
+  int32_t max_depth;
+  /* 0 means the size of the request that triggers the prefetch */
+  int64_t block_size;
+
+  /* the stream that prefetches for the current request, -1 if none */
+  int32_t pf_stream_idx;
+
+  /* prefetched block that has not been used -> stream slot and generation */
+  id_map_t *prefetched;
+
+  int64_t n_req;
+  /* statistics */
+  int64_t n_prefetch;
+  int64_t n_prefetch_hit;
+  int64_t n_prefetch_unused;
+} Stride_params_t;
+
+typedef struct Stride_init_params {
+  int32_t n_stream;
+  int64_t max_stride;
+  int32_t min_confidence;
+  int32_t init_depth;
+  int32_t max_depth;
+  int64_t block_size;
+} Stride_init_params_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+//
+//  profilerOPT.h
+//  offline optimal (OPT) profilers
+//
+//  the profilers in this file need the next access time of each request,
+//  so they can only be used with oracle traces, e.g., oracleGeneral
+//
+
+#ifndef profilerOPT_h
+#define profilerOPT_h
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "const.h"
+#include "reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint64_t cache_size;
+  int64_t n_req;
+  int64_t n_req_byte;
+
+  /* the number of misses of the offline optimal is in
+   * [n_miss_lower, n_miss_upper], the bounds on object misses and byte
+   * misses come from two different schedules */
+  int64_t n_miss_lower;
+  int64_t n_miss_upper;
+  int64_t n_miss_byte_lower;
+  int64_t n_miss_byte_upper;
+} opt_bound_t;
+
+/**
+ * @brief bound the object and byte miss ratio of the offline optimal for
+ * variable-size objects at multiple cache sizes in one run
+ *
+ * this follows the idea of FOO/PFOO (Berger et al., SIGMETRICS'18),
+ * caching decisions are made on intervals between two consecutive requests
+ * to the same object,
+ *
+ * lower bound: the capacity constraint at each time is relaxed to one
+ *   constraint on the total space-time (cache_size * n_req), the relaxed
+ *   problem is a fractional knapsack solved greedily
+ *
+ * upper bound: intervals are admitted greedily in increasing order of
+ *   space-time per hit (object) or per byte hit (byte) if the cache has space
+ *   during the whole interval, this gives a feasible offline schedule
+ *
+ * the trace is split into n_segments segments, each (cache size, segment)
+ * pair is computed by one thread, intervals crossing segment boundaries are
+ * admitted afterwards (one thread per cache size) in the space left by the
+ * segments, so more segments give more parallelism and a slightly different
+ * upper bound, the lower bound is not affected
+ *
+ * @param reader an oracle reader that provides next_access_vtime
+ * @param num_of_sizes
+ * @param cache_sizes
+ * @param n_segments number of trace segments, 1 gives the tightest bound
+ * @param num_of_threads
+ * @return an array of opt_bound_t (one per cache size),
+ *    the user is responsible for free-ing the result
+ */
+opt_bound_t *get_opt_miss_bounds(reader_t *reader, int num_of_sizes,
+                                 const uint64_t *cache_sizes, int n_segments,
+                                 int num_of_threads);
+
+/**
+ * @brief the Belady (MIN) object miss ratio of unit-size objects at
+ * cache size 0 ~ size computed in one pass
+ *
+ * Belady is a stack algorithm for unit-size objects, so we use the Mattson
+ * stack with next access time as the priority, a request at stack depth d is
+ * a hit for all cache sizes >= d. The stack is truncated at depth size
+ *
+ * each request scans and shifts the stack down to the depth of the object (or
+ * the whole stack on a miss), so a request costs O(size) and the profiler
+ * costs O(n_req * size), this is fast for up to ~1e5 objects but becomes
+ * quadratic for large caches, simulate Belady at a few sizes instead
+ *
+ * @param reader an oracle reader that provides next_access_vtime
+ * @param size the largest cache size (number of objects)
+ * @return an array of size + 1 miss ratios, the i-th is for cache size i,
+ *    the user is responsible for free-ing the result with g_free
+ */
+double *get_belady_obj_miss_ratio(reader_t *reader, int64_t size);
+
+/**
+ * @brief approximate Belady miss ratio of variable-size objects at multiple
+ * cache sizes in one pass
+ *
+ * this uses the same priority stack as get_belady_obj_miss_ratio, but the
+ * depth of a request is the number of bytes above and including the object,
+ * a request is a hit for all cache sizes >= the byte depth. Belady is not a
+ * stack algorithm for variable-size objects, so this is an approximation
+ * (use get_opt_miss_bounds for bounds on the optimal)
+ *
+ * like get_belady_obj_miss_ratio, a request costs O(the number of objects in
+ * the largest cache size), so the profiler is quadratic for large caches
+ *
+ * @param reader an oracle reader that provides next_access_vtime
+ * @param num_of_sizes
+ * @param cache_sizes
+ * @return an array of cache_stat_t (one per cache size),
+ *    the user is responsible for free-ing the result
+ */
+cache_stat_t *get_belady_miss_ratio_at_multi_sizes(reader_t *reader,
+                                                   int num_of_sizes,
+                                                   const uint64_t *cache_sizes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* profilerOPT_h */
@@ -76,6 +76,10 @@ typedef struct reader {
   /************* common fields *************/
   uint64_t n_read_req;
   uint64_t n_total_req; /* number of requests in the trace */
+  /* number of objects and bytes of objects declared in the trace header,
+   * e.g., LCS trace, 0 if unknown */
+  int64_t n_total_obj;
+  int64_t n_total_obj_byte;
   char *trace_path;
   size_t file_size;
   reader_init_param_t init_params;
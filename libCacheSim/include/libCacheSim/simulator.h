@@ -9,6 +9,7 @@
 #define simulator_h
 
 #include "cache.h"
+#include "metricsRecorder.h"
 #include "reader.h"
 
 #ifdef __cplusplus
@@ -35,6 +36,9 @@ extern "C" {
  * @param warmup_reader
  * @param warmup_frac
  * @param num_of_threads
+ * @param metrics_recorder if not NULL, record the metrics over time of each
+ *    cache, the cache_idx in the output is the index of the cache size, the
+ *    recorder is not owned by the simulator
  * @return
  */
 cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
@@ -42,7 +46,8 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
                                       const uint64_t *cache_sizes,
                                       reader_t *warmup_reader,
                                       double warmup_frac, int warmup_sec,
-                                      int num_of_threads);
+                                      int num_of_threads,
+                                      metrics_recorder_t *metrics_recorder);
 
 /**
  * this function performs cache_size/step_size simulations to obtain miss ratio,
@@ -80,6 +85,9 @@ cache_stat_t *simulate_at_multi_sizes_with_step_size(
  * @param warmup_reader
  * @param warmup_frac
  * @param num_of_threads
+ * @param metrics_recorder if not NULL, record the metrics over time of each
+ *    cache, the cache_idx in the output is the index of the cache in caches,
+ *    the recorder is not owned by the simulator
  * @return
  */
 cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
@@ -87,7 +95,64 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
                                          reader_t *warmup_reader,
                                          double warmup_frac, int warmup_sec,
                                          int num_of_threads, 
-                                         bool free_cache_when_finish);
+                                         bool free_cache_when_finish,
+                                         metrics_recorder_t *metrics_recorder);
+
+/**
+ * same as simulate_with_multi_caches, but each thread simulates a group of
+ * caches in lock step: it reads a batch of requests that fits in the L2 cache
+ * and feeds the batch to every cache in the group before reading the next
+ * batch, the group size is chosen so that the metadata of the caches fits in
+ * the LLC, this reduces the memory traffic when simulating many small caches
+ *
+ * @param reader
+ * @param caches
+ * @param num_of_caches
+ * @param warmup_reader
+ * @param warmup_frac
+ * @param num_of_threads
+ * @return
+ */
+cache_stat_t *simulate_with_multi_caches_tiled(
+    reader_t *reader, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    int num_of_threads, bool free_cache_when_finish,
+    metrics_recorder_t *metrics_recorder);
+
+/* a branch of a warm cache, the fields that are NULL are not changed */
+typedef struct {
+  /* passed to cache->set_params, e.g., "move-to-main-threshold=1" */
+  const char *eviction_params;
+  /* replace the admissioner of the cache */
+  const char *admission_algo;
+  const char *admission_params;
+} sim_branch_t;
+
+/**
+ * warm up one cache using the first prefix_frac of the requests, then fork
+ * a child process for each branch, the child changes the parameters of the
+ * warm cache and simulates the rest of the trace, the children share the warm
+ * cache with the parent copy-on-write, so neither the memory nor the time of
+ * the warm up is paid per branch
+ *
+ * the prefix is reported as warm up (n_warmup_req), at most num_of_threads
+ * children run at the same time, the cache is not freed and stays at the
+ * end of the prefix, this should not be called while other threads are
+ * simulating
+ *
+ * @param reader
+ * @param cache
+ * @param prefix_frac
+ * @param branches
+ * @param num_of_branches
+ * @param num_of_threads
+ * @return an array of num_of_branches results, freed by the user
+ */
+cache_stat_t *simulate_with_forked_branches(reader_t *reader, cache_t *cache,
+                                            double prefix_frac,
+                                            const sim_branch_t branches[],
+                                            int num_of_branches,
+                                            int num_of_threads);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,274 @@
+//
+//  cacheCluster.c
+//  libCacheSim
+//
+//  the dispatcher (the calling thread) reads the trace and hashes each request
+//  to its servers on the consistent hash ring, then pushes the request into
+//  the queue of each server, each server is owned by exactly one worker, so a
+//  server sees its requests in trace order no matter how many workers run
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../include/libCacheSim/cacheCluster.h"
+
+#include <sched.h>
+
+#include "../dataStructure/consistentHash.h"
+#include "../dataStructure/spscQueue.h"
+
+/* the number of requests that can be queued for one server, power of 2 */
+#define SERVER_QUEUE_SIZE 4096
+
+/* the fields of a request that a server needs */
+typedef struct {
+  int64_t clock_time;
+  uint64_t hv;
+  obj_id_t obj_id;
+  int64_t obj_size;
+  int64_t next_access_vtime;
+  int32_t ttl;
+  req_op_e op;
+  /* whether the server serves the request or receives it as a replica */
+  bool primary;
+} server_req_t;
+
+typedef struct {
+  spsc_queue_t *queue;
+  cache_t *cache;
+  cluster_server_stat_t stat;
+} server_t;
+
+typedef struct {
+  server_t *servers;
+  int n_server;
+  int n_worker;
+  int worker_id;
+} cluster_worker_params_t;
+
+/* serve the queued requests of a server, return the number served */
+static int64_t _drain(server_t *server, request_t *req) {
+  int64_t n = 0;
+  server_req_t *item;
+  while ((item = spsc_queue_peek(server->queue)) != NULL) {
+    req->clock_time = item->clock_time;
+    req->hv = item->hv;
+    req->obj_id = item->obj_id;
+    req->obj_size = item->obj_size;
+    req->next_access_vtime = item->next_access_vtime;
+    req->ttl = item->ttl;
+    req->op = item->op;
+    bool primary = item->primary;
+    spsc_queue_pop(server->queue);
+
+    bool hit = server->cache->get(server->cache, req);
+    if (primary) {
+      server->stat.n_req += 1;
+      server->stat.n_req_byte += req->obj_size;
+      if (hit) {
+        server->stat.n_hit += 1;
+        server->stat.n_hit_byte += req->obj_size;
+      }
+    } else {
+      server->stat.n_replica_req += 1;
+    }
+    n++;
+  }
+  return n;
+}
+
+static gpointer _cluster_worker(gpointer data) {
+  cluster_worker_params_t *params = (cluster_worker_params_t *)data;
+  request_t *req = new_request();
+
+  while (true) {
+    int64_t n_served = 0;
+    bool finished = true;
+    for (int i = params->worker_id; i < params->n_server;
+         i += params->n_worker) {
+      n_served += _drain(&params->servers[i], req);
+      finished = finished && spsc_queue_is_finished(params->servers[i].queue);
+    }
+    if (finished) break;
+    if (n_served == 0) sched_yield();
+  }
+
+  free_request(req);
+  return NULL;
+}
+
+cache_cluster_t *create_cache_cluster(cache_t **caches, const double *weights,
+                                      int n_server, int replication) {
+  if (n_server <= 0) {
+    ERROR("cache cluster needs at least one server\n");
+  }
+  if (replication <= 0 || replication > n_server) {
+    ERROR("replication %d must be in [1, %d]\n", replication, n_server);
+  }
+
+  cache_cluster_t *cluster = my_malloc(cache_cluster_t);
+  memset(cluster, 0, sizeof(cache_cluster_t));
+  cluster->n_server = n_server;
+  cluster->replication = replication;
+  cluster->caches = my_malloc_n(cache_t *, n_server);
+  memcpy(cluster->caches, caches, sizeof(cache_t *) * n_server);
+  cluster->available = my_malloc_n(bool, n_server);
+  for (int i = 0; i < n_server; i++) cluster->available[i] = true;
+
+  double *w = NULL;
+  if (weights != NULL) {
+    w = my_malloc_n(double, n_server);
+    memcpy(w, weights, sizeof(double) * n_server);
+  }
+  cluster->ring = ch_ring_create_ring(n_server, w);
+  if (w != NULL) my_free(sizeof(double) * n_server, w);
+
+  return cluster;
+}
+
+void free_cache_cluster(cache_cluster_t *cluster) {
+  for (int i = 0; i < cluster->n_server; i++) {
+    cluster->caches[i]->cache_free(cluster->caches[i]);
+  }
+  ch_ring_destroy_ring(cluster->ring);
+  my_free(sizeof(cache_t *) * cluster->n_server, cluster->caches);
+  my_free(sizeof(bool) * cluster->n_server, cluster->available);
+  my_free(sizeof(cache_cluster_t), cluster);
+}
+
+static void _apply_event(cache_cluster_t *cluster,
+                         const cluster_event_t *event) {
+  if (event->server_id < 0 || event->server_id >= cluster->n_server) {
+    ERROR("cluster event on server %d, but the cluster has %d servers\n",
+          event->server_id, cluster->n_server);
+  }
+
+  bool available = event->type == CLUSTER_EVENT_ADD_SERVER;
+  if (cluster->available[event->server_id] == available) {
+    WARN("server %d is already %s before request %ld\n", event->server_id,
+         available ? "in the cluster" : "removed", (long)event->n_req);
+  }
+  cluster->available[event->server_id] = available;
+  DEBUG("%s server %d before request %ld\n", available ? "add" : "remove",
+        event->server_id, (long)event->n_req);
+}
+
+cluster_stat_t *simulate_cache_cluster(cache_cluster_t *cluster,
+                                       reader_t *reader,
+                                       const cluster_event_t *events,
+                                       int n_event, int num_of_threads) {
+  int n_server = cluster->n_server;
+  int n_worker = num_of_threads;
+  if (n_worker < 1) n_worker = 1;
+  if (n_worker > n_server) n_worker = n_server;
+
+  server_t *servers = my_malloc_n(server_t, n_server);
+  memset(servers, 0, sizeof(server_t) * n_server);
+  for (int i = 0; i < n_server; i++) {
+    servers[i].queue =
+        create_spsc_queue(SERVER_QUEUE_SIZE, sizeof(server_req_t));
+    servers[i].cache = cluster->caches[i];
+  }
+
+  cluster_worker_params_t *params =
+      my_malloc_n(cluster_worker_params_t, n_worker);
+  GThread **workers = my_malloc_n(GThread *, n_worker);
+  for (int i = 0; i < n_worker; i++) {
+    params[i].servers = servers;
+    params[i].n_server = n_server;
+    params[i].n_worker = n_worker;
+    params[i].worker_id = i;
+    workers[i] = g_thread_new("cacheCluster", _cluster_worker, &params[i]);
+  }
+
+  cluster_stat_t *stat = my_malloc(cluster_stat_t);
+  memset(stat, 0, sizeof(cluster_stat_t));
+  stat->n_server = n_server;
+  stat->server_stats = my_malloc_n(cluster_server_stat_t, n_server);
+
+  unsigned int *idxs = my_malloc_n(unsigned int, cluster->replication);
+  request_t *req = new_request();
+  server_req_t item;
+  int next_event = 0;
+  int64_t n_req = 0;
+
+  read_one_req(reader, req);
+  while (req->valid) {
+    while (next_event < n_event && events[next_event].n_req <= n_req) {
+      _apply_event(cluster, &events[next_event++]);
+    }
+
+    unsigned int n = ch_ring_get_available_servers_from_uint64(
+        req->obj_id, cluster->ring, cluster->replication, idxs,
+        cluster->available);
+    if (n == 0) {
+      stat->n_unserved += 1;
+      stat->n_miss += 1;
+      stat->n_miss_byte += req->obj_size;
+    }
+
+    item.clock_time = req->clock_time;
+    item.hv = req->hv;
+    item.obj_id = req->obj_id;
+    item.obj_size = req->obj_size;
+    item.next_access_vtime = req->next_access_vtime;
+    item.ttl = req->ttl;
+    item.op = req->op;
+    for (unsigned int i = 0; i < n; i++) {
+      item.primary = i == 0;
+      spsc_queue_push(servers[idxs[i]].queue, &item);
+    }
+
+    stat->n_req += 1;
+    stat->n_req_byte += req->obj_size;
+    n_req += 1;
+    read_one_req(reader, req);
+  }
+  /* the events after the end of the trace still change the membership */
+  while (next_event < n_event) {
+    _apply_event(cluster, &events[next_event++]);
+  }
+
+  for (int i = 0; i < n_server; i++) {
+    spsc_queue_close(servers[i].queue);
+  }
+  for (int i = 0; i < n_worker; i++) {
+    g_thread_join(workers[i]);
+  }
+
+  int64_t max_served = 0;
+  for (int i = 0; i < n_server; i++) {
+    cluster_server_stat_t *s = &servers[i].stat;
+    stat->server_stats[i] = *s;
+    stat->n_miss += s->n_req - s->n_hit;
+    stat->n_miss_byte += s->n_req_byte - s->n_hit_byte;
+    if (s->n_req > max_served) max_served = s->n_req;
+  }
+  int64_t n_served = stat->n_req - stat->n_unserved;
+  if (n_served > 0) {
+    stat->load_imbalance =
+        (double)max_served / ((double)n_served / (double)n_server);
+  }
+
+  free_request(req);
+  my_free(sizeof(unsigned int) * cluster->replication, idxs);
+  my_free(sizeof(GThread *) * n_worker, workers);
+  my_free(sizeof(cluster_worker_params_t) * n_worker, params);
+  for (int i = 0; i < n_server; i++) {
+    free_spsc_queue(servers[i].queue);
+  }
+  my_free(sizeof(server_t) * n_server, servers);
+
+  return stat;
+}
+
+void free_cluster_stat(cluster_stat_t *stat) {
+  my_free(sizeof(cluster_server_stat_t) * stat->n_server, stat->server_stats);
+  my_free(sizeof(cluster_stat_t), stat);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,422 @@
+//
+//  cacheHierarchy.c
+//  libCacheSim
+//
+//  each cache of the hierarchy is a stage running on its own thread, a first
+//  level stage reads its trace, the other stages read the queues from the
+//  stages of the level below, a stage passes the misses, the writes and the
+//  evicted objects to every stage of the next level through single-producer
+//  single-consumer queues
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../include/libCacheSim/cacheHierarchy.h"
+
+#include <sched.h>
+
+#include "../dataStructure/idMap.h"
+#include "../dataStructure/spscQueue.h"
+
+/* the number of messages that can be queued between two stages */
+#define HIERARCHY_QUEUE_SIZE 8192
+
+typedef enum {
+  HIER_MSG_READ,
+  HIER_MSG_WRITE,
+  /* an object evicted from the level above in an exclusive hierarchy */
+  HIER_MSG_DEMOTE,
+} hier_msg_type_e;
+
+typedef struct {
+  /* the largest clock time of the producer so far, the streams are merged by
+   * this key, which does not decrease even if the trace is not sorted */
+  int64_t key;
+  int64_t clock_time;
+  obj_id_t obj_id;
+  int64_t obj_size;
+  int32_t ttl;
+  int8_t type;
+  /* whether a demoted object is dirty */
+  bool dirty;
+} hier_msg_t;
+
+typedef struct {
+  int level;
+  cache_t *cache;
+  /* the first level reads the trace, other levels read the inputs */
+  reader_t *reader;
+  spsc_queue_t **inputs;
+  int n_input;
+  /* the queues to every stage of the next level, none for the last level */
+  spsc_queue_t **outputs;
+  int n_output;
+  int64_t out_key;
+
+  /* the level gives up the objects it passes to the level above */
+  bool exclusive;
+  /* the level receives the evictions of the level above and demotes its own
+   * evictions */
+  bool demote;
+  bool write_back;
+  /* the objects that are written but not written back, write-back only */
+  id_map_t *dirty;
+
+  /* the request being served, its time is used for the evicted objects */
+  request_t *req;
+  hierarchy_cache_stat_t stat;
+} hier_stage_t;
+
+static inline bool _is_write(req_op_e op) {
+  switch (op) {
+    case OP_SET:
+    case OP_ADD:
+    case OP_CAS:
+    case OP_REPLACE:
+    case OP_APPEND:
+    case OP_PREPEND:
+    case OP_INCR:
+    case OP_DECR:
+    case OP_WRITE:
+    case OP_UPDATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void _emit(hier_stage_t *stage, hier_msg_type_e type, obj_id_t obj_id,
+                  int64_t obj_size, bool dirty) {
+  if (stage->req->clock_time > stage->out_key) {
+    stage->out_key = stage->req->clock_time;
+  }
+  hier_msg_t msg = {.key = stage->out_key,
+                    .clock_time = stage->req->clock_time,
+                    .obj_id = obj_id,
+                    .obj_size = obj_size,
+                    .ttl = stage->req->ttl,
+                    .type = (int8_t)type,
+                    .dirty = dirty};
+  for (int i = 0; i < stage->n_output; i++) {
+    spsc_queue_push(stage->outputs[i], &msg);
+  }
+}
+
+/* pass a read or write to the next level, or to the backend at the last
+ * level */
+static inline void _forward(hier_stage_t *stage, hier_msg_type_e type,
+                            obj_id_t obj_id, int64_t obj_size) {
+  stage->stat.n_forward += 1;
+  stage->stat.n_forward_byte += obj_size;
+  if (stage->n_output > 0) _emit(stage, type, obj_id, obj_size, false);
+}
+
+static inline void _write_back(hier_stage_t *stage, obj_id_t obj_id,
+                               int64_t obj_size) {
+  stage->stat.n_writeback += 1;
+  stage->stat.n_writeback_byte += obj_size;
+  if (stage->n_output > 0) {
+    _emit(stage, HIER_MSG_WRITE, obj_id, obj_size, false);
+  }
+}
+
+static inline bool _clear_dirty(hier_stage_t *stage, obj_id_t obj_id) {
+  return stage->write_back && id_map_remove(stage->dirty, obj_id);
+}
+
+static void _on_evict(cache_t *cache, const cache_obj_t *obj, void *data) {
+  (void)cache;
+  hier_stage_t *stage = (hier_stage_t *)data;
+  stage->stat.n_eviction += 1;
+
+  bool dirty = _clear_dirty(stage, obj->obj_id);
+  if (stage->demote && stage->n_output > 0) {
+    _emit(stage, HIER_MSG_DEMOTE, obj->obj_id, obj->obj_size, dirty);
+  } else if (dirty) {
+    _write_back(stage, obj->obj_id, obj->obj_size);
+  }
+}
+
+/* the evictions are only observed through cache_evict_base, an algorithm that
+ * evicts from its sub-caches would silently lose the demotions and the
+ * write-backs */
+static bool _get(hier_stage_t *stage) {
+  int64_t n_eviction = stage->cache->n_eviction;
+  int64_t n_observed = stage->stat.n_eviction;
+  bool hit = stage->cache->get(stage->cache, stage->req);
+  if ((stage->demote || stage->write_back) &&
+      stage->cache->n_eviction > n_eviction &&
+      stage->stat.n_eviction == n_observed) {
+    ERROR(
+        "%s does not evict through cache_evict_base, it cannot be used in an "
+        "exclusive or write-back hierarchy\n",
+        stage->cache->cache_name);
+  }
+  return hit;
+}
+
+static void _serve_read(hier_stage_t *stage) {
+  request_t *req = stage->req;
+  stage->stat.n_req += 1;
+  stage->stat.n_req_byte += req->obj_size;
+
+  if (stage->exclusive) {
+    bool hit = stage->cache->find(stage->cache, req, false) != NULL;
+    if (hit) {
+      stage->stat.n_hit += 1;
+      stage->stat.n_hit_byte += req->obj_size;
+      stage->cache->remove(stage->cache, req->obj_id);
+      /* the object moves to the level above clean */
+      if (_clear_dirty(stage, req->obj_id)) {
+        _write_back(stage, req->obj_id, req->obj_size);
+      }
+    } else {
+      _forward(stage, HIER_MSG_READ, req->obj_id, req->obj_size);
+    }
+    return;
+  }
+
+  if (_get(stage)) {
+    stage->stat.n_hit += 1;
+    stage->stat.n_hit_byte += req->obj_size;
+  } else {
+    /* the object may have expired while dirty */
+    _clear_dirty(stage, req->obj_id);
+    _forward(stage, HIER_MSG_READ, req->obj_id, req->obj_size);
+  }
+}
+
+static void _serve_write(hier_stage_t *stage) {
+  request_t *req = stage->req;
+  stage->stat.n_req += 1;
+  stage->stat.n_req_byte += req->obj_size;
+  stage->stat.n_write += 1;
+
+  if (stage->exclusive) {
+    /* only the level above keeps the new data */
+    if (stage->cache->find(stage->cache, req, false) != NULL) {
+      stage->stat.n_hit += 1;
+      stage->stat.n_hit_byte += req->obj_size;
+      stage->cache->remove(stage->cache, req->obj_id);
+      _clear_dirty(stage, req->obj_id);
+    }
+    _forward(stage, HIER_MSG_WRITE, req->obj_id, req->obj_size);
+    return;
+  }
+
+  if (_get(stage)) {
+    stage->stat.n_hit += 1;
+    stage->stat.n_hit_byte += req->obj_size;
+  }
+  if (stage->write_back) {
+    id_map_put(stage->dirty, req->obj_id, 1);
+  } else {
+    _forward(stage, HIER_MSG_WRITE, req->obj_id, req->obj_size);
+  }
+}
+
+static void _serve_demotion(hier_stage_t *stage, bool dirty) {
+  stage->stat.n_demotion += 1;
+  _clear_dirty(stage, stage->req->obj_id);
+  _get(stage);
+  if (dirty && stage->write_back) {
+    id_map_put(stage->dirty, stage->req->obj_id, 1);
+  }
+}
+
+static gpointer _first_level_stage(gpointer data) {
+  hier_stage_t *stage = (hier_stage_t *)data;
+  request_t *req = stage->req;
+
+  read_one_req(stage->reader, req);
+  while (req->valid) {
+    if (_is_write(req->op)) {
+      _serve_write(stage);
+    } else {
+      _serve_read(stage);
+    }
+    read_one_req(stage->reader, req);
+  }
+
+  for (int i = 0; i < stage->n_output; i++) spsc_queue_close(stage->outputs[i]);
+  return NULL;
+}
+
+/* return the input with the smallest (key, input index), -1 if all inputs
+ * are finished, -2 if an input that is not finished is empty */
+static int _next_input(hier_stage_t *stage) {
+  int best = -1;
+  const hier_msg_t *best_msg = NULL;
+  for (int i = 0; i < stage->n_input; i++) {
+    const hier_msg_t *msg = spsc_queue_peek(stage->inputs[i]);
+    if (msg == NULL) {
+      if (spsc_queue_is_finished(stage->inputs[i])) continue;
+      return -2;
+    }
+    if (best_msg == NULL || msg->key < best_msg->key) {
+      best = i;
+      best_msg = msg;
+    }
+  }
+  return best;
+}
+
+static gpointer _upper_level_stage(gpointer data) {
+  hier_stage_t *stage = (hier_stage_t *)data;
+  request_t *req = stage->req;
+
+  while (true) {
+    int idx = _next_input(stage);
+    if (idx == -1) break;
+    if (idx == -2) {
+      sched_yield();
+      continue;
+    }
+
+    const hier_msg_t *msg = spsc_queue_peek(stage->inputs[idx]);
+    req->clock_time = msg->clock_time;
+    req->obj_id = msg->obj_id;
+    req->obj_size = msg->obj_size;
+    req->ttl = msg->ttl;
+    req->op = msg->type == HIER_MSG_WRITE ? OP_SET : OP_GET;
+    hier_msg_type_e type = (hier_msg_type_e)msg->type;
+    bool dirty = msg->dirty;
+    spsc_queue_pop(stage->inputs[idx]);
+
+    if (type == HIER_MSG_READ) {
+      _serve_read(stage);
+    } else if (type == HIER_MSG_WRITE) {
+      _serve_write(stage);
+    } else {
+      _serve_demotion(stage, dirty);
+    }
+  }
+
+  for (int i = 0; i < stage->n_output; i++) spsc_queue_close(stage->outputs[i]);
+  return NULL;
+}
+
+hierarchy_stat_t *simulate_cache_hierarchy(
+    reader_t **readers, const hierarchy_level_t *levels, int n_level,
+    hierarchy_inclusion_e inclusion, hierarchy_write_policy_e write_policy) {
+  if (n_level <= 0) {
+    ERROR("cache hierarchy needs at least one level\n");
+  }
+  for (int i = 0; i < n_level; i++) {
+    if (levels[i].n_cache <= 0) {
+      ERROR("level %d of the cache hierarchy has no cache\n", i);
+    }
+    if (i > 0 && i < n_level - 1 && levels[i].n_cache != 1) {
+      ERROR("only the first and the last level can have several caches\n");
+    }
+  }
+
+  bool exclusive = inclusion == HIERARCHY_EXCLUSIVE;
+  hier_stage_t **stages = my_malloc_n(hier_stage_t *, n_level);
+  for (int i = 0; i < n_level; i++) {
+    stages[i] = my_malloc_n(hier_stage_t, levels[i].n_cache);
+    memset(stages[i], 0, sizeof(hier_stage_t) * levels[i].n_cache);
+    for (int j = 0; j < levels[i].n_cache; j++) {
+      hier_stage_t *stage = &stages[i][j];
+      stage->level = i;
+      stage->cache = levels[i].caches[j];
+      stage->reader = i == 0 ? readers[j] : NULL;
+      stage->exclusive = exclusive && i > 0;
+      stage->demote = exclusive;
+      stage->write_back = write_policy == HIERARCHY_WRITE_BACK;
+      if (stage->write_back) stage->dirty = create_id_map(1024);
+      stage->req = new_request();
+      snprintf(stage->stat.cache_name, CACHE_NAME_ARRAY_LEN, "%s",
+               stage->cache->cache_name);
+
+      if (stage->cache->evict_listener != NULL) {
+        WARN("%s already has an eviction listener, it is replaced\n",
+             stage->cache->cache_name);
+      }
+      stage->cache->evict_listener = _on_evict;
+      stage->cache->evict_listener_data = stage;
+    }
+  }
+
+  /* the queue from stage j of level i - 1 to stage k of level i is
+   * stages[i][k].inputs[j] and stages[i - 1][j].outputs[k] */
+  for (int i = 1; i < n_level; i++) {
+    for (int j = 0; j < levels[i - 1].n_cache; j++) {
+      stages[i - 1][j].n_output = levels[i].n_cache;
+      stages[i - 1][j].outputs =
+          my_malloc_n(spsc_queue_t *, levels[i].n_cache);
+    }
+    for (int k = 0; k < levels[i].n_cache; k++) {
+      stages[i][k].n_input = levels[i - 1].n_cache;
+      stages[i][k].inputs = my_malloc_n(spsc_queue_t *, levels[i - 1].n_cache);
+      for (int j = 0; j < levels[i - 1].n_cache; j++) {
+        spsc_queue_t *queue =
+            create_spsc_queue(HIERARCHY_QUEUE_SIZE, sizeof(hier_msg_t));
+        stages[i][k].inputs[j] = queue;
+        stages[i - 1][j].outputs[k] = queue;
+      }
+    }
+  }
+
+  int n_thread = 0;
+  for (int i = 0; i < n_level; i++) n_thread += levels[i].n_cache;
+  GThread **threads = my_malloc_n(GThread *, n_thread);
+  int t = 0;
+  for (int i = 0; i < n_level; i++) {
+    for (int j = 0; j < levels[i].n_cache; j++) {
+      threads[t++] = g_thread_new(
+          "cacheHierarchy", i == 0 ? _first_level_stage : _upper_level_stage,
+          &stages[i][j]);
+    }
+  }
+  for (t = 0; t < n_thread; t++) g_thread_join(threads[t]);
+  my_free(sizeof(GThread *) * n_thread, threads);
+
+  hierarchy_stat_t *stat = my_malloc(hierarchy_stat_t);
+  stat->n_level = n_level;
+  stat->n_cache = my_malloc_n(int, n_level);
+  stat->cache_stats = my_malloc_n(hierarchy_cache_stat_t *, n_level);
+  for (int i = 0; i < n_level; i++) {
+    stat->n_cache[i] = levels[i].n_cache;
+    stat->cache_stats[i] =
+        my_malloc_n(hierarchy_cache_stat_t, levels[i].n_cache);
+    for (int j = 0; j < levels[i].n_cache; j++) {
+      hier_stage_t *stage = &stages[i][j];
+      stat->cache_stats[i][j] = stage->stat;
+
+      stage->cache->evict_listener = NULL;
+      stage->cache->evict_listener_data = NULL;
+      if (stage->dirty != NULL) free_id_map(stage->dirty);
+      free_request(stage->req);
+      for (int k = 0; k < stage->n_input; k++) {
+        free_spsc_queue(stage->inputs[k]);
+      }
+      if (stage->n_input > 0) {
+        my_free(sizeof(spsc_queue_t *) * stage->n_input, stage->inputs);
+      }
+      if (stage->n_output > 0) {
+        my_free(sizeof(spsc_queue_t *) * stage->n_output, stage->outputs);
+      }
+    }
+    my_free(sizeof(hier_stage_t) * levels[i].n_cache, stages[i]);
+  }
+  my_free(sizeof(hier_stage_t *) * n_level, stages);
+
+  return stat;
+}
+
+void free_hierarchy_stat(hierarchy_stat_t *stat) {
+  for (int i = 0; i < stat->n_level; i++) {
+    my_free(sizeof(hierarchy_cache_stat_t) * stat->n_cache[i],
+            stat->cache_stats[i]);
+  }
+  my_free(sizeof(hierarchy_cache_stat_t *) * stat->n_level, stat->cache_stats);
+  my_free(sizeof(int) * stat->n_level, stat->n_cache);
+  my_free(sizeof(hierarchy_stat_t), stat);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,304 @@
+//
+// record the metrics of each cache over time, see metricsRecorder.h for the
+// output format
+//
+
+#include "../include/libCacheSim/metricsRecorder.h"
+
+#include <errno.h>
+#include <glib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/mem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the size of the stdio buffer of the output file */
+#define METRICS_WRITE_BUF_SIZE (1024 * 1024)
+
+typedef enum {
+  METRICS_RECORD_CACHE = 1,
+  METRICS_RECORD_WINDOW = 2,
+  /* tells the writer to stop */
+  METRICS_RECORD_STOP = 3,
+} metrics_record_type_e;
+
+typedef struct {
+  int16_t bucket;
+  int64_t cnt;
+} metrics_age_bucket_t;
+
+typedef struct {
+  metrics_record_type_e type;
+  int32_t cache_idx;
+  int64_t cache_size;
+  char cache_name[CACHE_NAME_ARRAY_LEN];
+
+  int64_t window_idx;
+  int64_t start_rtime;
+  int64_t end_rtime;
+  int64_t n_req;
+  int64_t n_miss;
+  int64_t n_req_byte;
+  int64_t n_miss_byte;
+  int64_t n_obj;
+  int64_t occupied_byte;
+  int64_t n_eviction;
+  int32_t n_age_bucket;
+  metrics_age_bucket_t age[];
+} metrics_record_t;
+
+struct metrics_recorder {
+  FILE *ofile;
+  char *ofile_buf;
+  metrics_format_e format;
+  int64_t window_sec;
+  int64_t window_req;
+
+  GAsyncQueue *queue;
+  GThread *writer;
+
+  /* used by the writer only, cache_idx -> cache name and size */
+  GHashTable *caches;
+  int64_t n_record;
+  bool has_error;
+};
+
+/**************** writer ****************/
+static void _write_csv(metrics_recorder_t *recorder,
+                       const metrics_record_t *r) {
+  const metrics_record_t *cache =
+      g_hash_table_lookup(recorder->caches, GINT_TO_POINTER(r->cache_idx));
+  FILE *f = recorder->ofile;
+
+  fprintf(f,
+          "%d,%s,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%.6lf,%.6lf,%lld,"
+          "%lld,%lld,",
+          r->cache_idx, cache != NULL ? cache->cache_name : "",
+          (long long)(cache != NULL ? cache->cache_size : 0),
+          (long long)r->window_idx, (long long)r->start_rtime,
+          (long long)r->end_rtime, (long long)r->n_req, (long long)r->n_miss,
+          (long long)r->n_req_byte, (long long)r->n_miss_byte,
+          r->n_req > 0 ? (double)r->n_miss / (double)r->n_req : 0,
+          r->n_req_byte > 0 ? (double)r->n_miss_byte / (double)r->n_req_byte
+                            : 0,
+          (long long)r->n_obj, (long long)r->occupied_byte,
+          (long long)r->n_eviction);
+  for (int i = 0; i < r->n_age_bucket; i++) {
+    fprintf(f, "%s%d:%lld", i == 0 ? "" : ";", r->age[i].bucket,
+            (long long)r->age[i].cnt);
+  }
+  fputc('\n', f);
+}
+
+static void _write_binary(metrics_recorder_t *recorder,
+                          const metrics_record_t *r) {
+  FILE *f = recorder->ofile;
+  uint8_t type = (uint8_t)r->type;
+  fwrite(&type, sizeof(type), 1, f);
+  fwrite(&r->cache_idx, sizeof(int32_t), 1, f);
+
+  if (r->type == METRICS_RECORD_CACHE) {
+    uint16_t name_len = (uint16_t)strlen(r->cache_name);
+    fwrite(&r->cache_size, sizeof(int64_t), 1, f);
+    fwrite(&name_len, sizeof(name_len), 1, f);
+    fwrite(r->cache_name, 1, name_len, f);
+    return;
+  }
+
+  /* the fields from window_idx to n_eviction are contiguous */
+  fwrite(&r->window_idx, sizeof(int64_t), 10, f);
+  fwrite(&r->n_age_bucket, sizeof(int32_t), 1, f);
+  for (int i = 0; i < r->n_age_bucket; i++) {
+    fwrite(&r->age[i].bucket, sizeof(int16_t), 1, f);
+    fwrite(&r->age[i].cnt, sizeof(int64_t), 1, f);
+  }
+}
+
+static gpointer _metrics_writer(gpointer data) {
+  metrics_recorder_t *recorder = (metrics_recorder_t *)data;
+
+  while (true) {
+    metrics_record_t *r = g_async_queue_pop(recorder->queue);
+    if (r->type == METRICS_RECORD_STOP) {
+      g_free(r);
+      break;
+    }
+
+    if (r->type == METRICS_RECORD_CACHE) {
+      /* the cache record is kept to look up the name */
+      g_hash_table_insert(recorder->caches, GINT_TO_POINTER(r->cache_idx), r);
+      if (recorder->format == METRICS_FORMAT_BINARY) {
+        _write_binary(recorder, r);
+      }
+      continue;
+    }
+
+    if (recorder->format == METRICS_FORMAT_CSV) {
+      _write_csv(recorder, r);
+    } else {
+      _write_binary(recorder, r);
+    }
+    recorder->n_record += 1;
+    g_free(r);
+  }
+
+  if (ferror(recorder->ofile)) {
+    recorder->has_error = true;
+  }
+  return NULL;
+}
+
+/**************** recorder ****************/
+metrics_format_e metrics_format_from_path(const char *ofilepath) {
+  size_t len = strlen(ofilepath);
+  if (len >= 4 && strcasecmp(ofilepath + len - 4, ".csv") == 0) {
+    return METRICS_FORMAT_CSV;
+  }
+  return METRICS_FORMAT_BINARY;
+}
+
+metrics_recorder_t *create_metrics_recorder(const char *ofilepath,
+                                            metrics_format_e format,
+                                            int64_t window_sec,
+                                            int64_t window_req) {
+  if (window_sec <= 0 && window_req <= 0) {
+    ERROR("metrics recorder requires a window in seconds or requests\n");
+    return NULL;
+  }
+
+  metrics_recorder_t *recorder = my_malloc(metrics_recorder_t);
+  memset(recorder, 0, sizeof(metrics_recorder_t));
+  recorder->format = format;
+  recorder->window_sec = window_sec;
+  recorder->window_req = window_req;
+
+  recorder->ofile = fopen(ofilepath, "wb");
+  if (recorder->ofile == NULL) {
+    ERROR("cannot open %s: %s\n", ofilepath, strerror(errno));
+    my_free(sizeof(metrics_recorder_t), recorder);
+    return NULL;
+  }
+  recorder->ofile_buf = malloc(METRICS_WRITE_BUF_SIZE);
+  setvbuf(recorder->ofile, recorder->ofile_buf, _IOFBF,
+          METRICS_WRITE_BUF_SIZE);
+
+  if (format == METRICS_FORMAT_CSV) {
+    fprintf(recorder->ofile,
+            "cache_idx,cache_name,cache_size,window_idx,start_rtime,end_rtime,"
+            "n_req,n_miss,n_req_byte,n_miss_byte,miss_ratio,byte_miss_ratio,"
+            "n_obj,occupied_byte,n_eviction,eviction_age\n");
+  } else {
+    fwrite(METRICS_BINARY_MAGIC, 1, strlen(METRICS_BINARY_MAGIC),
+           recorder->ofile);
+  }
+
+  recorder->caches =
+      g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+  recorder->queue = g_async_queue_new();
+  recorder->writer =
+      g_thread_new("metrics_writer", _metrics_writer, recorder);
+
+  return recorder;
+}
+
+void close_metrics_recorder(metrics_recorder_t *recorder) {
+  metrics_record_t *stop = g_new0(metrics_record_t, 1);
+  stop->type = METRICS_RECORD_STOP;
+  g_async_queue_push(recorder->queue, stop);
+  g_thread_join(recorder->writer);
+
+  if (fclose(recorder->ofile) != 0 || recorder->has_error) {
+    WARN("failed to write metrics: %s\n", strerror(errno));
+  }
+  DEBUG("metrics recorder writes %lld windows\n",
+        (long long)recorder->n_record);
+
+  free(recorder->ofile_buf);
+  g_async_queue_unref(recorder->queue);
+  g_hash_table_destroy(recorder->caches);
+  my_free(sizeof(metrics_recorder_t), recorder);
+}
+
+/**************** tracker ****************/
+metrics_tracker_t *create_metrics_tracker(metrics_recorder_t *recorder,
+                                          int32_t cache_idx,
+                                          const cache_t *cache) {
+  metrics_tracker_t *tracker = my_malloc(metrics_tracker_t);
+  memset(tracker, 0, sizeof(metrics_tracker_t));
+  tracker->recorder = recorder;
+  tracker->cache_idx = cache_idx;
+  tracker->window_sec = recorder->window_sec;
+  tracker->window_req = recorder->window_req;
+  tracker->last_n_eviction = cache->n_eviction;
+  memcpy(tracker->last_eviction_age_cnt, cache->log_eviction_age_cnt,
+         sizeof(tracker->last_eviction_age_cnt));
+
+  metrics_record_t *r = g_new0(metrics_record_t, 1);
+  r->type = METRICS_RECORD_CACHE;
+  r->cache_idx = cache_idx;
+  r->cache_size = cache->cache_size;
+  snprintf(r->cache_name, CACHE_NAME_ARRAY_LEN, "%s", cache->cache_name);
+  g_async_queue_push(recorder->queue, r);
+
+  return tracker;
+}
+
+void metrics_tracker_flush(metrics_tracker_t *tracker, const cache_t *cache,
+                           int64_t end_rtime) {
+  int n_age_bucket = 0;
+  for (int i = 0; i < EVICTION_AGE_ARRAY_SZE; i++) {
+    if (cache->log_eviction_age_cnt[i] != tracker->last_eviction_age_cnt[i]) {
+      n_age_bucket++;
+    }
+  }
+
+  metrics_record_t *r = g_malloc0(sizeof(metrics_record_t) +
+                                  sizeof(metrics_age_bucket_t) * n_age_bucket);
+  r->type = METRICS_RECORD_WINDOW;
+  r->cache_idx = tracker->cache_idx;
+  r->window_idx = tracker->window_idx;
+  r->start_rtime = tracker->window_start_rtime;
+  r->end_rtime = end_rtime;
+  r->n_req = tracker->n_req;
+  r->n_miss = tracker->n_miss;
+  r->n_req_byte = tracker->n_req_byte;
+  r->n_miss_byte = tracker->n_miss_byte;
+  r->n_obj = cache->get_n_obj(cache);
+  r->occupied_byte = cache->get_occupied_byte(cache);
+  r->n_eviction = cache->n_eviction - tracker->last_n_eviction;
+  for (int i = 0; i < EVICTION_AGE_ARRAY_SZE; i++) {
+    int64_t cnt =
+        cache->log_eviction_age_cnt[i] - tracker->last_eviction_age_cnt[i];
+    if (cnt != 0) {
+      r->age[r->n_age_bucket].bucket = (int16_t)i;
+      r->age[r->n_age_bucket].cnt = cnt;
+      r->n_age_bucket++;
+      tracker->last_eviction_age_cnt[i] = cache->log_eviction_age_cnt[i];
+    }
+  }
+  g_async_queue_push(tracker->recorder->queue, r);
+
+  tracker->last_n_eviction = cache->n_eviction;
+  tracker->window_idx += 1;
+  tracker->window_start_rtime = end_rtime;
+  tracker->n_req = 0;
+  tracker->n_miss = 0;
+  tracker->n_req_byte = 0;
+  tracker->n_miss_byte = 0;
+}
+
+void free_metrics_tracker(metrics_tracker_t *tracker, const cache_t *cache,
+                          int64_t end_rtime) {
+  if (tracker->n_req > 0) {
+    metrics_tracker_flush(tracker, cache, end_rtime);
+  }
+  my_free(sizeof(metrics_tracker_t), tracker);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,675 @@
+//
+//  profilerOPT.c
+//  libCacheSim
+//
+//  bounds on the offline optimal for variable-size objects,
+//  see profilerOPT.h for the details
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../include/libCacheSim/profilerOPT.h"
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+#include "../include/libCacheSim/mem.h"
+
+/* the time an object stays in the cache between two consecutive requests,
+ * the object occupies slots [start, end), where slot t is the time between
+ * request t and request t + 1 */
+typedef struct {
+  int64_t start;
+  int64_t end;
+  int64_t size;
+} opt_interval_t;
+
+typedef struct {
+  int64_t start;
+  int64_t end;
+  /* indexes into the interval array, sorted by object or byte cost */
+  int64_t *obj_order;
+  int64_t *byte_order;
+  int64_t n_interval;
+} opt_segment_t;
+
+typedef struct {
+  const opt_interval_t *intervals;
+  int64_t n_interval;
+  int64_t n_req;
+  const int64_t *obj_order;
+  const int64_t *byte_order;
+
+  opt_segment_t *segments;
+  int n_segments;
+  /* the intervals crossing segment boundaries, sorted by cost */
+  int64_t *cross_obj_order;
+  int64_t *cross_byte_order;
+  int64_t n_cross;
+  /* per cache size, whether each interval is admitted by the object (bit 0)
+   * and the byte (bit 1) upper bound, only used with multiple segments */
+  uint8_t *admitted;
+
+  int num_of_sizes;
+  opt_bound_t *result;
+  /* the number of hits found by the upper bound, summed over segments */
+  int64_t *n_hit_upper;
+  int64_t *n_hit_byte_upper;
+  GMutex mtx;
+} opt_mt_params_t;
+
+/* a segment tree supporting range add and range max */
+typedef struct {
+  int64_t *max;
+  int64_t *lazy;
+  int64_t n;
+} seg_tree_t;
+
+static void seg_tree_add(seg_tree_t *tree, int64_t node, int64_t l, int64_t r,
+                         int64_t ql, int64_t qr, int64_t v) {
+  if (qr < l || r < ql) return;
+  if (ql <= l && r <= qr) {
+    tree->max[node] += v;
+    tree->lazy[node] += v;
+    return;
+  }
+  int64_t mid = (l + r) / 2;
+  seg_tree_add(tree, node * 2, l, mid, ql, qr, v);
+  seg_tree_add(tree, node * 2 + 1, mid + 1, r, ql, qr, v);
+  tree->max[node] = MAX(tree->max[node * 2], tree->max[node * 2 + 1]) +
+                    tree->lazy[node];
+}
+
+static int64_t seg_tree_max(const seg_tree_t *tree, int64_t node, int64_t l,
+                            int64_t r, int64_t ql, int64_t qr) {
+  if (qr < l || r < ql) return 0;
+  if (ql <= l && r <= qr) return tree->max[node];
+  int64_t mid = (l + r) / 2;
+  int64_t m = MAX(seg_tree_max(tree, node * 2, l, mid, ql, qr),
+                  seg_tree_max(tree, node * 2 + 1, mid + 1, r, ql, qr));
+  return m + tree->lazy[node];
+}
+
+static void seg_tree_init(seg_tree_t *tree, int64_t n) {
+  tree->n = n;
+  tree->max = calloc(n * 4, sizeof(int64_t));
+  tree->lazy = calloc(n * 4, sizeof(int64_t));
+  ASSERT_NOT_NULL(tree->max, "cannot allocate segment tree of %ld slots\n",
+                  (long)n);
+  ASSERT_NOT_NULL(tree->lazy, "cannot allocate segment tree of %ld slots\n",
+                  (long)n);
+}
+
+static void seg_tree_free(seg_tree_t *tree) {
+  free(tree->max);
+  free(tree->lazy);
+}
+
+/**
+ * @brief greedily admit the intervals in the given order, an interval is
+ * admitted if the cache has enough space during the interval, the tree
+ * covers the slots starting from offset
+ *
+ * @param admitted if not NULL, flag is set for the admitted intervals
+ * @return the number of hits (if count_byte is false) or byte hits
+ */
+static int64_t _opt_admit_greedy(seg_tree_t *tree, int64_t offset,
+                                 const opt_interval_t *intervals,
+                                 const int64_t *order, int64_t n_interval,
+                                 int64_t cache_size, bool count_byte,
+                                 uint8_t *admitted, uint8_t flag) {
+  int64_t n_hit = 0;
+  for (int64_t i = 0; i < n_interval; i++) {
+    const opt_interval_t *itv = &intervals[order[i]];
+    if (itv->size > cache_size) continue;
+
+    int64_t l = itv->start - offset, r = itv->end - 1 - offset;
+    if (seg_tree_max(tree, 1, 0, tree->n - 1, l, r) + itv->size >
+        cache_size) {
+      continue;
+    }
+    seg_tree_add(tree, 1, 0, tree->n - 1, l, r, itv->size);
+    if (admitted != NULL) admitted[order[i]] |= flag;
+    n_hit += count_byte ? itv->size : 1;
+  }
+
+  return n_hit;
+}
+
+/**
+ * @brief greedily admit the intervals of one segment in the given order
+ *
+ * @return the number of hits (if count_byte is false) or byte hits
+ */
+static int64_t _opt_upper_bound_hit(const opt_interval_t *intervals,
+                                    const opt_segment_t *seg,
+                                    const int64_t *order, int64_t cache_size,
+                                    bool count_byte, uint8_t *admitted,
+                                    uint8_t flag) {
+  int64_t n_slot = seg->end - seg->start;
+  if (n_slot <= 0) return 0;
+
+  seg_tree_t tree;
+  seg_tree_init(&tree, n_slot);
+  int64_t n_hit =
+      _opt_admit_greedy(&tree, seg->start, intervals, order, seg->n_interval,
+                        cache_size, count_byte, admitted, flag);
+  seg_tree_free(&tree);
+  return n_hit;
+}
+
+/**
+ * @brief admit the intervals crossing segment boundaries in the space left by
+ * the intervals admitted in the segments
+ *
+ * @return the number of hits (if count_byte is false) or byte hits
+ */
+static int64_t _opt_cross_upper_bound_hit(const opt_mt_params_t *params,
+                                          uint8_t *admitted,
+                                          const int64_t *order,
+                                          int64_t cache_size, bool count_byte,
+                                          uint8_t flag) {
+  if (params->n_req <= 0) return 0;
+
+  seg_tree_t tree;
+  seg_tree_init(&tree, params->n_req);
+  for (int64_t i = 0; i < params->n_interval; i++) {
+    if (admitted[i] & flag) {
+      const opt_interval_t *itv = &params->intervals[i];
+      seg_tree_add(&tree, 1, 0, tree.n - 1, itv->start, itv->end - 1,
+                   itv->size);
+    }
+  }
+  int64_t n_hit =
+      _opt_admit_greedy(&tree, 0, params->intervals, order, params->n_cross,
+                        cache_size, count_byte, NULL, flag);
+  seg_tree_free(&tree);
+  return n_hit;
+}
+
+/**
+ * @brief fractional knapsack on the total space-time of the cache
+ *
+ * @return an upper bound on the number of hits (or byte hits)
+ */
+static int64_t _opt_lower_bound_hit(const opt_interval_t *intervals,
+                                    int64_t n_interval, const int64_t *order,
+                                    int64_t n_req, int64_t cache_size,
+                                    bool count_byte) {
+  double budget = (double)cache_size * (double)n_req;
+  double n_hit = 0;
+  for (int64_t i = 0; i < n_interval; i++) {
+    const opt_interval_t *itv = &intervals[order[i]];
+    if (itv->size > cache_size) continue;
+
+    double cost = (double)itv->size * (double)(itv->end - itv->start);
+    double benefit = count_byte ? (double)itv->size : 1.0;
+    if (cost <= budget) {
+      budget -= cost;
+      n_hit += benefit;
+    } else {
+      n_hit += benefit * budget / cost;
+      break;
+    }
+  }
+
+  return (int64_t)n_hit;
+}
+
+static void _get_opt_bound_thread(gpointer data, gpointer user_data) {
+  opt_mt_params_t *params = (opt_mt_params_t *)user_data;
+  int job_id = GPOINTER_TO_UINT(data) - 1;
+  int size_idx = job_id / params->n_segments;
+  int seg_idx = job_id % params->n_segments;
+  opt_bound_t *res = &params->result[size_idx];
+  const opt_segment_t *seg = &params->segments[seg_idx];
+
+  uint8_t *admitted = params->admitted == NULL
+                          ? NULL
+                          : params->admitted + size_idx * params->n_interval;
+  int64_t n_hit = _opt_upper_bound_hit(params->intervals, seg, seg->obj_order,
+                                       res->cache_size, false, admitted, 1);
+  int64_t n_hit_byte =
+      _opt_upper_bound_hit(params->intervals, seg, seg->byte_order,
+                           res->cache_size, true, admitted, 2);
+
+  /* the lower bound is computed on the whole trace */
+  if (seg_idx == 0) {
+    res->n_miss_lower =
+        res->n_req - _opt_lower_bound_hit(params->intervals,
+                                          params->n_interval, params->obj_order,
+                                          params->n_req, res->cache_size, false);
+    res->n_miss_byte_lower =
+        res->n_req_byte -
+        _opt_lower_bound_hit(params->intervals, params->n_interval,
+                             params->byte_order, params->n_req,
+                             res->cache_size, true);
+  }
+
+  g_mutex_lock(&(params->mtx));
+  params->n_hit_upper[size_idx] += n_hit;
+  params->n_hit_byte_upper[size_idx] += n_hit_byte;
+  g_mutex_unlock(&(params->mtx));
+}
+
+static void _get_opt_cross_bound_thread(gpointer data, gpointer user_data) {
+  opt_mt_params_t *params = (opt_mt_params_t *)user_data;
+  int size_idx = GPOINTER_TO_UINT(data) - 1;
+  uint8_t *admitted = params->admitted + size_idx * params->n_interval;
+  int64_t cache_size = params->result[size_idx].cache_size;
+
+  int64_t n_hit = _opt_cross_upper_bound_hit(
+      params, admitted, params->cross_obj_order, cache_size, false, 1);
+  int64_t n_hit_byte = _opt_cross_upper_bound_hit(
+      params, admitted, params->cross_byte_order, cache_size, true, 2);
+
+  g_mutex_lock(&(params->mtx));
+  params->n_hit_upper[size_idx] += n_hit;
+  params->n_hit_byte_upper[size_idx] += n_hit_byte;
+  g_mutex_unlock(&(params->mtx));
+}
+
+/* qsort does not take a context, so the intervals are passed in TLS */
+static __thread const opt_interval_t *sort_intervals;
+
+/* the cost of an object hit is the space-time of the interval */
+static int _cmp_obj_cost(const void *p1, const void *p2) {
+  const opt_interval_t *a = &sort_intervals[*(const int64_t *)p1];
+  const opt_interval_t *b = &sort_intervals[*(const int64_t *)p2];
+  double ca = (double)a->size * (double)(a->end - a->start);
+  double cb = (double)b->size * (double)(b->end - b->start);
+  if (ca != cb) return ca < cb ? -1 : 1;
+  return a->start < b->start ? -1 : (a->start > b->start ? 1 : 0);
+}
+
+/* the cost of a byte hit is the length of the interval */
+static int _cmp_byte_cost(const void *p1, const void *p2) {
+  const opt_interval_t *a = &sort_intervals[*(const int64_t *)p1];
+  const opt_interval_t *b = &sort_intervals[*(const int64_t *)p2];
+  int64_t la = a->end - a->start, lb = b->end - b->start;
+  if (la != lb) return la < lb ? -1 : 1;
+  return a->start < b->start ? -1 : (a->start > b->start ? 1 : 0);
+}
+
+/**
+ * @brief split the sorted intervals into segments, keeping the order,
+ * intervals that cross segment boundaries are kept in a separate list
+ */
+static void _build_segments(opt_mt_params_t *params, int64_t n_req) {
+  int n_seg = params->n_segments;
+  int64_t seg_len = (n_req + n_seg - 1) / n_seg;
+  params->segments = my_malloc_n(opt_segment_t, n_seg);
+  memset(params->segments, 0, sizeof(opt_segment_t) * n_seg);
+
+  for (int s = 0; s < n_seg; s++) {
+    params->segments[s].start = MIN((int64_t)s * seg_len, n_req);
+    params->segments[s].end = MIN((int64_t)(s + 1) * seg_len, n_req);
+  }
+
+  /* count the intervals in each segment */
+  int64_t *seg_cnt = my_malloc_n(int64_t, n_seg);
+  memset(seg_cnt, 0, sizeof(int64_t) * n_seg);
+  for (int64_t i = 0; i < params->n_interval; i++) {
+    const opt_interval_t *itv = &params->intervals[i];
+    int s = (int)(itv->start / seg_len);
+    if (itv->end <= params->segments[s].end) seg_cnt[s]++;
+  }
+
+  int64_t n_cross = params->n_interval;
+  for (int s = 0; s < n_seg; s++) {
+    params->segments[s].obj_order = my_malloc_n(int64_t, MAX(seg_cnt[s], 1));
+    params->segments[s].byte_order = my_malloc_n(int64_t, MAX(seg_cnt[s], 1));
+    n_cross -= seg_cnt[s];
+  }
+  params->cross_obj_order = my_malloc_n(int64_t, MAX(n_cross, 1));
+  params->cross_byte_order = my_malloc_n(int64_t, MAX(n_cross, 1));
+
+  const int64_t *orders[2] = {params->obj_order, params->byte_order};
+  for (int o = 0; o < 2; o++) {
+    for (int s = 0; s < n_seg; s++) params->segments[s].n_interval = 0;
+    params->n_cross = 0;
+    for (int64_t i = 0; i < params->n_interval; i++) {
+      int64_t idx = orders[o][i];
+      const opt_interval_t *itv = &params->intervals[idx];
+      int s = (int)(itv->start / seg_len);
+      opt_segment_t *seg = &params->segments[s];
+      if (itv->end > seg->end) {
+        int64_t *cross_order =
+            o == 0 ? params->cross_obj_order : params->cross_byte_order;
+        cross_order[params->n_cross++] = idx;
+        continue;
+      }
+      int64_t *seg_order = o == 0 ? seg->obj_order : seg->byte_order;
+      seg_order[seg->n_interval++] = idx;
+    }
+  }
+
+  my_free(sizeof(int64_t) * n_seg, seg_cnt);
+}
+
+opt_bound_t *get_opt_miss_bounds(reader_t *reader, int num_of_sizes,
+                                 const uint64_t *cache_sizes, int n_segments,
+                                 int num_of_threads) {
+  int64_t n_req = 0, n_req_byte = 0;
+  int64_t n_interval = 0, interval_array_size = 1024 * 1024;
+  opt_interval_t *intervals = malloc(sizeof(opt_interval_t) * interval_array_size);
+  ASSERT_NOT_NULL(intervals, "cannot allocate interval array\n");
+
+  request_t *req = new_request();
+  read_one_req(reader, req);
+  if (req->valid && req->next_access_vtime == -2) {
+    ERROR("%s requires a trace with next access time, e.g., oracleGeneral\n",
+          __func__);
+    abort();
+  }
+
+  while (req->valid) {
+    /* next_access_vtime starts from 1 */
+    int64_t next = req->next_access_vtime;
+    if (next > 0 && next != MAX_REUSE_DISTANCE) {
+      if (n_interval == interval_array_size) {
+        interval_array_size *= 2;
+        intervals = realloc(intervals,
+                            sizeof(opt_interval_t) * interval_array_size);
+        ASSERT_NOT_NULL(intervals, "cannot allocate interval array\n");
+      }
+      intervals[n_interval].start = n_req;
+      intervals[n_interval].end = next - 1;
+      intervals[n_interval].size = req->obj_size;
+      n_interval += 1;
+    }
+    n_req += 1;
+    n_req_byte += req->obj_size;
+    read_one_req(reader, req);
+  }
+  free_request(req);
+  reset_reader(reader);
+
+  /* drop the intervals that end beyond the processed requests,
+   * e.g., when the reader is capped at n requests */
+  int64_t n_valid = 0;
+  for (int64_t i = 0; i < n_interval; i++) {
+    if (intervals[i].end > intervals[i].start && intervals[i].end < n_req) {
+      intervals[n_valid++] = intervals[i];
+    }
+  }
+  n_interval = n_valid;
+
+  int64_t *obj_order = my_malloc_n(int64_t, MAX(n_interval, 1));
+  int64_t *byte_order = my_malloc_n(int64_t, MAX(n_interval, 1));
+  for (int64_t i = 0; i < n_interval; i++) {
+    obj_order[i] = i;
+    byte_order[i] = i;
+  }
+  sort_intervals = intervals;
+  qsort(obj_order, n_interval, sizeof(int64_t), _cmp_obj_cost);
+  qsort(byte_order, n_interval, sizeof(int64_t), _cmp_byte_cost);
+
+  opt_bound_t *result = my_malloc_n(opt_bound_t, num_of_sizes);
+  memset(result, 0, sizeof(opt_bound_t) * num_of_sizes);
+  for (int i = 0; i < num_of_sizes; i++) {
+    result[i].cache_size = cache_sizes[i];
+    result[i].n_req = n_req;
+    result[i].n_req_byte = n_req_byte;
+  }
+
+  opt_mt_params_t *params = my_malloc(opt_mt_params_t);
+  memset(params, 0, sizeof(opt_mt_params_t));
+  params->intervals = intervals;
+  params->n_interval = n_interval;
+  params->n_req = n_req;
+  params->obj_order = obj_order;
+  params->byte_order = byte_order;
+  params->n_segments = MAX(MIN(n_segments, (int)MAX(n_req, 1)), 1);
+  params->num_of_sizes = num_of_sizes;
+  params->result = result;
+  params->n_hit_upper = my_malloc_n(int64_t, num_of_sizes);
+  params->n_hit_byte_upper = my_malloc_n(int64_t, num_of_sizes);
+  memset(params->n_hit_upper, 0, sizeof(int64_t) * num_of_sizes);
+  memset(params->n_hit_byte_upper, 0, sizeof(int64_t) * num_of_sizes);
+  g_mutex_init(&(params->mtx));
+  _build_segments(params, n_req);
+  if (params->n_cross > 0) {
+    params->admitted = my_malloc_n(uint8_t, num_of_sizes * n_interval);
+    memset(params->admitted, 0, num_of_sizes * n_interval);
+  }
+
+  INFO("%s starts computation, %ld req, %ld intervals, %d sizes, %d segments, "
+       "%d threads\n",
+       __func__, (long)n_req, (long)n_interval, num_of_sizes,
+       params->n_segments, num_of_threads);
+
+  GThreadPool *gthread_pool =
+      g_thread_pool_new((GFunc)_get_opt_bound_thread, (gpointer)params,
+                        num_of_threads, TRUE, NULL);
+  ASSERT_NOT_NULL(gthread_pool, "cannot create thread pool in profiler\n");
+
+  int n_jobs = num_of_sizes * params->n_segments;
+  for (int i = 1; i < n_jobs + 1; i++) {
+    ASSERT_TRUE(g_thread_pool_push(gthread_pool, GSIZE_TO_POINTER(i), NULL),
+                "cannot push data into thread_pool in %s\n", __func__);
+  }
+
+  /* wait for all jobs to finish */
+  g_thread_pool_free(gthread_pool, FALSE, TRUE);
+
+  /* admit the intervals crossing segment boundaries, one job per size */
+  if (params->n_cross > 0) {
+    gthread_pool =
+        g_thread_pool_new((GFunc)_get_opt_cross_bound_thread, (gpointer)params,
+                          num_of_threads, TRUE, NULL);
+    ASSERT_NOT_NULL(gthread_pool, "cannot create thread pool in profiler\n");
+    for (int i = 1; i < num_of_sizes + 1; i++) {
+      ASSERT_TRUE(g_thread_pool_push(gthread_pool, GSIZE_TO_POINTER(i), NULL),
+                  "cannot push data into thread_pool in %s\n", __func__);
+    }
+    g_thread_pool_free(gthread_pool, FALSE, TRUE);
+  }
+
+  for (int i = 0; i < num_of_sizes; i++) {
+    result[i].n_miss_upper = n_req - params->n_hit_upper[i];
+    result[i].n_miss_byte_upper = n_req_byte - params->n_hit_byte_upper[i];
+  }
+
+  // clean up
+  for (int s = 0; s < params->n_segments; s++) {
+    my_free(sizeof(int64_t) * MAX(params->segments[s].n_interval, 1),
+            params->segments[s].obj_order);
+    my_free(sizeof(int64_t) * MAX(params->segments[s].n_interval, 1),
+            params->segments[s].byte_order);
+  }
+  my_free(sizeof(opt_segment_t) * params->n_segments, params->segments);
+  my_free(sizeof(int64_t) * MAX(params->n_cross, 1), params->cross_obj_order);
+  my_free(sizeof(int64_t) * MAX(params->n_cross, 1), params->cross_byte_order);
+  if (params->admitted != NULL) {
+    my_free(sizeof(uint8_t) * num_of_sizes * n_interval, params->admitted);
+  }
+  my_free(sizeof(int64_t) * num_of_sizes, params->n_hit_upper);
+  my_free(sizeof(int64_t) * num_of_sizes, params->n_hit_byte_upper);
+  g_mutex_clear(&(params->mtx));
+  my_free(sizeof(opt_mt_params_t), params);
+  my_free(sizeof(int64_t) * MAX(n_interval, 1), obj_order);
+  my_free(sizeof(int64_t) * MAX(n_interval, 1), byte_order);
+  free(intervals);
+
+  return result;
+}
+
+/************************** Belady priority stack **************************/
+typedef struct {
+  obj_id_t obj_id;
+  int64_t next_access_vtime;
+  int64_t obj_size;
+} belady_stack_entry_t;
+
+typedef struct {
+  belady_stack_entry_t *entries;
+  int64_t n_entry;
+  int64_t array_size;
+  int64_t n_byte;
+} belady_stack_t;
+
+static void _belady_stack_init(belady_stack_t *stack) {
+  stack->array_size = 1024;
+  stack->entries = malloc(sizeof(belady_stack_entry_t) * stack->array_size);
+  ASSERT_NOT_NULL(stack->entries, "cannot allocate Belady stack\n");
+  stack->n_entry = 0;
+  stack->n_byte = 0;
+}
+
+/**
+ * @brief move the requested object to the top of the stack, the other objects
+ * above its old position are bubbled down by priority (Mattson et al.):
+ * position i keeps the object with the earlier next access among the object
+ * at i and the one carried from above, the other one is carried down
+ *
+ * the stack is truncated to max_depth (objects or bytes)
+ *
+ * @return the depth of the object (including itself) before this request,
+ *    -1 if the object is not in the stack
+ */
+static int64_t _belady_stack_access(belady_stack_t *stack,
+                                    const request_t *req, bool count_byte,
+                                    int64_t max_depth) {
+  belady_stack_entry_t carried = {.obj_id = req->obj_id,
+                                  .next_access_vtime = req->next_access_vtime,
+                                  .obj_size = req->obj_size};
+  belady_stack_entry_t *entries = stack->entries;
+  int64_t depth = 0;
+
+  for (int64_t i = 0; i < stack->n_entry; i++) {
+    belady_stack_entry_t z = entries[i];
+    if (z.obj_id == req->obj_id) {
+      entries[i] = carried;
+      stack->n_byte += req->obj_size - z.obj_size;
+      return depth + (count_byte ? req->obj_size : 1);
+    }
+
+    depth += count_byte ? z.obj_size : 1;
+    if (i == 0 || carried.next_access_vtime < z.next_access_vtime) {
+      entries[i] = carried;
+      carried = z;
+    }
+  }
+
+  /* the object is not in the stack, the carried one is the bottom */
+  if (stack->n_entry == stack->array_size) {
+    stack->array_size *= 2;
+    stack->entries = realloc(stack->entries, sizeof(belady_stack_entry_t) *
+                                                 stack->array_size);
+    ASSERT_NOT_NULL(stack->entries, "cannot allocate Belady stack\n");
+  }
+  stack->entries[stack->n_entry++] = carried;
+  stack->n_byte += req->obj_size;
+
+  if (count_byte) {
+    while (stack->n_entry > 0 && stack->n_byte > max_depth) {
+      stack->n_byte -= stack->entries[--stack->n_entry].obj_size;
+    }
+  } else {
+    stack->n_entry = MIN(stack->n_entry, max_depth);
+  }
+
+  return -1;
+}
+
+static void _check_oracle_reader(reader_t *reader, const char *func_name) {
+  request_t *req = new_request();
+  read_one_req(reader, req);
+  if (req->valid && req->next_access_vtime == -2) {
+    ERROR("%s requires a trace with next access time, e.g., oracleGeneral\n",
+          func_name);
+    abort();
+  }
+  free_request(req);
+  reset_reader(reader);
+}
+
+double *get_belady_obj_miss_ratio(reader_t *reader, int64_t size) {
+  _check_oracle_reader(reader, __func__);
+
+  int64_t n_req = 0;
+  int64_t *hit_cnt = my_malloc_n(int64_t, size + 1);
+  memset(hit_cnt, 0, sizeof(int64_t) * (size + 1));
+  double *miss_ratio = g_new(double, size + 1);
+
+  belady_stack_t stack;
+  _belady_stack_init(&stack);
+
+  request_t *req = new_request();
+  read_one_req(reader, req);
+  while (req->valid) {
+    int64_t depth = _belady_stack_access(&stack, req, false, size);
+    if (depth > 0 && depth <= size) {
+      hit_cnt[depth] += 1;
+    }
+    n_req += 1;
+    read_one_req(reader, req);
+  }
+
+  int64_t n_hit = 0;
+  for (int64_t i = 0; i < size + 1; i++) {
+    n_hit += hit_cnt[i];
+    miss_ratio[i] = n_req == 0 ? 0 : (double)(n_req - n_hit) / (double)n_req;
+  }
+
+  free(stack.entries);
+  free_request(req);
+  my_free(sizeof(int64_t) * (size + 1), hit_cnt);
+  reset_reader(reader);
+
+  return miss_ratio;
+}
+
+cache_stat_t *get_belady_miss_ratio_at_multi_sizes(
+    reader_t *reader, int num_of_sizes, const uint64_t *cache_sizes) {
+  _check_oracle_reader(reader, __func__);
+
+  cache_stat_t *result = my_malloc_n(cache_stat_t, num_of_sizes);
+  memset(result, 0, sizeof(cache_stat_t) * num_of_sizes);
+  int64_t max_size = 0;
+  for (int i = 0; i < num_of_sizes; i++) {
+    result[i].cache_size = (int64_t)cache_sizes[i];
+    strncpy(result[i].cache_name, "Belady-stack", CACHE_NAME_ARRAY_LEN);
+    max_size = MAX(max_size, (int64_t)cache_sizes[i]);
+  }
+
+  belady_stack_t stack;
+  _belady_stack_init(&stack);
+
+  int64_t n_req = 0, n_req_byte = 0;
+  request_t *req = new_request();
+  read_one_req(reader, req);
+  while (req->valid) {
+    int64_t depth = _belady_stack_access(&stack, req, true, max_size);
+    for (int i = 0; i < num_of_sizes; i++) {
+      if (depth < 0 || depth > result[i].cache_size) {
+        result[i].n_miss += 1;
+        result[i].n_miss_byte += req->obj_size;
+      }
+    }
+    n_req += 1;
+    n_req_byte += req->obj_size;
+    read_one_req(reader, req);
+  }
+
+  for (int i = 0; i < num_of_sizes; i++) {
+    result[i].n_req = n_req;
+    result[i].n_req_byte = n_req_byte;
+  }
+
+  free(stack.entries);
+  free_request(req);
+  reset_reader(reader);
+
+  return result;
+}
+
+#ifdef __cplusplus
+}
+#endif
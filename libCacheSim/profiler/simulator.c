@@ -12,13 +12,27 @@ extern "C" {
 
 #include "../include/libCacheSim/simulator.h"
 
+#include <errno.h>
 #include <math.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
-#include "../cache/cacheUtils.h"
+#include "../dataStructure/hashtable/hashtable.h"
 #include "../include/libCacheSim/evictionAlgo.h"
+#include "../include/libCacheSim/metricsRecorder.h"
 #include "../include/libCacheSim/plugin.h"
 #include "../utils/include/myprint.h"
 #include "../utils/include/mystr.h"
+#include "../utils/include/mysys.h"
+
+/* the number of requests used to probe the speed of an algorithm */
+#define N_PROBE_REQ 20000
+/* how often the progress is printed when waiting for the simulations */
+#define PROGRESS_REPORT_INTERVAL_SEC 60
+/* how often (in requests) the metadata bytes of a cache are sampled to find
+ * the peak */
+#define METADATA_SAMPLE_INTERVAL (1 << 16)
 
 typedef struct simulator_multithreading_params {
   reader_t *reader;
@@ -29,15 +43,221 @@ typedef struct simulator_multithreading_params {
   int warmup_sec; /* num of seconds of requests used for warming up cache */
   cache_stat_t *result;
   GMutex mtx; /* prevent simultaneous write to progress */
+  GCond progress_cond; /* signaled when a simulation finishes */
   gint *progress;
   gpointer other_data;
   bool free_cache_when_finish;
+
+  /* the simulations are sorted by predicted cost (slowest first),
+   * each worker takes the next one when it finishes the current one */
+  int *job_order;
+  gint next_job;
+  int n_worker;
+  bool pin_worker;
+
+  /* in tiled mode, the caches (in job order) are split into groups, a worker
+   * reads a batch of requests that fits in L2 and feeds it to every cache in
+   * a group before reading the next batch, the group is sized so that the
+   * metadata of the caches fits in the worker's share of the LLC,
+   * group i has the caches job_order[group_start[i], group_start[i + 1]) */
+  bool tiled;
+  int batch_size;
+  int n_group;
+  int *group_start;
+
+  /* NULL if the metrics over time are not recorded */
+  metrics_recorder_t *metrics_recorder;
 } sim_mt_params_t;
 
+typedef struct {
+  int idx;
+  double ns_per_req;
+  uint64_t cache_size;
+} sim_job_t;
+
+/* the measured ns/req of each algorithm (keyed by cache name) from the
+ * simulations that have finished in this process, it is used to predict the
+ * cost of later simulations */
+static GHashTable *ns_per_req_history = NULL;
+static GMutex ns_per_req_history_mtx;
+
+static void _record_ns_per_req(const char *cache_name, double ns_per_req) {
+  g_mutex_lock(&ns_per_req_history_mtx);
+  if (ns_per_req_history == NULL) {
+    ns_per_req_history =
+        g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  }
+  double *v = g_new(double, 1);
+  *v = ns_per_req;
+  g_hash_table_replace(ns_per_req_history, g_strdup(cache_name), v);
+  g_mutex_unlock(&ns_per_req_history_mtx);
+}
+
+/* return -1 if the algorithm has not been simulated */
+static double _lookup_ns_per_req(const char *cache_name) {
+  double ns_per_req = -1;
+  g_mutex_lock(&ns_per_req_history_mtx);
+  if (ns_per_req_history != NULL) {
+    double *v = g_hash_table_lookup(ns_per_req_history, cache_name);
+    if (v != NULL) ns_per_req = *v;
+  }
+  g_mutex_unlock(&ns_per_req_history_mtx);
+  return ns_per_req;
+}
+
+/**
+ * @brief measure the speed of an algorithm by running the first N_PROBE_REQ
+ * requests on a clone of the cache, this underestimates algorithms whose
+ * cost grows later (e.g., learned caches that start training), which is
+ * corrected by the history after the first run
+ *
+ * @param reader
+ * @param cache
+ * @return double ns per request
+ */
+static double _probe_ns_per_req(reader_t *reader, const cache_t *cache) {
+  cache_t *probe_cache = clone_cache(cache);
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  set_rand_seed(0);
+
+  int64_t n_req = 0;
+  gint64 start_time = g_get_monotonic_time();
+  read_one_req(cloned_reader, req);
+  while (req->valid && n_req < N_PROBE_REQ) {
+    probe_cache->get(probe_cache, req);
+    n_req++;
+    read_one_req(cloned_reader, req);
+  }
+  gint64 elapsed_us = g_get_monotonic_time() - start_time;
+
+  free_request(req);
+  close_reader(cloned_reader);
+  probe_cache->cache_free(probe_cache);
+
+  return n_req == 0 ? 0 : (double)elapsed_us * 1000.0 / (double)n_req;
+}
+
+static int _cmp_sim_job(const void *a, const void *b) {
+  const sim_job_t *j1 = a, *j2 = b;
+  if (j1->ns_per_req != j2->ns_per_req) {
+    return j1->ns_per_req > j2->ns_per_req ? -1 : 1;
+  }
+  /* a larger cache of the same algorithm usually runs slower */
+  if (j1->cache_size != j2->cache_size) {
+    return j1->cache_size > j2->cache_size ? -1 : 1;
+  }
+  return j1->idx - j2->idx;
+}
+
+/**
+ * @brief order the simulations by predicted cost so that the slowest ones
+ * start first and the fast ones fill the idle workers at the end, the cost
+ * is from previous simulations of the same algorithm in this process or a
+ * short probe
+ *
+ * @param params
+ * @param num_of_threads
+ */
+static void _schedule_jobs(sim_mt_params_t *params, int num_of_threads) {
+  int n_caches = (int)params->n_caches;
+  sim_job_t *jobs = my_malloc_n(sim_job_t, n_caches);
+
+  /* no need to probe if there is only one algorithm or every simulation gets
+   * its own worker */
+  bool need_probe = false;
+  for (int i = 1; i < n_caches && n_caches > num_of_threads; i++) {
+    if (strcmp(params->caches[i]->cache_name, params->caches[0]->cache_name) != 0) {
+      need_probe = true;
+      break;
+    }
+  }
+  GHashTable *probed = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+  for (int i = 0; i < n_caches; i++) {
+    const cache_t *cache = params->caches[i];
+    jobs[i].idx = i;
+    jobs[i].cache_size = cache->cache_size;
+    jobs[i].ns_per_req = _lookup_ns_per_req(cache->cache_name);
+    if (jobs[i].ns_per_req >= 0 || !need_probe) continue;
+
+    double *v = g_hash_table_lookup(probed, cache->cache_name);
+    if (v == NULL) {
+      v = g_new(double, 1);
+      *v = _probe_ns_per_req(params->reader, cache);
+      g_hash_table_insert(probed, (gpointer)cache->cache_name, v);
+      DEBUG("probe %s %.2lf ns/req\n", cache->cache_name, *v);
+    }
+    jobs[i].ns_per_req = *v;
+  }
+  g_hash_table_destroy(probed);
+
+  qsort(jobs, n_caches, sizeof(sim_job_t), _cmp_sim_job);
+  params->job_order = my_malloc_n(int, n_caches);
+  for (int i = 0; i < n_caches; i++) {
+    params->job_order[i] = jobs[i].idx;
+  }
+  my_free(sizeof(sim_job_t) * n_caches, jobs);
+}
+
+/* record the metadata bytes of the cache and update the peak */
+static inline void _sample_metadata_byte(cache_stat_t *result,
+                                         const cache_t *cache) {
+  result->metadata_byte = cache->get_metadata_bytes(cache);
+  result->max_metadata_byte =
+      MAX(result->max_metadata_byte, result->metadata_byte);
+}
+
+/**
+ * @brief record the final stat of a simulation, report its throughput and
+ * progress, and free the cache if needed
+ *
+ * @param params
+ * @param idx
+ * @param runtime_sec
+ */
+static void _finish_simulation(sim_mt_params_t *params, int idx,
+                               double runtime_sec) {
+  cache_stat_t *result = params->result;
+  cache_t *local_cache = params->caches[idx];
+
+  result[idx].n_obj = local_cache->n_obj;
+  result[idx].occupied_byte = local_cache->occupied_byte;
+  result[idx].n_eviction = local_cache->n_eviction;
+  result[idx].evicted_bytes = local_cache->n_evicted_byte;
+  result[idx].expired_obj_cnt = local_cache->n_expiration;
+  result[idx].expired_bytes = local_cache->n_expired_byte;
+  _sample_metadata_byte(&result[idx], local_cache);
+  strncpy(result[idx].cache_name, local_cache->cache_name,
+          CACHE_NAME_ARRAY_LEN);
+
+  result[idx].runtime_sec = runtime_sec;
+  int64_t n_processed = result[idx].n_warmup_req + result[idx].n_req;
+  if (n_processed > 0) {
+    _record_ns_per_req(local_cache->cache_name,
+                       runtime_sec * 1e9 / (double)n_processed);
+  }
+  char cache_size_str[64];
+  convert_size_to_str(local_cache->cache_size, cache_size_str);
+  INFO("cache %s (size %s) finishes in %.2lf sec, throughput %.2lf MQPS\n",
+       local_cache->cache_name, cache_size_str, runtime_sec,
+       (double)n_processed / 1e6 / MAX(runtime_sec, 1e-6));
+
+  // report progress
+  g_mutex_lock(&(params->mtx));
+  (*(params->progress))++;
+  g_cond_signal(&(params->progress_cond));
+  g_mutex_unlock(&(params->mtx));
+
+  if (params->free_cache_when_finish) {
+    local_cache->cache_free(local_cache);
+  }
+}
+
 static void _simulate(gpointer data, gpointer user_data) {
   sim_mt_params_t *params = (sim_mt_params_t *)user_data;
   int idx = GPOINTER_TO_UINT(data) - 1;
   set_rand_seed(0);
+  gint64 start_time = g_get_monotonic_time();
 
   cache_stat_t *result = params->result;
   reader_t *cloned_reader = clone_reader(params->reader);
@@ -84,56 +304,332 @@ static void _simulate(gpointer data, gpointer user_data) {
          (double)(req->clock_time - start_ts) / 3600.0);
   }
 
+  metrics_tracker_t *tracker = NULL;
+  if (params->metrics_recorder != NULL) {
+    tracker =
+        create_metrics_tracker(params->metrics_recorder, idx, local_cache);
+  }
+
   while (req->valid) {
     result[idx].n_req++;
     result[idx].n_req_byte += req->obj_size;
 
     req->clock_time -= start_ts;
-    if (local_cache->get(local_cache, req) == false) {
+    bool hit = local_cache->get(local_cache, req);
+    if (hit == false) {
       result[idx].n_miss++;
       result[idx].n_miss_byte += req->obj_size;
     }
+    if (tracker != NULL) {
+      metrics_tracker_record(tracker, local_cache, req, hit);
+    }
+    if (result[idx].n_req % METADATA_SAMPLE_INTERVAL == 0) {
+      _sample_metadata_byte(&result[idx], local_cache);
+    }
     read_one_req(cloned_reader, req);
   }
 
-/* disabled due to ARC and LeCaR use ghost entries in the hash table */
-#if defined(SUPPORT_TTL) && defined(ENABLE_SCAN)
-  /* get expiration information */
-  if (local_cache->hashtable->n_obj != 0) {
-    cache_stat_t temp_stat;
-    memset(&temp_stat, 0, sizeof(cache_stat_t));
-    temp_stat.curr_rtime = req->clock_time;
-    get_cache_state(local_cache, &temp_stat);
-
-    if (local_cache->occupied_size != temp_stat.occupied_size) {
-      WARN(
-          "occupied_size not match, %ld vs %ld, maybe the "
-          "cache uses a ghost list, in which case, the expired "
-          "object count may not be accurate",
-          local_cache->occupied_size, temp_stat.occupied_size);
+  result[idx].curr_rtime = req->clock_time;
+  if (tracker != NULL) {
+    free_metrics_tracker(tracker, local_cache, req->clock_time);
+  }
+  _finish_simulation(
+      params, idx,
+      (double)(g_get_monotonic_time() - start_time) / G_TIME_SPAN_SECOND);
+
+  // clean up
+  free_request(req);
+  close_reader(cloned_reader);
+}
+
+/**************** tiled simulation ****************/
+/* read the next batch of requests, return the number of requests read */
+static int _read_batch(reader_t *reader, request_t *batch, int batch_size) {
+  int n_req = 0;
+  while (n_req < batch_size) {
+    if (read_one_req(reader, &batch[n_req]) != 0 || !batch[n_req].valid) {
+      break;
     }
-    result[idx].expired_obj_cnt = temp_stat.expired_obj_cnt;
-    result[idx].expired_bytes = temp_stat.expired_bytes;
+    n_req++;
   }
-#endif
+  return n_req;
+}
 
-  result[idx].curr_rtime = req->clock_time;
-  result[idx].n_obj = local_cache->n_obj;
-  result[idx].occupied_byte = local_cache->occupied_byte;
-  strncpy(result[idx].cache_name, local_cache->cache_name,
-          CACHE_NAME_ARRAY_LEN);
+/**
+ * @brief feed a batch of requests to the caches of a group, the first
+ * n_warmup_req requests in the batch are used to warm up the caches
+ *
+ * each cache has its own random seed so that the results are the same as
+ * simulating the caches one by one, the caches may modify the request, so
+ * each cache gets a copy
+ */
+static void _feed_batch(sim_mt_params_t *params, const int *cache_idx,
+                        int n_cache, uint64_t *rand_seeds, gint64 *runtime_us,
+                        metrics_tracker_t **trackers, const request_t *batch,
+                        int n_req, int n_warmup_req, request_t *req) {
+  cache_stat_t *result = params->result;
+  for (int j = 0; j < n_cache; j++) {
+    int idx = cache_idx[j];
+    cache_t *cache = params->caches[idx];
+    gint64 start_time = g_get_monotonic_time();
+    rand_seed = rand_seeds[j];
+
+    for (int i = 0; i < n_warmup_req; i++) {
+      copy_request(req, &batch[i]);
+      cache->get(cache, req);
+    }
+    result[idx].n_warmup_req += n_warmup_req;
 
-  // report progress
-  g_mutex_lock(&(params->mtx));
-  (*(params->progress))++;
-  g_mutex_unlock(&(params->mtx));
+    if (n_warmup_req < n_req && trackers != NULL && trackers[j] == NULL) {
+      trackers[j] =
+          create_metrics_tracker(params->metrics_recorder, idx, cache);
+    }
+    for (int i = n_warmup_req; i < n_req; i++) {
+      copy_request(req, &batch[i]);
+      result[idx].n_req++;
+      result[idx].n_req_byte += req->obj_size;
+      bool hit = cache->get(cache, req);
+      if (hit == false) {
+        result[idx].n_miss++;
+        result[idx].n_miss_byte += req->obj_size;
+      }
+      if (trackers != NULL) {
+        metrics_tracker_record(trackers[j], cache, req, hit);
+      }
+      if (result[idx].n_req % METADATA_SAMPLE_INTERVAL == 0) {
+        _sample_metadata_byte(&result[idx], cache);
+      }
+    }
 
-  // clean up
-  if (params->free_cache_when_finish) {
-    local_cache->cache_free(local_cache);
+    rand_seeds[j] = rand_seed;
+    runtime_us[j] += g_get_monotonic_time() - start_time;
+  }
+}
+
+/**
+ * @brief simulate a group of caches in lock step, it has the same warmup
+ * semantics as _simulate
+ *
+ * @param params
+ * @param group
+ */
+static void _simulate_tile(sim_mt_params_t *params, int group) {
+  const int *cache_idx = params->job_order + params->group_start[group];
+  int n_cache = params->group_start[group + 1] - params->group_start[group];
+  int batch_size = params->batch_size;
+
+  request_t *batch = my_malloc_n(request_t, batch_size);
+  for (int i = 0; i < batch_size; i++) {
+    request_t *tmp = new_request();
+    copy_request(&batch[i], tmp);
+    free_request(tmp);
+  }
+  request_t *req = new_request();
+  uint64_t *rand_seeds = my_malloc_n(uint64_t, n_cache);
+  gint64 *runtime_us = my_malloc_n(gint64, n_cache);
+  memset(rand_seeds, 0, sizeof(uint64_t) * n_cache);
+  memset(runtime_us, 0, sizeof(gint64) * n_cache);
+  /* the trackers are created when the warm up of the caches finishes */
+  metrics_tracker_t **trackers = NULL;
+  if (params->metrics_recorder != NULL) {
+    trackers = my_malloc_n(metrics_tracker_t *, n_cache);
+    memset(trackers, 0, sizeof(metrics_tracker_t *) * n_cache);
+  }
+
+  for (int j = 0; j < n_cache; j++) {
+    strncpy(params->result[cache_idx[j]].cache_name,
+            params->caches[cache_idx[j]]->cache_name, CACHE_NAME_ARRAY_LEN);
+  }
+
+  int n_req;
+  /* warm up using warmup_reader */
+  if (params->warmup_reader) {
+    reader_t *warmup_cloned_reader = clone_reader(params->warmup_reader);
+    while ((n_req = _read_batch(warmup_cloned_reader, batch, batch_size)) > 0) {
+      _feed_batch(params, cache_idx, n_cache, rand_seeds, runtime_us, NULL,
+                  batch, n_req, n_req, req);
+    }
+    close_reader(warmup_cloned_reader);
+  }
+
+  /* using warmup_frac or warmup_sec of requests from reader to warm up */
+  reader_t *cloned_reader = clone_reader(params->reader);
+  bool in_warmup = params->n_warmup_req > 0 || params->warmup_sec > 0;
+  uint64_t n_warmup = 0;
+  int64_t start_ts = 0, curr_rtime = 0;
+  bool first_batch = true;
+  while ((n_req = _read_batch(cloned_reader, batch, batch_size)) > 0) {
+    if (first_batch) {
+      start_ts = batch[0].clock_time;
+      first_batch = false;
+    }
+    int n_warmup_req = 0;
+    for (int i = 0; i < n_req; i++) {
+      if (in_warmup) {
+        if (n_warmup < params->n_warmup_req ||
+            batch[i].clock_time - start_ts < params->warmup_sec) {
+          n_warmup++;
+          n_warmup_req++;
+        } else {
+          in_warmup = false;
+        }
+      }
+      batch[i].clock_time -= start_ts;
+    }
+    curr_rtime = batch[n_req - 1].clock_time;
+    _feed_batch(params, cache_idx, n_cache, rand_seeds, runtime_us, trackers,
+                batch, n_req, n_warmup_req, req);
+  }
+  close_reader(cloned_reader);
+
+  for (int j = 0; j < n_cache; j++) {
+    params->result[cache_idx[j]].curr_rtime = curr_rtime;
+    if (trackers != NULL && trackers[j] != NULL) {
+      free_metrics_tracker(trackers[j], params->caches[cache_idx[j]],
+                           curr_rtime);
+    }
+    _finish_simulation(params, cache_idx[j],
+                       (double)runtime_us[j] / G_TIME_SPAN_SECOND);
+  }
+
+  my_free(sizeof(request_t) * batch_size, batch);
+  my_free(sizeof(uint64_t) * n_cache, rand_seeds);
+  my_free(sizeof(gint64) * n_cache, runtime_us);
+  if (trackers != NULL) {
+    my_free(sizeof(metrics_tracker_t *) * n_cache, trackers);
+  }
+  free_request(req);
+}
+
+/* the mean request size of the first requests */
+static int64_t _sample_mean_req_size(reader_t *reader, int n_sample) {
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  int64_t n_req = 0, n_byte = 0;
+  while (n_req < n_sample && read_one_req(cloned_reader, req) == 0 &&
+         req->valid) {
+    n_req++;
+    n_byte += req->obj_size;
   }
   free_request(req);
   close_reader(cloned_reader);
+  return n_req == 0 ? 1 : MAX(n_byte / n_req, 1);
+}
+
+/* the object metadata and hash table of a full cache */
+static int64_t _estimate_cache_metadata_byte(const cache_t *cache,
+                                             int64_t mean_obj_size) {
+  int64_t n_obj = (int64_t)cache->cache_size / mean_obj_size + 1;
+  return n_obj * (int64_t)cache_get_obj_struct_size(cache) +
+         (int64_t)hashsize(cache->hashtable->hashpower) *
+             (int64_t)sizeof(cache_obj_t *);
+}
+
+/**
+ * @brief split the caches (in job order) into groups, a group takes at most
+ * its worker's share of the LLC and each worker gets at least one group
+ *
+ * @param params
+ */
+static void _build_tiles(sim_mt_params_t *params) {
+  int n_caches = (int)params->n_caches;
+  params->batch_size =
+      (int)MAX(get_cpu_cache_size(2) / 2 / (int64_t)sizeof(request_t), 64);
+
+  int64_t mean_obj_size =
+      _sample_mean_req_size(params->reader, params->batch_size);
+  int64_t llc_share = get_cpu_cache_size(3) / params->n_worker;
+  int max_group_size = (n_caches + params->n_worker - 1) / params->n_worker;
+
+  params->group_start = my_malloc_n(int, n_caches + 1);
+  params->n_group = 0;
+  int64_t group_md_byte = 0;
+  int group_size = 0;
+  for (int i = 0; i < n_caches; i++) {
+    int64_t md_byte = _estimate_cache_metadata_byte(
+        params->caches[params->job_order[i]], mean_obj_size);
+    if (group_size == 0 || group_size >= max_group_size ||
+        group_md_byte + md_byte > llc_share) {
+      params->group_start[params->n_group++] = i;
+      group_md_byte = 0;
+      group_size = 0;
+    }
+    group_md_byte += md_byte;
+    group_size++;
+  }
+  params->group_start[params->n_group] = n_caches;
+
+  INFO("tiled simulation: %d caches in %d groups, batch %d requests\n",
+       n_caches, params->n_group, params->batch_size);
+}
+
+static gpointer _sim_worker(gpointer data) {
+  sim_mt_params_t *params = (sim_mt_params_t *)data;
+
+  if (params->pin_worker) {
+    /* set_thread_affinity assigns cores round-robin and is not thread-safe */
+    g_mutex_lock(&(params->mtx));
+    set_thread_affinity(pthread_self());
+    g_mutex_unlock(&(params->mtx));
+  }
+
+  while (true) {
+    int job = g_atomic_int_add(&(params->next_job), 1);
+    if (params->tiled) {
+      if (job >= params->n_group) break;
+      _simulate_tile(params, job);
+    } else {
+      if (job >= params->n_caches) break;
+      _simulate(GUINT_TO_POINTER(params->job_order[job] + 1), params);
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief run the simulations in params on num_of_threads workers and block
+ * until all of them finish
+ *
+ * @param params
+ * @param num_of_threads
+ */
+static void _run_simulations(sim_mt_params_t *params, int num_of_threads) {
+  int n_caches = (int)params->n_caches;
+  if (num_of_threads < 1) num_of_threads = 1;
+  params->n_worker = MIN(num_of_threads, n_caches);
+  params->pin_worker = num_of_threads <= get_n_cores();
+  params->next_job = 0;
+  g_cond_init(&(params->progress_cond));
+  _schedule_jobs(params, num_of_threads);
+  if (params->tiled) _build_tiles(params);
+
+  GThread **workers = my_malloc_n(GThread *, params->n_worker);
+  for (int i = 0; i < params->n_worker; i++) {
+    workers[i] = g_thread_new("simulator", _sim_worker, params);
+  }
+
+  // wait for all simulations to finish
+  g_mutex_lock(&(params->mtx));
+  while (*(params->progress) < n_caches) {
+    gint64 end_time = g_get_monotonic_time() +
+                      PROGRESS_REPORT_INTERVAL_SEC * G_TIME_SPAN_SECOND;
+    if (!g_cond_wait_until(&(params->progress_cond), &(params->mtx),
+                           end_time)) {
+      INFO("%d/%d simulations finished\n", *(params->progress), n_caches);
+    }
+  }
+  g_mutex_unlock(&(params->mtx));
+
+  for (int i = 0; i < params->n_worker; i++) {
+    g_thread_join(workers[i]);
+  }
+  my_free(sizeof(GThread *) * params->n_worker, workers);
+  my_free(sizeof(int) * n_caches, params->job_order);
+  if (params->tiled) {
+    my_free(sizeof(int) * (n_caches + 1), params->group_start);
+  }
+  g_cond_clear(&(params->progress_cond));
 }
 
 cache_stat_t *simulate_at_multi_sizes_with_step_size(
@@ -149,7 +645,7 @@ cache_stat_t *simulate_at_multi_sizes_with_step_size(
 
   cache_stat_t *res = simulate_at_multi_sizes(
       reader, cache, num_of_sizes, cache_sizes, warmup_reader, warmup_frac,
-      warmup_sec, num_of_threads);
+      warmup_sec, num_of_threads, NULL);
   my_free(sizeof(uint64_t) * num_of_sizes, cache_sizes);
   return res;
 }
@@ -174,7 +670,8 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
                                       const uint64_t *cache_sizes,
                                       reader_t *warmup_reader,
                                       double warmup_frac, int warmup_sec,
-                                      int num_of_threads) {
+                                      int num_of_threads,
+                                      metrics_recorder_t *metrics_recorder) {
   int progress = 0;
 
   cache_stat_t *result = my_malloc_n(cache_stat_t, num_of_sizes);
@@ -190,22 +687,15 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
       (uint64_t)((double)get_num_of_req(reader) * warmup_frac);
   params->result = result;
   params->free_cache_when_finish = true;
+  params->tiled = false;
+  params->metrics_recorder = metrics_recorder;
   params->progress = &progress;
   g_mutex_init(&(params->mtx));
 
-  // build the thread pool
-  GThreadPool *gthread_pool = g_thread_pool_new(
-      (GFunc)_simulate, (gpointer)params, num_of_threads, TRUE, NULL);
-  ASSERT_NOT_NULL(gthread_pool, "cannot create thread pool in simulator\n");
-
-  // start computation
   params->caches = my_malloc_n(cache_t *, num_of_sizes);
-  for (int i = 1; i < num_of_sizes + 1; i++) {
-    params->caches[i - 1] =
-        create_cache_with_new_size(cache, cache_sizes[i - 1]);
-    result[i - 1].cache_size = cache_sizes[i - 1];
-    ASSERT_TRUE(g_thread_pool_push(gthread_pool, GSIZE_TO_POINTER(i), NULL),
-                "cannot push data into thread_pool in get_miss_ratio\n");
+  for (int i = 0; i < num_of_sizes; i++) {
+    params->caches[i] = create_cache_with_new_size(cache, cache_sizes[i]);
+    result[i].cache_size = cache_sizes[i];
   }
 
   char start_cache_size[64], end_cache_size[64];
@@ -218,13 +708,10 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
       __func__, cache->cache_name, (long long)(params->n_warmup_req),
       start_cache_size, end_cache_size, num_of_sizes, num_of_threads);
 
-  // wait for all simulations to finish
-  while (progress < (uint64_t)num_of_sizes - 1) {
-    print_progress((double)progress / (double)(num_of_sizes - 1) * 100);
-  }
+  // start computation and wait for all simulations to finish
+  _run_simulations(params, num_of_threads);
 
   // clean up
-  g_thread_pool_free(gthread_pool, FALSE, TRUE);
   g_mutex_clear(&(params->mtx));
   my_free(sizeof(cache_t *) * num_of_sizes, params->caches);
   my_free(sizeof(sim_mt_params_t), params);
@@ -233,24 +720,11 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
   return result;
 }
 
-/**
- * @brief run multiple simulations in parallel
- *
- * @param reader
- * @param caches
- * @param num_of_caches
- * @param warmup_reader
- * @param warmup_frac
- * @param warmup_sec
- * @param num_of_threads
- * @return cache_stat_t*
- */
-cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
-                                         int num_of_caches,
-                                         reader_t *warmup_reader,
-                                         double warmup_frac, int warmup_sec,
-                                         int num_of_threads,
-                                         bool free_cache_when_finish) {
+static cache_stat_t *_simulate_with_multi_caches(
+    reader_t *reader, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    int num_of_threads, bool free_cache_when_finish, bool tiled,
+    metrics_recorder_t *metrics_recorder) {
   assert(num_of_caches > 0);
   int i, progress = 0;
 
@@ -261,6 +735,7 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
   sim_mt_params_t *params = my_malloc(sim_mt_params_t);
   params->reader = reader;
   params->caches = caches;
+  params->n_caches = num_of_caches;
   params->warmup_reader = warmup_reader;
   params->warmup_sec = warmup_sec;
   if (warmup_frac > 1e-6) {
@@ -271,20 +746,13 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
   }
   params->result = result;
   params->free_cache_when_finish = free_cache_when_finish;
+  params->tiled = tiled;
+  params->metrics_recorder = metrics_recorder;
   params->progress = &progress;
   g_mutex_init(&(params->mtx));
 
-  // build the thread pool
-  GThreadPool *gthread_pool = g_thread_pool_new(
-      (GFunc)_simulate, (gpointer)params, num_of_threads, TRUE, NULL);
-  ASSERT_NOT_NULL(gthread_pool, "cannot create thread pool in simulator\n");
-
-  // start computation
-  for (i = 1; i < num_of_caches + 1; i++) {
-    result[i - 1].cache_size = caches[i - 1]->cache_size;
-
-    ASSERT_TRUE(g_thread_pool_push(gthread_pool, GSIZE_TO_POINTER(i), NULL),
-                "cannot push data into thread_pool in get_miss_ratio\n");
+  for (i = 0; i < num_of_caches; i++) {
+    result[i].cache_size = caches[i]->cache_size;
   }
 
   char start_cache_size[64], end_cache_size[64];
@@ -294,17 +762,14 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
   INFO(
       "%s starts computation, num_warmup_req %lld, start cache %s size %s, "
       "end cache %s size %s, %d caches, %d threads, please wait\n",
-      __func__, (long long)(params->n_warmup_req), caches[0]->cache_name,
+      tiled ? "simulate_with_multi_caches_tiled" : "simulate_with_multi_caches", (long long)(params->n_warmup_req), caches[0]->cache_name,
       start_cache_size, caches[num_of_caches - 1]->cache_name, end_cache_size,
       num_of_caches, num_of_threads);
 
-  // wait for all simulations to finish
-  while (progress < (uint64_t)num_of_caches - 1) {
-    print_progress((double)progress / (double)(num_of_caches - 1) * 100);
-  }
+  // start computation and wait for all simulations to finish
+  _run_simulations(params, num_of_threads);
 
   // clean up
-  g_thread_pool_free(gthread_pool, FALSE, TRUE);
   g_mutex_clear(&(params->mtx));
   my_free(sizeof(sim_mt_params_t), params);
 
@@ -312,6 +777,247 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
   return result;
 }
 
+/**
+ * @brief run multiple simulations in parallel
+ *
+ * @param reader
+ * @param caches
+ * @param num_of_caches
+ * @param warmup_reader
+ * @param warmup_frac
+ * @param warmup_sec
+ * @param num_of_threads
+ * @param free_cache_when_finish
+ * @param metrics_recorder
+ * @return cache_stat_t*
+ */
+cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
+                                         int num_of_caches,
+                                         reader_t *warmup_reader,
+                                         double warmup_frac, int warmup_sec,
+                                         int num_of_threads,
+                                         bool free_cache_when_finish,
+                                         metrics_recorder_t *metrics_recorder) {
+  return _simulate_with_multi_caches(reader, caches, num_of_caches,
+                                     warmup_reader, warmup_frac, warmup_sec,
+                                     num_of_threads, free_cache_when_finish,
+                                     false, metrics_recorder);
+}
+
+/**
+ * @brief run multiple simulations in parallel, each worker simulates a group
+ * of caches in lock step on batches of requests, this reads the trace once
+ * per group instead of once per cache and is faster for many small caches
+ *
+ * @param reader
+ * @param caches
+ * @param num_of_caches
+ * @param warmup_reader
+ * @param warmup_frac
+ * @param warmup_sec
+ * @param num_of_threads
+ * @param free_cache_when_finish
+ * @param metrics_recorder
+ * @return cache_stat_t*
+ */
+cache_stat_t *simulate_with_multi_caches_tiled(
+    reader_t *reader, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    int num_of_threads, bool free_cache_when_finish,
+    metrics_recorder_t *metrics_recorder) {
+  return _simulate_with_multi_caches(reader, caches, num_of_caches,
+                                     warmup_reader, warmup_frac, warmup_sec,
+                                     num_of_threads, free_cache_when_finish,
+                                     true, metrics_recorder);
+}
+
+/* runs in the child process, it changes the warm cache in place and never
+ * returns, the result is written to the memory shared with the parent */
+static void _simulate_branch(reader_t *reader, cache_t *cache,
+                             const sim_branch_t *branch, int64_t n_prefix_req,
+                             cache_stat_t *result) {
+  gint64 start_time = g_get_monotonic_time();
+
+  if (branch->eviction_params != NULL) {
+    if (cache->set_params == NULL) {
+      WARN("%s does not support changing the parameters of a warm cache\n",
+           cache->cache_name);
+      _exit(1);
+    }
+    if (!cache->set_params(cache, branch->eviction_params)) {
+      _exit(1);
+    }
+  }
+  if (branch->admission_algo != NULL) {
+    if (cache->admissioner != NULL) {
+      cache->admissioner->free(cache->admissioner);
+    }
+    cache->admissioner =
+        create_admissioner(branch->admission_algo, branch->admission_params);
+    if (cache->admissioner == NULL) {
+      _exit(1);
+    }
+  }
+  strncpy(result->cache_name, cache->cache_name, CACHE_NAME_ARRAY_LEN);
+
+  /* each child opens the trace again because an inherited file descriptor
+   * shares its offset with the parent and the other children */
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  read_one_req(cloned_reader, req);
+  int64_t start_ts = (int64_t)req->clock_time;
+  for (int64_t i = 0; i < n_prefix_req && req->valid; i++) {
+    read_one_req(cloned_reader, req);
+  }
+
+  while (req->valid) {
+    result->n_req++;
+    result->n_req_byte += req->obj_size;
+
+    req->clock_time -= start_ts;
+    if (cache->get(cache, req) == false) {
+      result->n_miss++;
+      result->n_miss_byte += req->obj_size;
+    }
+    if (result->n_req % METADATA_SAMPLE_INTERVAL == 0) {
+      _sample_metadata_byte(result, cache);
+    }
+    read_one_req(cloned_reader, req);
+  }
+
+  result->curr_rtime = req->clock_time;
+  result->n_obj = cache->get_n_obj(cache);
+  result->occupied_byte = cache->get_occupied_byte(cache);
+  _sample_metadata_byte(result, cache);
+  result->runtime_sec =
+      (double)(g_get_monotonic_time() - start_time) / G_TIME_SPAN_SECOND;
+
+  /* skip freeing, touching the cache would copy the pages shared with the
+   * parent */
+  fflush(stdout);
+  fflush(stderr);
+  _exit(0);
+}
+
+/* wait for one of the branches to finish, return the index of its branch or
+ * -(index + 1) if it failed, only the pids of the branches are waited on, so
+ * the children started by the caller are not reaped */
+static int _wait_branch(pid_t *pids, int num_of_branches) {
+  while (true) {
+    for (int i = 0; i < num_of_branches; i++) {
+      if (pids[i] <= 0) continue;
+
+      int status;
+      pid_t pid = waitpid(pids[i], &status, WNOHANG);
+      if (pid == 0) continue;
+      if (pid < 0) {
+        ERROR("waitpid %d failed: %s\n", (int)pids[i], strerror(errno));
+        pids[i] = 0;
+        return -(i + 1);
+      }
+
+      pids[i] = 0;
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        WARN("branch %d (pid %d) failed\n", i, (int)pid);
+        return -(i + 1);
+      }
+      return i;
+    }
+    /* a branch runs for at least seconds, polling costs little */
+    usleep(1000);
+  }
+}
+
+cache_stat_t *simulate_with_forked_branches(reader_t *reader, cache_t *cache,
+                                            double prefix_frac,
+                                            const sim_branch_t branches[],
+                                            int num_of_branches,
+                                            int num_of_threads) {
+  assert(num_of_branches > 0);
+  set_rand_seed(0);
+
+  /* warm up the cache with the common prefix */
+  gint64 start_time = g_get_monotonic_time();
+  int64_t n_prefix_req = (int64_t)((double)get_num_of_req(reader) * prefix_frac);
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  read_one_req(cloned_reader, req);
+  int64_t start_ts = (int64_t)req->clock_time;
+  int64_t n_req = 0;
+  while (req->valid && n_req < n_prefix_req) {
+    req->clock_time -= start_ts;
+    cache->get(cache, req);
+    n_req += 1;
+    read_one_req(cloned_reader, req);
+  }
+  n_prefix_req = n_req;
+  free_request(req);
+  close_reader(cloned_reader);
+
+  INFO("%s: cache %s finishes the prefix of %lld requests in %.2lf sec, "
+       "forking %d branches with %d processes\n",
+       __func__, cache->cache_name, (long long)n_prefix_req,
+       (double)(g_get_monotonic_time() - start_time) / G_TIME_SPAN_SECOND,
+       num_of_branches, num_of_threads);
+
+  /* the children write their results to shared memory */
+  size_t result_size = sizeof(cache_stat_t) * num_of_branches;
+  cache_stat_t *shared_result =
+      mmap(NULL, result_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+           -1, 0);
+  if (shared_result == MAP_FAILED) {
+    ERROR("cannot allocate shared memory: %s\n", strerror(errno));
+  }
+  memset(shared_result, 0, result_size);
+  for (int i = 0; i < num_of_branches; i++) {
+    shared_result[i].cache_size = cache->cache_size;
+    shared_result[i].n_warmup_req = n_prefix_req;
+  }
+
+  pid_t *pids = my_malloc_n(pid_t, num_of_branches);
+  memset(pids, 0, sizeof(pid_t) * num_of_branches);
+  int n_running = 0, n_failed = 0;
+  for (int i = 0; i < num_of_branches; i++) {
+    while (n_running >= MAX(num_of_threads, 1)) {
+      int ret = _wait_branch(pids, num_of_branches);
+      n_running--;
+      if (ret < 0) n_failed++;
+    }
+
+    /* the buffered output would be printed again by the child */
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+      ERROR("fork failed: %s\n", strerror(errno));
+    } else if (pid == 0) {
+      _simulate_branch(reader, cache, &branches[i], n_prefix_req,
+                       &shared_result[i]);
+    }
+    pids[i] = pid;
+    n_running++;
+  }
+
+  while (n_running > 0) {
+    int ret = _wait_branch(pids, num_of_branches);
+    n_running--;
+    if (ret < 0) n_failed++;
+  }
+
+  cache_stat_t *result = my_malloc_n(cache_stat_t, num_of_branches);
+  memcpy(result, shared_result, result_size);
+  munmap(shared_result, result_size);
+  my_free(sizeof(pid_t) * num_of_branches, pids);
+
+  INFO("%s: %d branches finish in %.2lf sec, %d failed\n", __func__,
+       num_of_branches,
+       (double)(g_get_monotonic_time() - start_time) / G_TIME_SPAN_SECOND,
+       n_failed);
+
+  // user is responsible for free-ing the result
+  return result;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,13 +3,35 @@
 //
 
 #include <algorithm>  // std::make_heap, std::pop_heap, std::push_heap, std::sort_heap
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>  // std::vector
 
 #include "analyzer.h"
 #include "utils/include/utils.h"
 
 void traceAnalyzer::TraceAnalyzer::initialize() {
-  obj_map_.reserve(DEFAULT_PREALLOC_N_OBJ);
+  need_obj_map_ = !option_.obj_stat_sketch || option_.req_rate ||
+                  option_.popularity_decay || option_.prob_at_age ||
+                  option_.size_change ||
+                  (option_.size && !option_.size_sketch) ||
+                  (option_.reuse && !option_.reuse_sketch) ||
+                  (option_.popularity && !option_.popularity_sketch);
+
+  obj_map_shards_.resize(n_thread_);
+  if (need_obj_map_) {
+    /* use the number of objects in the trace header if there is one */
+    int64_t n_obj_hint = reader_->n_total_obj > 0
+                             ? reader_->n_total_obj
+                             : (int64_t)DEFAULT_PREALLOC_N_OBJ;
+    for (auto &shard : obj_map_shards_) {
+      shard.reserve(n_obj_hint / n_thread_ + 1);
+    }
+  } else {
+    obj_stat_sketch_ = new ObjStatSketch(sketch_n_sample_obj_);
+  }
 
   op_stat_ = new OpStat();
 
@@ -25,14 +47,23 @@ void traceAnalyzer::TraceAnalyzer::initialize() {
     access_stat_ = new AccessPattern(access_pattern_sample_ratio_inv_);
   }
 
-  if (option_.size) {
+  if (option_.size && option_.size_sketch) {
+    size_sketch_ = new SizeSketch(sketch_n_sample_obj_);
+  } else if (option_.size) {
     size_stat_ = new SizeDistribution(output_path_, time_window_);
   }
 
-  if (option_.reuse) {
+  if (option_.reuse && option_.reuse_sketch) {
+    reuse_sketch_ = new ReuseSketch(sketch_n_sample_obj_);
+  } else if (option_.reuse) {
     reuse_stat_ = new ReuseDistribution(output_path_, time_window_);
   }
 
+  if (option_.popularity && option_.popularity_sketch) {
+    popularity_sketch_ =
+        new PopularitySketch(sketch_top_k_, sketch_n_sample_obj_);
+  }
+
   if (option_.popularity_decay) {
     popularity_decay_stat_ =
         new PopularityDecay(output_path_, time_window_, warmup_time_);
@@ -55,6 +86,83 @@ void traceAnalyzer::TraceAnalyzer::initialize() {
   }
 
   // scan_detector_ = new ScanDetector(reader_, output_path, 100);
+
+  /* op stat uses overwrite, which is computed from the object map, or
+   * estimated by the object sketch if there is no object map */
+  modules_.push_back({"op", need_obj_map_,
+                      [this](request_t *req) { op_stat_->add_req(req); }});
+  if (obj_stat_sketch_ != nullptr) {
+    modules_.push_back({"objStatSketch", false, [this](request_t *req) {
+                          obj_stat_sketch_->add_req(req);
+                        }});
+  }
+  if (ttl_stat_ != nullptr) {
+    modules_.push_back(
+        {"ttl", false, [this](request_t *req) { ttl_stat_->add_req(req); }});
+  }
+  if (req_rate_stat_ != nullptr) {
+    modules_.push_back({"reqRate", true, [this](request_t *req) {
+                          req_rate_stat_->add_req(req);
+                        }});
+  }
+  if (size_stat_ != nullptr) {
+    modules_.push_back(
+        {"size", true, [this](request_t *req) { size_stat_->add_req(req); }});
+  }
+  if (reuse_stat_ != nullptr) {
+    modules_.push_back(
+        {"reuse", true, [this](request_t *req) { reuse_stat_->add_req(req); }});
+  }
+  if (access_stat_ != nullptr) {
+    modules_.push_back({"accessPattern", false, [this](request_t *req) {
+                          access_stat_->add_req(req);
+                        }});
+  }
+  if (popularity_decay_stat_ != nullptr) {
+    modules_.push_back({"popularityDecay", true, [this](request_t *req) {
+                          popularity_decay_stat_->add_req(req);
+                        }});
+  }
+  if (prob_at_age_ != nullptr) {
+    modules_.push_back({"probAtAge", true, [this](request_t *req) {
+                          prob_at_age_->add_req(req);
+                        }});
+  }
+  if (lifetime_stat_ != nullptr) {
+    modules_.push_back({"lifetime", false, [this](request_t *req) {
+                          lifetime_stat_->add_req(req);
+                        }});
+  }
+  if (create_future_reuse_ != nullptr) {
+    modules_.push_back({"createFutureReuse", false, [this](request_t *req) {
+                          create_future_reuse_->add_req(req);
+                        }});
+  }
+  if (size_change_distribution_ != nullptr) {
+    modules_.push_back({"sizeChange", true, [this](request_t *req) {
+                          size_change_distribution_->add_req(req);
+                        }});
+  }
+  if (scan_detector_ != nullptr) {
+    modules_.push_back({"scanDetector", false, [this](request_t *req) {
+                          scan_detector_->add_req(req);
+                        }});
+  }
+  if (popularity_sketch_ != nullptr) {
+    modules_.push_back({"popularitySketch", false, [this](request_t *req) {
+                          popularity_sketch_->add_req(req);
+                        }});
+  }
+  if (size_sketch_ != nullptr) {
+    modules_.push_back({"sizeSketch", false, [this](request_t *req) {
+                          size_sketch_->add_req(req);
+                        }});
+  }
+  if (reuse_sketch_ != nullptr) {
+    modules_.push_back({"reuseSketch", false, [this](request_t *req) {
+                          reuse_sketch_->add_req(req);
+                        }});
+  }
 }
 
 void traceAnalyzer::TraceAnalyzer::cleanup() {
@@ -77,6 +185,11 @@ void traceAnalyzer::TraceAnalyzer::cleanup() {
 
   delete scan_detector_;
 
+  delete obj_stat_sketch_;
+  delete popularity_sketch_;
+  delete size_sketch_;
+  delete reuse_sketch_;
+
   if (n_hit_cnt_ != nullptr) {
     delete[] n_hit_cnt_;
   }
@@ -85,145 +198,72 @@ void traceAnalyzer::TraceAnalyzer::cleanup() {
   }
 }
 
-void traceAnalyzer::TraceAnalyzer::run() {
-  if (has_run_) return;
-
-  request_t *req = new_request();
-  read_one_req(reader_, req);
-  start_ts_ = req->clock_time;
-  int32_t curr_time_window_idx = 0;
-  int next_time_window_ts = time_window_;
-
-  int64_t n = 0;
-  /* going through the trace */
-  do {
-    DEBUG_ASSERT(req->obj_size != 0);
-
-    // change real time to relative time
-    req->clock_time -= start_ts_;
-
-    while (req->clock_time >= next_time_window_ts) {
-      curr_time_window_idx += 1;
-      next_time_window_ts += time_window_;
-    }
-
-    if (curr_time_window_idx != time_to_window_idx(req->clock_time)) {
-      ERROR(
-          "The data is not ordered by time, please sort the trace first!"
-          "Current time %ld requested object %lu, obj size %lu\n",
-          (long)(req->clock_time + start_ts_), (unsigned long)req->obj_id,
-          (long)req->obj_size);
-    }
-
-    DEBUG_ASSERT(curr_time_window_idx == time_to_window_idx(req->clock_time));
-
-    n_req_ += 1;
-    sum_obj_size_req += req->obj_size;
-
-    auto it = obj_map_.find(req->obj_id);
-    if (it == obj_map_.end()) {
-      /* the first request to the object */
-      req->compulsory_miss =
-          true; /* whether the object is seen for the first time */
-      req->overwrite = false;
-      req->first_seen_in_window = true;
-      req->create_rtime = (int32_t)req->clock_time;
-      req->prev_size = -1;
-      //      req->last_seen_window_idx = curr_time_window_idx;
-
-      req->vtime_since_last_access = -1;
-      req->rtime_since_last_access = -1;
-
-      struct obj_info obj_info;
-      obj_info.create_rtime = (int32_t)req->clock_time;
-      obj_info.freq = 1;
-      obj_info.obj_size = (obj_size_t)req->obj_size;
-      obj_info.last_access_rtime = (int32_t)req->clock_time;
-      obj_info.last_access_vtime = n_req_;
-
-      obj_map_[req->obj_id] = obj_info;
-      sum_obj_size_obj += req->obj_size;
-
+void traceAnalyzer::TraceAnalyzer::update_obj_info(obj_info_map_type &obj_map,
+                                                   request_t *req,
+                                                   int64_t vtime,
+                                                   int32_t window_idx,
+                                                   uint64_t *sum_obj_size_obj) {
+  auto it = obj_map.find(req->obj_id);
+  if (it == obj_map.end()) {
+    /* the first request to the object */
+    req->compulsory_miss =
+        true; /* whether the object is seen for the first time */
+    req->overwrite = false;
+    req->first_seen_in_window = true;
+    req->create_rtime = (int32_t)req->clock_time;
+    req->prev_size = -1;
+    //      req->last_seen_window_idx = curr_time_window_idx;
+
+    req->vtime_since_last_access = -1;
+    req->rtime_since_last_access = -1;
+
+    struct obj_info obj_info;
+    obj_info.create_rtime = (int32_t)req->clock_time;
+    obj_info.freq = 1;
+    obj_info.obj_size = (obj_size_t)req->obj_size;
+    obj_info.last_access_rtime = (int32_t)req->clock_time;
+    obj_info.last_access_vtime = vtime;
+
+    obj_map[req->obj_id] = obj_info;
+    *sum_obj_size_obj += req->obj_size;
+
+  } else {
+    req->compulsory_miss = false;
+    req->first_seen_in_window =
+        (time_to_window_idx(it->second.last_access_rtime) != window_idx);
+    req->create_rtime = it->second.create_rtime;
+    if (req->op == OP_SET || req->op == OP_REPLACE || req->op == OP_CAS) {
+      req->overwrite = true;
     } else {
-      req->compulsory_miss = false;
-      req->first_seen_in_window =
-          (time_to_window_idx(it->second.last_access_rtime) !=
-           curr_time_window_idx);
-      req->create_rtime = it->second.create_rtime;
-      if (req->op == OP_SET || req->op == OP_REPLACE || req->op == OP_CAS) {
-        req->overwrite = true;
-      } else {
-        req->overwrite = false;
-      }
-      req->vtime_since_last_access =
-          (int64_t)n_req_ - it->second.last_access_vtime;
-      req->rtime_since_last_access =
-          (int64_t)(req->clock_time) - it->second.last_access_rtime;
-
-      assert(req->vtime_since_last_access > 0);
-      assert(req->rtime_since_last_access >= 0);
-
-      req->prev_size = it->second.obj_size;
-      it->second.obj_size = req->obj_size;
-      it->second.freq += 1;
-      it->second.last_access_vtime = n_req_;
-      it->second.last_access_rtime = (int32_t)(req->clock_time);
-    }
-
-    op_stat_->add_req(req);
-
-    if (ttl_stat_ != nullptr) {
-      ttl_stat_->add_req(req);
-    }
-
-    if (req_rate_stat_ != nullptr) {
-      req_rate_stat_->add_req(req);
-    }
-
-    if (size_stat_ != nullptr) {
-      size_stat_->add_req(req);
-    }
-
-    if (reuse_stat_ != nullptr) {
-      reuse_stat_->add_req(req);
-    }
-
-    if (access_stat_ != nullptr) {
-      access_stat_->add_req(req);
-    }
-
-    if (popularity_decay_stat_ != nullptr) {
-      popularity_decay_stat_->add_req(req);
-    }
-
-    if (prob_at_age_ != nullptr) {
-      prob_at_age_->add_req(req);
-    }
-
-    if (lifetime_stat_ != nullptr) {
-      lifetime_stat_->add_req(req);
-    }
-
-    if (create_future_reuse_ != nullptr) {
-      create_future_reuse_->add_req(req);
+      req->overwrite = false;
     }
+    req->vtime_since_last_access = vtime - it->second.last_access_vtime;
+    req->rtime_since_last_access =
+        (int64_t)(req->clock_time) - it->second.last_access_rtime;
+
+    assert(req->vtime_since_last_access > 0);
+    assert(req->rtime_since_last_access >= 0);
+
+    req->prev_size = it->second.obj_size;
+    it->second.obj_size = req->obj_size;
+    it->second.freq += 1;
+    it->second.last_access_vtime = vtime;
+    it->second.last_access_rtime = (int32_t)(req->clock_time);
+  }
+}
 
-    if (size_change_distribution_ != nullptr) {
-      size_change_distribution_->add_req(req);
-    }
-    if (scan_detector_ != nullptr) {
-      scan_detector_->add_req(req);
-    }
+void traceAnalyzer::TraceAnalyzer::run() {
+  if (has_run_) return;
 
-    read_one_req(reader_, req);
-  } while (req->valid);
-  end_ts_ = req->clock_time + start_ts_;
+  if (n_thread_ > 1) {
+    run_pipelined();
+  } else {
+    run_sequential();
+  }
 
   /* processing */
   post_processing();
 
-  free_request(req);
-
   ofstream ofs("stat", ios::out | ios::app);
   ofs << gen_stat_str() << endl;
   ofs.close();
@@ -252,6 +292,18 @@ void traceAnalyzer::TraceAnalyzer::run() {
     popularity_stat_->dump(output_path_);
   }
 
+  if (popularity_sketch_ != nullptr) {
+    popularity_sketch_->dump(output_path_);
+  }
+
+  if (size_sketch_ != nullptr) {
+    size_sketch_->dump(output_path_);
+  }
+
+  if (reuse_sketch_ != nullptr) {
+    reuse_sketch_->dump(output_path_);
+  }
+
   if (popularity_decay_stat_ != nullptr) {
     popularity_decay_stat_->dump(output_path_);
   }
@@ -283,20 +335,67 @@ void traceAnalyzer::TraceAnalyzer::run() {
   has_run_ = true;
 }
 
+void traceAnalyzer::TraceAnalyzer::run_sequential() {
+  request_t *req = new_request();
+  read_one_req(reader_, req);
+  start_ts_ = req->clock_time;
+  int32_t curr_time_window_idx = 0;
+  int next_time_window_ts = time_window_;
+
+  /* going through the trace */
+  do {
+    DEBUG_ASSERT(req->obj_size != 0);
+
+    // change real time to relative time
+    req->clock_time -= start_ts_;
+
+    while (req->clock_time >= next_time_window_ts) {
+      curr_time_window_idx += 1;
+      next_time_window_ts += time_window_;
+    }
+
+    if (curr_time_window_idx != time_to_window_idx(req->clock_time)) {
+      ERROR(
+          "The data is not ordered by time, please sort the trace first!"
+          "Current time %ld requested object %lu, obj size %lu\n",
+          (long)(req->clock_time + start_ts_), (unsigned long)req->obj_id,
+          (long)req->obj_size);
+    }
+
+    DEBUG_ASSERT(curr_time_window_idx == time_to_window_idx(req->clock_time));
+
+    n_req_ += 1;
+    sum_obj_size_req += req->obj_size;
+
+    if (need_obj_map_) {
+      update_obj_info(obj_map_shards_[0], req, n_req_, curr_time_window_idx,
+                      &sum_obj_size_obj);
+    }
+
+    for (auto &module : modules_) {
+      module.add_req(req);
+    }
+
+    read_one_req(reader_, req);
+  } while (req->valid);
+  end_ts_ = req->clock_time + start_ts_;
+
+  free_request(req);
+}
 string traceAnalyzer::TraceAnalyzer::gen_stat_str() {
   stat_ss_.clear();
-  double cold_miss_ratio = (double)obj_map_.size() / (double)n_req_;
+  double cold_miss_ratio = (double)n_obj() / (double)n_req_;
   double byte_cold_miss_ratio =
       (double)sum_obj_size_obj / (double)sum_obj_size_req;
   int mean_obj_size_req = (int)((double)sum_obj_size_req / (double)n_req_);
   int mean_obj_size_obj =
-      (int)((double)sum_obj_size_obj / (double)obj_map_.size());
-  double freq_mean = (double)n_req_ / (double)obj_map_.size();
+      (int)((double)sum_obj_size_obj / (double)n_obj());
+  double freq_mean = (double)n_req_ / (double)n_obj();
   int64_t time_span = end_ts_ - start_ts_;
 
   stat_ss_ << setprecision(4) << fixed << "dat: " << reader_->trace_path << "\n"
            << "number of requests: " << n_req_
-           << ", number of objects: " << obj_map_.size() << "\n"
+           << ", number of objects: " << n_obj() << "\n"
            << "number of req GiB: " << (double)sum_obj_size_req / (double)GiB
            << ", number of obj GiB: " << (double)sum_obj_size_obj / (double)GiB
            << "\n"
@@ -314,11 +413,14 @@ string traceAnalyzer::TraceAnalyzer::gen_stat_str() {
   }
   if (req_rate_stat_ != nullptr) stat_ss_ << *req_rate_stat_;
   if (popularity_stat_ != nullptr) stat_ss_ << *popularity_stat_;
+  if (popularity_sketch_ != nullptr) stat_ss_ << *popularity_sketch_;
+  if (size_sketch_ != nullptr) stat_ss_ << *size_sketch_;
+  if (reuse_sketch_ != nullptr) stat_ss_ << *reuse_sketch_;
 
   stat_ss_ << "X-hit (number of obj accessed X times): ";
   for (int i = 0; i < track_n_hit_; i++) {
     stat_ss_ << n_hit_cnt_[i] << "("
-             << (double)n_hit_cnt_[i] / (double)obj_map_.size() << "), ";
+             << (double)n_hit_cnt_[i] / (double)n_obj() << "), ";
   }
   stat_ss_ << "\n";
 
@@ -346,17 +448,216 @@ void traceAnalyzer::TraceAnalyzer::post_processing() {
   memset(n_hit_cnt_, 0, sizeof(uint64_t) * track_n_hit_);
   memset(popular_cnt_, 0, sizeof(uint64_t) * track_n_popular_);
 
-  for (auto it : obj_map_) {
-    if (it.second.freq <= track_n_hit_) {
-      n_hit_cnt_[it.second.freq - 1] += 1;
+  if (need_obj_map_) {
+    for (const auto &shard : obj_map_shards_) {
+      for (const auto &it : shard) {
+        if (it.second.freq <= track_n_hit_) {
+          n_hit_cnt_[it.second.freq - 1] += 1;
+        }
+      }
+    }
+  } else {
+    /* estimated from the sampled objects */
+    auto n_hit_cnt = obj_stat_sketch_->n_hit_cnt(track_n_hit_);
+    for (int i = 0; i < track_n_hit_; i++) {
+      n_hit_cnt_[i] = (uint64_t)llround(n_hit_cnt[i]);
     }
+    sum_obj_size_obj = (uint64_t)obj_stat_sketch_->obj_byte();
+    op_stat_->set_overwrite_cnt(obj_stat_sketch_->n_overwrite());
   }
 
-  if (option_.popularity) {
-    popularity_stat_ = new Popularity(obj_map_);
+  if (popularity_sketch_ != nullptr) {
+    popularity_sketch_->finish();
+    auto &sorted_freq = popularity_sketch_->get_sorted_freq();
+    for (int i = 0; i < track_n_popular_ && i < (int)sorted_freq.size(); i++) {
+      popular_cnt_[i] = sorted_freq[i];
+    }
+  } else if (option_.popularity) {
+    popularity_stat_ = new Popularity(obj_map_shards_);
     auto sorted_freq = popularity_stat_->get_sorted_freq();
     for (int i = 0; i < track_n_popular_; i++) {
       popular_cnt_[i] = sorted_freq[i];
     }
   }
+
+  if (size_sketch_ != nullptr) {
+    size_sketch_->finish();
+  }
+}
+
+namespace {
+/* a batch of requests in the pipeline */
+struct req_batch {
+  std::vector<request_t> reqs;
+  int n_req = 0;
+  /* the vtime of the first request minus 1 */
+  int64_t vtime_base = 0;
+  /* the indexes of the requests of each shard */
+  std::vector<std::vector<uint32_t>> shard_req_idx;
+};
+
+/* the pipeline has three stages, the reader, the object map shards and the
+ * analyses, each thread counts the batches it has finished, a thread only
+ * waits when it catches up with the stage before it, the requests and the
+ * object map shards are not locked because each is written by one thread */
+class pipeline_sync {
+ public:
+  explicit pipeline_sync(int n_shard, int n_module)
+      : shard_done(n_shard), module_done(n_module) {
+    for (auto &v : shard_done) v = 0;
+    for (auto &v : module_done) v = 0;
+  }
+
+  std::atomic<int64_t> n_batch_read{0};
+  /* the total number of batches, known when the reader finishes */
+  std::atomic<int64_t> n_batch{INT64_MAX};
+  std::vector<std::atomic<int64_t>> shard_done;
+  std::vector<std::atomic<int64_t>> module_done;
+
+  static int64_t min_of(const std::vector<std::atomic<int64_t>> &v) {
+    int64_t m = INT64_MAX;
+    for (const auto &x : v) m = std::min(m, x.load(std::memory_order_acquire));
+    return m;
+  }
+
+  void finish(std::atomic<int64_t> &cnt, int64_t n) {
+    cnt.store(n, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(mtx_);
+    cv_.notify_all();
+  }
+
+  /* wait until ready() returns true, return false if batch b does not exist */
+  template <typename F>
+  bool wait_for(int64_t b, F ready) {
+    if (ready()) return true;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [&] {
+      return ready() || b >= n_batch.load(std::memory_order_acquire);
+    });
+    return ready();
+  }
+
+ private:
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+inline int shard_of(obj_id_t obj_id, int n_shard) {
+  return (int)(((obj_id * 0x9E3779B97F4A7C15ULL) >> 32) % (uint64_t)n_shard);
+}
+}  // namespace
+
+/**
+ * @brief the trace is read in batches by this thread, n_thread_ threads
+ * update the object map, each owns the objects of one shard, and fill the
+ * fields of the requests used in analysis, each analysis runs in its own
+ * thread and sees the requests in order, the analyses that do not need the
+ * object map run at the same time as the object map update
+ */
+void traceAnalyzer::TraceAnalyzer::run_pipelined() {
+  const int n_shard = n_thread_;
+  const int n_module = (int)modules_.size();
+  std::vector<req_batch> batches(PIPELINE_N_BATCH);
+  request_t *req = new_request();
+  for (auto &batch : batches) {
+    batch.reqs.resize(PIPELINE_BATCH_SIZE, *req);
+    batch.shard_req_idx.resize(n_shard);
+  }
+
+  pipeline_sync sync(n_shard, n_module);
+  std::vector<uint64_t> sum_obj_size_obj_shard(n_shard, 0);
+
+  auto shard_worker = [&](int s) {
+    for (int64_t b = 0;; b++) {
+      if (!sync.wait_for(b, [&] { return sync.n_batch_read.load() > b; })) {
+        break;
+      }
+      req_batch &batch = batches[b % PIPELINE_N_BATCH];
+      for (uint32_t i : batch.shard_req_idx[s]) {
+        request_t *r = &batch.reqs[i];
+        update_obj_info(obj_map_shards_[s], r, batch.vtime_base + i + 1,
+                        time_to_window_idx(r->clock_time),
+                        &sum_obj_size_obj_shard[s]);
+      }
+      sync.finish(sync.shard_done[s], b + 1);
+    }
+  };
+
+  auto module_worker = [&](int m) {
+    analysis_module &module = modules_[m];
+    for (int64_t b = 0;; b++) {
+      bool has_batch = sync.wait_for(b, [&] {
+        return module.need_obj_info ? sync.min_of(sync.shard_done) > b
+                                    : sync.n_batch_read.load() > b;
+      });
+      if (!has_batch) break;
+      req_batch &batch = batches[b % PIPELINE_N_BATCH];
+      for (int i = 0; i < batch.n_req; i++) {
+        module.add_req(&batch.reqs[i]);
+      }
+      sync.finish(sync.module_done[m], b + 1);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int s = 0; s < n_shard; s++) threads.emplace_back(shard_worker, s);
+  for (int m = 0; m < n_module; m++) threads.emplace_back(module_worker, m);
+
+  /* the reader */
+  read_one_req(reader_, req);
+  start_ts_ = req->clock_time;
+  int32_t curr_time_window_idx = 0;
+  int64_t next_time_window_ts = time_window_;
+  int64_t last_clock_time = req->clock_time;
+
+  for (int64_t b = 0; req->valid; b++) {
+    /* reuse the slot after every stage finishes the batch in it */
+    sync.wait_for(b, [&] {
+      return sync.min_of(sync.module_done) > b - PIPELINE_N_BATCH &&
+             sync.min_of(sync.shard_done) > b - PIPELINE_N_BATCH;
+    });
+
+    req_batch &batch = batches[b % PIPELINE_N_BATCH];
+    batch.vtime_base = n_req_;
+    batch.n_req = 0;
+    for (auto &idx : batch.shard_req_idx) idx.clear();
+
+    while (req->valid && batch.n_req < PIPELINE_BATCH_SIZE) {
+      DEBUG_ASSERT(req->obj_size != 0);
+      last_clock_time = req->clock_time;
+      req->clock_time -= start_ts_;
+
+      while (req->clock_time >= next_time_window_ts) {
+        curr_time_window_idx += 1;
+        next_time_window_ts += time_window_;
+      }
+      if (curr_time_window_idx != time_to_window_idx(req->clock_time)) {
+        ERROR(
+            "The data is not ordered by time, please sort the trace first!"
+            "Current time %ld requested object %lu, obj size %lu\n",
+            (long)(req->clock_time + start_ts_), (unsigned long)req->obj_id,
+            (long)req->obj_size);
+      }
+
+      n_req_ += 1;
+      sum_obj_size_req += req->obj_size;
+      if (need_obj_map_) {
+        batch.shard_req_idx[shard_of(req->obj_id, n_shard)].push_back(
+            batch.n_req);
+      }
+      batch.reqs[batch.n_req++] = *req;
+
+      read_one_req(reader_, req);
+    }
+    sync.finish(sync.n_batch_read, b + 1);
+  }
+  sync.finish(sync.n_batch, sync.n_batch_read.load());
+  end_ts_ = last_clock_time;
+
+  for (auto &t : threads) t.join();
+
+  for (int s = 0; s < n_shard; s++) {
+    sum_obj_size_obj += sum_obj_size_obj_shard[s];
+  }
+  free_request(req);
 }
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -26,6 +27,7 @@
 #include "reqRate.h"
 #include "reuse.h"
 #include "size.h"
+#include "sketchStat.h"
 #include "struct.h"
 #include "ttl.h"
 
@@ -56,6 +58,14 @@ typedef struct analysis_option {
   bool prob_at_age;
 
   bool size_change;
+
+  /* use fixed-memory sketches instead of exact per-object state, the object
+   * map is not built if none of the enabled analyses needs it */
+  bool popularity_sketch;
+  bool size_sketch;
+  bool reuse_sketch;
+  /* the number of objects, object bytes, X-hit wonders and overwrites */
+  bool obj_stat_sketch;
 } analysis_option_t;
 
 typedef struct analysis_param {
@@ -66,6 +76,14 @@ typedef struct analysis_param {
   int warmup_time;
   double access_pattern_sample_ratio;
   int access_pattern_sample_ratio_inv;
+  /* the number of threads updating the object map, if it is larger than 1,
+   * the trace is read, the object map is updated (sharded by object) and
+   * each analysis runs in different threads in a pipeline */
+  int n_thread;
+  /* the number of most popular objects tracked by the popularity sketch */
+  int sketch_top_k;
+  /* the max number of objects sampled by each sketch analysis */
+  int sketch_n_sample_obj;
 } analysis_param_t;
 
 static analysis_param_t default_param() {
@@ -76,12 +94,15 @@ static analysis_param_t default_param() {
   param.warmup_time = 86400;
   param.access_pattern_sample_ratio = 0.01;
   param.access_pattern_sample_ratio_inv = 101;
+  param.n_thread = 1;
+  param.sketch_top_k = 1024;
+  param.sketch_n_sample_obj = 1 << 17;
 
   return param;
 };
 
 static struct analysis_option default_option() {
-  struct analysis_option option = {0};
+  struct analysis_option option = {};
   option.req_rate = false;
   option.access_pattern = false;
   option.ttl = false;
@@ -93,12 +114,21 @@ static struct analysis_option default_option() {
   option.prob_at_age = false;
   option.size_change = false;
   option.lifetime = false;
+  option.popularity_sketch = false;
+  option.size_sketch = false;
+  option.reuse_sketch = false;
+  option.obj_stat_sketch = false;
 
   return option;
 };
 
 #define DEFAULT_PREALLOC_N_OBJ 1e8
 
+/* the pipeline reads the trace in batches, and keeps at most
+ * PIPELINE_N_BATCH batches in flight */
+#define PIPELINE_BATCH_SIZE 16384
+#define PIPELINE_N_BATCH 16
+
 class TraceAnalyzer {
  public:
   explicit TraceAnalyzer(reader_t *reader, string output_path,
@@ -112,7 +142,10 @@ class TraceAnalyzer {
         track_n_popular_(params.track_n_popular),
         track_n_hit_(params.track_n_hit),
         time_window_(params.time_window),
-        warmup_time_(params.warmup_time) {
+        warmup_time_(params.warmup_time),
+        n_thread_(params.n_thread > 1 ? params.n_thread : 1),
+        sketch_top_k_(params.sketch_top_k),
+        sketch_n_sample_obj_(params.sketch_n_sample_obj) {
     if (warmup_time_ % time_window_ != 0) {
       /* the popularityDecay computation needs warmup time to be multiple of
        * time_window */
@@ -150,6 +183,10 @@ class TraceAnalyzer {
   int track_n_hit_;
   // the sampling ratio used in access pattern analysis
   int access_pattern_sample_ratio_inv_;
+  // the number of threads (and shards) updating the object map
+  int n_thread_;
+  int sketch_top_k_;
+  int sketch_n_sample_obj_;
 
   /* stat */
   int64_t n_req_ = 0;
@@ -166,7 +203,17 @@ class TraceAnalyzer {
    * an object is requested, we ignore for now */
   //  uint64_t sum_req_size_req = 0, sum_req_size_obj = 0;
 
-  obj_info_map_type obj_map_;
+  /* the object map is sharded by object id, each shard is only updated by
+   * one thread */
+  std::vector<obj_info_map_type> obj_map_shards_;
+
+  size_t n_obj() const {
+    if (!need_obj_map_) return (size_t)obj_stat_sketch_->n_obj();
+
+    size_t n = 0;
+    for (const auto &shard : obj_map_shards_) n += shard.size();
+    return n;
+  }
 
  private:
   reader_t *reader_ = nullptr;
@@ -192,8 +239,36 @@ class TraceAnalyzer {
   SizeChangeDistribution *size_change_distribution_ = nullptr;
   ScanDetector *scan_detector_ = nullptr;
 
+  ObjStatSketch *obj_stat_sketch_ = nullptr;
+  PopularitySketch *popularity_sketch_ = nullptr;
+  SizeSketch *size_sketch_ = nullptr;
+  ReuseSketch *reuse_sketch_ = nullptr;
+
+  /* false if all the enabled analyses use sketches */
+  bool need_obj_map_ = true;
+
+  /* the enabled analyses, each declares whether it uses the fields computed
+   * from the object map (e.g., reuse distance), the ones that do not can
+   * start before the object map is updated in the pipeline */
+  struct analysis_module {
+    const char *name;
+    bool need_obj_info;
+    std::function<void(request_t *)> add_req;
+  };
+  std::vector<analysis_module> modules_;
+
   string output_path_;
 
+  void run_sequential();
+
+  void run_pipelined();
+
+  /* update the object map and fill the fields of req used in analysis,
+   * vtime is the index of the request starting from 1 */
+  void update_obj_info(obj_info_map_type &obj_map, request_t *req,
+                       int64_t vtime, int32_t window_idx,
+                       uint64_t *sum_obj_size_obj);
+
   void post_processing();
 
   string gen_stat_str();
@@ -26,6 +26,11 @@ class OpStat {
     if (req->overwrite) overwrite_cnt_ += 1;
   }
 
+  /* used when the overwrites are estimated without the object map */
+  inline void set_overwrite_cnt(uint64_t overwrite_cnt) {
+    overwrite_cnt_ = overwrite_cnt;
+  }
+
   friend ostream& operator<<(ostream& os, const OpStat& op) {
     stringstream stat_ss;
     uint64_t n_req = accumulate(op.op_cnt_, op.op_cnt_ + OP_INVALID + 1, 0UL);
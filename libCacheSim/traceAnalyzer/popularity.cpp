@@ -44,17 +44,24 @@ void Popularity::dump(string &path_base) {
   ofs.close();
 }
 
-void Popularity::run(obj_info_map_type &obj_map) {
+void Popularity::run(std::vector<obj_info_map_type> &obj_maps) {
+  size_t n_obj = 0;
+  for (const auto &obj_map : obj_maps) {
+    n_obj += obj_map.size();
+  }
+
   /* freq_vec_ is a sorted vec of obj frequency */
-  freq_vec_.reserve(obj_map.size());
-  for (const auto &p : obj_map) {
-    freq_vec_.push_back(p.second.freq);
+  freq_vec_.reserve(n_obj);
+  for (const auto &obj_map : obj_maps) {
+    for (const auto &p : obj_map) {
+      freq_vec_.push_back(p.second.freq);
+    }
   }
   sort(freq_vec_.begin(), freq_vec_.end(), greater<>());
 
-  if (obj_map.size() < 200) {
+  if (n_obj < 200) {
     fit_fail_reason_ = "popularity: too few objects (" +
-                       to_string(obj_map.size()) +
+                       to_string(n_obj) +
                        "), skip the popularity computation";
     WARN("%s\n", fit_fail_reason_.c_str());
     return;
@@ -67,8 +74,8 @@ void Popularity::run(obj_info_map_type &obj_map) {
   }
 
   /* calculate Zipf alpha using linear regression */
-  vector<double> log_freq(obj_map.size());
-  vector<double> log_rank(obj_map.size());
+  vector<double> log_freq(n_obj);
+  vector<double> log_rank(n_obj);
 
   int i = 0;
   for_each(log_freq.begin(), log_freq.end(),
@@ -34,7 +34,10 @@ class Popularity {
   Popularity() { has_run = false; };
   ~Popularity() = default;
 
-  explicit Popularity(obj_info_map_type &obj_map) { run(obj_map); };
+  /* the objects may be sharded into multiple maps */
+  explicit Popularity(std::vector<obj_info_map_type> &obj_maps) {
+    run(obj_maps);
+  };
 
   friend std::ostream &operator<<(std::ostream &os,
                                   const Popularity &popularity) {
@@ -61,7 +64,7 @@ class Popularity {
   std::string fit_fail_reason_ = "";
 
  private:
-  void run(obj_info_map_type &obj_map);
+  void run(std::vector<obj_info_map_type> &obj_maps);
 
   std::vector<uint32_t> freq_vec_{};
   double slope_ = -1, intercept_ = -1, r2_ = -1;
@@ -0,0 +1,188 @@
+#include "sketch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace traceAnalyzer {
+using namespace std;
+
+/**************** HyperLogLog ****************/
+double HyperLogLog::estimate() const {
+  const double m = (double)registers_.size();
+  double alpha_m = 0.7213 / (1 + 1.079 / m);
+  double sum = 0;
+  int n_zero = 0;
+  for (auto r : registers_) {
+    sum += ldexp(1.0, -r);
+    if (r == 0) n_zero += 1;
+  }
+  double est = alpha_m * m * m / sum;
+
+  /* use linear counting when the cardinality is small */
+  if (est <= 2.5 * m && n_zero > 0) {
+    est = m * log(m / (double)n_zero);
+  }
+  return est;
+}
+
+/**************** Count-Min ****************/
+uint32_t CountMinSketch::add(uint64_t hv) {
+  uint32_t est = estimate(hv);
+  if (est == UINT32_MAX) return est;
+
+  /* conservative update: only increase the counters equal to the minimum */
+  for (int row = 0; row < depth_; row++) {
+    uint32_t &c = counters_[pos(hv, row)];
+    if (c == est) c = est + 1;
+  }
+  return est + 1;
+}
+
+uint32_t CountMinSketch::estimate(uint64_t hv) const {
+  uint32_t est = UINT32_MAX;
+  for (int row = 0; row < depth_; row++) {
+    est = min(est, counters_[pos(hv, row)]);
+  }
+  return est;
+}
+
+/**************** top k ****************/
+void TopK::update(obj_id_t obj_id, uint32_t freq) {
+  auto it = pos_.find(obj_id);
+  if (it != pos_.end()) {
+    /* the estimate only increases */
+    heap_[it->second].first = freq;
+    sift_down(it->second);
+    return;
+  }
+
+  if ((int)heap_.size() < k_) {
+    heap_.emplace_back(freq, obj_id);
+    pos_[obj_id] = heap_.size() - 1;
+    sift_up(heap_.size() - 1);
+  } else if (freq > heap_[0].first) {
+    pos_.erase(heap_[0].second);
+    heap_[0] = {freq, obj_id};
+    pos_[obj_id] = 0;
+    sift_down(0);
+  }
+}
+
+void TopK::sift_down(size_t i) {
+  const size_t n = heap_.size();
+  while (true) {
+    size_t smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+    if (l < n && heap_[l].first < heap_[smallest].first) smallest = l;
+    if (r < n && heap_[r].first < heap_[smallest].first) smallest = r;
+    if (smallest == i) return;
+    swap(heap_[i], heap_[smallest]);
+    pos_[heap_[i].second] = i;
+    pos_[heap_[smallest].second] = smallest;
+    i = smallest;
+  }
+}
+
+void TopK::sift_up(size_t i) {
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (heap_[parent].first <= heap_[i].first) return;
+    swap(heap_[i], heap_[parent]);
+    pos_[heap_[i].second] = i;
+    pos_[heap_[parent].second] = parent;
+    i = parent;
+  }
+}
+
+vector<uint32_t> TopK::sorted_freq() const {
+  vector<uint32_t> freq;
+  freq.reserve(heap_.size());
+  for (const auto &p : heap_) freq.push_back(p.first);
+  sort(freq.begin(), freq.end(), greater<>());
+  return freq;
+}
+
+/**************** DDSketch ****************/
+void DDSketch::add_to_bucket(int idx, double weight) {
+  if (buckets_.empty()) {
+    min_idx_ = idx;
+    buckets_.push_back(0);
+  }
+
+  if (idx < min_idx_) {
+    int n_new = min_idx_ - idx;
+    if ((int)buckets_.size() + n_new > max_n_bucket_) {
+      /* the lowest bucket has absorbed the smaller values */
+      idx = min_idx_;
+    } else {
+      buckets_.insert(buckets_.begin(), n_new, 0);
+      min_idx_ = idx;
+    }
+  } else if (idx - min_idx_ >= (int)buckets_.size()) {
+    buckets_.resize(idx - min_idx_ + 1, 0);
+    if ((int)buckets_.size() > max_n_bucket_) {
+      /* merge the lowest buckets so that the high quantiles stay accurate */
+      int n_merge = (int)buckets_.size() - max_n_bucket_;
+      double merged = 0;
+      for (int i = 0; i <= n_merge; i++) merged += buckets_[i];
+      buckets_.erase(buckets_.begin(), buckets_.begin() + n_merge);
+      buckets_[0] = merged;
+      min_idx_ += n_merge;
+    }
+  }
+
+  buckets_[idx - min_idx_] += weight;
+}
+
+double DDSketch::quantile(double q) const {
+  if (n_ <= 0) return NAN;
+  double rank = q * n_;
+  double cum = zero_cnt_;
+  if (cum >= rank && zero_cnt_ > 0) return 0;
+
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    cum += buckets_[i];
+    if (cum >= rank) {
+      /* the middle of the bucket (in relative error) */
+      return 2 * pow(gamma_, min_idx_ + (int)i) / (gamma_ + 1);
+    }
+  }
+  return 2 * pow(gamma_, min_idx_ + (int)buckets_.size() - 1) / (gamma_ + 1);
+}
+
+/**************** sampler ****************/
+ObjSampler::sampled_obj *ObjSampler::access(obj_id_t obj_id, uint64_t hv,
+                                            bool *is_new) {
+  uint32_t sample_hv = (uint32_t)(hv >> 32);
+  *is_new = false;
+  if (sample_hv >= threshold_) return nullptr;
+
+  auto it = obj_map_.find(obj_id);
+  if (it != obj_map_.end()) return &it->second;
+
+  *is_new = true;
+  sampled_obj &obj = obj_map_[obj_id];
+  memset(&obj, 0, sizeof(obj));
+  obj.hv = sample_hv;
+  hv_heap_.emplace(sample_hv, obj_id);
+
+  /* lower the threshold to the largest hash, and drop all objects with it */
+  bool dropped_self = false;
+  while (obj_map_.size() > max_n_obj_) {
+    uint32_t max_hv = hv_heap_.top().first;
+    threshold_ = max_hv;
+    while (!hv_heap_.empty() && hv_heap_.top().first == max_hv) {
+      if (hv_heap_.top().second == obj_id) dropped_self = true;
+      obj_map_.erase(hv_heap_.top().second);
+      hv_heap_.pop();
+    }
+  }
+
+  if (dropped_self) {
+    *is_new = false;
+    return nullptr;
+  }
+  return &obj;
+}
+
+}  // namespace traceAnalyzer
@@ -0,0 +1,200 @@
+#pragma once
+/* fixed-memory sketches used by the approximate (streaming) analyses, the
+ * memory of each sketch is set at construction and does not grow with the
+ * number of requests or objects in the trace */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "struct.h"
+
+namespace traceAnalyzer {
+
+static inline uint64_t sketch_hash(uint64_t z) {
+  /* the splitmix64 finalizer, obj_id can be sequential */
+  z += 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * HyperLogLog, estimates the number of distinct objects using 2^precision
+ * one-byte registers, the standard error is 1.04 / sqrt(2^precision)
+ */
+class HyperLogLog {
+ public:
+  explicit HyperLogLog(int precision = 14)
+      : precision_(precision), registers_(1ULL << precision, 0) {}
+
+  inline void add(uint64_t hv) {
+    uint64_t idx = hv >> (64 - precision_);
+    /* the bit after the lower (64 - precision) bits bounds the rank */
+    uint64_t w = (hv << precision_) | (1ULL << (precision_ - 1));
+    uint8_t rank = (uint8_t)(__builtin_clzll(w) + 1);
+    if (rank > registers_[idx]) registers_[idx] = rank;
+  }
+
+  double estimate() const;
+
+ private:
+  int precision_;
+  std::vector<uint8_t> registers_;
+};
+
+/**
+ * Count-Min sketch with conservative update, the estimate never
+ * under-counts, and over-counts by at most e * n_req / width with
+ * probability 1 - exp(-depth)
+ */
+class CountMinSketch {
+ public:
+  explicit CountMinSketch(int depth = 4, int log2_width = 16)
+      : depth_(depth),
+        log2_width_(log2_width),
+        mask_((1ULL << log2_width) - 1),
+        counters_((size_t)depth << log2_width, 0) {}
+
+  /* add one request and return the new estimate of the object */
+  uint32_t add(uint64_t hv);
+
+  uint32_t estimate(uint64_t hv) const;
+
+ private:
+  inline size_t pos(uint64_t hv, int row) const {
+    uint64_t h2 = (hv >> 32) | 1;
+    return ((size_t)row << log2_width_) +
+           ((hv + (uint64_t)row * h2) & mask_);
+  }
+
+  int depth_;
+  int log2_width_;
+  uint64_t mask_;
+  std::vector<uint32_t> counters_;
+};
+
+/**
+ * the k objects with the largest Count-Min estimates, kept in a min-heap
+ * indexed by object id
+ */
+class TopK {
+ public:
+  explicit TopK(int k) : k_(k) {
+    heap_.reserve(k);
+    pos_.reserve(k * 2);
+  }
+
+  void update(obj_id_t obj_id, uint32_t freq);
+
+  /* the frequencies sorted in descending order */
+  std::vector<uint32_t> sorted_freq() const;
+
+ private:
+  void sift_down(size_t i);
+
+  void sift_up(size_t i);
+
+  int k_;
+  std::vector<std::pair<uint32_t, obj_id_t>> heap_;
+  robin_hood::unordered_flat_map<obj_id_t, size_t> pos_;
+};
+
+/**
+ * DDSketch, a quantile sketch with relative error, a value v is counted in
+ * bucket ceil(log_gamma(v)) where gamma = (1 + alpha) / (1 - alpha), when the
+ * number of buckets exceeds the limit, the lowest buckets are merged
+ */
+class DDSketch {
+ public:
+  explicit DDSketch(double rel_acc = 0.01, int max_n_bucket = 2048)
+      : gamma_((1 + rel_acc) / (1 - rel_acc)),
+        log_gamma_(log(gamma_)),
+        max_n_bucket_(max_n_bucket) {}
+
+  /* values smaller than 1 (e.g., a reuse time of 0) are counted as 0 */
+  inline void add(double v, double weight = 1) {
+    n_ += weight;
+    if (v < 1) {
+      zero_cnt_ += weight;
+      return;
+    }
+    int idx = (int)ceil(log(v) / log_gamma_);
+    add_to_bucket(idx, weight);
+  }
+
+  double quantile(double q) const;
+
+  double count() const { return n_; }
+
+  /* call f(lower bound, upper bound, count) for each non-empty bucket */
+  template <typename F>
+  void for_each_bucket(F f) const {
+    if (zero_cnt_ > 0) f(0.0, 0.0, zero_cnt_);
+    for (size_t i = 0; i < buckets_.size(); i++) {
+      if (buckets_[i] <= 0) continue;
+      int idx = min_idx_ + (int)i;
+      f(pow(gamma_, idx - 1), pow(gamma_, idx), buckets_[i]);
+    }
+  }
+
+ private:
+  void add_to_bucket(int idx, double weight);
+
+  double gamma_;
+  double log_gamma_;
+  int max_n_bucket_;
+
+  double n_ = 0;
+  double zero_cnt_ = 0;
+  /* buckets_[i] is the count of bucket min_idx_ + i */
+  int min_idx_ = 0;
+  std::vector<double> buckets_;
+};
+
+/**
+ * fixed-size spatial sampling (as in SHARDS), an object is sampled if its hash
+ * is below a threshold, when more than max_n_obj objects are sampled, the
+ * threshold is lowered to drop the object with the largest hash, so each
+ * sampled request stands for 1 / sample_rate() requests
+ */
+class ObjSampler {
+ public:
+  struct sampled_obj {
+    int64_t last_access_vtime;
+    int64_t last_access_rtime;
+    int64_t obj_size;
+    uint32_t freq;
+    uint32_t hv;
+  };
+
+  explicit ObjSampler(size_t max_n_obj) : max_n_obj_(max_n_obj) {
+    obj_map_.reserve(max_n_obj + 1);
+  }
+
+  /* return nullptr if the object is not sampled, *is_new is true if the
+   * object is sampled for the first time */
+  sampled_obj *access(obj_id_t obj_id, uint64_t hv, bool *is_new);
+
+  inline double sample_rate() const {
+    return (double)threshold_ / (double)(1ULL << 32);
+  }
+
+  template <typename F>
+  void for_each(F f) const {
+    for (const auto &p : obj_map_) f(p.second);
+  }
+
+ private:
+  size_t max_n_obj_;
+  /* sampled if the upper 32 bits of the hash is below the threshold */
+  uint64_t threshold_ = 1ULL << 32;
+  robin_hood::unordered_node_map<obj_id_t, sampled_obj> obj_map_;
+  /* the sampled objects ordered by hash, the largest is dropped first */
+  std::priority_queue<std::pair<uint32_t, obj_id_t>> hv_heap_;
+};
+
+}  // namespace traceAnalyzer
@@ -0,0 +1,190 @@
+#include "sketchStat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include "../include/libCacheSim/logging.h"
+#include "popularity.h"
+
+namespace traceAnalyzer {
+using namespace std;
+
+static void dump_ddsketch(ofstream &ofs, const DDSketch &sketch,
+                          const string &name) {
+  ofs << "# " << name << " quantile: value\n";
+  for (double q : sketch_quantiles) {
+    ofs << q << ":" << sketch.quantile(q) << "\n";
+  }
+  ofs << "# " << name << " (lower bound, upper bound]: count\n";
+  sketch.for_each_bucket([&](double lo, double hi, double cnt) {
+    ofs << (int64_t)lo << "," << (int64_t)hi << ":" << (int64_t)llround(cnt)
+        << "\n";
+  });
+}
+
+/**************** object stat ****************/
+void ObjStatSketch::add_req(request_t *req) {
+  uint64_t hv = sketch_hash(req->obj_id);
+  hll_.add(hv);
+
+  bool is_new;
+  ObjSampler::sampled_obj *obj = sampler_.access(req->obj_id, hv, &is_new);
+  if (obj == nullptr) return;
+
+  if (is_new) {
+    obj->obj_size = req->obj_size;
+  } else if (req->op == OP_SET || req->op == OP_REPLACE ||
+             req->op == OP_CAS) {
+    n_overwrite_ += 1.0 / sampler_.sample_rate();
+  }
+  obj->freq += 1;
+}
+
+double ObjStatSketch::obj_byte() const {
+  double sum = 0;
+  sampler_.for_each(
+      [&](const ObjSampler::sampled_obj &obj) { sum += obj.obj_size; });
+  return sum / sampler_.sample_rate();
+}
+
+vector<double> ObjStatSketch::n_hit_cnt(int n_hit) const {
+  vector<double> cnt(n_hit, 0);
+  double weight = 1.0 / sampler_.sample_rate();
+  sampler_.for_each([&](const ObjSampler::sampled_obj &obj) {
+    if ((int)obj.freq <= n_hit) cnt[obj.freq - 1] += weight;
+  });
+  return cnt;
+}
+
+/**************** popularity ****************/
+void PopularitySketch::add_req(request_t *req) {
+  uint64_t hv = sketch_hash(req->obj_id);
+  top_k_.update(req->obj_id, cm_.add(hv));
+
+  bool is_new;
+  ObjSampler::sampled_obj *obj = sampler_.access(req->obj_id, hv, &is_new);
+  if (obj != nullptr) obj->freq += 1;
+}
+
+void PopularitySketch::finish() {
+  top_freq_ = top_k_.sorted_freq();
+  size_t n_obj = top_freq_.size();
+
+  if (n_obj < 200) {
+    fit_fail_reason_ = "popularity: too few objects (" + to_string(n_obj) +
+                       "), skip the popularity computation";
+    WARN("%s\n", fit_fail_reason_.c_str());
+    return;
+  }
+
+  if (top_freq_[0] < 200) {
+    fit_fail_reason_ = "popularity: the most popular object has " +
+                       to_string(top_freq_[0]) + " requests ";
+    WARN("%s\n", fit_fail_reason_.c_str());
+  }
+
+  vector<double> log_freq(n_obj);
+  vector<double> log_rank(n_obj);
+  for (size_t i = 0; i < n_obj; i++) {
+    log_freq[i] = log(top_freq_[i]);
+    log_rank[i] = log(i + 1);
+  }
+  slope_ = -PopularityUtils::slope(log_rank, log_freq);
+}
+
+void PopularitySketch::dump(string &path_base) {
+  if (top_freq_.empty()) {
+    ERROR("popularity has not been computed\n");
+    return;
+  }
+
+  ofstream ofs(path_base + ".popularity", ios::out | ios::trunc);
+  ofs << "# " << path_base << "\n";
+  ofs << "# freq (sorted):cnt - for Zipf plot, estimated using sketches, the "
+         "top "
+      << top_freq_.size()
+      << " objects from Count-Min and the others from sampled objects\n";
+
+  uint32_t last_freq = top_freq_[0];
+  uint32_t freq_cnt = 0;
+  for (auto &cnt : top_freq_) {
+    if (cnt == last_freq) {
+      freq_cnt += 1;
+    } else {
+      ofs << last_freq << ":" << freq_cnt << "\n";
+      freq_cnt = 1;
+      last_freq = cnt;
+    }
+  }
+  ofs << last_freq << ":" << freq_cnt << "\n";
+
+  /* the objects less popular than the top k */
+  map<uint32_t, double, greater<>> tail_freq_cnt;
+  double weight = 1.0 / sampler_.sample_rate();
+  sampler_.for_each([&](const ObjSampler::sampled_obj &obj) {
+    if (obj.freq < top_freq_.back()) tail_freq_cnt[obj.freq] += weight;
+  });
+  for (auto &p : tail_freq_cnt) {
+    ofs << p.first << ":" << (uint64_t)llround(p.second) << "\n";
+  }
+  ofs.close();
+}
+
+/**************** size ****************/
+void SizeSketch::add_req(request_t *req) {
+  req_size_.add((double)req->obj_size);
+
+  bool is_new;
+  ObjSampler::sampled_obj *obj =
+      sampler_.access(req->obj_id, sketch_hash(req->obj_id), &is_new);
+  if (obj != nullptr && is_new) obj->obj_size = req->obj_size;
+}
+
+void SizeSketch::finish() {
+  /* the sampled objects are a uniform sample at the final rate */
+  double weight = 1.0 / sampler_.sample_rate();
+  sampler_.for_each([&](const ObjSampler::sampled_obj &obj) {
+    obj_size_.add((double)obj.obj_size, weight);
+  });
+}
+
+void SizeSketch::dump(string &path_base) {
+  ofstream ofs(path_base + ".sizeSketch", ios::out | ios::trunc);
+  ofs << "# " << path_base << "\n";
+  dump_ddsketch(ofs, req_size_, "object size weighted by request");
+  dump_ddsketch(ofs, obj_size_, "object size weighted by object");
+  ofs.close();
+}
+
+/**************** reuse ****************/
+void ReuseSketch::add_req(request_t *req) {
+  n_req_ += 1;
+
+  bool is_new;
+  ObjSampler::sampled_obj *obj =
+      sampler_.access(req->obj_id, sketch_hash(req->obj_id), &is_new);
+  if (obj == nullptr) return;
+
+  double weight = 1.0 / sampler_.sample_rate();
+  if (is_new) {
+    n_compulsory_miss_ += weight;
+  } else {
+    reuse_rtime_.add((double)(req->clock_time - obj->last_access_rtime),
+                     weight);
+    reuse_vtime_.add((double)(n_req_ - obj->last_access_vtime), weight);
+  }
+  obj->last_access_rtime = req->clock_time;
+  obj->last_access_vtime = n_req_;
+}
+
+void ReuseSketch::dump(string &path_base) {
+  ofstream ofs(path_base + ".reuseSketch", ios::out | ios::trunc);
+  ofs << "# " << path_base << "\n";
+  ofs << "# compulsory miss: " << (int64_t)llround(n_compulsory_miss_) << "\n";
+  dump_ddsketch(ofs, reuse_rtime_, "reuse real time");
+  dump_ddsketch(ofs, reuse_vtime_, "reuse virtual time");
+  ofs.close();
+}
+
+}  // namespace traceAnalyzer
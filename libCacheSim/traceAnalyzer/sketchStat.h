@@ -0,0 +1,158 @@
+#pragma once
+/* the approximate versions of the popularity, size, reuse and object
+ * analyses, they do not use the object map and use a fixed amount of memory
+ * regardless of the trace size */
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/libCacheSim/request.h"
+#include "sketch.h"
+
+namespace traceAnalyzer {
+
+/* the quantiles reported in the stat and the sketch dumps */
+static const double sketch_quantiles[] = {0.01, 0.1, 0.25, 0.5,
+                                          0.75, 0.9, 0.99, 0.999};
+
+static inline std::string quantile_label(double q) {
+  std::ostringstream ss;
+  ss << "p" << q * 100;
+  return ss.str();
+}
+
+/**
+ * the number of objects (HyperLogLog), and the object bytes, the number of
+ * one-hit, two-hit ... wonders and the overwrites estimated from the sampled
+ * objects, used instead of the object map
+ */
+class ObjStatSketch {
+ public:
+  explicit ObjStatSketch(int n_sample_obj) : sampler_(n_sample_obj) {}
+
+  void add_req(request_t *req);
+
+  double n_obj() const { return hll_.estimate(); }
+
+  /* the sum of object size, each object counted once */
+  double obj_byte() const;
+
+  /* the number of objects requested 1, 2, ..., n_hit times */
+  std::vector<double> n_hit_cnt(int n_hit) const;
+
+  uint64_t n_overwrite() const { return (uint64_t)n_overwrite_; }
+
+ private:
+  HyperLogLog hll_;
+  ObjSampler sampler_;
+  double n_overwrite_ = 0;
+};
+
+/**
+ * the most popular objects from Count-Min and a top-k heap, and the
+ * frequency of the other objects from the sampled objects, the Zipf alpha is
+ * fitted on the top k objects
+ */
+class PopularitySketch {
+ public:
+  PopularitySketch(int top_k, int n_sample_obj)
+      : cm_(4, 18), top_k_(top_k), sampler_(n_sample_obj) {}
+
+  void add_req(request_t *req);
+
+  /* fit the Zipf alpha, called after the trace is processed */
+  void finish();
+
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const PopularitySketch &popularity) {
+    if (popularity.fit_fail_reason_.size() > 0)
+      os << popularity.fit_fail_reason_ << "\n";
+    else
+      os << std::setprecision(4)
+         << "popularity (sketch, top " << popularity.top_freq_.size()
+         << " objects): Zipf linear fitting slope=" << popularity.slope_
+         << "\n";
+    return os;
+  }
+
+  /* the estimated frequencies of the top k objects in descending order */
+  std::vector<uint32_t> &get_sorted_freq() { return top_freq_; }
+
+  void dump(std::string &path_base);
+
+  std::string fit_fail_reason_ = "";
+
+ private:
+  CountMinSketch cm_;
+  TopK top_k_;
+  ObjSampler sampler_;
+
+  std::vector<uint32_t> top_freq_{};
+  double slope_ = -1;
+};
+
+/**
+ * the object size distribution weighted by request and by object, the object
+ * weighted one is estimated from the sampled objects
+ */
+class SizeSketch {
+ public:
+  explicit SizeSketch(int n_sample_obj) : sampler_(n_sample_obj) {}
+
+  void add_req(request_t *req);
+
+  void finish();
+
+  friend std::ostream &operator<<(std::ostream &os, const SizeSketch &size) {
+    os << "object size quantile (sketch) weighted by req/obj: ";
+    for (double q : sketch_quantiles) {
+      os << quantile_label(q) << ":" << (int64_t)size.req_size_.quantile(q)
+         << "/" << (int64_t)size.obj_size_.quantile(q) << ", ";
+    }
+    os << "\n";
+    return os;
+  }
+
+  void dump(std::string &path_base);
+
+ private:
+  ObjSampler sampler_;
+  DDSketch req_size_;
+  DDSketch obj_size_;
+};
+
+/**
+ * the reuse time (real and virtual) distribution of the requests to the
+ * sampled objects, each weighted by the inverse of the sampling rate
+ */
+class ReuseSketch {
+ public:
+  explicit ReuseSketch(int n_sample_obj) : sampler_(n_sample_obj) {}
+
+  void add_req(request_t *req);
+
+  friend std::ostream &operator<<(std::ostream &os, const ReuseSketch &reuse) {
+    os << "reuse time quantile (sketch) real/virtual: ";
+    for (double q : sketch_quantiles) {
+      os << quantile_label(q) << ":" << (int64_t)reuse.reuse_rtime_.quantile(q)
+         << "/" << (int64_t)reuse.reuse_vtime_.quantile(q) << ", ";
+    }
+    os << "\n";
+    return os;
+  }
+
+  void dump(std::string &path_base);
+
+ private:
+  ObjSampler sampler_;
+  int64_t n_req_ = 0;
+  double n_compulsory_miss_ = 0;
+  DDSketch reuse_rtime_;
+  DDSketch reuse_vtime_;
+};
+
+}  // namespace traceAnalyzer
@@ -81,6 +81,8 @@ int LCSReader_setup(reader_t *reader) {
   reader->init_params.binary_fmt_str = strdup(header->format);
   reader->init_params.trace_start_offset = sizeof(lcs_trace_header_t);
   reader->trace_start_offset = sizeof(lcs_trace_header_t);
+  reader->n_total_obj = header->n_obj;
+  reader->n_total_obj_byte = header->n_obj_byte;
 
   binaryReader_setup(reader);
 
@@ -0,0 +1,293 @@
+//
+// generate synthetic workloads on the fly, see synthetic.h for the spec
+//
+
+#define _GNU_SOURCE
+#include "synthetic.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "../../include/libCacheSim/macro.h"
+#include "../../utils/include/mystr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************** random numbers ****************/
+static inline uint64_t mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/* splitmix64, the stream of each request is seeded by (seed, index) */
+static inline uint64_t next_u64(uint64_t *state) {
+  *state += 0x9e3779b97f4a7c15ULL;
+  return mix64(*state);
+}
+
+static inline double u64_to_double(uint64_t v) {
+  return (double)(v >> 11) * 0x1.0p-53;
+}
+
+/**************** rejection-inversion Zipf ****************/
+/* W. Hormann and G. Derflinger, Rejection-inversion to generate variates from
+ * monotone discrete distributions, 1996, it samples rank in [1, n] in O(1)
+ * time and memory */
+static inline double helper1(double x) {
+  return fabs(x) > 1e-8 ? log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+static inline double helper2(double x) {
+  return fabs(x) > 1e-8 ? expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+static inline double zipf_h(double alpha, double x) { return exp(-alpha * log(x)); }
+
+static inline double zipf_h_integral(double alpha, double x) {
+  double log_x = log(x);
+  return helper2((1 - alpha) * log_x) * log_x;
+}
+
+static inline double zipf_h_integral_inv(double alpha, double x) {
+  double t = x * (1 - alpha);
+  if (t < -1) t = -1;
+  return exp(helper1(t) * x);
+}
+
+static void zipf_init(synthetic_params_t *params) {
+  double a = params->alpha;
+  params->h_integral_x1 = zipf_h_integral(a, 1.5) - 1;
+  params->h_integral_n = zipf_h_integral(a, (double)params->n_obj + 0.5);
+  params->s = 2 - zipf_h_integral_inv(a, zipf_h_integral(a, 2.5) - zipf_h(a, 2));
+}
+
+/* return rank in [0, n_obj) */
+static inline uint64_t zipf_sample(const synthetic_params_t *params, uint64_t *state) {
+  const double a = params->alpha;
+  while (true) {
+    double u = params->h_integral_n + u64_to_double(next_u64(state)) * (params->h_integral_x1 - params->h_integral_n);
+    double x = zipf_h_integral_inv(a, u);
+    uint64_t k = (uint64_t)(x + 0.5);
+    if (k < 1) {
+      k = 1;
+    } else if (k > params->n_obj) {
+      k = params->n_obj;
+    }
+
+    if ((double)k - x <= params->s || u >= zipf_h_integral(a, (double)k + 0.5) - zipf_h(a, (double)k)) {
+      return k - 1;
+    }
+  }
+}
+
+/**************** object size ****************/
+/* the size is a function of the object so that it does not change */
+static inline int64_t obj_size_of(const synthetic_params_t *params, obj_id_t obj_id) {
+  if (params->size_dist == SYNTHETIC_SIZE_FIXED) return params->obj_size;
+
+  double u = u64_to_double(mix64(obj_id ^ mix64(params->seed + 1)));
+  if (params->size_dist == SYNTHETIC_SIZE_UNIFORM) {
+    return params->size_min + (int64_t)(u * (double)(params->size_max - params->size_min + 1));
+  }
+
+  /* bounded pareto via inverse CDF */
+  double lo = (double)params->size_min, hi = (double)params->size_max;
+  double a = params->size_alpha;
+  double sz = lo / pow(1 - u * (1 - pow(lo / hi, a)), 1.0 / a);
+  return MIN((int64_t)sz, params->size_max);
+}
+
+/**************** reader ****************/
+static void parse_synthetic_params(const char *spec, synthetic_params_t *params) {
+  char *params_str = strdup(spec);
+  char *old_params_str = params_str;
+  char *end;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by '=' */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space and comma
+    while (params_str != NULL && (*params_str == ' ' || *params_str == ',')) {
+      params_str++;
+    }
+
+    if (value == NULL) {
+      ERROR("synthetic trace spec \"%s\" has key %s without value\n", spec, key);
+      exit(1);
+    }
+
+    key = replace_char(key, '_', '-');
+
+    if (strcasecmp(key, "dist") == 0) {
+      if (strcasecmp(value, "zipf") == 0) {
+        params->dist = SYNTHETIC_ZIPF;
+      } else if (strcasecmp(value, "uniform") == 0) {
+        params->dist = SYNTHETIC_UNIFORM;
+      } else if (strcasecmp(value, "scan") == 0) {
+        params->dist = SYNTHETIC_SCAN;
+      } else {
+        ERROR("unknown synthetic distribution %s\n", value);
+        exit(1);
+      }
+    } else if (strcasecmp(key, "alpha") == 0) {
+      params->alpha = strtod(value, &end);
+    } else if (strcasecmp(key, "n-obj") == 0) {
+      params->n_obj = (uint64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "n-req") == 0) {
+      params->n_req = (uint64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "seed") == 0) {
+      params->seed = strtoull(value, &end, 0);
+    } else if (strcasecmp(key, "time-span") == 0) {
+      params->time_span = (int64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "scan-len") == 0) {
+      params->scan_len = (uint64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "scan-ratio") == 0) {
+      params->scan_ratio = strtod(value, &end);
+    } else if (strcasecmp(key, "churn-interval") == 0) {
+      params->churn_interval = (uint64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "churn-step") == 0) {
+      params->churn_step = (uint64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "size-dist") == 0) {
+      if (strcasecmp(value, "fixed") == 0) {
+        params->size_dist = SYNTHETIC_SIZE_FIXED;
+      } else if (strcasecmp(value, "uniform") == 0) {
+        params->size_dist = SYNTHETIC_SIZE_UNIFORM;
+      } else if (strcasecmp(value, "pareto") == 0) {
+        params->size_dist = SYNTHETIC_SIZE_PARETO;
+      } else {
+        ERROR("unknown synthetic size distribution %s\n", value);
+        exit(1);
+      }
+    } else if (strcasecmp(key, "obj-size") == 0) {
+      params->obj_size = (int64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "size-min") == 0) {
+      params->size_min = (int64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "size-max") == 0) {
+      params->size_max = (int64_t)strtod(value, &end);
+    } else if (strcasecmp(key, "size-alpha") == 0) {
+      params->size_alpha = strtod(value, &end);
+    } else {
+      ERROR("synthetic trace does not support parameter %s\n", key);
+      exit(1);
+    }
+  }
+
+  free(old_params_str);
+}
+
+int syntheticReader_setup(reader_t *reader) {
+  synthetic_params_t *params = malloc(sizeof(synthetic_params_t));
+  memset(params, 0, sizeof(synthetic_params_t));
+  params->dist = SYNTHETIC_ZIPF;
+  params->alpha = 1.0;
+  params->n_obj = 1000000;
+  params->n_req = 100000000;
+  params->seed = 0;
+  params->time_span = 86400 * 7;
+  params->scan_ratio = 0.1;
+  params->churn_step = 0;
+  params->size_dist = SYNTHETIC_SIZE_FIXED;
+  params->obj_size = 4000;
+  params->size_min = 1000;
+  params->size_max = 1000000;
+  params->size_alpha = 1.0;
+
+  parse_synthetic_params(reader->trace_path, params);
+
+  if (params->n_obj == 0 || params->n_req == 0) {
+    ERROR("synthetic trace requires n-obj > 0 and n-req > 0\n");
+    exit(1);
+  }
+  if (params->size_min <= 0 || params->size_max < params->size_min || params->obj_size <= 0) {
+    ERROR("synthetic trace has invalid object size setting\n");
+    exit(1);
+  }
+  if (params->alpha < 0 || params->size_alpha <= 0) {
+    ERROR("synthetic trace requires alpha >= 0 and size-alpha > 0\n");
+    exit(1);
+  }
+  if (params->alpha == 0) params->dist = SYNTHETIC_UNIFORM;
+  if (params->dist == SYNTHETIC_ZIPF) zipf_init(params);
+
+  params->scan_period = 0;
+  if (params->scan_len > 0 && params->dist != SYNTHETIC_SCAN) {
+    if (params->scan_ratio <= 0 || params->scan_ratio > 1) {
+      ERROR("synthetic trace requires scan-ratio in (0, 1]\n");
+      exit(1);
+    }
+    params->scan_period = (uint64_t)ceil((double)params->scan_len / params->scan_ratio);
+  }
+  if (params->churn_step > 0 && params->churn_interval == 0) {
+    ERROR("synthetic trace requires churn-interval when churn-step is set\n");
+    exit(1);
+  }
+
+  reader->reader_params = params;
+  reader->trace_format = BINARY_TRACE_FORMAT;
+  reader->item_size = 1;
+  reader->file_size = params->n_req;
+  reader->n_total_req = params->n_req;
+  reader->obj_id_is_num = true;
+  if (params->size_dist == SYNTHETIC_SIZE_FIXED) {
+    /* used to size the cache index, the churn does not change the mean size */
+    reader->n_total_obj = params->n_obj;
+    reader->n_total_obj_byte = params->n_obj * params->obj_size;
+  }
+
+  return 0;
+}
+
+int synthetic_read_one_req(reader_t *reader, request_t *req) {
+  const synthetic_params_t *params = reader->reader_params;
+  if (reader->mmap_offset >= reader->file_size) {
+    req->valid = false;
+    return 1;
+  }
+  const uint64_t idx = reader->mmap_offset;
+  reader->mmap_offset += 1;
+
+  uint64_t state = mix64(mix64(params->seed) ^ idx);
+  uint64_t rank;
+  uint64_t pos_in_scan = params->scan_period > 0 ? idx % params->scan_period : UINT64_MAX;
+  if (pos_in_scan < params->scan_len) {
+    /* all requests in one scan start from the same random object */
+    uint64_t scan_state = mix64(mix64(params->seed) ^ ~(idx / params->scan_period));
+    rank = (next_u64(&scan_state) % params->n_obj + pos_in_scan) % params->n_obj;
+  } else {
+    switch (params->dist) {
+      case SYNTHETIC_ZIPF:
+        rank = zipf_sample(params, &state);
+        break;
+      case SYNTHETIC_UNIFORM:
+        rank = next_u64(&state) % params->n_obj;
+        break;
+      case SYNTHETIC_SCAN:
+        rank = idx % params->n_obj;
+        break;
+      default:
+        ERROR("unknown synthetic distribution %d\n", params->dist);
+        abort();
+    }
+  }
+
+  req->obj_id = rank;
+  if (params->churn_step > 0) {
+    req->obj_id += idx / params->churn_interval * params->churn_step;
+  }
+  req->obj_size = obj_size_of(params, req->obj_id);
+  req->clock_time = (int64_t)(idx * params->time_span / params->n_req);
+  req->op = OP_GET;
+  req->next_access_vtime = -2;
+
+  return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
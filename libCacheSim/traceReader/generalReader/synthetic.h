@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+ * synthetic trace reader, requests are generated on the fly instead of being
+ * read from a file, the trace_path is the workload spec, e.g.,
+ *
+ *    dist=zipf,alpha=0.8,n-obj=1000000,n-req=100000000,seed=42
+ *
+ * supported keys
+ *    dist: zipf (default), uniform, scan
+ *    alpha: zipf skewness, default 1.0
+ *    n-obj: number of objects, default 1000000
+ *    n-req: number of requests, default 100000000
+ *    seed: random seed, default 0
+ *    time-span: clock time of the last request in sec, default 7 days
+ *    scan-len, scan-ratio: a fraction scan-ratio of requests are sequential
+ *        scans of scan-len objects starting from a random object
+ *    churn-interval, churn-step: every churn-interval requests, the obj_id of
+ *        each popularity rank shifts by churn-step, so new objects become
+ *        popular and old objects fade out
+ *    size-dist: fixed (default), uniform, pareto
+ *    obj-size: object size used by fixed size distribution, default 4000
+ *    size-min, size-max, size-alpha: used by uniform and bounded pareto
+ *
+ * each request is a function of (seed, request index), so the trace is
+ * deterministic, and reset, clone, skip and reading backward work the same
+ * way as a binary trace: the reader treats the trace as a file of n-req
+ * items of size 1 and the mmap_offset is the index of the next request
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "../../include/libCacheSim/reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  SYNTHETIC_ZIPF,
+  SYNTHETIC_UNIFORM,
+  SYNTHETIC_SCAN,
+} synthetic_dist_e;
+
+typedef enum {
+  SYNTHETIC_SIZE_FIXED,
+  SYNTHETIC_SIZE_UNIFORM,
+  SYNTHETIC_SIZE_PARETO,
+} synthetic_size_dist_e;
+
+typedef struct {
+  synthetic_dist_e dist;
+  double alpha;
+  uint64_t n_obj;
+  uint64_t n_req;
+  uint64_t seed;
+  int64_t time_span;
+
+  uint64_t scan_len;
+  double scan_ratio;
+  uint64_t scan_period;
+
+  uint64_t churn_interval;
+  uint64_t churn_step;
+
+  synthetic_size_dist_e size_dist;
+  int64_t obj_size;
+  int64_t size_min;
+  int64_t size_max;
+  double size_alpha;
+
+  /* constants of the rejection-inversion Zipf sampler */
+  double h_integral_x1;
+  double h_integral_n;
+  double s;
+} synthetic_params_t;
+
+int syntheticReader_setup(reader_t *reader);
+
+int synthetic_read_one_req(reader_t *reader, request_t *req);
+
+#ifdef __cplusplus
+}
+#endif
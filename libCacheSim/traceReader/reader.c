@@ -26,6 +26,7 @@
 #include "generalReader/lcs.h"
 #include "generalReader/libcsv.h"
 #include "generalReader/readerInternal.h"
+#include "generalReader/synthetic.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,7 +54,8 @@ reader_t *setup_reader(const char *const trace_path, const trace_type_e trace_ty
   reader->zstd_reader_p = NULL;
 #ifdef SUPPORT_ZSTD_TRACE
   size_t slen = strlen(trace_path);
-  if (strncmp(trace_path + (slen - 4), ".zst", 4) == 0 || strncmp(trace_path + (slen - 7), ".zst.22", 7) == 0) {
+  if (trace_type != SYNTHETIC_TRACE &&
+      (strncmp(trace_path + (slen - 4), ".zst", 4) == 0 || strncmp(trace_path + (slen - 7), ".zst.22", 7) == 0)) {
     reader->is_zstd_file = true;
     reader->zstd_reader_p = create_zstd_reader(trace_path);
     if (!_info_printed) {
@@ -65,6 +67,8 @@ reader_t *setup_reader(const char *const trace_path, const trace_type_e trace_ty
   reader->trace_format = INVALID_TRACE_FORMAT;
   reader->trace_type = trace_type;
   reader->n_total_req = 0;
+  reader->n_total_obj = 0;
+  reader->n_total_obj_byte = 0;
   reader->n_read_req = 0;
   reader->ignore_size_zero_req = true;
   reader->ignore_obj_size = false;
@@ -97,6 +101,12 @@ reader_t *setup_reader(const char *const trace_path, const trace_type_e trace_ty
   assert(trace_path != NULL);
   reader->trace_path = strdup(trace_path);
 
+  if (trace_type == SYNTHETIC_TRACE) {
+    /* the trace_path is the workload spec, there is no file to open */
+    syntheticReader_setup(reader);
+    return reader;
+  }
+
   if ((fd = open(trace_path, O_RDONLY)) < 0) {
     ERROR("Unable to open '%s', %s\n", trace_path, strerror(errno));
     exit(1);
@@ -367,6 +377,9 @@ int read_one_req(reader_t *const reader, request_t *const req) {
       case VALPIN_TRACE:
         status = valpin_read_one_req(reader, req);
         break;
+      case SYNTHETIC_TRACE:
+        status = synthetic_read_one_req(reader, req);
+        break;
       default:
         ERROR(
             "cannot recognize reader obj_id_type, given reader obj_id_type: "
@@ -595,7 +608,7 @@ reader_t *clone_reader(const reader_t *const reader_in) {
   reader_t *reader = setup_reader(reader_in->trace_path, reader_in->trace_type, &reader_in->init_params);
   reader->n_total_req = reader_in->n_total_req;
 
-  if (reader->trace_format != TXT_TRACE_FORMAT) {
+  if (reader->trace_format != TXT_TRACE_FORMAT && reader->mapped_file != NULL) {
     munmap(reader->mapped_file, reader->file_size);
     reader->mapped_file = reader_in->mapped_file;
   }
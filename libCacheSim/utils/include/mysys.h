@@ -10,14 +10,21 @@
 #define UTILS_h
 
 #include <pthread.h>
+#include <stdint.h>
 #include <sys/resource.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 int set_thread_affinity(pthread_t tid);
 
 int get_n_cores(void);
 
 int n_cores(void);
 
+int64_t get_cpu_cache_size(int level);
+
 double gettime(void);
 
 void print_cwd(void);
@@ -30,5 +37,8 @@ void print_resource_usage(void);
 
 void print_rusage_diff(struct rusage *r1, struct rusage *r2);
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* UTILS_h */
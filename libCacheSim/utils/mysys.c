@@ -90,6 +90,24 @@ void print_glib_ver(void) {
 
 int n_cores(void) { return get_n_cores(); }
 
+/**
+ * @brief get the size of the L2 or L3 (last level) CPU cache in bytes,
+ * returns a common size if the system does not report it
+ *
+ * @param level 2 or 3
+ * @return int64_t
+ */
+int64_t get_cpu_cache_size(int level) {
+  long sz = 0;
+#if defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+  sz = sysconf(level == 2 ? _SC_LEVEL2_CACHE_SIZE : _SC_LEVEL3_CACHE_SIZE);
+#endif
+  if (sz <= 0) {
+    sz = level == 2 ? 1 * MiB : 32 * MiB;
+  }
+  return (int64_t)sz;
+}
+
 double gettime(void) {
   struct timeval tv;
   gettimeofday(&tv, NULL);
@@ -254,6 +254,8 @@ static cache_t *create_test_cache(const char *alg_name,
     cache = S3FIFO_init(cc_params, "move-to-main-threshold=2");
   } else if (strcasecmp(alg_name, "Sieve") == 0) {
     cache = Sieve_init(cc_params, NULL);
+  } else if (strcasecmp(alg_name, "WTinyLFU") == 0) {
+    cache = WTinyLFU_init(cc_params, NULL);
   } else if (strcasecmp(alg_name, "Mithril") == 0) {
     cache = LRU_init(cc_params, NULL);
     cache->prefetcher =
@@ -264,6 +266,10 @@ static cache_t *create_test_cache(const char *alg_name,
   } else if (strcasecmp(alg_name, "PG") == 0) {
     cache = LRU_init(cc_params, NULL);
     cache->prefetcher = create_prefetcher("PG", NULL, cc_params.cache_size);
+  } else if (strcasecmp(alg_name, "Stride") == 0) {
+    cache = LRU_init(cc_params, NULL);
+    cache->prefetcher =
+        create_prefetcher("Stride", NULL, cc_params.cache_size);
   } else {
     printf("cannot recognize algorithm %s\n", alg_name);
     exit(1);
@@ -0,0 +1,210 @@
+#include "../libCacheSim/dataStructure/countMinSketch.h"
+#include "../libCacheSim/include/libCacheSim/admissionAlgo.h"
+#include "../libCacheSim/utils/include/mymath.h"
+#include "common.h"
+
+/* the lower bits of a hash value choose the block of the count-min sketch */
+#define HV_BLOCK0 0x1234567800000000ULL
+#define HV_BLOCK1 0x9abcdef000000001ULL
+
+static bool _admit(admissioner_t *admissioner, request_t *req, obj_id_t obj_id,
+                   int64_t clock_time) {
+  req->obj_id = obj_id;
+  req->obj_size = 1;
+  req->clock_time = clock_time;
+  req->hv = 0;
+  return admissioner->admit(admissioner, req);
+}
+
+/* rotate the filters after n-obj insertions */
+static void test_bloomfilter_doorkeeper(gconstpointer user_data) {
+  request_t *req = new_request();
+  admissioner_t *admissioner =
+      create_admissioner("bloomfilter", "n-obj=1000, fp-rate=0.01");
+
+  /* the first request is rejected, the second one is admitted */
+  g_assert_false(_admit(admissioner, req, 1, 0));
+  g_assert_true(_admit(admissioner, req, 1, 0));
+  g_assert_true(_admit(admissioner, req, 1, 0));
+
+  /* the object is still remembered after one rotation */
+  for (obj_id_t id = 100; id < 1100; id++) _admit(admissioner, req, id, 0);
+  g_assert_true(_admit(admissioner, req, 1, 0));
+
+  /* and forgotten after two rotations without a request */
+  for (obj_id_t id = 2000; id < 5000; id++) _admit(admissioner, req, id, 0);
+  g_assert_false(_admit(admissioner, req, 1, 0));
+  g_assert_true(_admit(admissioner, req, 1, 0));
+
+  /* the clone starts with empty filters */
+  admissioner_t *clone = admissioner->clone(admissioner);
+  g_assert_false(_admit(clone, req, 1, 0));
+  g_assert_true(_admit(clone, req, 1, 0));
+
+  clone->free(clone);
+  admissioner->free(admissioner);
+  free_request(req);
+}
+
+/* rotate the filters every rotate-sec seconds */
+static void test_bloomfilter_doorkeeper_time(gconstpointer user_data) {
+  request_t *req = new_request();
+  admissioner_t *admissioner =
+      create_admissioner("bloomfilter", "n-obj=1000, rotate-sec=10");
+
+  g_assert_false(_admit(admissioner, req, 1, 1));
+  g_assert_true(_admit(admissioner, req, 1, 2));
+
+  /* one rotation, the object is in the previous filter */
+  g_assert_false(_admit(admissioner, req, 2, 15));
+  g_assert_true(_admit(admissioner, req, 2, 16));
+
+  /* two rotations, object 1 is forgotten, object 2 is not */
+  g_assert_false(_admit(admissioner, req, 3, 30));
+  g_assert_true(_admit(admissioner, req, 2, 31));
+  g_assert_false(_admit(admissioner, req, 1, 32));
+
+  admissioner->free(admissioner);
+  free_request(req);
+}
+
+static bool _admit_hv(admissioner_t *admissioner, request_t *req,
+                      uint64_t hv) {
+  req->obj_id = (obj_id_t)hv;
+  req->obj_size = 1;
+  req->hv = hv;
+  return admissioner->admit(admissioner, req);
+}
+
+/* admit on the min-freq-th request, and forget the requests after the
+ * counters are halved */
+static void test_frequency(gconstpointer user_data) {
+  request_t *req = new_request();
+  admissioner_t *admissioner = create_admissioner("frequency", "min-freq=3");
+  g_assert_false(_admit(admissioner, req, 1, 0));
+  g_assert_false(_admit(admissioner, req, 1, 0));
+  g_assert_true(_admit(admissioner, req, 1, 0));
+  g_assert_true(_admit(admissioner, req, 1, 0));
+
+  admissioner_t *clone = admissioner->clone(admissioner);
+  g_assert_false(_admit(clone, req, 1, 0));
+  clone->free(clone);
+  admissioner->free(admissioner);
+
+  /* 128 blocks, one block is halved every 15 requests */
+  admissioner = create_admissioner("frequency", "n-obj=1000, sample-size=2000");
+  g_assert_false(_admit_hv(admissioner, req, HV_BLOCK0));
+  g_assert_true(_admit_hv(admissioner, req, HV_BLOCK0));
+  for (int i = 0; i < 4000; i++) _admit_hv(admissioner, req, HV_BLOCK1);
+  /* the count is halved twice from 2 to 0 */
+  g_assert_false(_admit_hv(admissioner, req, HV_BLOCK0));
+  g_assert_true(_admit_hv(admissioner, req, HV_BLOCK0));
+  admissioner->free(admissioner);
+
+  free_request(req);
+}
+
+/* the AVX2 and the scalar paths return the same counts and leave the same
+ * counters */
+static void test_count_min_sketch_simd(gconstpointer user_data) {
+  count_min_sketch_t *simd = create_count_min_sketch(1024, 0);
+  count_min_sketch_t *scalar = create_count_min_sketch(1024, 0);
+  scalar->use_simd = false;
+  if (!simd->use_simd) {
+    g_test_message("AVX2 is not supported, only the scalar path is tested");
+  }
+
+  set_rand_seed(42);
+  uint64_t hvs[4096];
+  for (int i = 0; i < 4096; i++) hvs[i] = next_rand();
+  for (int i = 0; i < 200000; i++) {
+    /* skewed towards the small indexes */
+    uint64_t range = (next_rand() >> 33) % 4096 + 1;
+    uint64_t hv = hvs[(next_rand() >> 33) % range];
+    g_assert_cmpint(count_min_sketch_add(simd, hv), ==,
+                    count_min_sketch_add(scalar, hv));
+    g_assert_cmpint(count_min_sketch_estimate(simd, hv), ==,
+                    count_min_sketch_estimate(scalar, hv));
+  }
+  g_assert_cmpint(memcmp(simd->table, scalar->table,
+                         simd->n_block * CMS_BLOCK_N_WORD * sizeof(uint64_t)),
+                  ==, 0);
+
+  free_count_min_sketch(simd);
+  free_count_min_sketch(scalar);
+}
+
+/* counters saturate at CMS_COUNTER_MAX and every block is halved once every
+ * sample_size additions */
+static void test_count_min_sketch_aging(gconstpointer user_data) {
+  /* 128 blocks, one block is halved every 32 additions */
+  count_min_sketch_t *cms = create_count_min_sketch(1024, 4096);
+  g_assert_cmpint(cms->n_block, ==, 128);
+
+  for (int i = 1; i <= 20; i++) {
+    g_assert_cmpint(count_min_sketch_add(cms, HV_BLOCK0), ==,
+                    MIN(i, CMS_COUNTER_MAX));
+  }
+  g_assert_cmpint(count_min_sketch_estimate(cms, HV_BLOCK0), ==, 15);
+
+  for (int i = 0; i < 4096; i++) count_min_sketch_add(cms, HV_BLOCK1);
+  g_assert_cmpint(count_min_sketch_estimate(cms, HV_BLOCK0), ==, 7);
+  for (int i = 0; i < 4096; i++) count_min_sketch_add(cms, HV_BLOCK1);
+  g_assert_cmpint(count_min_sketch_estimate(cms, HV_BLOCK0), ==, 3);
+
+  /* the counters are reset when the sketch grows */
+  g_assert_false(count_min_sketch_ensure_capacity(cms, 1024));
+  g_assert_true(count_min_sketch_ensure_capacity(cms, 4096));
+  g_assert_cmpint(cms->n_block, ==, 512);
+  g_assert_cmpint(cms->sample_size, ==, 4096 * 4);
+  g_assert_cmpint(count_min_sketch_estimate(cms, HV_BLOCK1), ==, 0);
+
+  free_count_min_sketch(cms);
+}
+
+/* the state of the admissioner is counted in the metadata of the cache */
+static void test_admission_metadata_bytes(gconstpointer user_data) {
+  common_cache_params_t cc_params = {
+      .cache_size = 1000, .hashpower = 16, .default_ttl = 0};
+  cache_t *cache = LRU_init(cc_params, NULL);
+  int64_t base_bytes = cache->get_metadata_bytes(cache);
+
+  cache->admissioner = create_admissioner("bloomfilter", "n-obj=10000");
+  int64_t bf_bytes =
+      cache->admissioner->get_metadata_bytes(cache->admissioner);
+  /* two filters of about 1.2 bytes per object */
+  g_assert_cmpint(bf_bytes, >, 2 * 10000);
+  g_assert_cmpint(cache->get_metadata_bytes(cache), ==, base_bytes + bf_bytes);
+  cache->admissioner->free(cache->admissioner);
+
+  cache->admissioner = create_admissioner("frequency", "n-obj=10000");
+  /* the sketch of the admissioner has the same size */
+  count_min_sketch_t *cms = create_count_min_sketch(10000, 0);
+  int64_t freq_bytes =
+      cache->admissioner->get_metadata_bytes(cache->admissioner);
+  g_assert_cmpint(freq_bytes, >, count_min_sketch_get_metadata_bytes(cms));
+  free_count_min_sketch(cms);
+  g_assert_cmpint(cache->get_metadata_bytes(cache), ==,
+                  base_bytes + freq_bytes);
+
+  cache->cache_free(cache);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_data_func("/libCacheSim/admission_bloomfilter", NULL,
+                       test_bloomfilter_doorkeeper);
+  g_test_add_data_func("/libCacheSim/admission_bloomfilter_rotate_sec", NULL,
+                       test_bloomfilter_doorkeeper_time);
+  g_test_add_data_func("/libCacheSim/admission_frequency", NULL,
+                       test_frequency);
+  g_test_add_data_func("/libCacheSim/count_min_sketch_simd", NULL,
+                       test_count_min_sketch_simd);
+  g_test_add_data_func("/libCacheSim/count_min_sketch_aging", NULL,
+                       test_count_min_sketch_aging);
+  g_test_add_data_func("/libCacheSim/admission_metadata_bytes", NULL,
+                       test_admission_metadata_bytes);
+
+  return g_test_run();
+}
@@ -515,7 +515,24 @@ static void test_Sieve(gconstpointer user_data) {
 }
 
 static void test_WTinyLFU(gconstpointer user_data) {
-  // TODO: to be implemented
+  uint64_t miss_cnt_true[] = {89975, 85362, 79758, 76965,
+                              70964, 65793, 60058, 56537};
+  uint64_t miss_byte_true[] = {4057700352, 3743034368, 3446802944, 3208240640,
+                               2914955264, 2635003904, 2507213824, 2434254336};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("WTinyLFU", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+
+  print_results(cache, res);
+  _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
+                           miss_cnt_true, g_req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
 }
 
 static void test_LIRS(gconstpointer user_data) {
@@ -539,6 +556,265 @@ static void test_LIRS(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+#if (defined(ENABLE_LRB) && ENABLE_LRB == 1) || \
+    (defined(ENABLE_GLCACHE) && ENABLE_GLCACHE == 1)
+/* run the whole trace through the cache and return the number of misses */
+static uint64_t _count_miss(reader_t *reader, cache_t *cache) {
+  request_t *req = new_request();
+  uint64_t n_req = 0, n_miss = 0;
+
+  reset_reader(reader);
+  while (read_one_req(reader, req) == 0) {
+    n_req++;
+    if (!cache->get(cache, req)) n_miss++;
+  }
+  g_assert_cmpuint(n_req, ==, g_req_cnt_true);
+
+  free_request(req);
+  cache->cache_free(cache);
+  reset_reader(reader);
+  return n_miss;
+}
+#endif
+
+#if defined(ENABLE_LRB) && ENABLE_LRB == 1
+static uint64_t _run_LRB(reader_t *reader, const char *params) {
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 2,
+                                     .hashpower = 20,
+                                     .default_ttl = DEFAULT_TTL};
+  return _count_miss(reader, LRB_init(cc_params, params));
+}
+
+/* synchronous training is deterministic, asynchronous training may drop
+ * batches depending on the timing of the worker, so it is only checked to
+ * run through the trace */
+static void test_LRB_training(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  uint64_t n_miss_sync = _run_LRB(reader, "async-training=false");
+  g_assert_cmpuint(_run_LRB(reader, NULL), ==, n_miss_sync);
+  g_assert_cmpuint(_run_LRB(reader, "async-training=false"), ==, n_miss_sync);
+
+  uint64_t n_miss_async = _run_LRB(reader, "async-training=true");
+  g_assert_cmpuint(n_miss_async, >, 0);
+  g_assert_cmpuint(n_miss_async, <=, g_req_cnt_true);
+}
+#endif /* ENABLE_LRB */
+
+#if defined(ENABLE_GLCACHE) && ENABLE_GLCACHE == 1
+static uint64_t _run_GLCache(reader_t *reader, const char *params) {
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 2,
+                                     .hashpower = 20,
+                                     .default_ttl = DEFAULT_TTL};
+  /* GLCache picks segments randomly when no segment can be ranked */
+  set_rand_seed(42);
+  return _count_miss(reader, GLCache_init(cc_params, params));
+}
+
+/* with synchronous training (the default) the model is retrained at the same
+ * requests in every run, so the miss count is fixed, with asynchronous
+ * training it depends on when the background retraining finishes, so it is
+ * only checked to run through the trace */
+static void test_GLCache_training(gconstpointer user_data) {
+  const char *sync_params = "type=learned, retrain-intvl=3600";
+  const char *async_params =
+      "type=learned, retrain-intvl=3600, async-train=true";
+
+  reader_t *reader = (reader_t *)user_data;
+  uint64_t n_miss_sync = _run_GLCache(reader, sync_params);
+  g_assert_cmpuint(_run_GLCache(reader, sync_params), ==, n_miss_sync);
+
+  uint64_t n_miss_async = _run_GLCache(reader, async_params);
+  g_assert_cmpuint(n_miss_async, >, 0);
+  g_assert_cmpuint(n_miss_async, <=, g_req_cnt_true);
+}
+#endif /* ENABLE_GLCACHE */
+
+/* a cache restored from a snapshot taken in the middle of the trace should
+ * make the same decisions as the cache that continues running */
+#define N_SNAPSHOT_REQ 50000
+static void test_snapshot(gconstpointer user_data) {
+  const char *algos[] = {"FIFO", "LRU", "Clock", "SLRU", "S3-FIFO"};
+  const char *snapshot_path = "test_snapshot.bin";
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 4,
+                                     .hashpower = 20,
+                                     .default_ttl = DEFAULT_TTL};
+  request_t *req = new_request();
+
+  for (int i = 0; i < (int)(sizeof(algos) / sizeof(algos[0])); i++) {
+    cache_t *cache = create_test_cache(algos[i], cc_params, reader, NULL);
+    g_assert_true(cache != NULL);
+
+    reset_reader(reader);
+    int64_t n_req = 0;
+    while (n_req < N_SNAPSHOT_REQ && read_one_req(reader, req) == 0) {
+      cache->get(cache, req);
+      n_req++;
+    }
+
+    g_assert_true(cache_save_snapshot(cache, snapshot_path));
+    cache_t *restored = create_test_cache(algos[i], cc_params, reader, NULL);
+    g_assert_true(cache_load_snapshot(restored, snapshot_path));
+    g_assert_cmpint(restored->get_n_obj(restored), ==, cache->get_n_obj(cache));
+    g_assert_cmpint(restored->get_occupied_byte(restored), ==,
+                    cache->get_occupied_byte(cache));
+
+    while (read_one_req(reader, req) == 0) {
+      bool hit = cache->get(cache, req);
+      g_assert_true(restored->get(restored, req) == hit);
+    }
+    g_assert_cmpint(restored->get_n_obj(restored), ==, cache->get_n_obj(cache));
+
+    cache->cache_free(cache);
+    restored->cache_free(restored);
+    remove(snapshot_path);
+  }
+
+  free_request(req);
+  reset_reader(reader);
+}
+
+/* loading a snapshot that does not match the cache fails without aborting */
+static void test_snapshot_mismatch(gconstpointer user_data) {
+  const char *snapshot_path = "test_snapshot_mismatch.bin";
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 4,
+                                     .hashpower = 20,
+                                     .default_ttl = DEFAULT_TTL};
+  request_t *req = new_request();
+
+  cache_t *cache = create_test_cache("SLRU", cc_params, reader, NULL);
+  reset_reader(reader);
+  for (int i = 0; i < N_SNAPSHOT_REQ && read_one_req(reader, req) == 0; i++) {
+    cache->get(cache, req);
+  }
+  g_assert_true(cache_save_snapshot(cache, snapshot_path));
+
+  /* a different algorithm */
+  cache_t *other = create_test_cache("Clock", cc_params, reader, NULL);
+  g_assert_false(cache_load_snapshot(other, snapshot_path));
+  other->cache_free(other);
+
+  /* a different number of segments */
+  other = SLRU_init(cc_params, "n-seg=4");
+  g_assert_false(cache_load_snapshot(other, snapshot_path));
+  other->cache_free(other);
+
+  /* a different cache size */
+  common_cache_params_t cc_params_small = cc_params;
+  cc_params_small.cache_size /= 2;
+  other = create_test_cache("SLRU", cc_params_small, reader, NULL);
+  g_assert_false(cache_load_snapshot(other, snapshot_path));
+  other->cache_free(other);
+
+  /* a truncated snapshot */
+  FILE *f = fopen(snapshot_path, "rb");
+  fseek(f, 0, SEEK_END);
+  long file_size = ftell(f);
+  fclose(f);
+  g_assert_cmpint(truncate(snapshot_path, file_size / 2), ==, 0);
+  other = create_test_cache("SLRU", cc_params, reader, NULL);
+  g_assert_false(cache_load_snapshot(other, snapshot_path));
+  other->cache_free(other);
+
+  /* a different algorithm with the same object struct (the tag differs) */
+  other = create_test_cache("LRU", cc_params, reader, NULL);
+  reset_reader(reader);
+  for (int i = 0; i < N_SNAPSHOT_REQ && read_one_req(reader, req) == 0; i++) {
+    other->get(other, req);
+  }
+  g_assert_true(cache_save_snapshot(other, snapshot_path));
+  other->cache_free(other);
+  other = create_test_cache("FIFO", cc_params, reader, NULL);
+  g_assert_false(cache_load_snapshot(other, snapshot_path));
+  other->cache_free(other);
+
+  /* a missing file */
+  remove(snapshot_path);
+  other = create_test_cache("SLRU", cc_params, reader, NULL);
+  g_assert_false(cache_load_snapshot(other, snapshot_path));
+  other->cache_free(other);
+
+  cache->cache_free(cache);
+  free_request(req);
+  reset_reader(reader);
+}
+
+#define OBJ_STRUCT_SIZE_ROUNDED(size) (((size) + 7) & ~(size_t)7)
+
+static cache_obj_t *_get_obj(cache_t *cache, request_t *req, obj_id_t id) {
+  req->obj_id = id;
+  cache->get(cache, req);
+  return cache->find(cache, req, false);
+}
+
+/* an algorithm allocates the object bytes it declares, the objects are
+ * carved from a pool and the object of an evicted object is reused */
+static void test_obj_struct_size(gconstpointer user_data) {
+  common_cache_params_t cc_params = {
+      .cache_size = 4, .hashpower = 16, .default_ttl = DEFAULT_TTL};
+  request_t *req = new_request();
+  req->obj_size = 1;
+
+  cache_t *cache = FIFO_init(cc_params, NULL);
+  g_assert_cmpuint(cache_get_obj_struct_size(cache), ==,
+                   OBJ_STRUCT_SIZE_ROUNDED(CACHE_OBJ_HEADER_SIZE));
+  cache->cache_free(cache);
+
+  cache = Clock_init(cc_params, NULL);
+  g_assert_cmpuint(cache_get_obj_struct_size(cache), ==,
+                   OBJ_STRUCT_SIZE_ROUNDED(CACHE_OBJ_SIZE_WITH(clock)));
+  cache->cache_free(cache);
+
+  /* an algorithm that does not declare the size has the full object */
+  cache = LIRS_init(cc_params, NULL);
+  g_assert_cmpuint(cache_get_obj_struct_size(cache), ==,
+                   OBJ_STRUCT_SIZE_ROUNDED(sizeof(cache_obj_t)));
+  cache->cache_free(cache);
+
+  cache = LRU_init(cc_params, NULL);
+  size_t obj_struct_size = cache_get_obj_struct_size(cache);
+  g_assert_cmpuint(obj_struct_size, ==,
+                   OBJ_STRUCT_SIZE_ROUNDED(CACHE_OBJ_HEADER_SIZE));
+  char *objs[4];
+  for (int i = 0; i < 4; i++) objs[i] = (char *)_get_obj(cache, req, i);
+  /* the objects are next to each other in the pool */
+  for (int i = 1; i < 4; i++) {
+    g_assert_true(objs[i] == objs[i - 1] + obj_struct_size);
+  }
+
+  /* object 0 is evicted and its memory is used by object 4 */
+  cache_obj_t *obj = _get_obj(cache, req, 4);
+  g_assert_true((char *)obj == objs[0]);
+  g_assert_cmpint(obj->obj_id, ==, 4);
+  req->obj_id = 0;
+  g_assert_null(cache->find(cache, req, false));
+
+  /* a removed object is reused by the next insertion */
+  req->obj_id = 2;
+  g_assert_true(cache->remove(cache, 2));
+  obj = _get_obj(cache, req, 5);
+  g_assert_true((char *)obj == objs[2]);
+  g_assert_cmpint(cache->get_n_obj(cache), ==, 4);
+  cache->cache_free(cache);
+
+  /* the metadata of a reused object is cleared */
+  cache = Clock_init(cc_params, NULL);
+  for (int i = 0; i < 4; i++) _get_obj(cache, req, i);
+  cache_obj_t *obj3 = _get_obj(cache, req, 3);
+  g_assert_cmpint(CACHE_OBJ_MEMBER(cache, obj3, clock).freq, ==, 1);
+  req->obj_id = 3;
+  g_assert_true(cache->remove(cache, 3));
+  obj = _get_obj(cache, req, 6);
+  g_assert_true(obj == obj3);
+  g_assert_cmpint(CACHE_OBJ_MEMBER(cache, obj, clock).freq, ==, 0);
+  cache->cache_free(cache);
+
+  free_request(req);
+}
+
 static void empty_test(gconstpointer user_data) { ; }
 
 int main(int argc, char *argv[]) {
@@ -570,6 +846,8 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func("/libCacheSim/cacheAlgo_Hyperbolic", reader,
                        test_Hyperbolic);
   g_test_add_data_func("/libCacheSim/cacheAlgo_LIRS", reader, test_LIRS);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_WTinyLFU", reader,
+                       test_WTinyLFU);
 
   g_test_add_data_func("/libCacheSim/cacheAlgo_Clock", reader, test_Clock);
   g_test_add_data_func("/libCacheSim/cacheAlgo_FIFO", reader, test_FIFO);
@@ -588,6 +866,22 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func("/libCacheSim/cacheAlgo_BeladySize", reader,
                        test_BeladySize);
 
+  g_test_add_data_func("/libCacheSim/cacheAlgo_obj_struct_size", reader,
+                       test_obj_struct_size);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_snapshot", reader,
+                       test_snapshot);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_snapshot_mismatch", reader,
+                       test_snapshot_mismatch);
+
+#if defined(ENABLE_LRB) && ENABLE_LRB == 1
+  g_test_add_data_func("/libCacheSim/cacheAlgo_LRB_training", reader,
+                       test_LRB_training);
+#endif
+#if defined(ENABLE_GLCACHE) && ENABLE_GLCACHE == 1
+  g_test_add_data_func("/libCacheSim/cacheAlgo_GLCache_training", reader,
+                       test_GLCache_training);
+#endif
+
   g_test_add_data_func_full("/libCacheSim/empty", reader, empty_test,
                             test_teardown);
 
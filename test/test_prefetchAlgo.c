@@ -65,6 +65,28 @@ static void test_Mithril(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+static void test_Mithril_incremental_mining(gconstpointer user_data) {
+  uint64_t miss_cnt_true[] = {79796, 78482, 76126, 75256,
+                              72336, 72062, 71936, 71667};
+  uint64_t miss_byte_true[] = {3471357440, 3399742464, 3285093888, 3245231616,
+                               3092759040, 3077801472, 3075234816, 3061489664};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = LRU_init(cc_params, NULL);
+  cache->prefetcher =
+      create_prefetcher("Mithril", "mining-step=16", cc_params.cache_size);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+
+  print_results(cache, res);
+  _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
+                           miss_cnt_true, g_req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
 static void test_OBL(gconstpointer user_data) {
   uint64_t miss_cnt_true[] = {92139, 88548, 82337, 80487, 71259, 70869, 70737, 70469};
   uint64_t miss_byte_true[] = {4213140480, 4060079616, 3776877568, 3659406848,
@@ -99,6 +121,41 @@ static void test_PG(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+static void test_Stride(gconstpointer user_data) {
+  uint64_t miss_cnt_true[] = {85475, 81752, 75776, 73735, 67368, 64317, 64192, 63920};
+  uint64_t miss_byte_true[] = {4170799104, 4020898816, 3745000448, 3629302784,
+                               3239773696, 3043179520, 3040426496, 3026947072};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("Stride", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+
+  print_results(cache, res);
+  _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true, miss_cnt_true, g_req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
+/* the state of the prefetcher is counted in the metadata of the cache */
+static void test_prefetch_metadata_bytes(gconstpointer user_data) {
+  const char *algos[] = {"Mithril", "OBL", "PG", "Stride"};
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .hashpower = 16, .default_ttl = DEFAULT_TTL};
+
+  for (int i = 0; i < (int)(sizeof(algos) / sizeof(algos[0])); i++) {
+    cache_t *cache = LRU_init(cc_params, NULL);
+    int64_t base_bytes = cache->get_metadata_bytes(cache);
+    cache->prefetcher = create_prefetcher(algos[i], NULL, cc_params.cache_size);
+    int64_t pf_bytes = cache->prefetcher->get_metadata_bytes(cache->prefetcher);
+    g_assert_cmpint(pf_bytes, >, 0);
+    g_assert_cmpint(cache->get_metadata_bytes(cache), ==,
+                    base_bytes + pf_bytes);
+    cache->cache_free(cache);
+  }
+}
+
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
   srand(0);  // for reproducibility
@@ -114,8 +171,13 @@ int main(int argc, char *argv[]) {
   reader = setup_oracleGeneralBin_reader();
   // reader = setup_vscsi_reader_with_ignored_obj_size();
   g_test_add_data_func("/libCacheSim/cacheAlgo_Mithril", reader, test_Mithril);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_Mithril_incremental_mining",
+                       reader, test_Mithril_incremental_mining);
   g_test_add_data_func("/libCacheSim/cacheAlgo_OBL", reader, test_OBL);
   g_test_add_data_func("/libCacheSim/cacheAlgo_PG", reader, test_PG);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_Stride", reader, test_Stride);
+  g_test_add_data_func("/libCacheSim/prefetch_metadata_bytes", reader,
+                       test_prefetch_metadata_bytes);
 
   return g_test_run();
 }
\ No newline at end of file
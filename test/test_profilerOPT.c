@@ -0,0 +1,115 @@
+//
+// test the offline optimal profilers
+//
+
+#include "common.h"
+
+static const uint64_t g_req_cnt_true = 113872, g_req_byte_true = 4368040448;
+
+static reader_t *setup_oracleGeneralBin_reader_ignore_obj_size(void) {
+  char data_path[1024];
+  _detect_data_path(data_path, "cloudPhysicsIO.oracleGeneral.bin");
+  reader_init_param_t init_params = {.ignore_obj_size = true};
+  return setup_reader(data_path, ORACLE_GENERAL_TRACE, &init_params);
+}
+
+static void test_opt_miss_bounds(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  uint64_t lru_miss_cnt[] = {93374, 89783, 83572, 81722,
+                             72494, 72104, 71972, 71704};
+  uint64_t lru_miss_byte[] = {4214303232, 4061242368, 3778040320, 3660569600,
+                              3100927488, 3078128640, 3075403776, 3061662720};
+  int n_sizes = CACHE_SIZE / STEP_SIZE;
+  uint64_t cache_sizes[CACHE_SIZE / STEP_SIZE];
+  for (int i = 0; i < n_sizes; i++) {
+    cache_sizes[i] = STEP_SIZE * (i + 1);
+  }
+
+  opt_bound_t *res =
+      get_opt_miss_bounds(reader, n_sizes, cache_sizes, 1, _n_cores());
+  opt_bound_t *res_seg =
+      get_opt_miss_bounds(reader, n_sizes, cache_sizes, 4, _n_cores());
+
+  for (int i = 0; i < n_sizes; i++) {
+    g_assert_cmpuint(res[i].n_req, ==, g_req_cnt_true);
+    g_assert_cmpuint(res[i].n_req_byte, ==, g_req_byte_true);
+    g_assert_cmpint(res[i].n_miss_lower, <=, res[i].n_miss_upper);
+    g_assert_cmpint(res[i].n_miss_byte_lower, <=, res[i].n_miss_byte_upper);
+
+    /* the lower bound is below any feasible policy */
+    g_assert_cmpint(res[i].n_miss_lower, <=, lru_miss_cnt[i]);
+    g_assert_cmpint(res[i].n_miss_byte_lower, <=, lru_miss_byte[i]);
+    /* compulsory misses */
+    g_assert_cmpint(res[i].n_miss_lower, >=, 48974);
+    /* the upper bound is a feasible policy that beats LRU */
+    g_assert_cmpint(res[i].n_miss_upper, <=, lru_miss_cnt[i]);
+    g_assert_cmpint(res[i].n_miss_byte_upper, <=, lru_miss_byte[i]);
+
+    /* segmenting does not change the lower bound */
+    g_assert_cmpint(res_seg[i].n_miss_lower, ==, res[i].n_miss_lower);
+    g_assert_cmpint(res_seg[i].n_miss_lower, <=, res_seg[i].n_miss_upper);
+    /* and does not loosen the upper bound beyond LRU */
+    g_assert_cmpint(res_seg[i].n_miss_upper, <=, lru_miss_cnt[i]);
+    g_assert_cmpint(res_seg[i].n_miss_byte_upper, <=, lru_miss_byte[i]);
+
+    if (i > 0) {
+      g_assert_cmpint(res[i].n_miss_lower, <=, res[i - 1].n_miss_lower);
+      g_assert_cmpint(res[i].n_miss_byte_lower, <=,
+                      res[i - 1].n_miss_byte_lower);
+    }
+  }
+
+  my_free(sizeof(opt_bound_t) * n_sizes, res);
+  my_free(sizeof(opt_bound_t) * n_sizes, res_seg);
+}
+
+static void test_belady_obj_miss_ratio(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  int64_t max_size = 4000;
+  double *mr = get_belady_obj_miss_ratio(reader, max_size);
+  g_assert_cmpfloat(mr[0], ==, 1.0);
+
+  /* compare with Belady simulated at a few sizes */
+  uint64_t cache_sizes[] = {100, 500, 1000, 2000, 4000};
+  int n_sizes = sizeof(cache_sizes) / sizeof(cache_sizes[0]);
+  common_cache_params_t cc_params = {
+      .cache_size = max_size, .hashpower = 16, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("Belady", cc_params, reader, NULL);
+  cache_stat_t *res = simulate_at_multi_sizes(reader, cache, n_sizes,
+                                              cache_sizes, NULL, 0, 0, 1, NULL);
+  for (int i = 0; i < n_sizes; i++) {
+    double sim_mr = (double)res[i].n_miss / (double)res[i].n_req;
+    g_assert_cmpfloat(fabs(mr[cache_sizes[i]] - sim_mr), <=, 1e-9);
+  }
+  for (int64_t i = 1; i <= max_size; i++) {
+    g_assert_cmpfloat(mr[i], <=, mr[i - 1]);
+  }
+
+  /* the approximate variant is exact for unit-size objects */
+  cache_stat_t *res_stack =
+      get_belady_miss_ratio_at_multi_sizes(reader, n_sizes, cache_sizes);
+  for (int i = 0; i < n_sizes; i++) {
+    g_assert_cmpint(res_stack[i].n_miss, ==, res[i].n_miss);
+  }
+
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t) * n_sizes, res);
+  my_free(sizeof(cache_stat_t) * n_sizes, res_stack);
+  g_free(mr);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  reader_t *reader;
+
+  /* OPT profilers require the next access time from oracleGeneral trace */
+  reader = setup_oracleGeneralBin_reader();
+  g_test_add_data_func_full("/libCacheSim/test_opt_miss_bounds", reader,
+                            test_opt_miss_bounds, test_teardown);
+
+  reader = setup_oracleGeneralBin_reader_ignore_obj_size();
+  g_test_add_data_func_full("/libCacheSim/test_belady_obj_miss_ratio", reader,
+                            test_belady_obj_miss_ratio, test_teardown);
+
+  return g_test_run();
+}
@@ -2,6 +2,9 @@
 // Created by Juncheng Yang on 11/21/19.
 //
 
+#include <sys/wait.h>
+
+#include "../libCacheSim/dataStructure/consistentHash.h"
 #include "common.h"
 
 /**
@@ -88,7 +91,7 @@ static void test_simulator(gconstpointer user_data) {
   uint64_t cache_sizes[] = {STEP_SIZE, STEP_SIZE * 2, STEP_SIZE * 4,
                             STEP_SIZE * 7};
   res = simulate_at_multi_sizes(reader, cache, 4, cache_sizes, NULL, 0, 0,
-                                _n_cores());
+                                _n_cores(), NULL);
   g_assert_cmpuint(res[0].cache_size, ==, STEP_SIZE);
   g_assert_cmpuint(res[1].n_req_byte, ==, req_byte_true);
   g_assert_cmpuint(res[3].n_req, ==, req_cnt_true);
@@ -107,7 +110,23 @@ static void test_simulator(gconstpointer user_data) {
   }
 
   res = simulate_with_multi_caches(reader, caches, 4, NULL, 0, 0, _n_cores(),
-                                   false);
+                                   false, NULL);
+  g_assert_cmpuint(res[0].cache_size, ==, STEP_SIZE);
+  g_assert_cmpuint(res[1].n_req_byte, ==, req_byte_true);
+  g_assert_cmpuint(res[3].n_req, ==, req_cnt_true);
+  g_assert_cmpuint(res[0].n_miss_byte, ==, miss_byte_true[0]);
+  g_assert_cmpuint(res[2].n_miss, ==, miss_cnt_true[3]);
+  g_assert_cmpuint(res[3].n_miss_byte, ==, miss_byte_true[6]);
+  g_free(res);
+
+  for (int i = 0; i < 4; i++) {
+    caches[i]->cache_free(caches[i]);
+    cc_params.cache_size = cache_sizes[i];
+    caches[i] = LRU_init(cc_params, NULL);
+  }
+
+  res = simulate_with_multi_caches_tiled(reader, caches, 4, NULL, 0, 0,
+                                         _n_cores(), false, NULL);
   g_assert_cmpuint(res[0].cache_size, ==, STEP_SIZE);
   g_assert_cmpuint(res[1].n_req_byte, ==, req_byte_true);
   g_assert_cmpuint(res[3].n_req, ==, req_cnt_true);
@@ -221,6 +240,437 @@ static void test_simulator_with_ttl(gconstpointer user_data) {
   cache->cache_free(cache);
 }
 
+/* each forked branch should match a cache that changes its parameters at
+ * the end of the prefix */
+static void test_simulator_forked_branches(gconstpointer user_data) {
+  const sim_branch_t branches[] = {
+      {NULL, NULL, NULL},
+      {"move-to-main-threshold=1", NULL, NULL},
+      {"move-to-main-threshold=3", NULL, NULL},
+      {"move-to-main-threshold=2", "size", "size=100000"}};
+  const int n_branch = sizeof(branches) / sizeof(branches[0]);
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 4,
+                                     .default_ttl = 0};
+  cache_t *cache = S3FIFO_init(cc_params, NULL);
+  g_assert_true(cache != NULL);
+
+  cache_stat_t *res = simulate_with_forked_branches(reader, cache, 0.2,
+                                                    branches, n_branch, 2);
+  int64_t n_prefix_req = (int64_t)((double)get_num_of_req(reader) * 0.2);
+
+  request_t *req = new_request();
+  for (int i = 0; i < n_branch; i++) {
+    cache_t *ref = S3FIFO_init(cc_params, NULL);
+    int64_t n_req = 0, n_miss = 0;
+    reset_reader(reader);
+    for (int64_t j = 0; read_one_req(reader, req) == 0; j++) {
+      if (j == n_prefix_req) {
+        if (branches[i].eviction_params != NULL) {
+          g_assert_true(ref->set_params(ref, branches[i].eviction_params));
+        }
+        if (branches[i].admission_algo != NULL) {
+          ref->admissioner = create_admissioner(branches[i].admission_algo,
+                                                branches[i].admission_params);
+        }
+      }
+      bool hit = ref->get(ref, req);
+      if (j >= n_prefix_req) {
+        n_req++;
+        n_miss += hit ? 0 : 1;
+      }
+    }
+
+    g_assert_cmpstr(res[i].cache_name, ==, ref->cache_name);
+    g_assert_cmpint(res[i].n_warmup_req, ==, n_prefix_req);
+    g_assert_cmpint(res[i].n_req, ==, n_req);
+    g_assert_cmpint(res[i].n_miss, ==, n_miss);
+    ref->cache_free(ref);
+  }
+  g_assert_cmpint(res[1].n_miss, !=, res[2].n_miss);
+  free_request(req);
+  reset_reader(reader);
+
+  my_free(sizeof(cache_stat_t) * n_branch, res);
+  cache->cache_free(cache);
+}
+
+/* a branch that cannot change the parameters fails without stopping the
+ * other branches, and the children of the caller are not reaped */
+static void test_simulator_forked_branches_failure(gconstpointer user_data) {
+  const sim_branch_t branches[] = {
+      {"move-to-main-threshold=1", NULL, NULL},
+      {"fifo-size-ratio=0.5", NULL, NULL},
+      {NULL, NULL, NULL}};
+  const int n_branch = sizeof(branches) / sizeof(branches[0]);
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 4,
+                                     .default_ttl = 0};
+  cache_t *cache = S3FIFO_init(cc_params, NULL);
+
+  pid_t user_child = fork();
+  g_assert_cmpint(user_child, >=, 0);
+  if (user_child == 0) _exit(7);
+
+  cache_stat_t *res = simulate_with_forked_branches(reader, cache, 0.2,
+                                                    branches, n_branch, 1);
+  g_assert_cmpint(res[0].n_req, >, 0);
+  g_assert_cmpint(res[1].n_req, ==, 0);
+  g_assert_cmpint(res[2].n_req, ==, res[0].n_req);
+
+  int status;
+  g_assert_cmpint(waitpid(user_child, &status, 0), ==, user_child);
+  g_assert_true(WIFEXITED(status));
+  g_assert_cmpint(WEXITSTATUS(status), ==, 7);
+
+  reset_reader(reader);
+  my_free(sizeof(cache_stat_t) * n_branch, res);
+  cache->cache_free(cache);
+}
+
+/* the simulator reports the metadata bytes of each cache, and a cache that
+ * charges its metadata keeps the data and the metadata within its size */
+static void test_simulator_charge_metadata(gconstpointer user_data) {
+  const int n_cache = 5;
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = 4 * MiB, .default_ttl = 0, .hashpower = 12};
+  cache_t *caches[n_cache];
+  caches[0] = LRU_init(cc_params, NULL);
+  caches[1] = LRU_init(cc_params, NULL);
+  caches[2] = S3FIFO_init(cc_params, NULL);
+  caches[3] = S3FIFO_init(cc_params, NULL);
+  /* the metadata alone is larger than the cache */
+  cc_params.cache_size = 32 * KiB;
+  caches[4] = LRU_init(cc_params, NULL);
+  caches[1]->charge_metadata = true;
+  caches[3]->charge_metadata = true;
+  caches[4]->charge_metadata = true;
+
+  cache_stat_t *res = simulate_with_multi_caches(
+      reader, caches, n_cache, NULL, 0, 0, _n_cores(), false, NULL);
+
+  for (int i = 0; i < n_cache; i++) {
+    cache_t *cache = caches[i];
+    int64_t metadata_byte = cache->get_metadata_bytes(cache);
+    g_assert_cmpint(res[i].metadata_byte, ==, metadata_byte);
+    g_assert_cmpint(res[i].max_metadata_byte, >=, metadata_byte);
+    g_assert_cmpint(metadata_byte, >, (int64_t)sizeof(cache_t));
+    if (cache->charge_metadata && cache->get_n_obj(cache) > 0) {
+      /* the struct of the last inserted object is charged on the next miss */
+      g_assert_cmpint(cache->get_occupied_byte(cache) + metadata_byte, <=,
+                      cache->cache_size + (int64_t)sizeof(cache_obj_t));
+    }
+  }
+  /* S3FIFO has the ghost and the sub-caches */
+  g_assert_cmpint(res[2].metadata_byte, >, res[0].metadata_byte);
+  g_assert_cmpint(res[1].n_miss, >=, res[0].n_miss);
+  g_assert_cmpint(res[4].n_miss, ==, res[4].n_req);
+  g_assert_cmpint(caches[4]->get_n_obj(caches[4]), ==, 0);
+
+  for (int i = 0; i < n_cache; i++) {
+    caches[i]->cache_free(caches[i]);
+  }
+  my_free(sizeof(cache_stat_t) * n_cache, res);
+}
+
+/* the windows of each cache should add up to the result of the cache */
+static void test_simulator_metrics(gconstpointer user_data) {
+  const char *metrics_path = "test_metrics.csv";
+  const int n_cache = 4;
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE,
+                                     .default_ttl = 0};
+  cache_t *caches[4];
+  for (int i = 0; i < n_cache; i++) {
+    cc_params.cache_size = STEP_SIZE * (i + 1);
+    caches[i] = LRU_init(cc_params, NULL);
+  }
+
+  metrics_recorder_t *recorder =
+      create_metrics_recorder(metrics_path, METRICS_FORMAT_CSV, 0, 10000);
+  cache_stat_t *res = simulate_with_multi_caches(
+      reader, caches, n_cache, NULL, 0, 0, _n_cores(), true, recorder);
+  close_metrics_recorder(recorder);
+
+  int64_t n_req[4] = {0}, n_miss[4] = {0}, n_eviction[4] = {0};
+  int n_window = 0;
+  char line[1024];
+  FILE *f = fopen(metrics_path, "r");
+  g_assert_true(f != NULL);
+  g_assert_true(fgets(line, sizeof(line), f) != NULL);
+  while (fgets(line, sizeof(line), f) != NULL) {
+    int idx;
+    char name[128];
+    long long cache_size, window_idx, start_rtime, end_rtime, req, miss, evict;
+    g_assert_cmpint(sscanf(line,
+                           "%d,%127[^,],%lld,%lld,%lld,%lld,%lld,%lld,%*d,%*d,"
+                           "%*f,%*f,%*d,%*d,%lld",
+                           &idx, name, &cache_size, &window_idx, &start_rtime,
+                           &end_rtime, &req, &miss, &evict),
+                    ==, 9);
+    g_assert_true(idx >= 0 && idx < n_cache);
+    g_assert_cmpint(req, <=, 10000);
+    n_req[idx] += req;
+    n_miss[idx] += miss;
+    n_eviction[idx] += evict;
+    n_window++;
+  }
+  fclose(f);
+  remove(metrics_path);
+
+  g_assert_cmpint(n_window, >=, n_cache * (res[0].n_req / 10000));
+  for (int i = 0; i < n_cache; i++) {
+    g_assert_cmpint(n_req[i], ==, res[i].n_req);
+    g_assert_cmpint(n_miss[i], ==, res[i].n_miss);
+    g_assert_cmpint(n_eviction[i], >, 0);
+  }
+  my_free(sizeof(cache_stat_t) * n_cache, res);
+}
+
+/* a cluster simulated by the workers should match the servers simulated
+ * one request at a time in trace order */
+static void test_simulator_cache_cluster(gconstpointer user_data) {
+  const int n_server = 4, replication = 2;
+  const cluster_event_t events[] = {
+      {20000, CLUSTER_EVENT_REMOVE_SERVER, 1},
+      {60000, CLUSTER_EVENT_ADD_SERVER, 1},
+      {80000, CLUSTER_EVENT_REMOVE_SERVER, 3}};
+  const int n_event = sizeof(events) / sizeof(events[0]);
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 8,
+                                     .default_ttl = 0};
+
+  cluster_stat_t *res[2];
+  for (int r = 0; r < 2; r++) {
+    cache_t *caches[4];
+    for (int i = 0; i < n_server; i++) caches[i] = LRU_init(cc_params, NULL);
+    cache_cluster_t *cluster =
+        create_cache_cluster(caches, NULL, n_server, replication);
+    res[r] = simulate_cache_cluster(cluster, reader, events, n_event,
+                                    r == 0 ? 1 : n_server);
+    g_assert_false(cluster->available[3]);
+    free_cache_cluster(cluster);
+    reset_reader(reader);
+  }
+
+  cache_t *refs[4];
+  for (int i = 0; i < n_server; i++) refs[i] = LRU_init(cc_params, NULL);
+  ring_t *ring = ch_ring_create_ring(n_server, NULL);
+  bool available[4] = {true, true, true, true};
+  int64_t n_req[4] = {0}, n_hit[4] = {0}, n_replica_req[4] = {0};
+  unsigned int idxs[2];
+  request_t *req = new_request();
+  for (int64_t j = 0, e = 0; read_one_req(reader, req) == 0; j++) {
+    while (e < n_event && events[e].n_req <= j) {
+      available[events[e].server_id] =
+          events[e].type == CLUSTER_EVENT_ADD_SERVER;
+      e++;
+    }
+    unsigned int n = ch_ring_get_available_servers_from_uint64(
+        req->obj_id, ring, replication, idxs, available);
+    g_assert_cmpuint(n, ==, replication);
+    for (unsigned int k = 0; k < n; k++) {
+      bool hit = refs[idxs[k]]->get(refs[idxs[k]], req);
+      if (k == 0) {
+        n_req[idxs[k]]++;
+        n_hit[idxs[k]] += hit ? 1 : 0;
+      } else {
+        n_replica_req[idxs[k]]++;
+      }
+    }
+  }
+  free_request(req);
+  reset_reader(reader);
+
+  for (int r = 0; r < 2; r++) {
+    int64_t n_miss = 0, n_served = 0, max_served = 0;
+    g_assert_cmpint(res[r]->n_req, ==, get_num_of_req(reader));
+    g_assert_cmpint(res[r]->n_unserved, ==, 0);
+    for (int i = 0; i < n_server; i++) {
+      cluster_server_stat_t *s = &res[r]->server_stats[i];
+      g_assert_cmpint(s->n_req, ==, n_req[i]);
+      g_assert_cmpint(s->n_hit, ==, n_hit[i]);
+      g_assert_cmpint(s->n_replica_req, ==, n_replica_req[i]);
+      n_miss += s->n_req - s->n_hit;
+      n_served += s->n_req;
+      if (s->n_req > max_served) max_served = s->n_req;
+    }
+    g_assert_cmpint(n_served, ==, res[r]->n_req);
+    g_assert_cmpint(n_miss, ==, res[r]->n_miss);
+    g_assert_cmpfloat_with_epsilon(
+        res[r]->load_imbalance,
+        (double)max_served / ((double)n_served / n_server), 1e-9);
+    g_assert_cmpfloat(res[r]->load_imbalance, >=, 1.0);
+  }
+  /* server 1 is removed for half of the trace */
+  g_assert_cmpint(n_req[1], <, n_req[0]);
+
+  for (int i = 0; i < n_server; i++) refs[i]->cache_free(refs[i]);
+  ch_ring_destroy_ring(ring);
+  free_cluster_stat(res[0]);
+  free_cluster_stat(res[1]);
+}
+
+/* a hierarchy of single caches should match the levels simulated one request
+ * at a time, and the what-if caches of the last level should see the same
+ * stream no matter how the threads are scheduled */
+static void test_simulator_cache_hierarchy(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 16,
+                                     .default_ttl = 0};
+  cache_t *l1 = LRU_init(cc_params, NULL);
+  cc_params.cache_size = CACHE_SIZE / 4;
+  cache_t *l2 = LRU_init(cc_params, NULL);
+  cc_params.cache_size = CACHE_SIZE;
+  cache_t *l3 = LRU_init(cc_params, NULL);
+  hierarchy_level_t levels[3] = {{&l1, 1}, {&l2, 1}, {&l3, 1}};
+  hierarchy_stat_t *res = simulate_cache_hierarchy(
+      &reader, levels, 3, HIERARCHY_INCLUSIVE, HIERARCHY_WRITE_THROUGH);
+  reset_reader(reader);
+
+  cache_t *refs[3];
+  int64_t n_req[3] = {0}, n_hit[3] = {0};
+  for (int i = 0; i < 3; i++) refs[i] = clone_cache(levels[i].caches[0]);
+  request_t *req = new_request();
+  while (read_one_req(reader, req) == 0) {
+    for (int i = 0; i < 3; i++) {
+      n_req[i]++;
+      if (refs[i]->get(refs[i], req)) {
+        n_hit[i]++;
+        break;
+      }
+    }
+  }
+  reset_reader(reader);
+  for (int i = 0; i < 3; i++) {
+    hierarchy_cache_stat_t *s = &res->cache_stats[i][0];
+    g_assert_cmpint(s->n_req, ==, n_req[i]);
+    g_assert_cmpint(s->n_hit, ==, n_hit[i]);
+    g_assert_cmpint(s->n_forward, ==, n_req[i] - n_hit[i]);
+    g_assert_cmpint(s->n_eviction, ==, levels[i].caches[0]->n_eviction);
+    refs[i]->cache_free(refs[i]);
+    levels[i].caches[0]->cache_free(levels[i].caches[0]);
+  }
+  free_hierarchy_stat(res);
+
+  /* two first level caches share three what-if last level caches */
+  hierarchy_stat_t *runs[2];
+  for (int r = 0; r < 2; r++) {
+    reader_t *readers[2] = {reader, clone_reader(reader)};
+    cache_t *firsts[2], *lasts[3];
+    cc_params.cache_size = CACHE_SIZE / 16;
+    for (int i = 0; i < 2; i++) firsts[i] = LRU_init(cc_params, NULL);
+    for (int i = 0; i < 3; i++) {
+      cc_params.cache_size = CACHE_SIZE / 4 * (i + 1);
+      lasts[i] = LRU_init(cc_params, NULL);
+    }
+    hierarchy_level_t two_levels[2] = {{firsts, 2}, {lasts, 3}};
+    runs[r] = simulate_cache_hierarchy(readers, two_levels, 2,
+                                       HIERARCHY_INCLUSIVE,
+                                       HIERARCHY_WRITE_THROUGH);
+    for (int i = 0; i < 2; i++) firsts[i]->cache_free(firsts[i]);
+    for (int i = 0; i < 3; i++) lasts[i]->cache_free(lasts[i]);
+    close_reader(readers[1]);
+    reset_reader(reader);
+  }
+  for (int i = 0; i < 3; i++) {
+    hierarchy_cache_stat_t *s = &runs[0]->cache_stats[1][i];
+    g_assert_cmpint(s->n_req, ==,
+                    runs[0]->cache_stats[0][0].n_forward +
+                        runs[0]->cache_stats[0][1].n_forward);
+    g_assert_cmpint(s->n_hit, ==, runs[1]->cache_stats[1][i].n_hit);
+    g_assert_cmpint(s->n_hit_byte, ==, runs[1]->cache_stats[1][i].n_hit_byte);
+  }
+  g_assert_cmpint(runs[0]->cache_stats[1][0].n_hit, <,
+                  runs[0]->cache_stats[1][2].n_hit);
+  free_hierarchy_stat(runs[0]);
+  free_hierarchy_stat(runs[1]);
+
+  /* an exclusive level receives every eviction of the level above */
+  cc_params.cache_size = CACHE_SIZE / 16;
+  l1 = LRU_init(cc_params, NULL);
+  cc_params.cache_size = CACHE_SIZE / 4;
+  l2 = LRU_init(cc_params, NULL);
+  hierarchy_level_t exclusive_levels[2] = {{&l1, 1}, {&l2, 1}};
+  res = simulate_cache_hierarchy(&reader, exclusive_levels, 2,
+                                 HIERARCHY_EXCLUSIVE, HIERARCHY_WRITE_THROUGH);
+  reset_reader(reader);
+  g_assert_cmpint(res->cache_stats[1][0].n_demotion, ==, l1->n_eviction);
+  g_assert_cmpint(res->cache_stats[1][0].n_req, ==,
+                  res->cache_stats[0][0].n_forward);
+  g_assert_cmpint(res->cache_stats[1][0].n_hit, >, 0);
+  l1->cache_free(l1);
+  l2->cache_free(l2);
+  free_hierarchy_stat(res);
+  free_request(req);
+}
+
+/* with write-back, the next level only sees the dirty objects evicted from
+ * the level above, with write-through it sees every write */
+static void test_simulator_cache_hierarchy_write_back(gconstpointer user_data) {
+  const char *trace_path = "test_hierarchy_writes.bin";
+  reader_t *reader = (reader_t *)user_data;
+  request_t *req = new_request();
+  FILE *f = fopen(trace_path, "wb");
+  g_assert_true(f != NULL);
+  for (int64_t i = 0; read_one_req(reader, req) == 0; i++) {
+    uint32_t ts = (uint32_t)req->clock_time;
+    uint64_t obj_id = (uint64_t)req->obj_id;
+    uint32_t obj_size = (uint32_t)req->obj_size;
+    uint8_t op = i % 4 == 0 ? OP_SET : OP_GET;
+    fwrite(&ts, sizeof(ts), 1, f);
+    fwrite(&obj_id, sizeof(obj_id), 1, f);
+    fwrite(&obj_size, sizeof(obj_size), 1, f);
+    fwrite(&op, sizeof(op), 1, f);
+  }
+  fclose(f);
+  free_request(req);
+  reset_reader(reader);
+
+  reader_init_param_t init_params = default_reader_init_params();
+  init_params.time_field = 1;
+  init_params.obj_id_field = 2;
+  init_params.obj_size_field = 3;
+  init_params.op_field = 4;
+  init_params.binary_fmt_str = "<IQIB";
+
+  hierarchy_stat_t *res[2];
+  for (int r = 0; r < 2; r++) {
+    reader_t *write_reader = open_trace(trace_path, BIN_TRACE, &init_params);
+    common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 16,
+                                       .default_ttl = 0};
+    cache_t *l1 = LRU_init(cc_params, NULL);
+    cc_params.cache_size = CACHE_SIZE / 4;
+    cache_t *l2 = LRU_init(cc_params, NULL);
+    hierarchy_level_t levels[2] = {{&l1, 1}, {&l2, 1}};
+    res[r] = simulate_cache_hierarchy(
+        &write_reader, levels, 2, HIERARCHY_INCLUSIVE,
+        r == 0 ? HIERARCHY_WRITE_THROUGH : HIERARCHY_WRITE_BACK);
+    l1->cache_free(l1);
+    l2->cache_free(l2);
+    close_reader(write_reader);
+  }
+  remove(trace_path);
+
+  hierarchy_cache_stat_t *wt = res[0]->cache_stats[0];
+  hierarchy_cache_stat_t *wb = res[1]->cache_stats[0];
+  g_assert_cmpint(wt->n_write, ==, (wt->n_req + 3) / 4);
+  g_assert_cmpint(wt->n_write, ==, wb->n_write);
+  g_assert_cmpint(wt->n_writeback, ==, 0);
+  g_assert_cmpint(wb->n_writeback, >, 0);
+  g_assert_cmpint(wb->n_forward + wb->n_writeback, <,
+                  wt->n_forward);
+  g_assert_cmpint(res[0]->cache_stats[1][0].n_write, ==, wt->n_write);
+  g_assert_cmpint(res[1]->cache_stats[1][0].n_write, ==, wb->n_writeback);
+  free_hierarchy_stat(res[0]);
+  free_hierarchy_stat(res[1]);
+}
+
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
   reader_t *reader;
@@ -257,6 +707,36 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func_full("/libCacheSim/simulator_warmup2", reader,
                             test_simulator_with_warmup2, test_teardown);
 
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_forked_branches", reader,
+                            test_simulator_forked_branches, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_forked_branches_failure",
+                            reader, test_simulator_forked_branches_failure,
+                            test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_charge_metadata", reader,
+                            test_simulator_charge_metadata, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_metrics", reader,
+                            test_simulator_metrics, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_cache_cluster", reader,
+                            test_simulator_cache_cluster, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_cache_hierarchy", reader,
+                            test_simulator_cache_hierarchy, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_cache_hierarchy_write_back",
+                            reader, test_simulator_cache_hierarchy_write_back,
+                            test_teardown);
+
 #ifdef SUPPORT_TTL
   reader = setup_vscsi_reader();
   g_test_add_data_func_full("/libCacheSim/simulator_with_ttl", reader,
@@ -0,0 +1,157 @@
+#include "../libCacheSim/dataStructure/timerWheel.h"
+#include "../libCacheSim/utils/include/mymath.h"
+#include "common.h"
+
+#define N_TW_ENTRY 20000
+
+typedef struct {
+  /* the time an entry fires, max(exp_time, the time it is added + 1) */
+  int64_t fire_time[N_TW_ENTRY];
+  bool added[N_TW_ENTRY];
+  bool done[N_TW_ENTRY];
+  /* the fire time of the last fired entry */
+  int64_t last_fire_time;
+  int64_t prev_now;
+  int64_t now;
+  int64_t n_fired;
+} tw_ref_t;
+
+static void _tw_expire(obj_id_t obj_id, uint32_t exp_time, void *user_data) {
+  tw_ref_t *ref = user_data;
+  g_assert_cmpuint(obj_id, <, N_TW_ENTRY);
+  g_assert_true(ref->added[obj_id]);
+  g_assert_false(ref->done[obj_id]);
+  /* the entries fire in the order of the fire time, within the advance */
+  g_assert_cmpint(ref->fire_time[obj_id], >=, ref->last_fire_time);
+  g_assert_cmpint(ref->fire_time[obj_id], >, ref->prev_now);
+  g_assert_cmpint(ref->fire_time[obj_id], <=, ref->now);
+  g_assert_cmpint(ref->fire_time[obj_id], >=, (int64_t)exp_time);
+  ref->last_fire_time = ref->fire_time[obj_id];
+  ref->done[obj_id] = true;
+  ref->n_fired += 1;
+}
+
+static bool _tw_keep(obj_id_t obj_id, uint32_t exp_time, void *user_data) {
+  tw_ref_t *ref = user_data;
+  if (obj_id % 7 != 0) return true;
+  ref->done[obj_id] = true;
+  return false;
+}
+
+/* compare the wheel with a reference that fires each entry at its fire time,
+ * the times span all levels and include large jumps and expired entries */
+static void test_timer_wheel(gconstpointer user_data) {
+  tw_ref_t *ref = g_new0(tw_ref_t, 1);
+  timer_wheel_t *tw = create_timer_wheel();
+  set_rand_seed(42);
+
+  int64_t n_added = 0;
+  while (n_added < N_TW_ENTRY) {
+    uint64_t r = next_rand() >> 33;
+    if (r % 4 != 0) {
+      /* the remaining time is in a random level */
+      int level = (int)((next_rand() >> 33) % TIMER_WHEEL_N_LEVEL);
+      int64_t remain = (int64_t)((next_rand() >> 33) %
+                                 (1ULL << (TIMER_WHEEL_SLOT_BITS * level + 4)));
+      remain -= 4; /* some entries have expired */
+      int64_t exp_time = MAX(tw->curr_time + remain, 0);
+      if (exp_time > UINT32_MAX) exp_time = UINT32_MAX;
+      timer_wheel_add(tw, n_added, (uint32_t)exp_time);
+      ref->fire_time[n_added] = MAX(exp_time, tw->curr_time + 1);
+      ref->added[n_added] = true;
+      n_added += 1;
+    } else if (r % 64 == 4) {
+      timer_wheel_compact(tw, _tw_keep, ref);
+    } else {
+      /* mostly small steps, sometimes a large jump */
+      int64_t step = r % 16 == 8 ? (int64_t)((next_rand() >> 33) % (1 << 20))
+                                 : (int64_t)((next_rand() >> 33) % 64);
+      ref->prev_now = tw->curr_time;
+      ref->now = tw->curr_time + step;
+      ref->last_fire_time = 0;
+      int64_t n_expected = 0;
+      for (int64_t i = 0; i < n_added; i++) {
+        if (!ref->done[i] && ref->fire_time[i] <= ref->now) n_expected += 1;
+      }
+
+      ref->n_fired = 0;
+      int64_t n_expired = timer_wheel_advance(tw, ref->now, _tw_expire, ref);
+      g_assert_cmpint(tw->curr_time, ==, ref->now);
+      g_assert_cmpint(n_expired, ==, n_expected);
+      g_assert_cmpint(ref->n_fired, ==, n_expected);
+
+      int64_t n_pending = 0;
+      for (int64_t i = 0; i < n_added; i++) {
+        if (ref->done[i]) continue;
+        g_assert_cmpint(ref->fire_time[i], >, ref->now);
+        n_pending += 1;
+      }
+      g_assert_cmpint(tw->n_entry, ==, n_pending);
+    }
+  }
+
+  /* drain the wheel */
+  ref->prev_now = tw->curr_time;
+  ref->now = UINT32_MAX;
+  ref->last_fire_time = 0;
+  timer_wheel_advance(tw, ref->now, _tw_expire, ref);
+  g_assert_cmpint(tw->n_entry, ==, 0);
+  for (int64_t i = 0; i < N_TW_ENTRY; i++) g_assert_true(ref->done[i]);
+
+  free_timer_wheel(tw);
+  g_free(ref);
+}
+
+/* the objects that expire are removed without being requested */
+static void test_cache_remove_expired(gconstpointer user_data) {
+  common_cache_params_t cc_params = {
+      .cache_size = 1000, .hashpower = 16, .default_ttl = 0};
+  cache_t *cache = LRU_init(cc_params, NULL);
+  request_t *req = new_request();
+  req->obj_size = 1;
+
+  /* the even objects expire at 200 + i, the odd ones at 2000 + i */
+  for (int i = 0; i < 100; i++) {
+    req->obj_id = i;
+    req->clock_time = i;
+    req->ttl = i % 2 == 0 ? 200 : 2000;
+    cache->get(cache, req);
+  }
+  g_assert_cmpint(cache->get_n_obj(cache), ==, 100);
+
+#ifdef SUPPORT_TTL
+  /* the even objects before 50 have exp_time < 250 */
+  g_assert_cmpint(cache_remove_expired(cache, 250), ==, 25);
+  g_assert_cmpint(cache->n_expiration, ==, 25);
+  g_assert_cmpint(cache->n_expired_byte, ==, 25);
+  g_assert_cmpint(cache->get_n_obj(cache), ==, 75);
+  g_assert_cmpint(cache->get_occupied_byte(cache), ==, 75);
+  g_assert_cmpint(cache_remove_expired(cache, 250), ==, 0);
+
+  /* a request removes the other even objects */
+  req->obj_id = 1000;
+  req->clock_time = 400;
+  req->ttl = 2000;
+  g_assert_false(cache->get(cache, req));
+  g_assert_cmpint(cache->n_expiration, ==, 50);
+  g_assert_cmpint(cache->get_n_obj(cache), ==, 51);
+  g_assert_cmpint(cache->n_eviction, ==, 0);
+#else
+  g_assert_cmpint(cache_remove_expired(cache, 250), ==, 0);
+  g_assert_cmpint(cache->n_expiration, ==, 0);
+  g_assert_cmpint(cache->get_n_obj(cache), ==, 100);
+#endif
+
+  free_request(req);
+  cache->cache_free(cache);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_data_func("/libCacheSim/timer_wheel", NULL, test_timer_wheel);
+  g_test_add_data_func("/libCacheSim/cache_remove_expired", NULL,
+                       test_cache_remove_expired);
+
+  return g_test_run();
+}
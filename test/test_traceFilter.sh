@@ -0,0 +1,55 @@
+#!/bin/bash
+# compare the LRU filters derived from stack distances with the LRU cache
+# usage: test_traceFilter.sh /path/to/traceFilter /path/to/cloudPhysicsIO.vscsi
+
+set -e
+
+trace_filter=$1
+trace=$2
+tmp_dir=$(mktemp -d)
+trap 'rm -rf ${tmp_dir}' EXIT
+
+run_filter() {
+  local output=$1
+  shift
+  "${trace_filter}" "${trace}" vscsi --filter-type lru -o "${output}" \
+    "$@" >/dev/null 2>&1
+}
+
+# each record in the filtered trace is 24 bytes
+n_miss() {
+  echo $(($(wc -c <"$1") / 24))
+}
+
+# the LRU cache is the default
+run_filter "${tmp_dir}/default" --filter-size 0.1
+run_filter "${tmp_dir}/lru" --filter-size 0.1 --lru-stack-dist false
+cmp -s "${tmp_dir}/default" "${tmp_dir}/lru" ||
+  { echo "the default filter is not the LRU cache"; exit 1; }
+
+# stack distances are exact when all objects have the same size
+for size in 0.01 0.1 0.5; do
+  run_filter "${tmp_dir}/lru_${size}" --filter-size ${size} \
+    --ignore-obj-size 1 --lru-stack-dist false
+  run_filter "${tmp_dir}/stack_${size}" --filter-size ${size} \
+    --ignore-obj-size 1 --lru-stack-dist true
+  cmp -s "${tmp_dir}/lru_${size}" "${tmp_dir}/stack_${size}" ||
+    { echo "size ${size}: stack distance differs from LRU"; exit 1; }
+done
+
+# with object sizes, the misses differ slightly (within 1%)
+for size in 0.1 64KiB; do
+  run_filter "${tmp_dir}/lru_size_${size}" --filter-size ${size} \
+    --lru-stack-dist false
+  run_filter "${tmp_dir}/stack_size_${size}" --filter-size ${size} \
+    --lru-stack-dist true
+  n_lru=$(n_miss "${tmp_dir}/lru_size_${size}")
+  n_stack=$(n_miss "${tmp_dir}/stack_size_${size}")
+  diff=$((n_stack > n_lru ? n_stack - n_lru : n_lru - n_stack))
+  if [[ ${n_lru} -eq 0 || $((diff * 100)) -gt ${n_lru} ]]; then
+    echo "size ${size}: LRU ${n_lru} misses, stack distance ${n_stack} misses"
+    exit 1
+  fi
+done
+
+echo "traceFilter test has passed"
@@ -150,6 +150,85 @@ void test_twr(gconstpointer user_data) {
          (unsigned long long)n_obj);
 }
 
+void test_synthetic(gconstpointer user_data) {
+  const int n_req = 200000, n_obj = 1000;
+  char spec[256];
+  snprintf(spec, sizeof(spec),
+           "dist=zipf,alpha=1.0,n-obj=%d,n-req=%d,seed=7,size-dist=uniform,"
+           "size-min=100,size-max=200",
+           n_obj, n_req);
+  reader_t *reader = setup_reader(spec, SYNTHETIC_TRACE, NULL);
+  g_assert_true(get_num_of_req(reader) == n_req);
+
+  request_t *req = new_request();
+  obj_id_t first_ids[N_TEST_REQ];
+  int64_t *cnt = g_new0(int64_t, n_obj);
+  int64_t *sizes = g_new0(int64_t, n_obj);
+  int i = 0;
+  while (read_one_req(reader, req) == 0) {
+    g_assert_cmpuint(req->obj_id, <, n_obj);
+    g_assert_cmpint(req->obj_size, >=, 100);
+    g_assert_cmpint(req->obj_size, <=, 200);
+    /* the size of an object does not change */
+    if (sizes[req->obj_id] != 0)
+      g_assert_cmpint(sizes[req->obj_id], ==, req->obj_size);
+    sizes[req->obj_id] = req->obj_size;
+    if (i < N_TEST_REQ) first_ids[i] = req->obj_id;
+    cnt[req->obj_id]++;
+    i++;
+  }
+  g_assert_cmpint(i, ==, n_req);
+
+  /* with alpha 1, rank 1 is requested twice as often as rank 2 */
+  g_assert_cmpint(cnt[0], >, cnt[1]);
+  g_assert_cmpint(cnt[1], >, cnt[9]);
+  g_assert_cmpfloat(fabs((double)cnt[0] / cnt[1] - 2.0), <, 0.1);
+  g_assert_cmpfloat(fabs((double)cnt[0] / cnt[9] - 10.0), <, 1.0);
+
+  /* the trace is deterministic after reset, skip and clone */
+  reset_reader(reader);
+  for (i = 0; i < N_TEST_REQ; i++) {
+    read_one_req(reader, req);
+    g_assert_cmpuint(req->obj_id, ==, first_ids[i]);
+  }
+  reset_reader(reader);
+  g_assert_true(skip_n_req(reader, 4) == 4);
+  read_one_req(reader, req);
+  g_assert_cmpuint(req->obj_id, ==, first_ids[4]);
+  read_one_req_above(reader, req);
+  g_assert_cmpuint(req->obj_id, ==, first_ids[3]);
+
+  reader_t *cloned_reader = clone_reader(reader);
+  read_first_req(cloned_reader, req);
+  g_assert_cmpuint(req->obj_id, ==, first_ids[0]);
+  close_reader(cloned_reader);
+  close_reader(reader);
+
+  /* scans and churn */
+  reader = setup_reader(
+      "dist=uniform,n-obj=1000,n-req=10000,scan-len=100,scan-ratio=0.5,"
+      "churn-interval=5000,churn-step=1000",
+      SYNTHETIC_TRACE, NULL);
+  obj_id_t last_id = 0;
+  for (i = 0; i < 10000; i++) {
+    read_one_req(reader, req);
+    int64_t base = i < 5000 ? 0 : 1000;
+    g_assert_cmpuint(req->obj_id, >=, base);
+    g_assert_cmpuint(req->obj_id, <, base + 1000);
+    /* the first 100 of every 200 requests are a sequential scan */
+    if (i % 200 > 0 && i % 200 < 100) {
+      g_assert_cmpuint(req->obj_id - base, ==, (last_id - base + 1) % 1000);
+    }
+    last_id = req->obj_id;
+  }
+  g_assert_true(read_one_req(reader, req) != 0);
+  close_reader(reader);
+
+  g_free(cnt);
+  g_free(sizes);
+  free_request(req);
+}
+
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
   reader_t *reader;
@@ -210,6 +289,8 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func_full("/libCacheSim/reader_more2_oracleGeneral", reader,
                             test_reader_more2, test_teardown);
 
+  g_test_add_data_func("/libCacheSim/reader_synthetic", NULL, test_synthetic);
+
   // g_test_add_data_func("/libCacheSim/test_twr", NULL, test_twr);
   return g_test_run();
 }
\ No newline at end of file